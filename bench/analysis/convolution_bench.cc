@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\analysis\convolution.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<float> RandomValues(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  std::vector<float> values;
+  for (size_t i = 0; i < count; ++i) { values.push_back(distribution(generator)); }
+  return values;
+}
+
+// Run with the instruction set given as first argument, see utility/simd.h.
+bool SelectSimdLevel(benchmark::State& state) {
+  SimdLevel level = SimdLevel(state.range(0));
+  if (GetSupportedSimdLevel() < level) { state.SkipWithError("Instruction set not supported by this CPU."); return false; }
+  SetSimdLevel(level);
+  return true;
+}
+
+} // namespace
+
+//
+// Convolution of 2^16 samples, arguments: method (see ConvolutionMethod), kernel length
+//
+void BM_Convolution(benchmark::State& state) {
+  std::vector<float> x = RandomValues(1 << 16, 1), h = RandomValues(size_t(state.range(1)), 2), y(x.size());
+  ConvolutionMethod method = ConvolutionMethod(state.range(0));
+  for (auto _ : state) {
+    Convolve(x.data(), x.size(), h.data(), h.size(), y.data(), h.size() / 2, IndexType::CLAMP, method);
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(x.size()));
+}
+BENCHMARK(BM_Convolution)->ArgsProduct({ { int(ConvolutionMethod::DIRECT), int(ConvolutionMethod::FFT) }, { 8, 32, 128, 512, 1024, 4096 } });
+
+// Hand-written loop over Sequence1D::Get, argument: kernel length
+void BM_ConvolutionGet(benchmark::State& state) {
+  Sequence1D<float> sequence(RandomValues(1 << 16, 1));
+  std::vector<float> h = RandomValues(size_t(state.range(0)), 2), y(sequence.Length());
+  for (auto _ : state) {
+    for (size_t i = 0; i < sequence.Length(); ++i) {
+      float sum = 0.f;
+      for (size_t k = 0; k < h.size(); ++k) { sum += h[k] * sequence.Get(size_t(std::max(ptrdiff_t(i + h.size() / 2) - ptrdiff_t(k), ptrdiff_t(0)))); }
+      y[i] = sum;
+    }
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+}
+BENCHMARK(BM_ConvolutionGet)->Arg(16)->Arg(64);
+
+// Direct convolution per instruction set, arguments: instruction set, kernel length
+void BM_ConvolutionDirectSimd(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  std::vector<float> x = RandomValues(1 << 16, 1), h = RandomValues(size_t(state.range(1)), 2), y(x.size());
+  for (auto _ : state) {
+    Convolve(x.data(), x.size(), h.data(), h.size(), y.data(), 0, IndexType::CLAMP, ConvolutionMethod::DIRECT);
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  SetSimdLevel(GetSupportedSimdLevel());
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(x.size()));
+}
+BENCHMARK(BM_ConvolutionDirectSimd)->ArgsProduct({ { int(SimdLevel::SCALAR), int(SimdLevel::SSE), int(SimdLevel::AVX2) }, { 16 } });
+
+// Streaming FIR filter over chunks of 256 samples, arguments: method, kernel length
+void BM_FirFilter(benchmark::State& state) {
+  std::vector<float> x = RandomValues(1 << 16, 1), y(x.size());
+  FirFilter<float> filter(RandomValues(size_t(state.range(1)), 2), ConvolutionMethod(state.range(0)));
+  for (auto _ : state) {
+    for (size_t begin = 0; begin < x.size(); begin += 256) { filter.Process(x.data() + begin, y.data() + begin, 256); }
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(x.size()));
+}
+BENCHMARK(BM_FirFilter)->ArgsProduct({ { int(ConvolutionMethod::DIRECT), int(ConvolutionMethod::FFT) }, { 16, 128 } });
@@ -0,0 +1,99 @@
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\analysis\fft.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<std::complex<float>> RandomComplex(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  std::vector<std::complex<float>> values;
+  for (size_t i = 0; i < count; ++i) { values.push_back(std::complex<float>(distribution(generator), distribution(generator))); }
+  return values;
+}
+
+// O(n^2) reference with precomputed roots of unity.
+void NaiveDft(const std::vector<std::complex<float>>& roots, const std::complex<float>* in, std::complex<float>* out) {
+  size_t n = roots.size();
+  for (size_t k = 0; k < n; ++k) {
+    std::complex<float> sum = 0.f;
+    for (size_t j = 0, index = 0; j < n; ++j, index = (index + k < n) ? index + k : index + k - n) { sum += detail::MultiplyComplex(in[j], roots[index]); }
+    out[k] = sum;
+  }
+}
+
+} // namespace
+
+//
+// Complex transforms, argument: size
+//
+void BM_NaiveDft(benchmark::State& state) {
+  size_t size = size_t(state.range(0));
+  std::vector<std::complex<float>> in = RandomComplex(size, 1), out(size), roots(size);
+  for (size_t k = 0; k < size; ++k) { roots[k] = std::polar(1.f, -2.f * float(PI) * float(k) / float(size)); }
+  for (auto _ : state) {
+    NaiveDft(roots, in.data(), out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size));
+}
+BENCHMARK(BM_NaiveDft)->RangeMultiplier(4)->Range(1 << 6, 1 << 12);
+
+void BM_Fft(benchmark::State& state) {
+  size_t size = size_t(state.range(0));
+  std::vector<std::complex<float>> in = RandomComplex(size, 1), out(size);
+  std::shared_ptr<const FftPlan<float>> plan = GetFftPlan<float>(size);
+  for (auto _ : state) {
+    plan->Forward(in.data(), out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size));
+}
+BENCHMARK(BM_Fft)->RangeMultiplier(4)->Range(1 << 6, 1 << 20);
+// Mixed radix sizes (2^6 * 3 * 5^2 * 7, 3^10) and a prime
+BENCHMARK(BM_Fft)->Arg(33600)->Arg(59049)->Arg(4099);
+
+// Creating the plan on every call instead of reusing it
+void BM_FftPlanCreation(benchmark::State& state) {
+  size_t size = size_t(state.range(0));
+  std::vector<std::complex<float>> in = RandomComplex(size, 1), out(size);
+  for (auto _ : state) {
+    FftPlan<float>(size).Forward(in.data(), out.data());
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size));
+}
+BENCHMARK(BM_FftPlanCreation)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+//
+// Real transforms of a Sequence1D, argument: size
+//
+void BM_RealFft(benchmark::State& state) {
+  size_t size = size_t(state.range(0));
+  std::vector<std::complex<float>> values = RandomComplex(size, 1);
+  Sequence1D<float> sequence;
+  for (const std::complex<float>& v : values) { sequence.Add(v.real()); }
+  GetRealFftPlan<float>(size);  // Create the cached plan outside the timed loop
+  for (auto _ : state) { benchmark::DoNotOptimize(RealFft(sequence)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size));
+}
+BENCHMARK(BM_RealFft)->RangeMultiplier(4)->Range(1 << 6, 1 << 20);
+
+// Forward and inverse transform in place
+void BM_SequenceFft(benchmark::State& state) {
+  size_t size = size_t(state.range(0));
+  Sequence1D<std::complex<float>> sequence(RandomComplex(size, 1));
+  GetFftPlan<float>(size);
+  for (auto _ : state) {
+    Fft(sequence);
+    InverseFft(sequence);
+    benchmark::DoNotOptimize(sequence.Ptr());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size));
+}
+BENCHMARK(BM_SequenceFft)->RangeMultiplier(4)->Range(1 << 6, 1 << 20);
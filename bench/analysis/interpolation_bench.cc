@@ -0,0 +1,159 @@
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\analysis\interpolation.h"
+
+using namespace j::math;
+
+namespace {
+
+Sequence1D<float> RandomSequence(size_t length, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+  std::vector<float> data;
+  for (size_t i = 0; i < length; ++i) { data.push_back(distribution(generator)); }
+  return Sequence1D<float>(data);
+}
+
+// Sample positions spread over the sequence, in random order to include the cost of cache misses on long sequences.
+std::vector<float> RandomPositions(size_t count, size_t length, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> distribution(0.f, float(length - 1));
+  std::vector<float> positions;
+  for (size_t i = 0; i < count; ++i) { positions.push_back(distribution(generator)); }
+  return positions;
+}
+
+// Run with the instruction set given as first argument, see utility/simd.h.
+bool SelectSimdLevel(benchmark::State& state) {
+  SimdLevel level = SimdLevel(state.range(0));
+  if (GetSupportedSimdLevel() < level) { state.SkipWithError("Instruction set not supported by this CPU."); return false; }
+  SetSimdLevel(level);
+  return true;
+}
+
+void SimdLevelArguments(benchmark::internal::Benchmark* b) {
+  for (int level : { int(SimdLevel::SCALAR), int(SimdLevel::SSE), int(SimdLevel::AVX2) }) { b->Args({ level, 1 << 16 }); }
+}
+
+} // namespace
+
+//
+// Interpolation of a Sequence1D, argument: sequence length
+//
+void BM_NearestNeighborInterpolation(benchmark::State& state) {
+  Sequence1D<float> sequence = RandomSequence(size_t(state.range(0)), 1);
+  std::vector<float> positions = RandomPositions(1 << 14, sequence.Length(), 2);
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (float x : positions) { sum += Interpolation::NearestNeighborInterpolation(sequence, x); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(positions.size()));
+}
+BENCHMARK(BM_NearestNeighborInterpolation)->Range(1 << 10, 1 << 22);
+
+void BM_LinearInterpolation(benchmark::State& state) {
+  Sequence1D<float> sequence = RandomSequence(size_t(state.range(0)), 1);
+  std::vector<float> positions = RandomPositions(1 << 14, sequence.Length(), 2);
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (float x : positions) { sum += Interpolation::LinearInterpolation(sequence, x); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(positions.size()));
+}
+BENCHMARK(BM_LinearInterpolation)->Range(1 << 10, 1 << 22);
+
+// Resampling a whole sequence at a fixed step, the access pattern of audio and signal resampling
+void BM_LinearInterpolationResample(benchmark::State& state) {
+  Sequence1D<float> sequence = RandomSequence(size_t(state.range(0)), 1);
+  const float step = 0.75f;
+  size_t count = size_t(float(sequence.Length() - 1) / step);
+  std::vector<float> result(count);
+  for (auto _ : state) {
+    for (size_t i = 0; i < count; ++i) { result[i] = Interpolation::LinearInterpolation(sequence, float(i) * step); }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(count));
+}
+BENCHMARK(BM_LinearInterpolationResample)->Range(1 << 10, 1 << 20);
+
+// The same resampling as a single batch call
+void BM_LinearResampleUniform(benchmark::State& state) {
+  Sequence1D<float> sequence = RandomSequence(size_t(state.range(0)), 1);
+  const double step = 0.75;
+  size_t count = size_t(double(sequence.Length() - 1) / step);
+  for (auto _ : state) { benchmark::DoNotOptimize(Interpolation::LinearResampleUniform(sequence, 0., step, count)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(count));
+}
+BENCHMARK(BM_LinearResampleUniform)->Range(1 << 10, 1 << 20);
+
+//
+// Batch resampling at random positions, arguments: instruction set, sequence length
+//
+void BM_NearestNeighborResample(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  Sequence1D<float> sequence = RandomSequence(size_t(state.range(1)), 1);
+  std::vector<float> positions = RandomPositions(1 << 14, sequence.Length(), 2);
+  for (auto _ : state) { benchmark::DoNotOptimize(Interpolation::NearestNeighborResample(sequence, positions)); }
+  SetSimdLevel(GetSupportedSimdLevel());
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(positions.size()));
+}
+BENCHMARK(BM_NearestNeighborResample)->Apply(SimdLevelArguments);
+
+void BM_LinearResample(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  Sequence1D<float> sequence = RandomSequence(size_t(state.range(1)), 1);
+  std::vector<float> positions = RandomPositions(1 << 14, sequence.Length(), 2);
+  for (auto _ : state) { benchmark::DoNotOptimize(Interpolation::LinearResample(sequence, positions)); }
+  SetSimdLevel(GetSupportedSimdLevel());
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(positions.size()));
+}
+BENCHMARK(BM_LinearResample)->Apply(SimdLevelArguments);
+
+void BM_LinearResampleWrap(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  Sequence1D<float> sequence = RandomSequence(size_t(state.range(1)), 1);
+  std::vector<float> positions = RandomPositions(1 << 14, 4 * sequence.Length(), 2);
+  for (auto _ : state) { benchmark::DoNotOptimize(Interpolation::LinearResample(sequence, positions, IndexType::WRAP)); }
+  SetSimdLevel(GetSupportedSimdLevel());
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(positions.size()));
+}
+BENCHMARK(BM_LinearResampleWrap)->Apply(SimdLevelArguments);
+
+//
+// Kernel interpolation, argument: kernel (see InterpolationKernel)
+//
+void BM_KernelResample(benchmark::State& state) {
+  Sequence1D<float> sequence = RandomSequence(1 << 16, 1);
+  std::vector<float> positions = RandomPositions(1 << 14, sequence.Length(), 2);
+  InterpolationKernel kernel = InterpolationKernel(state.range(0));
+  for (auto _ : state) { benchmark::DoNotOptimize(Interpolation::KernelResample(sequence, positions, kernel)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(positions.size()));
+}
+BENCHMARK(BM_KernelResample)->DenseRange(0, 2);
+
+void BM_KernelResampleTable(benchmark::State& state) {
+  Sequence1D<float> sequence = RandomSequence(1 << 16, 1);
+  std::vector<float> positions = RandomPositions(1 << 14, sequence.Length(), 2);
+  InterpolationTable table(InterpolationKernel(state.range(0)), 256);
+  for (auto _ : state) { benchmark::DoNotOptimize(Interpolation::KernelResample(sequence, positions, table)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(positions.size()));
+}
+BENCHMARK(BM_KernelResampleTable)->DenseRange(0, 2);
+
+// Polyphase resampling by 160 / 147 (48 kHz to 44.1 kHz)
+void BM_KernelResampleRational(benchmark::State& state) {
+  Sequence1D<float> sequence = RandomSequence(1 << 16, 1);
+  InterpolationTable table(InterpolationKernel(state.range(0)), 147);
+  size_t count = 0;
+  for (auto _ : state) {
+    Sequence1D<float> result = Interpolation::KernelResampleRational(sequence, table, 160);
+    count = result.Length();
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(count));
+}
+BENCHMARK(BM_KernelResampleRational)->DenseRange(0, 2);
@@ -0,0 +1,269 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\analysis\mapped_sequence.h"
+#include "..\..\lib\analysis\sequence.h"
+#include "..\..\lib\analysis\streaming_sequence.h"
+#include "..\..\lib\utility\allocator.h"
+
+using namespace j::math;
+
+namespace {
+
+template<typename valuetype>
+Sequence1D<valuetype> RandomSequence(size_t length, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(-100., 100.);
+  std::vector<valuetype> data;
+  for (size_t i = 0; i < length; ++i) { data.push_back(valuetype(distribution(generator))); }
+  return Sequence1D<valuetype>(data);
+}
+
+// Selects the instruction set given as the first benchmark argument, skipping the benchmark when it is unsupported.
+bool SelectSimdLevel(benchmark::State& state) {
+  SimdLevel level = SimdLevel(state.range(0));
+  if (GetSupportedSimdLevel() < level) { state.SkipWithError("Instruction set not supported by this CPU."); return false; }
+  SetSimdLevel(level);
+  return true;
+}
+
+void SimdLevelArguments(benchmark::internal::Benchmark* b) {
+  for (int level : { int(SimdLevel::SCALAR), int(SimdLevel::SSE), int(SimdLevel::AVX2) }) { b->Args({ level, 1 << 16 }); }
+}
+
+} // namespace
+
+//
+// Sequence1D reductions, argument: sequence length
+//
+template<typename valuetype>
+void BM_Sequence1DSum(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  for (auto _ : state) { benchmark::DoNotOptimize(sequence.Sum()); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sequence.Length() * sizeof(valuetype)));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DSum, int)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_Sequence1DSum, float)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_Sequence1DSum, double)->Range(1 << 10, 1 << 22);
+
+template<typename valuetype>
+void BM_Sequence1DSumOfSquares(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  for (auto _ : state) { benchmark::DoNotOptimize(sequence.SumOfSquares()); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sequence.Length() * sizeof(valuetype)));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DSumOfSquares, float)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_Sequence1DSumOfSquares, double)->Range(1 << 10, 1 << 22);
+
+template<typename valuetype>
+void BM_Sequence1DAverage(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  for (auto _ : state) { benchmark::DoNotOptimize(sequence.Average()); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sequence.Length() * sizeof(valuetype)));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DAverage, float)->Range(1 << 10, 1 << 22);
+
+// Arguments: sequence length, summation policy
+template<typename valuetype>
+void BM_Sequence1DSumPolicy(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  SummationPolicy policy = SummationPolicy(state.range(1));
+  for (auto _ : state) { benchmark::DoNotOptimize(sequence.Sum(policy)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sequence.Length() * sizeof(valuetype)));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DSumPolicy, float)->Ranges({ { 1 << 10, 1 << 22 }, { int(SummationPolicy::PAIRWISE), int(SummationPolicy::KAHAN) } });
+BENCHMARK_TEMPLATE(BM_Sequence1DSumPolicy, double)->Ranges({ { 1 << 10, 1 << 22 }, { int(SummationPolicy::PAIRWISE), int(SummationPolicy::KAHAN) } });
+
+// Arguments: SIMD level, sequence length
+template<typename valuetype>
+void BM_Sequence1DSumSimd(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(1)), 1);
+  for (auto _ : state) { benchmark::DoNotOptimize(sequence.Sum()); }
+  SetSimdLevel(GetSupportedSimdLevel());
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sequence.Length() * sizeof(valuetype)));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DSumSimd, float)->Apply(SimdLevelArguments);
+BENCHMARK_TEMPLATE(BM_Sequence1DSumSimd, double)->Apply(SimdLevelArguments);
+
+// Arguments: sequence length, thread count (0 for all hardware threads)
+template<typename valuetype>
+void BM_Sequence1DSumThreads(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  size_t thread_count = size_t(state.range(1));
+  for (auto _ : state) { benchmark::DoNotOptimize(sequence.Sum(SummationPolicy::PAIRWISE, thread_count)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sequence.Length() * sizeof(valuetype)));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DSumThreads, float)->ArgsProduct({ { 1 << 24 }, { 1, 2, 4, 0 } })->UseRealTime();
+
+// Single-pass statistics, arguments: sequence length, thread count
+template<typename valuetype>
+void BM_Sequence1DStatistics(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  size_t thread_count = size_t(state.range(1));
+  for (auto _ : state) { benchmark::DoNotOptimize(sequence.Statistics(thread_count)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sequence.Length() * sizeof(valuetype)));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DStatistics, float)->ArgsProduct({ { 1 << 10, 1 << 16, 1 << 22 }, { 1 } });
+BENCHMARK_TEMPLATE(BM_Sequence1DStatistics, double)->ArgsProduct({ { 1 << 10, 1 << 16, 1 << 22 }, { 1 } });
+BENCHMARK_TEMPLATE(BM_Sequence1DStatistics, float)->ArgsProduct({ { 1 << 24 }, { 2, 0 } })->UseRealTime();
+
+// File-backed sequence (pages already cached by the operating system), argument: sequence length
+template<typename valuetype>
+void BM_MappedSequence1DSum(benchmark::State& state) {
+  const char* path = "sequence_bench.bin";
+  {
+    Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(sequence.Ptr()), std::streamsize(sequence.Length() * sizeof(valuetype)));
+  }
+  {
+    MappedSequence1D<valuetype> sequence(path);
+    for (auto _ : state) { benchmark::DoNotOptimize(sequence.Sum()); }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(sequence.Length() * sizeof(valuetype)));
+  }
+  std::remove(path);
+}
+BENCHMARK_TEMPLATE(BM_MappedSequence1DSum, float)->Range(1 << 16, 1 << 24);
+
+// Appending one sample and querying the statistics, arguments: window capacity (0 for unbounded)
+template<typename valuetype>
+void BM_StreamingSequence1DAdd(benchmark::State& state) {
+  Sequence1D<valuetype> samples = RandomSequence<valuetype>(1 << 16, 1);
+  StreamingSequence1D<valuetype> sequence(size_t(state.range(0)));
+  size_t i = 0;
+  for (auto _ : state) {
+    sequence.Add(samples(i++ & 0xffff));
+    benchmark::DoNotOptimize(sequence.Average());
+    benchmark::DoNotOptimize(sequence.Variance());
+    benchmark::DoNotOptimize(sequence.Max());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK_TEMPLATE(BM_StreamingSequence1DAdd, float)->Arg(0)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_StreamingSequence1DAdd, double)->Arg(1 << 10);
+
+// Element access through the index conversion of Get
+template<typename valuetype>
+void BM_Sequence1DGet(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  IndexType index_type = IndexType(state.range(1));
+  for (auto _ : state) {
+    valuetype sum = 0;
+    for (size_t i = 0; i < sequence.Length(); ++i) { sum += sequence.Get(i, index_type); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DGet, float)->Args({ 1 << 16, int(IndexType::CLAMP) })->Args({ 1 << 16, int(IndexType::WRAP) });
+
+//
+// Range queries, arguments: sequence length, range length
+//
+// Windowed averages at random positions from the prefix sums (built before timing)
+template<typename valuetype>
+void BM_Sequence1DRangeAverage(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  size_t window = size_t(state.range(1));
+  std::mt19937 generator(2);
+  std::uniform_int_distribution<size_t> distribution(0, sequence.Length() - window);
+  std::vector<size_t> begins;
+  for (size_t i = 0; i < 1024; ++i) { begins.push_back(distribution(generator)); }
+  sequence.BuildPrefixSums();
+  for (auto _ : state) {
+    for (size_t begin : begins) { benchmark::DoNotOptimize(sequence.Average(begin, begin + window)); }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(begins.size()));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DRangeAverage, float)->Args({ 1 << 22, 1 << 10 })->Args({ 1 << 22, 1 << 16 });
+
+// The same windows summed one by one
+template<typename valuetype>
+void BM_Sequence1DRangeAverageLinear(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  size_t window = size_t(state.range(1));
+  std::mt19937 generator(2);
+  std::uniform_int_distribution<size_t> distribution(0, sequence.Length() - window);
+  std::vector<size_t> begins;
+  for (size_t i = 0; i < 1024; ++i) { begins.push_back(distribution(generator)); }
+  for (auto _ : state) {
+    for (size_t begin : begins) { benchmark::DoNotOptimize(ReduceSum(sequence.Ptr() + begin, window) / valuetype(window)); }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(begins.size()));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DRangeAverageLinear, float)->Args({ 1 << 22, 1 << 10 })->Args({ 1 << 22, 1 << 16 });
+
+// Building the prefix sums, arguments: sequence length, thread count (0 for all hardware threads)
+template<typename valuetype>
+void BM_PrefixSums(benchmark::State& state) {
+  Sequence1D<valuetype> sequence = RandomSequence<valuetype>(size_t(state.range(0)), 1);
+  std::vector<PrefixSumType<valuetype>> prefix(sequence.Length() + 1);
+  size_t thread_count = size_t(state.range(1));
+  for (auto _ : state) {
+    ComputePrefixSums(sequence.Ptr(), sequence.Length(), prefix.data(), false, thread_count);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(sequence.Length()));
+}
+BENCHMARK_TEMPLATE(BM_PrefixSums, float)->ArgsProduct({ { 1 << 24 }, { 1, 2, 4, 0 } })->UseRealTime();
+
+//
+// Allocation, argument: sequence length
+//
+namespace {
+
+// One frame of scratch work: 64 sequences built by repeated Add, each copied once.
+template<typename valuetype, typename allocator>
+void AddAndCopyFrame(const allocator& alloc, size_t length) {
+  for (size_t s = 0; s < 64; ++s) {
+    Sequence1D<valuetype, allocator> sequence(alloc);
+    for (size_t i = 0; i < length; ++i) { sequence.Add(valuetype(i)); }
+    Sequence1D<valuetype, allocator> copy = sequence;
+    benchmark::DoNotOptimize(copy.Ptr());
+  }
+}
+
+} // namespace
+
+template<typename valuetype>
+void BM_Sequence1DAddAndCopy(benchmark::State& state) {
+  size_t length = size_t(state.range(0));
+  for (auto _ : state) { AddAndCopyFrame<valuetype>(std::allocator<valuetype>(), length); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * 64 * int64_t(length));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DAddAndCopy, float)->Arg(16)->Arg(256)->Arg(4096);
+
+// The same frames from an arena, reset after every frame
+template<typename valuetype>
+void BM_Sequence1DAddAndCopyArena(benchmark::State& state) {
+  size_t length = size_t(state.range(0));
+  MemoryArena arena;
+  for (auto _ : state) {
+    AddAndCopyFrame<valuetype>(ArenaAllocator<valuetype>(arena), length);
+    arena.Reset();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * 64 * int64_t(length));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DAddAndCopyArena, float)->Arg(16)->Arg(256)->Arg(4096);
+
+// The same frames from a pool with blocks large enough for the final capacity of a sequence
+template<typename valuetype>
+void BM_Sequence1DAddAndCopyPool(benchmark::State& state) {
+  size_t length = size_t(state.range(0)), capacity = 1;
+  while (capacity < length) { capacity *= 2; }
+  MemoryPool pool(capacity * sizeof(valuetype));
+  for (auto _ : state) { AddAndCopyFrame<valuetype>(PoolAllocator<valuetype>(pool), length); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * 64 * int64_t(length));
+}
+BENCHMARK_TEMPLATE(BM_Sequence1DAddAndCopyPool, float)->Arg(16)->Arg(256)->Arg(4096);
@@ -0,0 +1,141 @@
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\analysis\interpolation.h"
+#include "..\..\lib\analysis\sequence_2d.h"
+#include "..\..\lib\analysis\sequence_3d.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<float> RandomValues(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+  std::vector<float> values;
+  for (size_t i = 0; i < count; ++i) { values.push_back(distribution(generator)); }
+  return values;
+}
+
+std::vector<size_t> RandomIndices(size_t count, size_t bound, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<size_t> distribution(1, bound - 2);
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < count; ++i) { indices.push_back(distribution(generator)); }
+  return indices;
+}
+
+void LayoutArguments(benchmark::internal::Benchmark* b, int size) {
+  for (int layout : { int(GridLayout::ROW_MAJOR), int(GridLayout::TILED), int(GridLayout::MORTON) }) { b->Args({ layout, size }); }
+}
+
+} // namespace
+
+//
+// Images, arguments: layout, width and height
+//
+// Sum over the columns one after the other, the access order that suits row-major storage worst.
+void BM_NestedVectorColumnSweep(benchmark::State& state) {
+  size_t size = size_t(state.range(1));
+  std::vector<float> values = RandomValues(size * size, 1);
+  std::vector<std::vector<float>> image(size);
+  for (size_t y = 0; y < size; ++y) { image[y].assign(values.begin() + ptrdiff_t(y * size), values.begin() + ptrdiff_t((y + 1) * size)); }
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (size_t x = 0; x < size; ++x) { for (size_t y = 0; y < size; ++y) { sum += image[y][x]; } }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size * size));
+}
+BENCHMARK(BM_NestedVectorColumnSweep)->Args({ 0, 2048 });
+
+void BM_Sequence2DColumnSweep(benchmark::State& state) {
+  size_t size = size_t(state.range(1));
+  seq2f image(size, size, RandomValues(size * size, 1), GridLayout(state.range(0)));
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (size_t x = 0; x < size; ++x) { for (size_t y = 0; y < size; ++y) { sum += image(x, y); } }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size * size));
+}
+BENCHMARK(BM_Sequence2DColumnSweep)->Apply([](benchmark::internal::Benchmark* b) { LayoutArguments(b, 2048); });
+
+// 3 x 3 neighborhoods at random positions
+void BM_Sequence2DNeighborhood(benchmark::State& state) {
+  size_t size = size_t(state.range(1));
+  seq2f image(size, size, RandomValues(size * size, 1), GridLayout(state.range(0)));
+  std::vector<size_t> xs = RandomIndices(1 << 14, size, 2), ys = RandomIndices(1 << 14, size, 3);
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (size_t i = 0; i < xs.size(); ++i) {
+      for (size_t dy = 0; dy < 3; ++dy) { for (size_t dx = 0; dx < 3; ++dx) { sum += image(xs[i] + dx - 1, ys[i] + dy - 1); } }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(xs.size()));
+}
+BENCHMARK(BM_Sequence2DNeighborhood)->Apply([](benchmark::internal::Benchmark* b) { LayoutArguments(b, 4096); });
+
+void BM_Sequence2DSum(benchmark::State& state) {
+  size_t size = size_t(state.range(1));
+  seq2f image(size, size, RandomValues(size * size, 1), GridLayout(state.range(0)));
+  for (auto _ : state) { benchmark::DoNotOptimize(image.Sum()); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size * size));
+}
+BENCHMARK(BM_Sequence2DSum)->Apply([](benchmark::internal::Benchmark* b) { LayoutArguments(b, 2048); });
+
+void BM_BilinearResize(benchmark::State& state) {
+  size_t size = size_t(state.range(1));
+  seq2f image(size, size, RandomValues(size * size, 1), GridLayout(state.range(0)));
+  for (auto _ : state) { benchmark::DoNotOptimize(Interpolation::BilinearResize(image, size * 3 / 2, size * 3 / 2)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(size * size * 9 / 4));
+}
+BENCHMARK(BM_BilinearResize)->Apply([](benchmark::internal::Benchmark* b) { LayoutArguments(b, 1024); });
+
+//
+// Volumes, arguments: layout, width, height and depth
+//
+// The 6 face neighbors of random voxels
+void BM_Sequence3DNeighborhood(benchmark::State& state) {
+  size_t size = size_t(state.range(1));
+  seq3f volume(size, size, size, RandomValues(size * size * size, 1), GridLayout(state.range(0)));
+  std::vector<size_t> xs = RandomIndices(1 << 14, size, 2), ys = RandomIndices(1 << 14, size, 3), zs = RandomIndices(1 << 14, size, 4);
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (size_t i = 0; i < xs.size(); ++i) {
+      size_t x = xs[i], y = ys[i], z = zs[i];
+      sum += volume(x - 1, y, z) + volume(x + 1, y, z) + volume(x, y - 1, z) + volume(x, y + 1, z) + volume(x, y, z - 1) + volume(x, y, z + 1);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(xs.size()));
+}
+BENCHMARK(BM_Sequence3DNeighborhood)->Apply([](benchmark::internal::Benchmark* b) { LayoutArguments(b, 256); });
+
+void BM_TrilinearInterpolation(benchmark::State& state) {
+  size_t size = size_t(state.range(1));
+  seq3f volume(size, size, size, RandomValues(size * size * size, 1), GridLayout(state.range(0)));
+  std::vector<float> positions = RandomValues(3 << 14, 5);
+  for (float& p : positions) { p = (p + 100.f) / 200.f * float(size - 1); }
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (size_t i = 0; i < positions.size(); i += 3) { sum += Interpolation::TrilinearInterpolation(volume, positions[i], positions[i + 1], positions[i + 2]); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(positions.size() / 3));
+}
+BENCHMARK(BM_TrilinearInterpolation)->Apply([](benchmark::internal::Benchmark* b) { LayoutArguments(b, 256); });
+
+// Sums over random 64 x 64 rectangles from the summed-area table (built before timing)
+void BM_Sequence2DRectangleSum(benchmark::State& state) {
+  size_t size = size_t(state.range(1));
+  seq2f image(size, size, RandomValues(size * size, 1), GridLayout(state.range(0)));
+  std::vector<size_t> xs = RandomIndices(1 << 10, size - 64, 2), ys = RandomIndices(1 << 10, size - 64, 3);
+  image.BuildSummedAreaTables();
+  for (auto _ : state) {
+    for (size_t i = 0; i < xs.size(); ++i) { benchmark::DoNotOptimize(image.Sum(xs[i], ys[i], xs[i] + 64, ys[i] + 64)); }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(xs.size()));
+}
+BENCHMARK(BM_Sequence2DRectangleSum)->Args({ int(GridLayout::ROW_MAJOR), 2048 });
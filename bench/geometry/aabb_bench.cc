@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\geometry\aabb_batch.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<AABB3Df> RandomBoxes(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> corner(-100.f, 100.f), size(0.f, 10.f);
+  std::vector<AABB3Df> boxes;
+  for (size_t i = 0; i < count; ++i) {
+    p3f p(corner(generator), corner(generator), corner(generator));
+    boxes.push_back(AABB3Df(p, p + vec3f(size(generator), size(generator), size(generator))));
+  }
+  return boxes;
+}
+
+} // namespace
+
+//
+// Overlap of one box with many, argument: number of boxes
+//
+void BM_AABBOverlapsScalar(benchmark::State& state) {
+  std::vector<AABB3Df> boxes = RandomBoxes(size_t(state.range(0)), 1);
+  AABB3Df query(-20.f, -20.f, -20.f, 20.f, 20.f, 20.f);
+  std::vector<uint64_t> mask(MaskWords(boxes.size()));
+  for (auto _ : state) {
+    std::fill(mask.begin(), mask.end(), 0);
+    for (size_t i = 0; i < boxes.size(); ++i) { if (boxes[i].Overlaps(query)) { mask[i / 64] |= uint64_t(1) << (i % 64); } }
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(boxes.size()));
+}
+BENCHMARK(BM_AABBOverlapsScalar)->Arg(1 << 16);
+
+void BM_AABBOverlapsBatch(benchmark::State& state) {
+  aabb3arrayf boxes(RandomBoxes(size_t(state.range(0)), 1));
+  AABB3Df query(-20.f, -20.f, -20.f, 20.f, 20.f, 20.f);
+  std::vector<uint64_t> mask;
+  for (auto _ : state) {
+    BatchOverlaps(boxes, query, mask);
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(boxes.Length()));
+}
+BENCHMARK(BM_AABBOverlapsBatch)->Arg(1 << 16);
+
+// Pairwise merge, argument: number of boxes
+void BM_AABBMergeScalar(benchmark::State& state) {
+  std::vector<AABB3Df> a = RandomBoxes(size_t(state.range(0)), 1), b = RandomBoxes(size_t(state.range(0)), 2), result(a.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < a.size(); ++i) { result[i] = a[i].Merge(b[i]); }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK(BM_AABBMergeScalar)->Arg(1 << 16);
+
+void BM_AABBMergeBatch(benchmark::State& state) {
+  aabb3arrayf a(RandomBoxes(size_t(state.range(0)), 1)), b(RandomBoxes(size_t(state.range(0)), 2)), result;
+  for (auto _ : state) {
+    BatchMerge(a, b, result);
+    benchmark::DoNotOptimize(result.Write().min_[0]);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.Length()));
+}
+BENCHMARK(BM_AABBMergeBatch)->Arg(1 << 16);
+
+// Bounds of a point set, argument: number of points
+void BM_BoundingBoxPointsScalar(benchmark::State& state) {
+  std::vector<AABB3Df> boxes = RandomBoxes(size_t(state.range(0)), 1);
+  std::vector<p3f> points;
+  for (const AABB3Df& box : boxes) { points.push_back(box.min_); }
+  for (auto _ : state) { benchmark::DoNotOptimize(BoundingBox(points)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_BoundingBoxPointsScalar)->Arg(1 << 16);
+
+void BM_BoundingBoxPointsBatch(benchmark::State& state) {
+  std::vector<AABB3Df> boxes = RandomBoxes(size_t(state.range(0)), 1);
+  p3arrayf points;
+  for (const AABB3Df& box : boxes) { points.Add(box.min_); }
+  for (auto _ : state) { benchmark::DoNotOptimize(BoundingBox(points)); }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.Length()));
+}
+BENCHMARK(BM_BoundingBoxPointsBatch)->Arg(1 << 16);
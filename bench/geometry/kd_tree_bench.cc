@@ -0,0 +1,132 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\geometry\kd_tree.h"
+#include "..\..\lib\geometry\spatial_hash.h"
+
+using namespace j::math;
+
+namespace {
+
+// Points in a cube of size 200, either uniform or in 16 clusters with a standard deviation of 1. The clusters are the
+// same for every seed.
+std::vector<p3f> RandomPoints(size_t count, bool clustered, unsigned int seed) {
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> uniform(-100.f, 100.f);
+  std::normal_distribution<float> spread(0.f, 1.f);
+  std::vector<p3f> centers;
+  for (int i = 0; i < 16; ++i) { centers.push_back(p3f(uniform(generator), uniform(generator), uniform(generator))); }
+  generator.seed(seed);
+  std::vector<p3f> points;
+  for (size_t i = 0; i < count; ++i) {
+    if (clustered) {
+      const p3f& c = centers[i % centers.size()];
+      points.push_back(p3f(c.x_ + spread(generator), c.y_ + spread(generator), c.z_ + spread(generator)));
+    } else {
+      points.push_back(p3f(uniform(generator), uniform(generator), uniform(generator)));
+    }
+  }
+  return points;
+}
+
+const size_t kNeighbors = 8;
+const size_t kQueries = 1024;
+
+} // namespace
+
+//
+// 8 nearest neighbors of 1024 queries drawn from the same distribution as the points, arguments: number of points,
+// clustered (0 or 1)
+//
+void BM_KdTreeNearest(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), state.range(1) != 0, 1);
+  std::vector<p3f> queries = RandomPoints(kQueries, state.range(1) != 0, 2);
+  KdTree3D<float> tree(points);
+  std::vector<size_t> indices;
+  for (auto _ : state) {
+    for (const p3f& q : queries) {
+      tree.FindNearest(q, kNeighbors, indices);
+      benchmark::DoNotOptimize(indices.data());
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_KdTreeNearest)->ArgsProduct({ { 1 << 12, 1 << 16, 1 << 20 }, { 0, 1 } });
+
+// With the leaf scans forced to scalar code
+void BM_KdTreeNearestScalar(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), state.range(1) != 0, 1);
+  std::vector<p3f> queries = RandomPoints(kQueries, state.range(1) != 0, 2);
+  KdTree3D<float> tree(points);
+  std::vector<size_t> indices;
+  SimdLevel original = GetSimdLevel();
+  SetSimdLevel(SimdLevel::SCALAR);
+  for (auto _ : state) {
+    for (const p3f& q : queries) {
+      tree.FindNearest(q, kNeighbors, indices);
+      benchmark::DoNotOptimize(indices.data());
+    }
+  }
+  SetSimdLevel(original);
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_KdTreeNearestScalar)->ArgsProduct({ { 1 << 20 }, { 0, 1 } });
+
+// Approximate search with epsilon = 0.5
+void BM_KdTreeNearestApproximate(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), state.range(1) != 0, 1);
+  std::vector<p3f> queries = RandomPoints(kQueries, state.range(1) != 0, 2);
+  KdTree3D<float> tree(points);
+  std::vector<size_t> indices;
+  for (auto _ : state) {
+    for (const p3f& q : queries) {
+      tree.FindNearest(q, kNeighbors, indices, 0.5f);
+      benchmark::DoNotOptimize(indices.data());
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_KdTreeNearestApproximate)->ArgsProduct({ { 1 << 20 }, { 0, 1 } });
+
+// Spatial hash with cells sized for kNeighbors points each if the points were uniform
+void BM_SpatialHashNearest(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), state.range(1) != 0, 1);
+  std::vector<p3f> queries = RandomPoints(kQueries, state.range(1) != 0, 2);
+  SpatialHash3D<float> hash(std::cbrt(200.f * 200.f * 200.f * float(kNeighbors) / float(points.size())), points);
+  std::vector<size_t> indices;
+  for (auto _ : state) {
+    for (const p3f& q : queries) {
+      hash.FindNearest(q, kNeighbors, indices);
+      benchmark::DoNotOptimize(indices.data());
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_SpatialHashNearest)->ArgsProduct({ { 1 << 12, 1 << 16, 1 << 20 }, { 0, 1 } });
+
+// Batch queries, arguments: thread count (0 for all hardware threads)
+void BM_KdTreeNearestBatch(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(1 << 20, true, 1);
+  std::vector<p3f> queries = RandomPoints(1 << 14, true, 2);
+  KdTree3D<float> tree(points);
+  std::vector<size_t> indices;
+  for (auto _ : state) {
+    tree.FindNearest(queries, kNeighbors, indices, size_t(state.range(0)));
+    benchmark::DoNotOptimize(indices.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_KdTreeNearestBatch)->Arg(1)->Arg(4)->Arg(0)->UseRealTime();
+
+// Build, arguments: thread count (0 for all hardware threads)
+void BM_KdTreeBuild(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(1 << 20, false, 1);
+  KdTree3D<float> tree;
+  for (auto _ : state) {
+    tree.Build(points, size_t(state.range(0)));
+    benchmark::DoNotOptimize(tree.Size());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_KdTreeBuild)->Arg(1)->Arg(4)->Arg(0)->UseRealTime();
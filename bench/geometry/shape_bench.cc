@@ -0,0 +1,173 @@
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\geometry\bounding_volume_hierarchy.h"
+#include "..\..\lib\geometry\line.h"
+#include "..\..\lib\geometry\plane.h"
+#include "..\..\lib\geometry\ray.h"
+#include "..\..\lib\geometry\shape_classification.h"
+#include "..\..\lib\geometry\sphere.h"
+
+using namespace j::math;
+
+namespace {
+
+template<typename valuetype>
+std::vector<Point3D<valuetype>> RandomPoints(size_t count, unsigned int seed, valuetype extent = valuetype(100)) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<valuetype> distribution(-extent, extent);
+  std::vector<Point3D<valuetype>> points;
+  for (size_t i = 0; i < count; ++i) { points.push_back(Point3D<valuetype>(distribution(generator), distribution(generator), distribution(generator))); }
+  return points;
+}
+
+std::vector<Sphere<float>> RandomSpheres(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> radius(0.1f, 1.f);
+  std::vector<Sphere<float>> spheres;
+  for (const Point3D<float>& c : RandomPoints<float>(count, seed)) { spheres.push_back(Sphere<float>(c, radius(generator))); }
+  return spheres;
+}
+
+} // namespace
+
+//
+// Distance queries of single shapes
+//
+template<typename valuetype>
+void BM_SphereSignedDistance(benchmark::State& state) {
+  std::vector<Point3D<valuetype>> points = RandomPoints<valuetype>(size_t(state.range(0)), 1);
+  Sphere<valuetype> sphere(Point3D<valuetype>(1, 2, 3), valuetype(10));
+  for (auto _ : state) {
+    valuetype sum = 0;
+    for (const Point3D<valuetype>& p : points) { sum += sphere.SignedDistanceToSurface(p); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK_TEMPLATE(BM_SphereSignedDistance, float)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_SphereSignedDistance, double)->Range(1 << 10, 1 << 16);
+
+template<typename valuetype>
+void BM_PlaneSignedDistance(benchmark::State& state) {
+  std::vector<Point3D<valuetype>> points = RandomPoints<valuetype>(size_t(state.range(0)), 1);
+  Plane<valuetype> plane(Point3D<valuetype>(1, 2, 3), Vector3D<valuetype>(1, 1, 1));
+  for (auto _ : state) {
+    valuetype sum = 0;
+    for (const Point3D<valuetype>& p : points) { sum += plane.SignedDistanceToSurface(p); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK_TEMPLATE(BM_PlaneSignedDistance, float)->Range(1 << 10, 1 << 16);
+
+template<typename valuetype>
+void BM_Line3DFindNearestPoint(benchmark::State& state) {
+  std::vector<Point3D<valuetype>> points = RandomPoints<valuetype>(size_t(state.range(0)), 1);
+  std::vector<Point3D<valuetype>> result(points.size());
+  Line3D<valuetype> line(Point3D<valuetype>(1, 2, 3), Vector3D<valuetype>(1, -1, 2));
+  for (auto _ : state) {
+    for (size_t i = 0; i < points.size(); ++i) { result[i] = line.FindNearestPoint(points[i]); }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK_TEMPLATE(BM_Line3DFindNearestPoint, float)->Range(1 << 10, 1 << 16);
+
+//
+// Point classification: scalar loop versus batch classification (shape_classification.h), argument: SIMD level
+//
+void BM_SphereIsInsideScalar(benchmark::State& state) {
+  std::vector<Point3D<float>> points = RandomPoints<float>(1 << 16, 1);
+  std::vector<uint64_t> mask(MaskWords(points.size()));
+  Sphere<float> sphere(Point3D<float>(1.f, 2.f, 3.f), 50.f);
+  for (auto _ : state) {
+    std::fill(mask.begin(), mask.end(), uint64_t(0));
+    for (size_t i = 0; i < points.size(); ++i) { if (sphere.IsInside(points[i])) { mask[i / 64] |= uint64_t(1) << (i % 64); } }
+    benchmark::DoNotOptimize(mask.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_SphereIsInsideScalar);
+
+void BM_SphereIsInsideBatch(benchmark::State& state) {
+  SimdLevel level = SimdLevel(state.range(0));
+  if (GetSupportedSimdLevel() < level) { state.SkipWithError("Instruction set not supported by this CPU."); return; }
+  SetSimdLevel(level);
+  std::vector<Point3D<float>> points = RandomPoints<float>(1 << 16, 1);
+  std::vector<uint64_t> mask(MaskWords(points.size()));
+  Sphere<float> sphere(Point3D<float>(1.f, 2.f, 3.f), 50.f);
+  for (auto _ : state) {
+    BatchIsInside(sphere, points.data(), points.size(), mask.data());
+    benchmark::DoNotOptimize(mask.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_SphereIsInsideBatch)->Arg(int(SimdLevel::SCALAR))->Arg(int(SimdLevel::SSE))->Arg(int(SimdLevel::AVX2));
+
+//
+// Bounding volume hierarchy versus a linear scan over the spheres, argument: number of spheres
+//
+void BM_SpheresNearestPointLinear(benchmark::State& state) {
+  std::vector<Sphere<float>> spheres = RandomSpheres(size_t(state.range(0)), 1);
+  std::vector<Point3D<float>> queries = RandomPoints<float>(256, 2);
+  for (auto _ : state) {
+    for (const Point3D<float>& q : queries) {
+      float best = std::numeric_limits<float>::max();
+      for (const Sphere<float>& s : spheres) { float d = s.DistanceToSurface(q); if (d < best) { best = d; } }
+      benchmark::DoNotOptimize(best);
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_SpheresNearestPointLinear)->Range(1 << 6, 1 << 14);
+
+void BM_SpheresNearestPointBvh(benchmark::State& state) {
+  BoundingVolumeHierarchy<Sphere<float>> bvh(RandomSpheres(size_t(state.range(0)), 1));
+  std::vector<Point3D<float>> queries = RandomPoints<float>(256, 2);
+  for (auto _ : state) {
+    for (const Point3D<float>& q : queries) {
+      Point3D<float> nearest;
+      bvh.FindNearestPoint(q, &nearest);
+      benchmark::DoNotOptimize(nearest);
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_SpheresNearestPointBvh)->Range(1 << 6, 1 << 14);
+
+void BM_SpheresRayLinear(benchmark::State& state) {
+  std::vector<Sphere<float>> spheres = RandomSpheres(size_t(state.range(0)), 1);
+  std::vector<Point3D<float>> targets = RandomPoints<float>(256, 2);
+  Point3D<float> origin(0.f, 0.f, -200.f);
+  for (auto _ : state) {
+    for (const Point3D<float>& target : targets) {
+      Ray3D<float> ray(origin, origin - target);
+      float t_max = std::numeric_limits<float>::max(), t;
+      for (const Sphere<float>& s : spheres) { if (ray.Intersect(s, &t, t_max)) { t_max = t; } }
+      benchmark::DoNotOptimize(t_max);
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(targets.size()));
+}
+BENCHMARK(BM_SpheresRayLinear)->Range(1 << 6, 1 << 14);
+
+void BM_SpheresRayBvh(benchmark::State& state) {
+  BoundingVolumeHierarchy<Sphere<float>> bvh(RandomSpheres(size_t(state.range(0)), 1));
+  std::vector<Point3D<float>> targets = RandomPoints<float>(256, 2);
+  Point3D<float> origin(0.f, 0.f, -200.f);
+  for (auto _ : state) {
+    for (const Point3D<float>& target : targets) {
+      float t = 0.f;
+      bvh.IntersectRay(origin, origin - target, &t);
+      benchmark::DoNotOptimize(t);
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(targets.size()));
+}
+BENCHMARK(BM_SpheresRayBvh)->Range(1 << 6, 1 << 14);
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\geometry\signed_distance_field.h"
+
+using namespace j::math;
+
+namespace {
+
+// The same scene as a tree of virtual nodes, as it would be built at run time
+struct Node {
+  virtual ~Node() = default;
+  virtual float Distance(const p3f& p) const = 0;
+};
+template<typename shape>
+struct ShapeNode : Node {
+  explicit ShapeNode(const shape& s) : field_{ s } { }
+  float Distance(const p3f& p) const override { return field_(p); }
+  SdfShape<shape> field_;
+};
+struct UnionNode : Node {
+  UnionNode(std::unique_ptr<Node> a, std::unique_ptr<Node> b) : a_{ std::move(a) }, b_{ std::move(b) } { }
+  float Distance(const p3f& p) const override { return std::min(a_->Distance(p), b_->Distance(p)); }
+  std::unique_ptr<Node> a_, b_;
+};
+struct DifferenceNode : Node {
+  DifferenceNode(std::unique_ptr<Node> a, std::unique_ptr<Node> b) : a_{ std::move(a) }, b_{ std::move(b) } { }
+  float Distance(const p3f& p) const override { return std::max(a_->Distance(p), -b_->Distance(p)); }
+  std::unique_ptr<Node> a_, b_;
+};
+
+const Spheref kSphere(0.f, 0.f, 0.f, 1.f);
+const AABB3Df kHole(-0.4f, -0.4f, -2.f, 0.4f, 0.4f, 2.f);
+const Spheref kMoon(1.2f, 0.f, 0.5f, 0.4f);
+const Planef kGround(p3f(0.f, 0.f, -1.f), vec3f(0.f, 0.f, 1.f));
+
+auto Scene() { return (Sdf(kSphere) - Sdf(kHole)) | Sdf(kMoon) | Sdf(kGround); }
+
+std::unique_ptr<Node> VirtualScene() {
+  std::unique_ptr<Node> carved(new DifferenceNode(std::unique_ptr<Node>(new ShapeNode<Spheref>(kSphere)), std::unique_ptr<Node>(new ShapeNode<AABB3Df>(kHole))));
+  std::unique_ptr<Node> with_moon(new UnionNode(std::move(carved), std::unique_ptr<Node>(new ShapeNode<Spheref>(kMoon))));
+  return std::unique_ptr<Node>(new UnionNode(std::move(with_moon), std::unique_ptr<Node>(new ShapeNode<Planef>(kGround))));
+}
+
+} // namespace
+
+//
+// Evaluation over a cubic grid, argument: grid points per side
+//
+void BM_SdfGridVirtual(benchmark::State& state) {
+  size_t n = size_t(state.range(0));
+  std::unique_ptr<Node> scene = VirtualScene();
+  std::vector<float> values(n * n * n);
+  float spacing = 4.f / float(n);
+  for (auto _ : state) {
+    for (size_t z = 0; z < n; ++z) {
+      for (size_t y = 0; y < n; ++y) {
+        for (size_t x = 0; x < n; ++x) { values[(z * n + y) * n + x] = scene->Distance(p3f(-2.f + float(x) * spacing, -2.f + float(y) * spacing, -2.f + float(z) * spacing)); }
+      }
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(values.size()));
+}
+BENCHMARK(BM_SdfGridVirtual)->Arg(64);
+
+// Argument 2: number of threads
+void BM_SdfGridExpression(benchmark::State& state) {
+  size_t n = size_t(state.range(0));
+  std::vector<float> values;
+  float spacing = 4.f / float(n);
+  for (auto _ : state) {
+    EvaluateGrid(Scene(), p3f(-2.f, -2.f, -2.f), vec3f(spacing, spacing, spacing), n, n, n, values, size_t(state.range(1)));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(values.size()));
+}
+BENCHMARK(BM_SdfGridExpression)->Args({ 64, 1 })->Args({ 64, 4 });
+
+//
+// Sphere tracing of a pinhole camera image, argument: image side in pixels
+//
+void BM_SdfSphereTrace(benchmark::State& state) {
+  size_t n = size_t(state.range(0));
+  std::vector<Ray3f> rays;
+  for (size_t y = 0; y < n; ++y) {
+    for (size_t x = 0; x < n; ++x) { rays.push_back(Ray3f(p3f(0.f, -5.f, 0.f), vec3f(float(x) / float(n) - 0.5f, 1.f, float(y) / float(n) - 0.5f))); }
+  }
+  std::vector<float> t;
+  std::vector<uint64_t> hits;
+  for (auto _ : state) {
+    SphereTrace(Scene(), rays, t, hits, 20.f, 1e-3f, 128, size_t(state.range(1)));
+    benchmark::DoNotOptimize(hits.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(rays.size()));
+}
+BENCHMARK(BM_SdfSphereTrace)->Args({ 128, 1 })->Args({ 128, 4 });
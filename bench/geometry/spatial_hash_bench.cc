@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\geometry\spatial_hash.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<p3f> RandomPoints(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+  std::vector<p3f> points;
+  for (size_t i = 0; i < count; ++i) { points.push_back(p3f(distribution(generator), distribution(generator), distribution(generator))); }
+  return points;
+}
+
+const float kRadius = 4.f;
+const size_t kNeighbors = 8;
+
+} // namespace
+
+//
+// Spatial hash versus a linear scan with Point3D::Distance, argument: number of points in a cube of size 200
+//
+void BM_PointsRadiusLinear(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), 1);
+  std::vector<p3f> queries = RandomPoints(256, 2);
+  std::vector<size_t> indices;
+  for (auto _ : state) {
+    for (const p3f& q : queries) {
+      indices.clear();
+      for (size_t i = 0; i < points.size(); ++i) { if (points[i].Distance(q) <= kRadius) { indices.push_back(i); } }
+      benchmark::DoNotOptimize(indices.data());
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_PointsRadiusLinear)->Range(1 << 10, 1 << 20);
+
+void BM_PointsRadiusSpatialHash(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), 1);
+  SpatialHash3D<float> hash(kRadius, points);
+  std::vector<p3f> queries = RandomPoints(256, 2);
+  std::vector<size_t> indices;
+  for (auto _ : state) {
+    for (const p3f& q : queries) {
+      hash.FindInRadius(q, kRadius, indices);
+      benchmark::DoNotOptimize(indices.data());
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_PointsRadiusSpatialHash)->Range(1 << 10, 1 << 20);
+
+void BM_PointsNearestLinear(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), 1);
+  std::vector<p3f> queries = RandomPoints(256, 2);
+  std::vector<std::pair<float, size_t>> candidates(points.size());
+  for (auto _ : state) {
+    for (const p3f& q : queries) {
+      for (size_t i = 0; i < points.size(); ++i) { candidates[i] = std::make_pair(points[i].Distance(q), i); }
+      std::partial_sort(candidates.begin(), candidates.begin() + kNeighbors, candidates.end());
+      benchmark::DoNotOptimize(candidates.data());
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_PointsNearestLinear)->Range(1 << 10, 1 << 20);
+
+void BM_PointsNearestSpatialHash(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), 1);
+  // Cells holding about kNeighbors points each
+  SpatialHash3D<float> hash(std::cbrt(200.f * 200.f * 200.f * float(kNeighbors) / float(points.size())), points);
+  std::vector<p3f> queries = RandomPoints(256, 2);
+  std::vector<size_t> indices;
+  for (auto _ : state) {
+    for (const p3f& q : queries) {
+      hash.FindNearest(q, kNeighbors, indices);
+      benchmark::DoNotOptimize(indices.data());
+    }
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(queries.size()));
+}
+BENCHMARK(BM_PointsNearestSpatialHash)->Range(1 << 10, 1 << 20);
+
+// Bulk build, arguments: number of points, thread count (0 for all hardware threads)
+void BM_SpatialHashBuild(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), 1);
+  SpatialHash3D<float> hash(kRadius);
+  for (auto _ : state) {
+    hash.Build(points, size_t(state.range(1)));
+    benchmark::DoNotOptimize(hash.Size());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_SpatialHashBuild)->ArgsProduct({ { 1 << 20 }, { 1, 2, 4, 0 } })->UseRealTime();
+
+// Inserting the points one by one
+void BM_SpatialHashInsert(benchmark::State& state) {
+  std::vector<p3f> points = RandomPoints(size_t(state.range(0)), 1);
+  for (auto _ : state) {
+    SpatialHash3D<float> hash(kRadius);
+    for (const p3f& p : points) { hash.Insert(p); }
+    benchmark::DoNotOptimize(hash.Size());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_SpatialHashInsert)->Arg(1 << 20);
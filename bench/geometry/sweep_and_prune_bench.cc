@@ -0,0 +1,66 @@
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\geometry\sweep_and_prune.h"
+
+using namespace j::math;
+
+namespace {
+
+// Spheres spread over a cube that holds about 4 neighbours per sphere, with a small random velocity each
+void RandomSpheres(size_t count, std::vector<Spheref>& spheres, std::vector<vec3f>& velocities) {
+  std::mt19937 generator(1);
+  float extent = std::cbrt(float(count) * 64.f);
+  std::uniform_real_distribution<float> position(0.f, extent), velocity(-0.1f, 0.1f);
+  spheres.clear();
+  velocities.clear();
+  for (size_t i = 0; i < count; ++i) {
+    spheres.push_back(Spheref(position(generator), position(generator), position(generator), 1.f));
+    velocities.push_back(vec3f(velocity(generator), velocity(generator), velocity(generator)));
+  }
+}
+
+void Move(std::vector<Spheref>& spheres, const std::vector<vec3f>& velocities) {
+  for (size_t i = 0; i < spheres.size(); ++i) { spheres[i] += velocities[i]; }
+}
+
+} // namespace
+
+//
+// Collisions of moving spheres per frame, argument: number of spheres
+//
+void BM_CollisionsBruteForce(benchmark::State& state) {
+  std::vector<Spheref> spheres;
+  std::vector<vec3f> velocities;
+  RandomSpheres(size_t(state.range(0)), spheres, velocities);
+  std::vector<std::pair<size_t, size_t>> collisions;
+  for (auto _ : state) {
+    Move(spheres, velocities);
+    collisions.clear();
+    for (size_t i = 0; i < spheres.size(); ++i) {
+      for (size_t j = i + 1; j < spheres.size(); ++j) { if (Overlap(spheres[i], spheres[j])) { collisions.push_back(std::make_pair(i, j)); } }
+    }
+    benchmark::DoNotOptimize(collisions.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(spheres.size()));
+}
+BENCHMARK(BM_CollisionsBruteForce)->Arg(1 << 10)->Arg(1 << 13);
+
+// Argument 2: number of threads for the narrow phase
+void BM_CollisionsSweepAndPrune(benchmark::State& state) {
+  std::vector<Spheref> spheres;
+  std::vector<vec3f> velocities;
+  RandomSpheres(size_t(state.range(0)), spheres, velocities);
+  SweepAndPrune3D<float> broad_phase;
+  std::vector<std::pair<size_t, size_t>> collisions;
+  FindCollisions(spheres, broad_phase, collisions);
+  for (auto _ : state) {
+    Move(spheres, velocities);
+    FindCollisions(spheres, broad_phase, collisions, size_t(state.range(1)));
+    benchmark::DoNotOptimize(collisions.data());
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(spheres.size()));
+}
+BENCHMARK(BM_CollisionsSweepAndPrune)->Args({ 1 << 10, 1 })->Args({ 1 << 13, 1 })->Args({ 1 << 16, 1 })->Args({ 1 << 16, 4 });
@@ -0,0 +1,130 @@
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\geometry\quaternion_batch.h"
+#include "..\..\lib\geometry\transform_batch.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<Point3D<float>> RandomPoints(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+  std::vector<Point3D<float>> points;
+  for (size_t i = 0; i < count; ++i) { points.push_back(Point3D<float>(distribution(generator), distribution(generator), distribution(generator))); }
+  return points;
+}
+
+AffineTransform3f ExampleTransform() { return AffineTransform3f::Translation(vec3f(1.f, -2.f, 3.f)) * AffineTransform3f::Rotation(vec3f(1.f, 2.f, 3.f), 0.7f); }
+
+// Arguments: SIMD level, thread count (0 uses all hardware threads)
+void TransformArguments(benchmark::internal::Benchmark* b) {
+  for (int level : { int(SimdLevel::SCALAR), int(SimdLevel::SSE), int(SimdLevel::AVX2) }) { b->Args({ level, 1 }); }
+  b->Args({ int(SimdLevel::AVX2), 0 });
+  b->UseRealTime();
+}
+
+bool SelectSimdLevel(benchmark::State& state) {
+  SimdLevel level = SimdLevel(state.range(0));
+  if (GetSupportedSimdLevel() < level) { state.SkipWithError("Instruction set not supported by this CPU."); return false; }
+  SetSimdLevel(level);
+  return true;
+}
+
+const size_t kPointCount = 1 << 18;
+
+} // namespace
+
+//
+// Affine transforms: Matrix4x4, AffineTransform3D and batch transformation
+//
+void BM_Matrix4x4TransformPoint(benchmark::State& state) {
+  std::vector<Point3D<float>> points = RandomPoints(kPointCount, 1), result(kPointCount);
+  mat4f m = ExampleTransform().ToMatrix4x4();
+  for (auto _ : state) {
+    for (size_t i = 0; i < points.size(); ++i) { result[i] = m.TransformPoint(points[i]); }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_Matrix4x4TransformPoint);
+
+void BM_AffineTransformPoint(benchmark::State& state) {
+  std::vector<Point3D<float>> points = RandomPoints(kPointCount, 1), result(kPointCount);
+  AffineTransform3f t = ExampleTransform();
+  for (auto _ : state) {
+    for (size_t i = 0; i < points.size(); ++i) { result[i] = t.TransformPoint(points[i]); }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_AffineTransformPoint);
+
+void BM_BatchTransformPoints(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  std::vector<Point3D<float>> points = RandomPoints(kPointCount, 1), result(kPointCount);
+  AffineTransform3f t = ExampleTransform();
+  for (auto _ : state) {
+    BatchTransformPoints(points.data(), t, result.data(), points.size(), size_t(state.range(1)));
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_BatchTransformPoints)->Apply(TransformArguments);
+
+void BM_BatchTransformPointArray(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  Point3DArray<float> points(RandomPoints(kPointCount, 1)), result;
+  AffineTransform3f t = ExampleTransform();
+  for (auto _ : state) {
+    BatchTransformPoints(points, t, result, size_t(state.range(1)));
+    benchmark::DoNotOptimize(result.X());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.Length()));
+}
+BENCHMARK(BM_BatchTransformPointArray)->Apply(TransformArguments);
+
+//
+// Quaternions: rotation and per-tick composition of many orientations
+//
+void BM_QuaternionRotate(benchmark::State& state) {
+  std::vector<Point3D<float>> points = RandomPoints(kPointCount, 1), result(kPointCount);
+  quatf q = quatf::FromAxisAngle(vec3f(1.f, 2.f, 3.f), 0.7f);
+  for (auto _ : state) {
+    for (size_t i = 0; i < points.size(); ++i) { result[i] = q.Rotate(points[i]); }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_QuaternionRotate);
+
+void BM_BatchRotate(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  std::vector<Point3D<float>> points = RandomPoints(kPointCount, 1), result(kPointCount);
+  quatf q = quatf::FromAxisAngle(vec3f(1.f, 2.f, 3.f), 0.7f);
+  for (auto _ : state) {
+    BatchRotate(points.data(), q, result.data(), points.size(), size_t(state.range(1)));
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK(BM_BatchRotate)->Apply(TransformArguments);
+
+void BM_BatchCompose(benchmark::State& state) {
+  std::vector<quatf> orientations(size_t(state.range(0)));
+  quatf delta = quatf::FromAxisAngle(vec3f(0.f, 1.f, 0.f), 0.01f);
+  for (auto _ : state) {
+    BatchCompose(delta, orientations.data(), orientations.data(), orientations.size(), size_t(state.range(1)));
+    benchmark::DoNotOptimize(orientations.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(orientations.size()));
+}
+BENCHMARK(BM_BatchCompose)->Args({ 1 << 15, 1 })->Args({ 1 << 15, 0 })->UseRealTime();
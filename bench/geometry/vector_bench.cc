@@ -0,0 +1,181 @@
+#include <random>
+#include <vector>
+#include <benchmark\benchmark.h>
+#include "..\..\lib\geometry\point.h"
+#include "..\..\lib\geometry\vector.h"
+#include "..\..\lib\geometry\vector_batch.h"
+#include "..\..\lib\geometry\vector_n.h"
+
+using namespace j::math;
+
+namespace {
+
+template<typename valuetype>
+std::vector<Vector3D<valuetype>> RandomVectors(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<valuetype> distribution(valuetype(-100), valuetype(100));
+  std::vector<Vector3D<valuetype>> vectors;
+  for (size_t i = 0; i < count; ++i) { vectors.push_back(Vector3D<valuetype>(distribution(generator), distribution(generator), distribution(generator))); }
+  return vectors;
+}
+
+template<typename valuetype>
+std::vector<Point3D<valuetype>> RandomPoints(size_t count, unsigned int seed) {
+  std::vector<Point3D<valuetype>> points;
+  for (const Vector3D<valuetype>& v : RandomVectors<valuetype>(count, seed)) { points.push_back(Point3D<valuetype>(v.x_, v.y_, v.z_)); }
+  return points;
+}
+
+// Selects the instruction set given as the first benchmark argument, skipping the benchmark when it is unsupported.
+bool SelectSimdLevel(benchmark::State& state) {
+  SimdLevel level = SimdLevel(state.range(0));
+  if (GetSupportedSimdLevel() < level) { state.SkipWithError("Instruction set not supported by this CPU."); return false; }
+  SetSimdLevel(level);
+  return true;
+}
+
+void SimdLevelArguments(benchmark::internal::Benchmark* b) {
+  for (int level : { int(SimdLevel::SCALAR), int(SimdLevel::SSE), int(SimdLevel::AVX2) }) { b->Args({ level, 1 << 16 }); }
+}
+
+} // namespace
+
+//
+// Vector3D and Point3D operators
+//
+template<typename valuetype>
+void BM_Vector3DAddScale(benchmark::State& state) {
+  std::vector<Vector3D<valuetype>> a = RandomVectors<valuetype>(size_t(state.range(0)), 1), b = RandomVectors<valuetype>(size_t(state.range(0)), 2);
+  std::vector<Vector3D<valuetype>> result(a.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < a.size(); ++i) { result[i] = a[i] + b[i] * valuetype(2); }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK_TEMPLATE(BM_Vector3DAddScale, float)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Vector3DAddScale, double)->Range(1 << 10, 1 << 16);
+
+template<typename valuetype>
+void BM_Vector3DScalarProduct(benchmark::State& state) {
+  std::vector<Vector3D<valuetype>> a = RandomVectors<valuetype>(size_t(state.range(0)), 1), b = RandomVectors<valuetype>(size_t(state.range(0)), 2);
+  for (auto _ : state) {
+    valuetype sum = 0;
+    for (size_t i = 0; i < a.size(); ++i) { sum += a[i].ScalarProduct(b[i]); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK_TEMPLATE(BM_Vector3DScalarProduct, float)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Vector3DScalarProduct, double)->Range(1 << 10, 1 << 16);
+
+template<typename valuetype>
+void BM_Vector3DCrossProduct(benchmark::State& state) {
+  std::vector<Vector3D<valuetype>> a = RandomVectors<valuetype>(size_t(state.range(0)), 1), b = RandomVectors<valuetype>(size_t(state.range(0)), 2);
+  std::vector<Vector3D<valuetype>> result(a.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < a.size(); ++i) { result[i] = a[i].CrossProduct(b[i]); }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK_TEMPLATE(BM_Vector3DCrossProduct, float)->Range(1 << 10, 1 << 16);
+
+template<typename valuetype>
+void BM_Vector3DNormalize(benchmark::State& state) {
+  std::vector<Vector3D<valuetype>> a = RandomVectors<valuetype>(size_t(state.range(0)), 1);
+  std::vector<Vector3D<valuetype>> result(a.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < a.size(); ++i) { result[i] = a[i].Normalize(); }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK_TEMPLATE(BM_Vector3DNormalize, float)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Vector3DNormalize, double)->Range(1 << 10, 1 << 16);
+
+template<typename valuetype>
+void BM_Point3DDistance(benchmark::State& state) {
+  std::vector<Point3D<valuetype>> points = RandomPoints<valuetype>(size_t(state.range(0)), 1);
+  Point3D<valuetype> p(1, 2, 3);
+  for (auto _ : state) {
+    float sum = 0;
+    for (const Point3D<valuetype>& q : points) { sum += q.Distance(p); }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+BENCHMARK_TEMPLATE(BM_Point3DDistance, float)->Range(1 << 10, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Point3DDistance, double)->Range(1 << 10, 1 << 16);
+
+//
+// Batch functions (vector_batch.h), arguments: SIMD level, count
+//
+template<typename valuetype>
+void BM_BatchNormalize(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  std::vector<Vector3D<valuetype>> a = RandomVectors<valuetype>(size_t(state.range(1)), 1);
+  std::vector<Vector3D<valuetype>> result(a.size());
+  for (auto _ : state) {
+    BatchNormalize(a.data(), result.data(), a.size());
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK_TEMPLATE(BM_BatchNormalize, float)->Apply(SimdLevelArguments);
+BENCHMARK_TEMPLATE(BM_BatchNormalize, double)->Apply(SimdLevelArguments);
+
+template<typename valuetype>
+void BM_BatchScalarProduct(benchmark::State& state) {
+  if (!SelectSimdLevel(state)) { return; }
+  std::vector<Vector3D<valuetype>> a = RandomVectors<valuetype>(size_t(state.range(1)), 1), b = RandomVectors<valuetype>(size_t(state.range(1)), 2);
+  std::vector<valuetype> result(a.size());
+  for (auto _ : state) {
+    BatchScalarProduct(a.data(), b.data(), result.data(), a.size());
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK_TEMPLATE(BM_BatchScalarProduct, float)->Apply(SimdLevelArguments);
+
+//
+// VectorN expression templates versus evaluating every intermediate result
+//
+template<size_t dimensions>
+void BM_VectorNExpression(benchmark::State& state) {
+  std::vector<VectorN<float, dimensions>> a(1024), b(1024), c(1024), result(1024);
+  for (size_t i = 0; i < a.size(); ++i) { for (size_t d = 0; d < dimensions; ++d) { a[i][d] = float(i + d); b[i][d] = float(i * d); c[i][d] = float(d); } }
+  for (auto _ : state) {
+    for (size_t i = 0; i < a.size(); ++i) { result[i] = a[i] + b[i] * 2.f - c[i]; }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK_TEMPLATE(BM_VectorNExpression, 4);
+BENCHMARK_TEMPLATE(BM_VectorNExpression, 16);
+
+template<size_t dimensions>
+void BM_VectorNTemporaries(benchmark::State& state) {
+  std::vector<VectorN<float, dimensions>> a(1024), b(1024), c(1024), result(1024);
+  for (size_t i = 0; i < a.size(); ++i) { for (size_t d = 0; d < dimensions; ++d) { a[i][d] = float(i + d); b[i][d] = float(i * d); c[i][d] = float(d); } }
+  for (auto _ : state) {
+    for (size_t i = 0; i < a.size(); ++i) {
+      VectorN<float, dimensions> scaled = b[i] * 2.f;
+      benchmark::DoNotOptimize(scaled);
+      VectorN<float, dimensions> sum = a[i] + scaled;
+      benchmark::DoNotOptimize(sum);
+      result[i] = sum - c[i];
+    }
+    benchmark::DoNotOptimize(result.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(a.size()));
+}
+BENCHMARK_TEMPLATE(BM_VectorNTemporaries, 4);
+BENCHMARK_TEMPLATE(BM_VectorNTemporaries, 16);
@@ -0,0 +1,21 @@
+#include <cstring>
+#include <string>
+#include <vector>
+#include "benchmark\benchmark.h"
+
+// Runs all benchmarks. Unless an output file is given with --benchmark_out, the results are also written as JSON to
+// j-math-bench.json in the working directory, so that runs of different releases can be compared (for example with
+// the compare.py tool that ships with Google Benchmark).
+int main(int argc, char** argv) {
+  std::vector<char*> arguments(argv, argv + argc);
+  bool has_output = false;
+  for (int i = 1; i < argc; ++i) { if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0) { has_output = true; } }
+  std::string output = "--benchmark_out=j-math-bench.json";
+  std::string format = "--benchmark_out_format=json";
+  if (!has_output) { arguments.push_back(&output[0]); arguments.push_back(&format[0]); }
+  int count = int(arguments.size());
+  benchmark::Initialize(&count, arguments.data());
+  if (benchmark::ReportUnrecognizedArguments(count, arguments.data())) { return 1; }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,334 @@
+#pragma once
+#ifndef J_MATH_CONVOLUTION_H_
+#define J_MATH_CONVOLUTION_H_
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "..\utility\simd.h"
+#include "fft.h"
+#include "sequence.h"
+
+namespace j {
+namespace math {
+
+// Convolution of a sequence x with a kernel h of K taps: y[i] = sum_k h[k] * x[i + origin - k] for every sample i of x,
+// so the output has the length of the input. origin = 0 gives a causal FIR filter, origin = K / 2 centers the kernel.
+// Samples of x outside the sequence are taken per IndexType.
+
+// Method of convolution
+enum class ConvolutionMethod {
+  AUTOMATIC,  // DIRECT for kernels shorter than kFftConvolutionThreshold taps and for integral values, FFT otherwise
+  DIRECT,     // Sum over the taps per output sample, O(n * K), vectorized and exact per the summation order
+  FFT         // Overlap-save with real FFTs, O(n * log(K)), rounding errors relative to the largest values
+};
+
+// Kernel length from which AUTOMATIC uses the FFT, see the BM_Convolution benchmarks.
+const size_t kFftConvolutionThreshold = 640;
+
+namespace detail {
+
+//
+// Valid convolution: y[i] = sum_k h[k] * x[i + K - 1 - k] for i in [0, count), reading x[0, count + K - 1)
+//
+template<typename valuetype>
+void ConvolveValidGeneric(const valuetype* x, const valuetype* h, size_t taps, valuetype* y, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    const valuetype* p = x + i + taps - 1;
+    valuetype sum = valuetype(0);
+    for (size_t k = 0; k < taps; ++k) { sum += h[k] * p[-ptrdiff_t(k)]; }
+    y[i] = sum;
+  }
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+// The vector kernels compute several consecutive outputs per register and accumulate the taps in the same order as
+// the generic kernel, so all instruction sets give identical results.
+J_MATH_TARGET_SSE2 inline void ConvolveValidSse(const float* x, const float* h, size_t taps, float* y, size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const float* p = x + i + taps - 1;
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps(), acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    for (size_t k = 0; k < taps; ++k) {
+      __m128 w = _mm_set1_ps(h[k]);
+      const float* q = p - k;
+      acc0 = _mm_add_ps(acc0, _mm_mul_ps(w, _mm_loadu_ps(q)));
+      acc1 = _mm_add_ps(acc1, _mm_mul_ps(w, _mm_loadu_ps(q + 4)));
+      acc2 = _mm_add_ps(acc2, _mm_mul_ps(w, _mm_loadu_ps(q + 8)));
+      acc3 = _mm_add_ps(acc3, _mm_mul_ps(w, _mm_loadu_ps(q + 12)));
+    }
+    _mm_storeu_ps(y + i, acc0);
+    _mm_storeu_ps(y + i + 4, acc1);
+    _mm_storeu_ps(y + i + 8, acc2);
+    _mm_storeu_ps(y + i + 12, acc3);
+  }
+  for (; i + 4 <= count; i += 4) {
+    const float* p = x + i + taps - 1;
+    __m128 acc = _mm_setzero_ps();
+    for (size_t k = 0; k < taps; ++k) { acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(h[k]), _mm_loadu_ps(p - k))); }
+    _mm_storeu_ps(y + i, acc);
+  }
+  ConvolveValidGeneric(x, h, taps, y, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void ConvolveValidSse(const double* x, const double* h, size_t taps, double* y, size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const double* p = x + i + taps - 1;
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    for (size_t k = 0; k < taps; ++k) {
+      __m128d w = _mm_set1_pd(h[k]);
+      const double* q = p - k;
+      acc0 = _mm_add_pd(acc0, _mm_mul_pd(w, _mm_loadu_pd(q)));
+      acc1 = _mm_add_pd(acc1, _mm_mul_pd(w, _mm_loadu_pd(q + 2)));
+      acc2 = _mm_add_pd(acc2, _mm_mul_pd(w, _mm_loadu_pd(q + 4)));
+      acc3 = _mm_add_pd(acc3, _mm_mul_pd(w, _mm_loadu_pd(q + 6)));
+    }
+    _mm_storeu_pd(y + i, acc0);
+    _mm_storeu_pd(y + i + 2, acc1);
+    _mm_storeu_pd(y + i + 4, acc2);
+    _mm_storeu_pd(y + i + 6, acc3);
+  }
+  for (; i + 2 <= count; i += 2) {
+    const double* p = x + i + taps - 1;
+    __m128d acc = _mm_setzero_pd();
+    for (size_t k = 0; k < taps; ++k) { acc = _mm_add_pd(acc, _mm_mul_pd(_mm_set1_pd(h[k]), _mm_loadu_pd(p - k))); }
+    _mm_storeu_pd(y + i, acc);
+  }
+  ConvolveValidGeneric(x, h, taps, y, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void ConvolveValidAvx2(const float* x, const float* h, size_t taps, float* y, size_t count) {
+  size_t i = 0;
+  for (; i + 32 <= count; i += 32) {
+    const float* p = x + i + taps - 1;
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps(), acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    for (size_t k = 0; k < taps; ++k) {
+      __m256 w = _mm256_set1_ps(h[k]);
+      const float* q = p - k;
+      acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(w, _mm256_loadu_ps(q)));
+      acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(w, _mm256_loadu_ps(q + 8)));
+      acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(w, _mm256_loadu_ps(q + 16)));
+      acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(w, _mm256_loadu_ps(q + 24)));
+    }
+    _mm256_storeu_ps(y + i, acc0);
+    _mm256_storeu_ps(y + i + 8, acc1);
+    _mm256_storeu_ps(y + i + 16, acc2);
+    _mm256_storeu_ps(y + i + 24, acc3);
+  }
+  for (; i + 8 <= count; i += 8) {
+    const float* p = x + i + taps - 1;
+    __m256 acc = _mm256_setzero_ps();
+    for (size_t k = 0; k < taps; ++k) { acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(h[k]), _mm256_loadu_ps(p - k))); }
+    _mm256_storeu_ps(y + i, acc);
+  }
+  ConvolveValidGeneric(x, h, taps, y, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void ConvolveValidAvx2(const double* x, const double* h, size_t taps, double* y, size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const double* p = x + i + taps - 1;
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd(), acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    for (size_t k = 0; k < taps; ++k) {
+      __m256d w = _mm256_set1_pd(h[k]);
+      const double* q = p - k;
+      acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(w, _mm256_loadu_pd(q)));
+      acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(w, _mm256_loadu_pd(q + 4)));
+      acc2 = _mm256_add_pd(acc2, _mm256_mul_pd(w, _mm256_loadu_pd(q + 8)));
+      acc3 = _mm256_add_pd(acc3, _mm256_mul_pd(w, _mm256_loadu_pd(q + 12)));
+    }
+    _mm256_storeu_pd(y + i, acc0);
+    _mm256_storeu_pd(y + i + 4, acc1);
+    _mm256_storeu_pd(y + i + 8, acc2);
+    _mm256_storeu_pd(y + i + 12, acc3);
+  }
+  for (; i + 4 <= count; i += 4) {
+    const double* p = x + i + taps - 1;
+    __m256d acc = _mm256_setzero_pd();
+    for (size_t k = 0; k < taps; ++k) { acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_set1_pd(h[k]), _mm256_loadu_pd(p - k))); }
+    _mm256_storeu_pd(y + i, acc);
+  }
+  ConvolveValidGeneric(x, h, taps, y, i, count);
+}
+
+#endif // J_MATH_SIMD_X86
+
+template<typename valuetype>
+void ConvolveValidDispatch(const valuetype* x, const valuetype* h, size_t taps, valuetype* y, size_t count) { ConvolveValidGeneric(x, h, taps, y, 0, count); }
+
+#if defined(J_MATH_SIMD_X86)
+#define J_MATH_CONVOLUTION_DISPATCH(valuetype) \
+  inline void ConvolveValidDispatch(const valuetype* x, const valuetype* h, size_t taps, valuetype* y, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: ConvolveValidAvx2(x, h, taps, y, count); return; \
+    case SimdLevel::SSE: ConvolveValidSse(x, h, taps, y, count); return; \
+    default: ConvolveValidGeneric(x, h, taps, y, 0, count); return; \
+    } \
+  }
+J_MATH_CONVOLUTION_DISPATCH(float)
+J_MATH_CONVOLUTION_DISPATCH(double)
+#undef J_MATH_CONVOLUTION_DISPATCH
+#endif // J_MATH_SIMD_X86
+
+//
+// Overlap-save convolution with the spectrum of the kernel computed once
+//
+template<typename valuetype, bool = std::is_floating_point<valuetype>::value>
+class FftConvolutionKernel {
+public:
+  using complex_type = std::complex<valuetype>;
+
+  // Transforms of at least 4 * K samples, so most of every block produces output.
+  explicit FftConvolutionKernel(const valuetype* h, size_t taps) : taps_{ taps } {
+    size_t size = 64;
+    while (size < 4 * taps) { size *= 2; }
+    plan_ = GetRealFftPlan<valuetype>(size);
+    std::vector<valuetype> padded(size, valuetype(0));
+    for (size_t k = 0; k < taps; ++k) { padded[k] = h[k]; }
+    spectrum_.resize(plan_->SpectrumSize());
+    plan_->Forward(padded.data(), spectrum_.data());
+  }
+
+  // Valid convolution as described above, each block of Size() - K + 1 outputs computed with one forward and one
+  // inverse transform.
+  void ConvolveValid(const valuetype* x, valuetype* y, size_t count) const {
+    size_t size = plan_->Size(), block = size - taps_ + 1;
+    std::vector<valuetype> buffer(size);
+    std::vector<complex_type> bins(plan_->SpectrumSize());
+    for (size_t begin = 0; begin < count; begin += block) {
+      size_t outputs = (count - begin < block) ? count - begin : block;
+      size_t inputs = outputs + taps_ - 1;
+      for (size_t j = 0; j < inputs; ++j) { buffer[j] = x[begin + j]; }
+      for (size_t j = inputs; j < size; ++j) { buffer[j] = valuetype(0); }
+      plan_->Forward(buffer.data(), bins.data());
+      for (size_t j = 0; j < bins.size(); ++j) { bins[j] = MultiplyComplex(bins[j], spectrum_[j]); }
+      plan_->Inverse(bins.data(), buffer.data());
+      // The circular wrap-around only affects the first K - 1 values.
+      for (size_t j = 0; j < outputs; ++j) { y[begin + j] = buffer[taps_ - 1 + j]; }
+    }
+  }
+
+private:
+  size_t taps_;
+  std::shared_ptr<const RealFftPlan<valuetype>> plan_;
+  std::vector<complex_type> spectrum_;
+};
+
+// Integral values are always convolved directly.
+template<typename valuetype>
+class FftConvolutionKernel<valuetype, false> {
+public:
+  FftConvolutionKernel(const valuetype*, size_t) { }
+  void ConvolveValid(const valuetype*, valuetype*, size_t) const { }
+};
+
+template<typename valuetype>
+bool UseFftConvolution(size_t taps, ConvolutionMethod method) {
+  if (!std::is_floating_point<valuetype>::value) { return false; }
+  return method == ConvolutionMethod::FFT || (method == ConvolutionMethod::AUTOMATIC && taps >= kFftConvolutionThreshold);
+}
+
+// Convolution per UseFftConvolution, fft_kernel only used (and then required) for the FFT method.
+template<typename valuetype>
+void ConvolveValid(const valuetype* x, const valuetype* h, size_t taps, valuetype* y, size_t count, const FftConvolutionKernel<valuetype>* fft_kernel) {
+  if (count == 0) { return; }
+  if (fft_kernel) { fft_kernel->ConvolveValid(x, y, count); } else { ConvolveValidDispatch(x, h, taps, y, count); }
+}
+
+// Outputs [begin, end) near the ends of the sequence, from a copy of the samples they need with the index type applied.
+template<bool wrap, typename valuetype>
+void ConvolveBoundary(const valuetype* x, size_t length, const valuetype* h, size_t taps, size_t origin, valuetype* y, size_t begin, size_t end, const FftConvolutionKernel<valuetype>* fft_kernel) {
+  if (begin >= end) { return; }
+  std::vector<valuetype> extended(end - begin + taps - 1);
+  ptrdiff_t first = ptrdiff_t(begin) + ptrdiff_t(origin) - ptrdiff_t(taps - 1);
+  for (size_t j = 0; j < extended.size(); ++j) { extended[j] = x[ExtendedIndex<wrap>(first + ptrdiff_t(j), length)]; }
+  ConvolveValid(extended.data(), h, taps, y + begin, end - begin, fft_kernel);
+}
+
+// Splits the output into the interior, where every tap lies inside the sequence and the samples are read in place,
+// and the regions at both ends.
+template<bool wrap, typename valuetype>
+void Convolve(const valuetype* x, size_t length, const valuetype* h, size_t taps, size_t origin, valuetype* y, const FftConvolutionKernel<valuetype>* fft_kernel) {
+  size_t interior_begin = taps - 1 - origin;
+  size_t interior_end = (origin < length) ? length - origin : 0;
+  if (interior_begin >= interior_end) {
+    ConvolveBoundary<wrap>(x, length, h, taps, origin, y, 0, length, fft_kernel);
+    return;
+  }
+  ConvolveBoundary<wrap>(x, length, h, taps, origin, y, 0, interior_begin, fft_kernel);
+  ConvolveValid(x + (interior_begin + origin - (taps - 1)), h, taps, y + interior_begin, interior_end - interior_begin, fft_kernel);
+  ConvolveBoundary<wrap>(x, length, h, taps, origin, y, interior_end, length, fft_kernel);
+}
+
+} // namespace detail
+
+// Convolution of length values x with taps values h into y (see the top of this file). origin must be smaller than taps.
+template<typename valuetype>
+void Convolve(const valuetype* x, size_t length, const valuetype* h, size_t taps, valuetype* y, size_t origin = 0, IndexType index_type = IndexType::CLAMP, ConvolutionMethod method = ConvolutionMethod::AUTOMATIC) {
+  if (length == 0 || taps == 0) { for (size_t i = 0; i < length; ++i) { y[i] = valuetype(0); } return; }
+  if (origin >= taps) { origin = taps - 1; }
+  std::unique_ptr<detail::FftConvolutionKernel<valuetype>> fft_kernel;
+  if (detail::UseFftConvolution<valuetype>(taps, method)) { fft_kernel.reset(new detail::FftConvolutionKernel<valuetype>(h, taps)); }
+  if (index_type == IndexType::WRAP) { detail::Convolve<true>(x, length, h, taps, origin, y, fft_kernel.get()); }
+  else { detail::Convolve<false>(x, length, h, taps, origin, y, fft_kernel.get()); }
+}
+
+template<typename valuetype>
+Sequence1D<valuetype> Convolve(const Sequence1D<valuetype>& sequence, const Sequence1D<valuetype>& kernel, size_t origin = 0, IndexType index_type = IndexType::CLAMP, ConvolutionMethod method = ConvolutionMethod::AUTOMATIC) {
+  std::vector<valuetype> result(sequence.Length());
+  Convolve(sequence.Ptr(), sequence.Length(), kernel.Ptr(), kernel.Length(), result.data(), origin, index_type, method);
+  return Sequence1D<valuetype>(std::move(result));
+}
+
+// Causal FIR filter for a signal that arrives in chunks: y[i] = sum_k h[k] * x[i - k] over all samples processed since
+// construction or Reset, with zeros before the first sample. The last K - 1 input samples are kept between chunks,
+// so filtering a signal in chunks gives the same result as filtering it at once.
+template<typename valuetype>
+class FirFilter {
+public:
+  // Constructors
+  explicit FirFilter(const std::vector<valuetype>& kernel, ConvolutionMethod method = ConvolutionMethod::AUTOMATIC)
+      : kernel_{ kernel }, history_(kernel.empty() ? 0 : kernel.size() - 1, valuetype(0)) {
+    if (!kernel_.empty() && detail::UseFftConvolution<valuetype>(kernel_.size(), method)) { fft_kernel_ = std::make_shared<const detail::FftConvolutionKernel<valuetype>>(kernel_.data(), kernel_.size()); }
+  }
+  FirFilter(const FirFilter&) = default;
+  ~FirFilter() = default;
+
+  // Operators
+  FirFilter& operator=(const FirFilter&) = default;
+
+  // Filter-specific operations
+  // Filters count samples from in into out (which may be the same array).
+  void Process(const valuetype* in, valuetype* out, size_t count) {
+    if (kernel_.empty()) { for (size_t i = 0; i < count; ++i) { out[i] = valuetype(0); } return; }
+    size_t taps = kernel_.size();
+    buffer_.resize(taps - 1 + count);
+    for (size_t j = 0; j < taps - 1; ++j) { buffer_[j] = history_[j]; }
+    for (size_t i = 0; i < count; ++i) { buffer_[taps - 1 + i] = in[i]; }
+    detail::ConvolveValid(buffer_.data(), kernel_.data(), taps, out, count, fft_kernel_.get());
+    for (size_t j = 0; j < taps - 1; ++j) { history_[j] = buffer_[count + j]; }
+  }
+  Sequence1D<valuetype> Process(const Sequence1D<valuetype>& sequence) {
+    std::vector<valuetype> result(sequence.Length());
+    Process(sequence.Ptr(), result.data(), sequence.Length());
+    return Sequence1D<valuetype>(std::move(result));
+  }
+  // Forgets the previous samples.
+  void Reset() { for (valuetype& v : history_) { v = valuetype(0); } }
+  size_t Taps() const { return kernel_.size(); }
+
+private:
+  std::vector<valuetype> kernel_;
+  std::vector<valuetype> history_;  // Last K - 1 input samples, oldest first
+  std::vector<valuetype> buffer_;
+  std::shared_ptr<const detail::FftConvolutionKernel<valuetype>> fft_kernel_;
+};
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_CONVOLUTION_H_
@@ -0,0 +1,355 @@
+#pragma once
+#ifndef J_MATH_FFT_H_
+#define J_MATH_FFT_H_
+
+#include <cmath>
+#include <complex>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "..\utility\pi.h"
+#include "sequence.h"
+
+namespace j {
+namespace math {
+
+// Fast Fourier transforms of any size, using the convention X[k] = sum_j x[j] * exp(-2 * pi * i * j * k / n) for the
+// forward transform. The inverse transform is scaled by 1 / n, so it restores the input.
+//
+// The size is factored into radix-4 and radix-2 stages followed by the remaining prime factors (mixed radix). Stages
+// with a prime factor p other than 2 cost O(n * p), so sizes with only small factors are fastest. Sizes with a prime
+// factor above kBluesteinThreshold are instead computed as a convolution of power-of-two size at least 2 * n - 1
+// (Bluestein's algorithm), which keeps every size O(n log n), a constant factor slower than a nearby power of two.
+
+// Prime factors up to this size use a direct DFT stage, larger ones make the whole transform use Bluestein's algorithm.
+const size_t kBluesteinThreshold = 64;
+// Number of plans of each kind and valuetype kept by GetFftPlan and GetRealFftPlan.
+const size_t kFftPlanCacheSize = 32;
+
+namespace detail {
+
+// Complex product without the NaN and infinity handling of std::complex, which keeps the butterflies inlined.
+template<typename valuetype>
+std::complex<valuetype> MultiplyComplex(const std::complex<valuetype>& a, const std::complex<valuetype>& b) {
+  return std::complex<valuetype>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+// exp(sign * 2 * pi * i * k / n) for k in [0, count).
+template<typename valuetype>
+std::vector<std::complex<valuetype>> Twiddles(size_t n, size_t count, double sign) {
+  std::vector<std::complex<valuetype>> twiddles(count);
+  for (size_t k = 0; k < count; ++k) {
+    long double angle = sign * 2.L * PI * (long double)(k) / (long double)(n);
+    twiddles[k] = std::complex<valuetype>(valuetype(std::cos(angle)), valuetype(std::sin(angle)));
+  }
+  return twiddles;
+}
+
+// exp(sign * pi * i * k^2 / n) for k in [0, n), with k^2 reduced modulo 2 * n so the angle stays accurate for large k.
+template<typename valuetype>
+std::vector<std::complex<valuetype>> Chirp(size_t n, double sign) {
+  std::vector<std::complex<valuetype>> chirp(n);
+  for (size_t k = 0; k < n; ++k) {
+    size_t k2 = size_t((unsigned long long)(k) * k % (2ULL * n));
+    long double angle = sign * PI * (long double)(k2) / (long double)(n);
+    chirp[k] = std::complex<valuetype>(valuetype(std::cos(angle)), valuetype(std::sin(angle)));
+  }
+  return chirp;
+}
+
+} // namespace detail
+
+// Precomputed factorization and twiddle factors for complex transforms of a fixed size. A plan is immutable after
+// construction and can be shared between threads; see GetFftPlan for a cache of plans. Sizes with a prime factor above
+// kBluesteinThreshold hold a plan of the power-of-two convolution size and allocate two buffers of that size per call.
+template<typename valuetype>
+class FftPlan {
+public:
+  using complex_type = std::complex<valuetype>;
+
+  // Constructors
+  explicit FftPlan(size_t size) : size_{ size } {
+    size_t remaining = size_;
+    while (remaining > 1) {
+      size_t p = (remaining % 4 == 0) ? 4 : ((remaining % 2 == 0) ? 2 : SmallestOddFactor(remaining));
+      if (p > kBluesteinThreshold) { InitializeBluestein(); return; }
+      remaining /= p;
+      factors_.push_back(p);
+      factors_.push_back(remaining);
+    }
+    forward_ = detail::Twiddles<valuetype>(size_, size_, -1.);
+    inverse_ = detail::Twiddles<valuetype>(size_, size_, 1.);
+  }
+  FftPlan(const FftPlan&) = default;
+  ~FftPlan() = default;
+
+  // Operators
+  FftPlan& operator=(const FftPlan&) = default;
+
+  // Transform-specific operations
+  size_t Size() const { return size_; }
+  // Out-of-place transforms of Size() values, in and out must not overlap.
+  void Forward(const complex_type* in, complex_type* out) const { Transform(in, out, false); }
+  void Inverse(const complex_type* in, complex_type* out) const {
+    Transform(in, out, true);
+    valuetype scale = valuetype(1) / valuetype(size_);
+    for (size_t i = 0; i < size_; ++i) { out[i] *= scale; }
+  }
+  // In-place transforms. These copy the input to a temporary of Size() values on every call; use the out-of-place
+  // overloads with a reused output buffer to avoid the allocation.
+  void Forward(complex_type* data) const { std::vector<complex_type> in(data, data + size_); Forward(in.data(), data); }
+  void Inverse(complex_type* data) const { std::vector<complex_type> in(data, data + size_); Inverse(in.data(), data); }
+
+private:
+  static size_t SmallestOddFactor(size_t n) {
+    for (size_t p = 3; p * p <= n; p += 2) { if (n % p == 0) { return p; } }
+    return n;
+  }
+
+  void Transform(const complex_type* in, complex_type* out, bool inverse) const {
+    if (size_ == 1) { out[0] = in[0]; }
+    if (size_ <= 1) { return; }
+    if (convolution_plan_) { TransformBluestein(in, out, inverse); return; }
+    Stage(out, in, 1, &factors_[0], inverse ? inverse_.data() : forward_.data(), inverse);
+  }
+
+  // X[k] = w[k] * sum_j (x[j] * w[j]) * conj(w[k - j]) with the chirp w[k] = exp(-pi * i * k^2 / n): a cyclic
+  // convolution of power-of-two size, evaluated with the transforms of the convolution plan. The transform of the
+  // conjugated chirp is precomputed per direction (the inverse uses the conjugate chirp).
+  void InitializeBluestein() {
+    factors_.clear();
+    size_t m = 1;
+    while (m < 2 * size_ - 1) { m *= 2; }
+    convolution_plan_ = std::make_shared<const FftPlan<valuetype>>(m);
+    chirp_ = detail::Chirp<valuetype>(size_, -1.);
+    for (int direction = 0; direction < 2; ++direction) {
+      std::vector<complex_type> b(m);
+      for (size_t k = 0; k < size_; ++k) {
+        complex_type w = (direction == 0) ? std::conj(chirp_[k]) : chirp_[k];
+        b[k] = w;
+        if (k > 0) { b[m - k] = w; }
+      }
+      std::vector<complex_type>& transformed = (direction == 0) ? forward_ : inverse_;
+      transformed.resize(m);
+      convolution_plan_->Forward(b.data(), transformed.data());
+    }
+  }
+
+  void TransformBluestein(const complex_type* in, complex_type* out, bool inverse) const {
+    size_t m = convolution_plan_->Size();
+    const std::vector<complex_type>& transformed = inverse ? inverse_ : forward_;
+    std::vector<complex_type> a(m), spectrum(m);
+    for (size_t k = 0; k < size_; ++k) { a[k] = detail::MultiplyComplex(in[k], inverse ? std::conj(chirp_[k]) : chirp_[k]); }
+    convolution_plan_->Forward(a.data(), spectrum.data());
+    for (size_t k = 0; k < m; ++k) { spectrum[k] = detail::MultiplyComplex(spectrum[k], transformed[k]); }
+    convolution_plan_->Inverse(spectrum.data(), a.data());
+    for (size_t k = 0; k < size_; ++k) { out[k] = detail::MultiplyComplex(a[k], inverse ? std::conj(chirp_[k]) : chirp_[k]); }
+  }
+
+  // Decimation in time: the p sub-transforms of length m over every p-th input (stride fstride in the original input)
+  // are computed into consecutive blocks of out and then combined by the butterflies of this stage.
+  void Stage(complex_type* out, const complex_type* in, size_t fstride, const size_t* factors, const complex_type* twiddles, bool inverse) const {
+    size_t p = factors[0], m = factors[1];
+    if (m == 1) {
+      for (size_t i = 0; i < p; ++i) { out[i] = in[i * fstride]; }
+    } else {
+      for (size_t i = 0; i < p; ++i) { Stage(out + i * m, in + i * fstride, fstride * p, factors + 2, twiddles, inverse); }
+    }
+    switch (p) {
+    case 2: Butterfly2(out, fstride, m, twiddles); break;
+    case 4: Butterfly4(out, fstride, m, twiddles, inverse); break;
+    default: ButterflyGeneric(out, fstride, p, m, twiddles); break;
+    }
+  }
+
+  static void Butterfly2(complex_type* out, size_t fstride, size_t m, const complex_type* twiddles) {
+    for (size_t k = 0; k < m; ++k) {
+      complex_type t = detail::MultiplyComplex(out[k + m], twiddles[k * fstride]);
+      out[k + m] = out[k] - t;
+      out[k] += t;
+    }
+  }
+
+  static void Butterfly4(complex_type* out, size_t fstride, size_t m, const complex_type* twiddles, bool inverse) {
+    for (size_t k = 0; k < m; ++k) {
+      complex_type s0 = detail::MultiplyComplex(out[k + m], twiddles[k * fstride]);
+      complex_type s1 = detail::MultiplyComplex(out[k + 2 * m], twiddles[2 * k * fstride]);
+      complex_type s2 = detail::MultiplyComplex(out[k + 3 * m], twiddles[3 * k * fstride]);
+      complex_type s5 = out[k] - s1;
+      complex_type f0 = out[k] + s1;
+      complex_type s3 = s0 + s2, s4 = s0 - s2;
+      out[k + 2 * m] = f0 - s3;
+      out[k] = f0 + s3;
+      // Multiplication of s4 by -i (forward) or i (inverse)
+      complex_type r = inverse ? complex_type(-s4.imag(), s4.real()) : complex_type(s4.imag(), -s4.real());
+      out[k + m] = s5 + r;
+      out[k + 3 * m] = s5 - r;
+    }
+  }
+
+  // Direct DFT of size p, with the twiddle factor of this stage folded into the DFT matrix. O(p) per output, which is
+  // why larger primes go through Bluestein's algorithm.
+  void ButterflyGeneric(complex_type* out, size_t fstride, size_t p, size_t m, const complex_type* twiddles) const {
+    complex_type local[16];
+    std::vector<complex_type> allocated((p > 16) ? p : 0);
+    complex_type* scratch = (p > 16) ? allocated.data() : local;
+    for (size_t k = 0; k < m; ++k) {
+      for (size_t q = 0; q < p; ++q) { scratch[q] = out[k + q * m]; }
+      for (size_t u = 0; u < p; ++u) {
+        size_t step = fstride * (k + u * m), index = 0;
+        complex_type sum = scratch[0];
+        for (size_t q = 1; q < p; ++q) {
+          index += step;
+          if (index >= size_) { index -= size_; }
+          sum += detail::MultiplyComplex(scratch[q], twiddles[index]);
+        }
+        out[k + u * m] = sum;
+      }
+    }
+  }
+
+  size_t size_;
+  std::vector<size_t> factors_;  // Pairs of radix p and remaining sub-transform length m per stage
+  std::vector<complex_type> forward_, inverse_;  // Twiddle factors, or the transformed chirps for Bluestein's algorithm
+  std::vector<complex_type> chirp_;  // exp(-pi * i * k^2 / n), Bluestein's algorithm only
+  std::shared_ptr<const FftPlan<valuetype>> convolution_plan_;  // Power-of-two plan, Bluestein's algorithm only
+};
+
+// Transforms of real input of a fixed size, producing (and consuming) the Size() / 2 + 1 non-redundant bins of the
+// Hermitian spectrum. Even sizes run as a complex transform of half the size.
+template<typename valuetype>
+class RealFftPlan {
+public:
+  using complex_type = std::complex<valuetype>;
+
+  // Constructors
+  explicit RealFftPlan(size_t size) : size_{ size }, plan_{ (size % 2 == 0) ? size / 2 : size } {
+    if (size_ % 2 == 0) { twiddles_ = detail::Twiddles<valuetype>(size_, size_ / 2, -1.); }
+  }
+  RealFftPlan(const RealFftPlan&) = default;
+  ~RealFftPlan() = default;
+
+  // Operators
+  RealFftPlan& operator=(const RealFftPlan&) = default;
+
+  // Transform-specific operations
+  size_t Size() const { return size_; }
+  size_t SpectrumSize() const { return size_ / 2 + 1; }
+  // Spectrum of Size() real values into SpectrumSize() bins.
+  void Forward(const valuetype* in, complex_type* out) const {
+    if (size_ == 0) { return; }
+    if (size_ % 2 == 1) {
+      std::vector<complex_type> data(in, in + size_), spectrum(size_);
+      plan_.Forward(data.data(), spectrum.data());
+      for (size_t k = 0; k < SpectrumSize(); ++k) { out[k] = spectrum[k]; }
+      return;
+    }
+    // Even and odd samples as real and imaginary parts of a half-size transform, separated by the Hermitian symmetry
+    // of the transforms of the even and odd samples.
+    size_t h = size_ / 2;
+    std::vector<complex_type> z(h);
+    plan_.Forward(reinterpret_cast<const complex_type*>(in), z.data());
+    out[0] = complex_type(z[0].real() + z[0].imag(), valuetype(0));
+    out[h] = complex_type(z[0].real() - z[0].imag(), valuetype(0));
+    for (size_t k = 1; k < h; ++k) {
+      complex_type a = z[k], b = std::conj(z[h - k]);
+      complex_type even = (a + b) * valuetype(0.5);
+      complex_type odd = (a - b) * valuetype(0.5);
+      odd = complex_type(odd.imag(), -odd.real());  // Division by i
+      out[k] = even + detail::MultiplyComplex(odd, twiddles_[k]);
+    }
+  }
+  // Size() real values from SpectrumSize() bins, scaled by 1 / Size(). The imaginary parts of the bins that must be
+  // real (0 and, for even sizes, Size() / 2) are ignored.
+  void Inverse(const complex_type* in, valuetype* out) const {
+    if (size_ == 0) { return; }
+    if (size_ % 2 == 1) {
+      std::vector<complex_type> spectrum(size_), data(size_);
+      spectrum[0] = complex_type(in[0].real(), valuetype(0));
+      for (size_t k = 1; k < SpectrumSize(); ++k) { spectrum[k] = in[k]; spectrum[size_ - k] = std::conj(in[k]); }
+      plan_.Inverse(spectrum.data(), data.data());
+      for (size_t i = 0; i < size_; ++i) { out[i] = data[i].real(); }
+      return;
+    }
+    size_t h = size_ / 2;
+    std::vector<complex_type> z(h);
+    for (size_t k = 0; k < h; ++k) {
+      complex_type a = (k == 0) ? complex_type(in[0].real(), valuetype(0)) : in[k];
+      complex_type b = (k == 0) ? complex_type(in[h].real(), valuetype(0)) : std::conj(in[h - k]);
+      complex_type even = (a + b) * valuetype(0.5);
+      complex_type odd = detail::MultiplyComplex((a - b) * valuetype(0.5), std::conj(twiddles_[k]));
+      z[k] = even + complex_type(-odd.imag(), odd.real());  // even + i * odd
+    }
+    plan_.Inverse(z.data(), reinterpret_cast<complex_type*>(out));
+  }
+
+private:
+  size_t size_;
+  FftPlan<valuetype> plan_;
+  std::vector<complex_type> twiddles_;  // exp(-2 * pi * i * k / Size()) for k < Size() / 2
+};
+
+namespace detail {
+
+// Plans are created on first use and kept until kFftPlanCacheSize other sizes have been used more recently. Evicted
+// plans stay valid for as long as a caller holds them.
+template<typename plan>
+class FftPlanCache {
+public:
+  static FftPlanCache& Instance() { static FftPlanCache cache; return cache; }
+
+  std::shared_ptr<const plan> Get(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = plans_.find(size);
+    if (found != plans_.end()) { found->second.second = ++time_; return found->second.first; }
+    if (plans_.size() >= kFftPlanCacheSize) {
+      auto oldest = plans_.begin();
+      for (auto it = plans_.begin(); it != plans_.end(); ++it) { if (it->second.second < oldest->second.second) { oldest = it; } }
+      plans_.erase(oldest);
+    }
+    std::shared_ptr<const plan> created = std::make_shared<const plan>(size);
+    plans_[size] = std::make_pair(created, ++time_);
+    return created;
+  }
+  size_t Size() { std::lock_guard<std::mutex> lock(mutex_); return plans_.size(); }
+  void Clear() { std::lock_guard<std::mutex> lock(mutex_); plans_.clear(); }
+
+private:
+  std::mutex mutex_;
+  std::map<size_t, std::pair<std::shared_ptr<const plan>, size_t>> plans_;  // Plan and time of last use per size
+  size_t time_ = 0;
+};
+
+} // namespace detail
+
+// Shared plan for transforms of the given size, so twiddle factors are computed only once per size. At most
+// kFftPlanCacheSize plans of each kind and valuetype are cached, the least recently used one is dropped first.
+template<typename valuetype> std::shared_ptr<const FftPlan<valuetype>> GetFftPlan(size_t size) { return detail::FftPlanCache<FftPlan<valuetype>>::Instance().Get(size); }
+template<typename valuetype> std::shared_ptr<const RealFftPlan<valuetype>> GetRealFftPlan(size_t size) { return detail::FftPlanCache<RealFftPlan<valuetype>>::Instance().Get(size); }
+// Releases the cached complex and real plans of a valuetype (plans still held by callers stay valid).
+template<typename valuetype> void ClearFftPlanCache() {
+  detail::FftPlanCache<FftPlan<valuetype>>::Instance().Clear();
+  detail::FftPlanCache<RealFftPlan<valuetype>>::Instance().Clear();
+}
+
+// In-place transforms of a complex sequence (through a temporary copy, see FftPlan::Forward).
+template<typename valuetype> void Fft(Sequence1D<std::complex<valuetype>>& sequence) { if (sequence.Length() > 0) { GetFftPlan<valuetype>(sequence.Length())->Forward(sequence.Ptr()); } }
+template<typename valuetype> void InverseFft(Sequence1D<std::complex<valuetype>>& sequence) { if (sequence.Length() > 0) { GetFftPlan<valuetype>(sequence.Length())->Inverse(sequence.Ptr()); } }
+
+// Spectrum (Length() / 2 + 1 bins) of a real sequence, and the real sequence of the given length with that spectrum.
+template<typename valuetype> Sequence1D<std::complex<valuetype>> RealFft(const Sequence1D<valuetype>& sequence) {
+  std::vector<std::complex<valuetype>> spectrum(sequence.Length() / 2 + 1);
+  if (sequence.Length() > 0) { GetRealFftPlan<valuetype>(sequence.Length())->Forward(sequence.Ptr(), spectrum.data()); }
+  return Sequence1D<std::complex<valuetype>>(std::move(spectrum));
+}
+template<typename valuetype> Sequence1D<valuetype> InverseRealFft(const Sequence1D<std::complex<valuetype>>& spectrum, size_t length) {
+  std::vector<valuetype> data(length);
+  if (length > 0 && spectrum.Length() >= length / 2 + 1) { GetRealFftPlan<valuetype>(length)->Inverse(spectrum.Ptr(), data.data()); }
+  return Sequence1D<valuetype>(std::move(data));
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_FFT_H_
@@ -0,0 +1,171 @@
+#pragma once
+#ifndef J_MATH_GRID_LAYOUT_H_
+#define J_MATH_GRID_LAYOUT_H_
+
+#include <cstddef>
+#include <vector>
+#include "sequence_reduction.h"
+
+namespace j {
+namespace math {
+
+// Order in which the elements of a two- or three-dimensional grid (Sequence2D, Sequence3D) are stored.
+//
+// Row-major storage keeps rows contiguous, which suits sweeps along x, but puts the neighbors along y a whole row
+// apart and those along z a whole slice. The tiled layout stores square (2D) or cubic (3D) tiles contiguously, tiles
+// in row-major order, so that a small neighborhood spans a few cache lines and pages; each dimension is padded to a
+// whole number of tiles. The Morton (Z-order) layout interleaves the bits of the coordinates, which keeps
+// neighborhoods of every size close in memory; each dimension is padded to a power of two.
+//
+// For both, the offset of an element is the sum of one precomputed table entry per coordinate, so that random access
+// costs about as much as in row-major storage.
+enum class GridLayout {
+  ROW_MAJOR,
+  TILED,
+  MORTON
+};
+
+// Number of elements along each side of a tile in the tiled layout.
+const size_t kGridTileSize2D = 16;
+const size_t kGridTileSize3D = 8;
+
+namespace detail {
+
+inline size_t GridLog2(size_t n) {
+  size_t bits = 0;
+  while ((size_t(1) << bits) < n) { ++bits; }
+  return bits;
+}
+
+// Storage offsets of the elements of a width x height x depth grid (depth 1 for two dimensions). Coordinates must lie
+// inside the grid.
+class GridIndexer {
+public:
+  // Constructors
+  GridIndexer() : GridIndexer(0, 0, 0, GridLayout::ROW_MAJOR, 1, 1) { }
+  GridIndexer(size_t width, size_t height, size_t depth, GridLayout layout, size_t tile_size, size_t tile_depth) : size_{ width, height, depth }, layout_{ layout } {
+    storage_size_ = Length();
+    if (layout_ == GridLayout::TILED) { BuildTiledTables(tile_size, tile_depth); }
+    if (layout_ == GridLayout::MORTON) { BuildMortonTables(); }
+  }
+  GridIndexer(const GridIndexer&) = default;
+  ~GridIndexer() = default;
+
+  // Operators
+  GridIndexer& operator=(const GridIndexer&) = default;
+
+  // Indexer-specific operations
+  GridLayout Layout() const { return layout_; }
+  size_t Size(size_t axis) const { return size_[axis]; }
+  size_t Length() const { return size_[0] * size_[1] * size_[2]; }
+  // Number of stored elements, more than Length() when the layout pads the grid.
+  size_t StorageSize() const { return storage_size_; }
+  size_t Offset(size_t x, size_t y, size_t z) const {
+    if (layout_ == GridLayout::ROW_MAJOR) { return (z * size_[1] + y) * size_[0] + x; }
+    return tables_[0][x] + tables_[1][y] + tables_[2][z];
+  }
+  // Copies count elements in row-major order, starting at row-major index begin, from the grid to out.
+  template<typename valuetype>
+  void GatherRowMajor(const valuetype* data, size_t begin, size_t count, valuetype* out) const {
+    if (layout_ == GridLayout::ROW_MAJOR) { for (size_t i = 0; i < count; ++i) { out[i] = data[begin + i]; } return; }
+    ForEachRowSegment(begin, count, [&](size_t row, size_t x, size_t i, size_t run) {
+      const size_t* table = &tables_[0][x];
+      for (size_t k = 0; k < run; ++k) { out[i + k] = data[row + table[k]]; }
+    });
+  }
+  // Copies count elements in row-major order, starting at row-major index begin, from in to the grid.
+  template<typename valuetype>
+  void ScatterRowMajor(const valuetype* in, size_t begin, size_t count, valuetype* data) const {
+    if (layout_ == GridLayout::ROW_MAJOR) { for (size_t i = 0; i < count; ++i) { data[begin + i] = in[i]; } return; }
+    ForEachRowSegment(begin, count, [&](size_t row, size_t x, size_t i, size_t run) {
+      const size_t* table = &tables_[0][x];
+      for (size_t k = 0; k < run; ++k) { data[row + table[k]] = in[i + k]; }
+    });
+  }
+
+private:
+  // Tiles are stored one after the other in row-major order, the elements of a tile in row-major order as well.
+  void BuildTiledTables(size_t tile_size, size_t tile_depth) {
+    size_t tile[3] = { tile_size, tile_size, tile_depth }, padded[3], element_stride = 1, tile_stride = 1;
+    for (size_t axis = 0; axis < 3; ++axis) {
+      if (tile[axis] < 1) { tile[axis] = 1; }
+      padded[axis] = (size_[axis] + tile[axis] - 1) / tile[axis] * tile[axis];
+      tile_stride *= tile[axis];
+    }
+    for (size_t axis = 0; axis < 3; ++axis) {
+      tables_[axis].resize(size_[axis]);
+      for (size_t c = 0; c < size_[axis]; ++c) { tables_[axis][c] = (c / tile[axis]) * tile_stride + (c % tile[axis]) * element_stride; }
+      element_stride *= tile[axis];
+      tile_stride *= padded[axis] / tile[axis];
+    }
+    storage_size_ = (Length() > 0) ? padded[0] * padded[1] * padded[2] : 0;
+  }
+
+  // Bit b of coordinate axis goes to the next free bit of the offset, axes taking turns for as long as they have bits.
+  // The contributions of the axes do not overlap, so their sum is the interleaved offset.
+  void BuildMortonTables() {
+    size_t bits[3], max_bits = 0;
+    for (size_t axis = 0; axis < 3; ++axis) {
+      bits[axis] = GridLog2(size_[axis]);
+      if (bits[axis] > max_bits) { max_bits = bits[axis]; }
+      tables_[axis].assign(size_[axis], 0);
+    }
+    size_t shift = 0;
+    for (size_t bit = 0; bit < max_bits; ++bit) {
+      for (size_t axis = 0; axis < 3; ++axis) {
+        if (bit >= bits[axis]) { continue; }
+        for (size_t c = 0; c < size_[axis]; ++c) { tables_[axis][c] |= ((c >> bit) & 1) << shift; }
+        ++shift;
+      }
+    }
+    storage_size_ = (Length() > 0) ? size_t(1) << shift : 0;
+  }
+
+  // Calls body(row, x, i, run) for the parts of rows covering count elements from row-major index begin: the elements
+  // x, ..., x + run - 1 of the row whose offsets are row + tables_[0][x], ..., correspond to the row-major indices
+  // begin + i, ..., begin + i + run - 1.
+  template<typename function>
+  void ForEachRowSegment(size_t begin, size_t count, function body) const {
+    if (count == 0 || Length() == 0) { return; }  // An empty grid has no rows to divide begin by
+    size_t x = begin % size_[0], y = (begin / size_[0]) % size_[1], z = begin / (size_[0] * size_[1]);
+    for (size_t i = 0; i < count; ) {
+      size_t run = (size_[0] - x < count - i) ? size_[0] - x : count - i;
+      body(tables_[1][y] + tables_[2][z], x, i, run);
+      i += run;
+      x = 0;
+      if (++y == size_[1]) { y = 0; ++z; }
+    }
+  }
+
+  size_t size_[3];
+  GridLayout layout_;
+  size_t storage_size_;
+  std::vector<size_t> tables_[3];  // Offset contributions of x, y and z (tiled and Morton layouts)
+};
+
+// Reductions over the elements of a grid in row-major order, equal to those over the row-major array for every
+// layout. Other layouts are copied to row-major order chunk by chunk.
+template<typename valuetype>
+const valuetype* GridChunk(const GridIndexer& indexer, const valuetype* data, size_t offset, size_t count, std::vector<valuetype>& buffer) {
+  if (indexer.Layout() == GridLayout::ROW_MAJOR) { return data + offset; }
+  buffer.resize(count);
+  indexer.GatherRowMajor(data, offset, count, buffer.data());
+  return buffer.data();
+}
+
+template<typename valuetype>
+valuetype GridSum(const GridIndexer& indexer, const valuetype* data, bool square, SummationPolicy policy, size_t thread_count) {
+  return SumChunks<valuetype>(indexer.Length(), square, policy, thread_count, [&indexer, data](size_t offset, size_t count, std::vector<valuetype>& buffer) { return GridChunk(indexer, data, offset, count, buffer); });
+}
+
+template<typename valuetype>
+SequenceStatistics<valuetype> GridStatistics(const GridIndexer& indexer, const valuetype* data, size_t thread_count) {
+  return StatisticsChunks<valuetype>(indexer.Length(), thread_count, [&indexer, data](size_t offset, size_t count, std::vector<valuetype>& buffer) { return GridChunk(indexer, data, offset, count, buffer); });
+}
+
+} // namespace detail
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_GRID_LAYOUT_H_
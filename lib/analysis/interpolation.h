@@ -3,21 +3,169 @@
 #define J_MATH_ANALYSIS_INTERPOLATION_H_
 
 #include <cmath>
+#include <vector>
+#include "interpolation_batch.h"
+#include "interpolation_kernel.h"
 #include "sequence.h"
+#include "sequence_2d.h"
+#include "sequence_3d.h"
 
 namespace j {
   namespace math {
 
     // Interpolation of discrete sequences.
     class Interpolation {
-      template<typename valuetype> valuetype NearestNeighborInterpolation(const Sequence1D<valuetype>& sequence, const float& x) { return sequence(std::round(x)); }
-      template<typename valuetype> valuetype LinearInterpolation(const Sequence1D<valuetype>& sequence, const float& x) {
-        size_t x1{ std::floor(x) };
-        size_t x2{ x1 + 1.0f };
+    public:
+      template<typename valuetype> static valuetype NearestNeighborInterpolation(const Sequence1D<valuetype>& sequence, const float& x) { return sequence(size_t(std::round(x))); }
+      template<typename valuetype> static valuetype LinearInterpolation(const Sequence1D<valuetype>& sequence, const float& x) {
+        size_t x1{ size_t(std::floor(x)) };
+        size_t x2{ x1 + 1 };
         valuetype y1{ sequence(x1) };
         valuetype y2{ sequence(x2) };
-        return ((x2 - x) * y1) + ((x - x1) * y2);
+        return valuetype(((float(x2) - x) * y1) + ((x - float(x1)) * y2));
       }
+      // Interpolation from the surrounding 4 (cubic) or 2 * radius (Lanczos) samples, see interpolation_kernel.h.
+      template<typename valuetype> static valuetype CubicInterpolation(const Sequence1D<valuetype>& sequence, const float& x) { return KernelInterpolation(sequence, x, InterpolationKernel::CATMULL_ROM); }
+      template<typename valuetype> static valuetype CubicBSplineInterpolation(const Sequence1D<valuetype>& sequence, const float& x) { return KernelInterpolation(sequence, x, InterpolationKernel::CUBIC_B_SPLINE); }
+      template<typename valuetype> static valuetype LanczosInterpolation(const Sequence1D<valuetype>& sequence, const float& x, size_t radius = kDefaultLanczosRadius) { return KernelInterpolation(sequence, x, InterpolationKernel::LANCZOS, radius); }
+      template<typename valuetype> static valuetype KernelInterpolation(const Sequence1D<valuetype>& sequence, const float& x, InterpolationKernel kernel, size_t lanczos_radius = kDefaultLanczosRadius) {
+        valuetype result;
+        detail::KernelResample<false>(sequence.Ptr(), sequence.Length(), &x, &result, 1, kernel, detail::KernelRadius(kernel, lanczos_radius));
+        return result;
+      }
+
+      // Interpolation of grids from the nearest sample or, one axis after the other, from the surrounding 4 (bilinear) or
+      // 8 (trilinear) samples. Positions outside the grid are clamped or wrapped according to index_type.
+      template<typename valuetype> static valuetype NearestNeighborInterpolation(const Sequence2D<valuetype>& sequence, const float& x, const float& y, IndexType index_type = IndexType::CLAMP) {
+        return sequence.Get(NearestTap(x, sequence.Width(), index_type), NearestTap(y, sequence.Height(), index_type));
+      }
+      template<typename valuetype> static valuetype BilinearInterpolation(const Sequence2D<valuetype>& sequence, const float& x, const float& y, IndexType index_type = IndexType::CLAMP) {
+        LinearTaps tx(x, sequence.Width(), index_type), ty(y, sequence.Height(), index_type);
+        return Bilinear(sequence, tx, ty);
+      }
+      template<typename valuetype> static valuetype NearestNeighborInterpolation(const Sequence3D<valuetype>& sequence, const float& x, const float& y, const float& z, IndexType index_type = IndexType::CLAMP) {
+        return sequence.Get(NearestTap(x, sequence.Width(), index_type), NearestTap(y, sequence.Height(), index_type), NearestTap(z, sequence.Depth(), index_type));
+      }
+      template<typename valuetype> static valuetype TrilinearInterpolation(const Sequence3D<valuetype>& sequence, const float& x, const float& y, const float& z, IndexType index_type = IndexType::CLAMP) {
+        LinearTaps tx(x, sequence.Width(), index_type), ty(y, sequence.Height(), index_type), tz(z, sequence.Depth(), index_type);
+        return Trilinear(sequence, tx, ty, tz);
+      }
+      // Grids resized to the given dimensions covering the same area, the corner samples staying in place. The result
+      // has the layout of the input; the taps along each axis are computed once per column, row and slice.
+      template<typename valuetype> static Sequence2D<valuetype> BilinearResize(const Sequence2D<valuetype>& sequence, size_t width, size_t height) {
+        Sequence2D<valuetype> result(width, height, sequence.Layout());
+        if (sequence.Length() == 0) { return result; }
+        std::vector<LinearTaps> tx = ResizeTaps(sequence.Width(), width), ty = ResizeTaps(sequence.Height(), height);
+        for (size_t y = 0; y < height; ++y) {
+          for (size_t x = 0; x < width; ++x) { result.Set(x, y, Bilinear(sequence, tx[x], ty[y])); }
+        }
+        return result;
+      }
+      template<typename valuetype> static Sequence3D<valuetype> TrilinearResize(const Sequence3D<valuetype>& sequence, size_t width, size_t height, size_t depth) {
+        Sequence3D<valuetype> result(width, height, depth, sequence.Layout());
+        if (sequence.Length() == 0) { return result; }
+        std::vector<LinearTaps> tx = ResizeTaps(sequence.Width(), width), ty = ResizeTaps(sequence.Height(), height), tz = ResizeTaps(sequence.Depth(), depth);
+        for (size_t z = 0; z < depth; ++z) {
+          for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) { result.Set(x, y, z, Trilinear(sequence, tx[x], ty[y], tz[z])); }
+          }
+        }
+        return result;
+      }
+
+      // Batch resampling: the sequence evaluated at many positions at once, vectorized where the instruction set allows
+      // (see interpolation_batch.h). Equal to calling the single-position functions for positions in [0, length - 1];
+      // positions outside are clamped or wrapped according to index_type.
+      template<typename valuetype> static Sequence1D<valuetype> NearestNeighborResample(const Sequence1D<valuetype>& sequence, const float* positions, size_t count, IndexType index_type = IndexType::CLAMP) { return Resample<false>(sequence, positions, count, index_type); }
+      template<typename valuetype> static Sequence1D<valuetype> NearestNeighborResample(const Sequence1D<valuetype>& sequence, const std::vector<float>& positions, IndexType index_type = IndexType::CLAMP) { return Resample<false>(sequence, positions.data(), positions.size(), index_type); }
+      template<typename valuetype> static Sequence1D<valuetype> LinearResample(const Sequence1D<valuetype>& sequence, const float* positions, size_t count, IndexType index_type = IndexType::CLAMP) { return Resample<true>(sequence, positions, count, index_type); }
+      template<typename valuetype> static Sequence1D<valuetype> LinearResample(const Sequence1D<valuetype>& sequence, const std::vector<float>& positions, IndexType index_type = IndexType::CLAMP) { return Resample<true>(sequence, positions.data(), positions.size(), index_type); }
+      // Resampling at count positions start, start + step, start + 2 * step, ...
+      template<typename valuetype> static Sequence1D<valuetype> NearestNeighborResampleUniform(const Sequence1D<valuetype>& sequence, double start, double step, size_t count, IndexType index_type = IndexType::CLAMP) { return ResampleUniform<false>(sequence, start, step, count, index_type); }
+      template<typename valuetype> static Sequence1D<valuetype> LinearResampleUniform(const Sequence1D<valuetype>& sequence, double start, double step, size_t count, IndexType index_type = IndexType::CLAMP) { return ResampleUniform<true>(sequence, start, step, count, index_type); }
+      // Resampling with ratio output samples per input sample, covering [0, length - 1] (e.g. 2 doubles the sample rate).
+      template<typename valuetype> static Sequence1D<valuetype> NearestNeighborResampleRatio(const Sequence1D<valuetype>& sequence, double ratio) { return ResampleUniform<false>(sequence, 0., 1. / ratio, ResampleRatioCount(sequence.Length(), ratio), IndexType::CLAMP); }
+      template<typename valuetype> static Sequence1D<valuetype> LinearResampleRatio(const Sequence1D<valuetype>& sequence, double ratio) { return ResampleUniform<true>(sequence, 0., 1. / ratio, ResampleRatioCount(sequence.Length(), ratio), IndexType::CLAMP); }
+      // Batch interpolation with a kernel, evaluating the kernel weights for every position.
+      template<typename valuetype> static Sequence1D<valuetype> KernelResample(const Sequence1D<valuetype>& sequence, const std::vector<float>& positions, InterpolationKernel kernel, IndexType index_type = IndexType::CLAMP, size_t lanczos_radius = kDefaultLanczosRadius) {
+        std::vector<valuetype> result(positions.size());
+        size_t radius = detail::KernelRadius(kernel, lanczos_radius);
+        if (sequence.Length() > 0 && !positions.empty()) {
+          if (index_type == IndexType::WRAP) { detail::KernelResample<true>(sequence.Ptr(), sequence.Length(), positions.data(), result.data(), positions.size(), kernel, radius); }
+          else { detail::KernelResample<false>(sequence.Ptr(), sequence.Length(), positions.data(), result.data(), positions.size(), kernel, radius); }
+        }
+        return Sequence1D<valuetype>(std::move(result));
+      }
+      // Batch interpolation with precomputed weights, each position rounded to the nearest phase of the table.
+      template<typename valuetype> static Sequence1D<valuetype> KernelResample(const Sequence1D<valuetype>& sequence, const std::vector<float>& positions, const InterpolationTable& table, IndexType index_type = IndexType::CLAMP) {
+        std::vector<valuetype> result(positions.size());
+        if (sequence.Length() > 0 && !positions.empty()) {
+          if (index_type == IndexType::WRAP) { table.Resample<true>(sequence.Ptr(), sequence.Length(), positions.data(), result.data(), positions.size()); }
+          else { table.Resample<false>(sequence.Ptr(), sequence.Length(), positions.data(), result.data(), positions.size()); }
+        }
+        return Sequence1D<valuetype>(std::move(result));
+      }
+      // Polyphase resampling by the rational factor table.PhaseCount() / down, covering [0, length - 1]: output sample i
+      // lies at i * down / table.PhaseCount(), so every output uses exact precomputed weights.
+      template<typename valuetype> static Sequence1D<valuetype> KernelResampleRational(const Sequence1D<valuetype>& sequence, const InterpolationTable& table, size_t down, IndexType index_type = IndexType::CLAMP) {
+        if (sequence.Length() == 0 || down == 0) { return Sequence1D<valuetype>(); }
+        std::vector<valuetype> result((sequence.Length() - 1) * table.PhaseCount() / down + 1);
+        if (index_type == IndexType::WRAP) { table.ResampleRational<true>(sequence.Ptr(), sequence.Length(), down, result.data(), result.size()); }
+        else { table.ResampleRational<false>(sequence.Ptr(), sequence.Length(), down, result.data(), result.size()); }
+        return Sequence1D<valuetype>(std::move(result));
+      }
+
+    private:
+      template<bool linear, typename valuetype> static Sequence1D<valuetype> Resample(const Sequence1D<valuetype>& sequence, const float* positions, size_t count, IndexType index_type) {
+        std::vector<valuetype> result(count);
+        if (sequence.Length() > 0 && count > 0) { detail::ResampleDispatch<linear>(sequence.Ptr(), sequence.Length(), positions, result.data(), count, index_type); }
+        return Sequence1D<valuetype>(std::move(result));
+      }
+      template<bool linear, typename valuetype> static Sequence1D<valuetype> ResampleUniform(const Sequence1D<valuetype>& sequence, double start, double step, size_t count, IndexType index_type) {
+        std::vector<valuetype> result(count);
+        if (sequence.Length() > 0 && count > 0) { detail::ResampleUniform<linear>(sequence.Ptr(), sequence.Length(), start, step, result.data(), count, index_type); }
+        return Sequence1D<valuetype>(std::move(result));
+      }
+      // Neighboring samples i0_ and i1_ along one axis of the given (non-zero) size and the weight t_ of i1_.
+      struct LinearTaps {
+        LinearTaps() = default;
+        LinearTaps(float x, size_t size, IndexType index_type) {
+          bool wrap = (index_type == IndexType::WRAP);
+          float p = wrap ? detail::ResamplePosition<true>(x, float(size), float(size)) : detail::ResamplePosition<false>(x, float(size - 1), float(size));
+          i0_ = size_t(p);
+          if (i0_ >= size) { i0_ = size - 1; }
+          t_ = p - float(i0_);
+          i1_ = (i0_ + 1 < size) ? i0_ + 1 : (wrap ? 0 : i0_);
+        }
+
+        size_t i0_ = 0;
+        size_t i1_ = 0;
+        float t_ = 0.f;
+      };
+      static size_t NearestTap(float x, size_t size, IndexType index_type) {
+        float p = (index_type == IndexType::WRAP) ? detail::ResamplePosition<true>(x + 0.5f, float(size), float(size)) : detail::ResamplePosition<false>(x + 0.5f, float(size), float(size));
+        return detail::ConvertIndex(size_t(p), size, index_type);
+      }
+      static std::vector<LinearTaps> ResizeTaps(size_t size, size_t count) {
+        std::vector<LinearTaps> taps(count);
+        double step = (count > 1) ? double(size - 1) / double(count - 1) : 0.;
+        for (size_t i = 0; i < count; ++i) { taps[i] = LinearTaps(float(double(i) * step), size, IndexType::CLAMP); }
+        return taps;
+      }
+      template<typename valuetype> static valuetype Bilinear(const Sequence2D<valuetype>& sequence, const LinearTaps& tx, const LinearTaps& ty) {
+        auto top = (1.f - tx.t_) * sequence(tx.i0_, ty.i0_) + tx.t_ * sequence(tx.i1_, ty.i0_);
+        auto bottom = (1.f - tx.t_) * sequence(tx.i0_, ty.i1_) + tx.t_ * sequence(tx.i1_, ty.i1_);
+        return valuetype((1.f - ty.t_) * top + ty.t_ * bottom);
+      }
+      template<typename valuetype> static valuetype Trilinear(const Sequence3D<valuetype>& sequence, const LinearTaps& tx, const LinearTaps& ty, const LinearTaps& tz) {
+        auto slice = [&](size_t z) {
+          auto top = (1.f - tx.t_) * sequence(tx.i0_, ty.i0_, z) + tx.t_ * sequence(tx.i1_, ty.i0_, z);
+          auto bottom = (1.f - tx.t_) * sequence(tx.i0_, ty.i1_, z) + tx.t_ * sequence(tx.i1_, ty.i1_, z);
+          return (1.f - ty.t_) * top + ty.t_ * bottom;
+        };
+        return valuetype((1.f - tz.t_) * slice(tz.i0_) + tz.t_ * slice(tz.i1_));
+      }
+      static size_t ResampleRatioCount(size_t length, double ratio) { return (length > 0 && ratio > 0.) ? size_t(std::floor(double(length - 1) * ratio)) + 1 : 0; }
     };
 
   } // namespace
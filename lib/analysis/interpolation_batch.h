@@ -0,0 +1,319 @@
+#pragma once
+#ifndef J_MATH_INTERPOLATION_BATCH_H_
+#define J_MATH_INTERPOLATION_BATCH_H_
+
+#include <cmath>
+#include <cstddef>
+#include "..\utility\simd.h"
+#include "sequence.h"
+
+namespace j {
+namespace math {
+
+// Batch kernels for resampling a sequence at many positions, used by Interpolation. Boundary handling is resolved per
+// position with the index type fixed for the whole batch, so the inner loops contain no switches. Results equal those
+// of Interpolation::NearestNeighborInterpolation and Interpolation::LinearInterpolation for positions in
+// [0, length - 1], on every SIMD level (no fused multiply-add).
+//
+// Positions outside the sequence are handled per IndexType: CLAMP evaluates at the nearest end, WRAP treats the
+// sequence as periodic with period length (linear interpolation between the last and the first sample included).
+// NaN positions evaluate at 0.
+
+namespace detail {
+
+const size_t kResampleBlockSize = 256;
+
+//
+// Position reduction shared by all kernels
+//
+// Maps x into [0, length - 1] (CLAMP) or [0, length) (WRAP).
+template<bool wrap>
+float ResamplePosition(float x, float last, float period) {
+  if (wrap) {
+    float q = std::floor(x / period);
+    x = x - period * q;
+    if (!(x < period)) { x = 0.f; }
+  }
+  if (!(x > 0.f)) { x = 0.f; }  // Also maps NaN to 0
+  return (x > last) ? last : x;
+}
+
+//
+// Generic kernels (any valuetype, positions [begin, end))
+//
+template<bool wrap, typename valuetype>
+void NearestNeighborResampleGeneric(const valuetype* data, size_t length, const float* x, valuetype* result, size_t begin, size_t end) {
+  float last = wrap ? float(length) : float(length - 1), period = float(length);
+  for (size_t i = begin; i < end; ++i) {
+    float p = ResamplePosition<wrap>(x[i], last, period);
+    size_t index = size_t(p);
+    if (p - float(index) >= 0.5f) { ++index; }
+    if (index >= length) { index = wrap ? 0 : length - 1; }
+    result[i] = data[index];
+  }
+}
+
+template<bool wrap, typename valuetype>
+void LinearResampleGeneric(const valuetype* data, size_t length, const float* x, valuetype* result, size_t begin, size_t end) {
+  float last = wrap ? float(length) : float(length - 1), period = float(length);
+  for (size_t i = begin; i < end; ++i) {
+    float p = ResamplePosition<wrap>(x[i], last, period);
+    size_t x1 = size_t(p);
+    if (x1 >= length) { x1 = length - 1; }
+    size_t x2 = x1 + 1;
+    valuetype y1 = data[x1];
+    valuetype y2 = data[(x2 < length) ? x2 : (wrap ? 0 : length - 1)];
+    result[i] = valuetype(((float(x2) - p) * y1) + ((p - float(x1)) * y2));
+  }
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+//
+// SSE2 kernels (positions and weights in vector registers, samples loaded individually)
+//
+template<bool wrap>
+J_MATH_TARGET_SSE2 inline __m128 ResamplePositionSse(__m128 x, __m128 last, __m128 period) {
+  if (wrap) {
+    __m128 q = _mm_div_ps(x, period);
+    // floor(q) without SSE4.1: truncate and step down where that rounded up. Truncation only fits |q| < 2^31, but floats
+    // with |q| >= 2^23 are integral already and pass through unchanged, as do NaN and infinity.
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(q));
+    t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, q), _mm_set1_ps(1.f)));
+    __m128 integral = _mm_cmpnlt_ps(_mm_andnot_ps(_mm_set1_ps(-0.f), q), _mm_set1_ps(8388608.f));
+    q = _mm_or_ps(_mm_and_ps(integral, q), _mm_andnot_ps(integral, t));
+    x = _mm_sub_ps(x, _mm_mul_ps(period, q));
+    x = _mm_and_ps(x, _mm_cmplt_ps(x, period));
+  }
+  x = _mm_max_ps(x, _mm_setzero_ps());  // Also maps NaN to 0
+  return _mm_min_ps(x, last);
+}
+
+template<bool wrap>
+J_MATH_TARGET_SSE2 inline void NearestNeighborResampleSse(const float* data, size_t length, const float* x, float* result, size_t count) {
+  __m128 last = _mm_set1_ps(wrap ? float(length) : float(length - 1)), period = _mm_set1_ps(float(length)), half = _mm_set1_ps(0.5f);
+  int indices[4];
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 p = ResamplePositionSse<wrap>(_mm_loadu_ps(x + i), last, period);
+    __m128i index = _mm_cvttps_epi32(p);
+    index = _mm_sub_epi32(index, _mm_castps_si128(_mm_cmpge_ps(_mm_sub_ps(p, _mm_cvtepi32_ps(index)), half)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), index);
+    for (int k = 0; k < 4; ++k) { size_t j = size_t(indices[k]); result[i + k] = data[(j < length) ? j : (wrap ? 0 : length - 1)]; }
+  }
+  NearestNeighborResampleGeneric<wrap>(data, length, x, result, i, count);
+}
+
+template<bool wrap>
+J_MATH_TARGET_SSE2 inline void LinearResampleSse(const float* data, size_t length, const float* x, float* result, size_t count) {
+  __m128 last = _mm_set1_ps(wrap ? float(length) : float(length - 1)), period = _mm_set1_ps(float(length));
+  __m128i last_index = _mm_set1_epi32(int(length - 1)), one = _mm_set1_epi32(1);
+  int indices[4];
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 p = ResamplePositionSse<wrap>(_mm_loadu_ps(x + i), last, period);
+    __m128i x1 = _mm_cvttps_epi32(p);
+    __m128i too_far = _mm_cmpgt_epi32(x1, last_index);
+    x1 = _mm_or_si128(_mm_and_si128(too_far, last_index), _mm_andnot_si128(too_far, x1));
+    __m128i x2 = _mm_add_epi32(x1, one);
+    __m128 w1 = _mm_sub_ps(_mm_cvtepi32_ps(x2), p), w2 = _mm_sub_ps(p, _mm_cvtepi32_ps(x1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), x1);
+    float y1[4], y2[4];
+    for (int k = 0; k < 4; ++k) {
+      size_t j = size_t(indices[k]);
+      y1[k] = data[j];
+      y2[k] = data[(j + 1 < length) ? j + 1 : (wrap ? 0 : length - 1)];
+    }
+    _mm_storeu_ps(result + i, _mm_add_ps(_mm_mul_ps(w1, _mm_loadu_ps(y1)), _mm_mul_ps(w2, _mm_loadu_ps(y2))));
+  }
+  LinearResampleGeneric<wrap>(data, length, x, result, i, count);
+}
+
+template<bool wrap>
+J_MATH_TARGET_SSE2 inline void NearestNeighborResampleSse(const double* data, size_t length, const float* x, double* result, size_t count) {
+  __m128 last = _mm_set1_ps(wrap ? float(length) : float(length - 1)), period = _mm_set1_ps(float(length)), half = _mm_set1_ps(0.5f);
+  int indices[4];
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 p = ResamplePositionSse<wrap>(_mm_loadu_ps(x + i), last, period);
+    __m128i index = _mm_cvttps_epi32(p);
+    index = _mm_sub_epi32(index, _mm_castps_si128(_mm_cmpge_ps(_mm_sub_ps(p, _mm_cvtepi32_ps(index)), half)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), index);
+    for (int k = 0; k < 4; ++k) { size_t j = size_t(indices[k]); result[i + k] = data[(j < length) ? j : (wrap ? 0 : length - 1)]; }
+  }
+  NearestNeighborResampleGeneric<wrap>(data, length, x, result, i, count);
+}
+
+template<bool wrap>
+J_MATH_TARGET_SSE2 inline void LinearResampleSse(const double* data, size_t length, const float* x, double* result, size_t count) {
+  __m128 last = _mm_set1_ps(wrap ? float(length) : float(length - 1)), period = _mm_set1_ps(float(length));
+  __m128i last_index = _mm_set1_epi32(int(length - 1)), one = _mm_set1_epi32(1);
+  int indices[4];
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 p = ResamplePositionSse<wrap>(_mm_loadu_ps(x + i), last, period);
+    __m128i x1 = _mm_cvttps_epi32(p);
+    __m128i too_far = _mm_cmpgt_epi32(x1, last_index);
+    x1 = _mm_or_si128(_mm_and_si128(too_far, last_index), _mm_andnot_si128(too_far, x1));
+    __m128 w1 = _mm_sub_ps(_mm_cvtepi32_ps(_mm_add_epi32(x1, one)), p), w2 = _mm_sub_ps(p, _mm_cvtepi32_ps(x1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(indices), x1);
+    double y1[4], y2[4];
+    for (int k = 0; k < 4; ++k) {
+      size_t j = size_t(indices[k]);
+      y1[k] = data[j];
+      y2[k] = data[(j + 1 < length) ? j + 1 : (wrap ? 0 : length - 1)];
+    }
+    __m128d w1_low = _mm_cvtps_pd(w1), w1_high = _mm_cvtps_pd(_mm_movehl_ps(w1, w1));
+    __m128d w2_low = _mm_cvtps_pd(w2), w2_high = _mm_cvtps_pd(_mm_movehl_ps(w2, w2));
+    _mm_storeu_pd(result + i, _mm_add_pd(_mm_mul_pd(w1_low, _mm_loadu_pd(y1)), _mm_mul_pd(w2_low, _mm_loadu_pd(y2))));
+    _mm_storeu_pd(result + i + 2, _mm_add_pd(_mm_mul_pd(w1_high, _mm_loadu_pd(y1 + 2)), _mm_mul_pd(w2_high, _mm_loadu_pd(y2 + 2))));
+  }
+  LinearResampleGeneric<wrap>(data, length, x, result, i, count);
+}
+
+//
+// AVX2 kernels (samples fetched with gather instructions)
+//
+template<bool wrap>
+J_MATH_TARGET_AVX2 inline __m256 ResamplePositionAvx2(__m256 x, __m256 last, __m256 period) {
+  if (wrap) {
+    __m256 q = _mm256_floor_ps(_mm256_div_ps(x, period));
+    x = _mm256_sub_ps(x, _mm256_mul_ps(period, q));
+    x = _mm256_and_ps(x, _mm256_cmp_ps(x, period, _CMP_LT_OQ));
+  }
+  x = _mm256_max_ps(x, _mm256_setzero_ps());  // Also maps NaN to 0
+  return _mm256_min_ps(x, last);
+}
+
+// Gather of four doubles. The masked form avoids reading an undefined source register.
+J_MATH_TARGET_AVX2 inline __m256d GatherAvx2(const double* data, __m128i index) { return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), data, index, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8); }
+
+// Index of the second sample of a linear interpolation, x1 + 1 at the end of the sequence replaced per index type.
+template<bool wrap>
+J_MATH_TARGET_AVX2 inline __m256i SecondIndexAvx2(__m256i x1, __m256i last_index) {
+  __m256i x2 = _mm256_add_epi32(x1, _mm256_set1_epi32(1));
+  __m256i past_end = _mm256_cmpgt_epi32(x2, last_index);
+  return wrap ? _mm256_andnot_si256(past_end, x2) : _mm256_min_epi32(x2, last_index);
+}
+
+template<bool wrap>
+J_MATH_TARGET_AVX2 inline void NearestNeighborResampleAvx2(const float* data, size_t length, const float* x, float* result, size_t count) {
+  __m256 last = _mm256_set1_ps(wrap ? float(length) : float(length - 1)), period = _mm256_set1_ps(float(length)), half = _mm256_set1_ps(0.5f);
+  __m256i last_index = _mm256_set1_epi32(int(length - 1));
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 p = ResamplePositionAvx2<wrap>(_mm256_loadu_ps(x + i), last, period);
+    __m256i index = _mm256_cvttps_epi32(p);
+    index = _mm256_sub_epi32(index, _mm256_castps_si256(_mm256_cmp_ps(_mm256_sub_ps(p, _mm256_cvtepi32_ps(index)), half, _CMP_GE_OQ)));
+    __m256i past_end = _mm256_cmpgt_epi32(index, last_index);
+    index = wrap ? _mm256_andnot_si256(past_end, index) : _mm256_min_epi32(index, last_index);
+    _mm256_storeu_ps(result + i, _mm256_i32gather_ps(data, index, 4));
+  }
+  NearestNeighborResampleGeneric<wrap>(data, length, x, result, i, count);
+}
+
+template<bool wrap>
+J_MATH_TARGET_AVX2 inline void LinearResampleAvx2(const float* data, size_t length, const float* x, float* result, size_t count) {
+  __m256 last = _mm256_set1_ps(wrap ? float(length) : float(length - 1)), period = _mm256_set1_ps(float(length));
+  __m256i last_index = _mm256_set1_epi32(int(length - 1));
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 p = ResamplePositionAvx2<wrap>(_mm256_loadu_ps(x + i), last, period);
+    __m256i x1 = _mm256_min_epi32(_mm256_cvttps_epi32(p), last_index);
+    __m256 w1 = _mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(x1, _mm256_set1_epi32(1))), p), w2 = _mm256_sub_ps(p, _mm256_cvtepi32_ps(x1));
+    __m256 y1 = _mm256_i32gather_ps(data, x1, 4), y2 = _mm256_i32gather_ps(data, SecondIndexAvx2<wrap>(x1, last_index), 4);
+    _mm256_storeu_ps(result + i, _mm256_add_ps(_mm256_mul_ps(w1, y1), _mm256_mul_ps(w2, y2)));
+  }
+  LinearResampleGeneric<wrap>(data, length, x, result, i, count);
+}
+
+template<bool wrap>
+J_MATH_TARGET_AVX2 inline void NearestNeighborResampleAvx2(const double* data, size_t length, const float* x, double* result, size_t count) {
+  __m128 last = _mm_set1_ps(wrap ? float(length) : float(length - 1)), period = _mm_set1_ps(float(length)), half = _mm_set1_ps(0.5f);
+  __m128i last_index = _mm_set1_epi32(int(length - 1));
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 p = ResamplePositionSse<wrap>(_mm_loadu_ps(x + i), last, period);
+    __m128i index = _mm_cvttps_epi32(p);
+    index = _mm_sub_epi32(index, _mm_castps_si128(_mm_cmpge_ps(_mm_sub_ps(p, _mm_cvtepi32_ps(index)), half)));
+    __m128i past_end = _mm_cmpgt_epi32(index, last_index);
+    index = wrap ? _mm_andnot_si128(past_end, index) : _mm_min_epi32(index, last_index);
+    _mm256_storeu_pd(result + i, GatherAvx2(data, index));
+  }
+  NearestNeighborResampleGeneric<wrap>(data, length, x, result, i, count);
+}
+
+template<bool wrap>
+J_MATH_TARGET_AVX2 inline void LinearResampleAvx2(const double* data, size_t length, const float* x, double* result, size_t count) {
+  __m128 last = _mm_set1_ps(wrap ? float(length) : float(length - 1)), period = _mm_set1_ps(float(length));
+  __m128i last_index = _mm_set1_epi32(int(length - 1)), one = _mm_set1_epi32(1);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 p = ResamplePositionSse<wrap>(_mm_loadu_ps(x + i), last, period);
+    __m128i x1 = _mm_min_epi32(_mm_cvttps_epi32(p), last_index);
+    __m128i x2 = _mm_add_epi32(x1, one);
+    __m128 w1 = _mm_sub_ps(_mm_cvtepi32_ps(x2), p), w2 = _mm_sub_ps(p, _mm_cvtepi32_ps(x1));
+    __m128i past_end = _mm_cmpgt_epi32(x2, last_index);
+    x2 = wrap ? _mm_andnot_si128(past_end, x2) : _mm_min_epi32(x2, last_index);
+    __m256d y1 = GatherAvx2(data, x1), y2 = GatherAvx2(data, x2);
+    _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_mul_pd(_mm256_cvtps_pd(w1), y1), _mm256_mul_pd(_mm256_cvtps_pd(w2), y2)));
+  }
+  LinearResampleGeneric<wrap>(data, length, x, result, i, count);
+}
+
+#endif // J_MATH_SIMD_X86
+
+//
+// Runtime dispatch on the selected instruction set and index type
+//
+template<typename valuetype>
+void NearestNeighborResampleDispatch(const valuetype* data, size_t length, const float* x, valuetype* result, size_t count, IndexType index_type) {
+  if (index_type == IndexType::WRAP) { NearestNeighborResampleGeneric<true>(data, length, x, result, 0, count); } else { NearestNeighborResampleGeneric<false>(data, length, x, result, 0, count); }
+}
+template<typename valuetype>
+void LinearResampleDispatch(const valuetype* data, size_t length, const float* x, valuetype* result, size_t count, IndexType index_type) {
+  if (index_type == IndexType::WRAP) { LinearResampleGeneric<true>(data, length, x, result, 0, count); } else { LinearResampleGeneric<false>(data, length, x, result, 0, count); }
+}
+
+#if defined(J_MATH_SIMD_X86)
+// The vector kernels use 32-bit indices and convert positions with 32-bit conversions.
+#define J_MATH_INTERPOLATION_BATCH_DISPATCH(name, valuetype) \
+  inline void name##Dispatch(const valuetype* data, size_t length, const float* x, valuetype* result, size_t count, IndexType index_type) { \
+    bool wrap = (index_type == IndexType::WRAP); \
+    SimdLevel level = (length <= (size_t(1) << 30)) ? GetSimdLevel() : SimdLevel::SCALAR; \
+    switch (level) { \
+    case SimdLevel::AVX2: if (wrap) { name##Avx2<true>(data, length, x, result, count); } else { name##Avx2<false>(data, length, x, result, count); } return; \
+    case SimdLevel::SSE: if (wrap) { name##Sse<true>(data, length, x, result, count); } else { name##Sse<false>(data, length, x, result, count); } return; \
+    default: if (wrap) { name##Generic<true>(data, length, x, result, 0, count); } else { name##Generic<false>(data, length, x, result, 0, count); } return; \
+    } \
+  }
+J_MATH_INTERPOLATION_BATCH_DISPATCH(NearestNeighborResample, float)
+J_MATH_INTERPOLATION_BATCH_DISPATCH(NearestNeighborResample, double)
+J_MATH_INTERPOLATION_BATCH_DISPATCH(LinearResample, float)
+J_MATH_INTERPOLATION_BATCH_DISPATCH(LinearResample, double)
+#undef J_MATH_INTERPOLATION_BATCH_DISPATCH
+#endif // J_MATH_SIMD_X86
+
+template<bool linear, typename valuetype>
+void ResampleDispatch(const valuetype* data, size_t length, const float* x, valuetype* result, size_t count, IndexType index_type) {
+  if (linear) { LinearResampleDispatch(data, length, x, result, count, index_type); } else { NearestNeighborResampleDispatch(data, length, x, result, count, index_type); }
+}
+
+// Resamples at the positions start + i * step (computed in double, rounded to float) for i in [0, count), a block at a
+// time so no position array is needed.
+template<bool linear, typename valuetype>
+void ResampleUniform(const valuetype* data, size_t length, double start, double step, valuetype* result, size_t count, IndexType index_type) {
+  float x[kResampleBlockSize];
+  for (size_t begin = 0; begin < count; begin += kResampleBlockSize) {
+    size_t block = (count - begin < kResampleBlockSize) ? count - begin : kResampleBlockSize;
+    for (size_t i = 0; i < block; ++i) { x[i] = float(start + double(begin + i) * step); }
+    ResampleDispatch<linear>(data, length, x, result + begin, block, index_type);
+  }
+}
+
+} // namespace detail
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_INTERPOLATION_BATCH_H_
@@ -0,0 +1,176 @@
+#pragma once
+#ifndef J_MATH_INTERPOLATION_KERNEL_H_
+#define J_MATH_INTERPOLATION_KERNEL_H_
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "..\utility\pi.h"
+#include "interpolation_batch.h"
+#include "sequence.h"
+
+namespace j {
+namespace math {
+
+// Convolution kernels for interpolating a sequence from more than two neighboring samples.
+enum class InterpolationKernel {
+  CATMULL_ROM,     // Cubic Hermite spline with tangents from the neighboring samples (4 taps, passes through the samples)
+  CUBIC_B_SPLINE,  // Uniform cubic B-spline (4 taps, smooth but does not pass through the samples)
+  LANCZOS          // Windowed sinc with a Lanczos window of the given radius (2 * radius taps), normalized to unit gain
+};
+
+const size_t kDefaultLanczosRadius = 3;
+const size_t kMaxKernelRadius = 16;
+
+namespace detail {
+
+inline size_t KernelRadius(InterpolationKernel kernel, size_t lanczos_radius) {
+  if (kernel != InterpolationKernel::LANCZOS) { return 2; }
+  return (lanczos_radius < 1) ? 1 : ((lanczos_radius > kMaxKernelRadius) ? kMaxKernelRadius : lanczos_radius);
+}
+
+// Weights of the 2 * radius taps floor(x) - radius + 1, ..., floor(x) + radius for the fractional position t in [0, 1).
+inline void KernelWeights(InterpolationKernel kernel, size_t radius, double t, double* weights) {
+  switch (kernel) {
+  case InterpolationKernel::CATMULL_ROM: {
+    double t2 = t * t, t3 = t2 * t;
+    weights[0] = 0.5 * (-t3 + 2. * t2 - t);
+    weights[1] = 0.5 * (3. * t3 - 5. * t2 + 2.);
+    weights[2] = 0.5 * (-3. * t3 + 4. * t2 + t);
+    weights[3] = 0.5 * (t3 - t2);
+    return;
+  }
+  case InterpolationKernel::CUBIC_B_SPLINE: {
+    double t2 = t * t, t3 = t2 * t, u = 1. - t;
+    weights[0] = u * u * u / 6.;
+    weights[1] = (3. * t3 - 6. * t2 + 4.) / 6.;
+    weights[2] = (-3. * t3 + 3. * t2 + 3. * t + 1.) / 6.;
+    weights[3] = t3 / 6.;
+    return;
+  }
+  case InterpolationKernel::LANCZOS: {
+    size_t taps = 2 * radius;
+    if (t == 0.) {
+      for (size_t k = 0; k < taps; ++k) { weights[k] = (k + 1 == radius) ? 1. : 0.; }
+      return;
+    }
+    // sin(pi * (t - k)) = (-1)^k * sin(pi * t), so only the window needs a sine per tap.
+    const double pi = double(PI), a = double(radius);
+    double s = std::sin(pi * t), total = 0.;
+    for (size_t k = 0; k < taps; ++k) {
+      double d = t + double(radius) - 1. - double(k);  // Distance from tap k to the position
+      double sign = (((radius - 1 + k) & 1) == 0) ? 1. : -1.;
+      weights[k] = sign * s * a * std::sin(pi * d / a) / (pi * pi * d * d);
+      total += weights[k];
+    }
+    for (size_t k = 0; k < taps; ++k) { weights[k] /= total; }
+    return;
+  }
+  default:
+    for (size_t k = 0; k < 2 * radius; ++k) { weights[k] = 0.; }
+  }
+}
+
+template<typename valuetype>
+valuetype KernelValue(double v) { return std::is_integral<valuetype>::value ? valuetype(std::llround(v)) : valuetype(v); }
+
+// Weighted sum of the taps around index. Taps beyond the ends are only resolved per index type near the ends.
+template<bool wrap, typename valuetype>
+valuetype KernelSum(const valuetype* data, size_t length, size_t index, const double* weights, size_t radius) {
+  double sum = 0.;
+  size_t taps = 2 * radius;
+  if (index + 1 >= radius && index + radius < length) {
+    const valuetype* p = data + (index + 1 - radius);
+    for (size_t k = 0; k < taps; ++k) { sum += weights[k] * double(p[k]); }
+  } else {
+    ptrdiff_t first = ptrdiff_t(index) + 1 - ptrdiff_t(radius);
+    for (size_t k = 0; k < taps; ++k) { sum += weights[k] * double(data[ExtendedIndex<wrap>(first + ptrdiff_t(k), length)]); }
+  }
+  return KernelValue<valuetype>(sum);
+}
+
+// Sample index and fractional position of x, reduced into the sequence like in interpolation_batch.h.
+template<bool wrap>
+size_t KernelPosition(size_t length, float x, double* t) {
+  float p = ResamplePosition<wrap>(x, wrap ? float(length) : float(length - 1), float(length));
+  size_t index = size_t(p);
+  if (index >= length) { index = length - 1; }
+  *t = double(p) - double(index);
+  return index;
+}
+
+template<bool wrap, typename valuetype>
+void KernelResample(const valuetype* data, size_t length, const float* x, valuetype* result, size_t count, InterpolationKernel kernel, size_t radius) {
+  double weights[2 * kMaxKernelRadius];
+  for (size_t i = 0; i < count; ++i) {
+    double t;
+    size_t index = KernelPosition<wrap>(length, x[i], &t);
+    KernelWeights(kernel, radius, t, weights);
+    result[i] = KernelSum<wrap>(data, length, index, weights, radius);
+  }
+}
+
+} // namespace detail
+
+// Kernel weights precomputed for phase_count equally spaced fractional positions p / phase_count. Resampling with a
+// table looks the weights up instead of evaluating the kernel, rounding each position to the nearest phase; for a
+// rational rate change up / down the positions fall exactly on the phases of a table with up phases (polyphase
+// resampling).
+class InterpolationTable {
+public:
+  // Constructors
+  InterpolationTable(InterpolationKernel kernel, size_t phase_count, size_t lanczos_radius = kDefaultLanczosRadius)
+      : kernel_{ kernel }, radius_{ detail::KernelRadius(kernel, lanczos_radius) }, phase_count_{ (phase_count < 1) ? 1 : phase_count } {
+    weights_.resize(phase_count_ * Taps());
+    for (size_t p = 0; p < phase_count_; ++p) { detail::KernelWeights(kernel_, radius_, double(p) / double(phase_count_), &weights_[p * Taps()]); }
+  }
+  InterpolationTable(const InterpolationTable&) = default;
+  ~InterpolationTable() = default;
+
+  // Operators
+  InterpolationTable& operator=(const InterpolationTable&) = default;
+
+  // Table-specific operations
+  InterpolationKernel Kernel() const { return kernel_; }
+  size_t Radius() const { return radius_; }
+  size_t Taps() const { return 2 * radius_; }
+  size_t PhaseCount() const { return phase_count_; }
+  // Weights of the taps floor(x) - Radius() + 1, ..., floor(x) + Radius() for the fractional position phase / PhaseCount().
+  const double* Weights(size_t phase) const { return &weights_[phase * Taps()]; }
+
+  // Resamples at the positions x (see Interpolation::KernelResample).
+  template<bool wrap, typename valuetype>
+  void Resample(const valuetype* data, size_t length, const float* x, valuetype* result, size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+      double t;
+      size_t index = detail::KernelPosition<wrap>(length, x[i], &t);
+      size_t phase = size_t(t * double(phase_count_) + 0.5);
+      if (phase == phase_count_) { ++index; phase = 0; }
+      result[i] = detail::KernelSum<wrap>(data, length, index, Weights(phase), radius_);
+    }
+  }
+  // Resamples at the positions i * down / PhaseCount() for i in [0, count), using integer positions only.
+  template<bool wrap, typename valuetype>
+  void ResampleRational(const valuetype* data, size_t length, size_t down, valuetype* result, size_t count) const {
+    size_t index = 0, phase = 0, index_step = down / phase_count_, phase_step = down % phase_count_;
+    for (size_t i = 0; i < count; ++i) {
+      result[i] = detail::KernelSum<wrap>(data, length, index, Weights(phase), radius_);
+      index += index_step;
+      phase += phase_step;
+      if (phase >= phase_count_) { phase -= phase_count_; ++index; }
+      if (wrap && index >= length) { index %= length; }
+    }
+  }
+
+private:
+  InterpolationKernel kernel_;
+  size_t radius_;
+  size_t phase_count_;
+  std::vector<double> weights_;
+};
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_INTERPOLATION_KERNEL_H_
@@ -0,0 +1,97 @@
+#pragma once
+#ifndef J_MATH_MAPPED_SEQUENCE_H_
+#define J_MATH_MAPPED_SEQUENCE_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "..\utility\mapped_file.h"
+#include "sequence.h"
+#include "sequence_reduction.h"
+
+namespace j {
+namespace math {
+
+// One-dimensional sequence of values stored in a raw binary file (native byte order, no header after offset_bytes) and
+// mapped into memory instead of being read. Only the pages that are accessed are loaded, so captures larger than the
+// available memory can be processed with the same element access and reductions as Sequence1D.
+//
+// The sequence is empty when the file cannot be mapped (see IsOpen). A trailing partial element is ignored. offset_bytes
+// should be a multiple of sizeof(valuetype) to keep the values aligned.
+template<typename valuetype>
+class MappedSequence1D {
+public:
+  // Constructors
+  MappedSequence1D() = default;
+  MappedSequence1D(const std::string& path, MapMode mode = MapMode::READ_ONLY, size_t offset_bytes = 0) { Open(path, mode, offset_bytes); }
+  MappedSequence1D(const MappedSequence1D&) = delete;
+  MappedSequence1D(MappedSequence1D&& other) { *this = std::move(other); }
+  ~MappedSequence1D() = default;
+
+  // Operators
+  MappedSequence1D& operator=(const MappedSequence1D&) = delete;
+  // Leaves other closed and empty, like Close.
+  MappedSequence1D& operator=(MappedSequence1D&& other) {
+    if (this != &other) {
+      file_ = std::move(other.file_);
+      offset_ = other.offset_;
+      length_ = other.length_;
+      other.offset_ = 0;
+      other.length_ = 0;
+    }
+    return *this;
+  }
+  valuetype operator()(const size_t& i) const { return Get(i); }
+
+  // Cast to different valuetype (copies the values into memory)
+  template<typename other_valuetype> operator Sequence1D<other_valuetype>() const { return Sequence1D<other_valuetype>(std::vector<other_valuetype>(Ptr(), Ptr() + Length())); }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const MappedSequence1D<valuetype>& sequence) { return os << "MappedSequence1D(length=" << sequence.Length() << ")"; }
+
+  // Sequence-specific operations
+  bool Open(const std::string& path, MapMode mode = MapMode::READ_ONLY, size_t offset_bytes = 0) {
+    offset_ = 0;
+    length_ = 0;
+    if (!file_.Open(path, mode)) { return false; }
+    if (file_.Size() > offset_bytes) {
+      offset_ = offset_bytes;
+      length_ = (file_.Size() - offset_bytes) / sizeof(valuetype);
+    }
+    return true;
+  }
+  void Close() { file_.Close(); offset_ = 0; length_ = 0; }
+  bool IsOpen() const { return file_.IsOpen(); }
+  valuetype Get(const size_t& index, IndexType index_type = IndexType::CLAMP) const { return Ptr()[detail::ConvertIndex(index, length_, index_type)]; }
+  // Only for sequences opened with MapMode::COPY_ON_WRITE; returns false (and changes nothing) for read-only mappings
+  // and empty sequences. The file itself is never modified.
+  bool Set(const size_t& index, const valuetype& data, IndexType index_type = IndexType::CLAMP) {
+    if (!file_.IsWritable() || length_ == 0) { return false; }
+    Ptr()[detail::ConvertIndex(index, length_, index_type)] = data;
+    return true;
+  }
+  // Direct access to the mapped values. Writing through the non-const pointer requires MapMode::COPY_ON_WRITE: the pages
+  // of a read-only mapping are protected, so a write crashes the program.
+  const valuetype* Ptr() const { return reinterpret_cast<const valuetype*>(static_cast<const char*>(file_.Data()) + offset_); }
+  valuetype* Ptr() { return reinterpret_cast<valuetype*>(static_cast<char*>(file_.Data()) + offset_); }
+  size_t Length() const { return length_; }
+  // Reductions, see Sequence1D.
+  valuetype Sum(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return ReduceSum(Ptr(), length_, policy, thread_count); }
+  valuetype SumOfSquares(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return ReduceSumOfSquares(Ptr(), length_, policy, thread_count); }
+  valuetype Average(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return Sum(policy, thread_count) / valuetype(Length()); }
+  SequenceStatistics<valuetype> Statistics(size_t thread_count = 1) const { return ReduceStatistics(Ptr(), length_, thread_count); }
+
+private:
+  MappedFile file_;
+  size_t offset_ = 0;
+  size_t length_ = 0;
+};
+
+using mseq1i = MappedSequence1D<int>;
+using mseq1f = MappedSequence1D<float>;
+using mseq1d = MappedSequence1D<double>;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_MAPPED_SEQUENCE_H_
@@ -0,0 +1,123 @@
+#pragma once
+#ifndef J_MATH_PREFIX_SUM_H_
+#define J_MATH_PREFIX_SUM_H_
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "..\utility\parallel.h"
+#include "sequence_reduction.h"
+
+namespace j {
+namespace math {
+
+// Prefix sums (running totals) of arrays and summed-area tables of two-dimensional grids, which answer sums over any
+// range or rectangle in constant time: the sum of data[begin, end) is prefix[end] - prefix[begin].
+//
+// Totals are accumulated in double (long long for integral values), so that the difference of two large totals keeps
+// the precision of a short range. The scan runs in blocks of kReductionChunkSize elements: every block is scanned on
+// its own, in parallel, and then offset by the total of the blocks before it. The block boundaries are fixed, so the
+// result does not depend on the thread count.
+
+template<typename valuetype>
+using PrefixSumType = typename std::conditional<std::is_floating_point<valuetype>::value, typename std::common_type<valuetype, double>::type, long long>::type;
+
+namespace detail {
+
+template<bool square, typename valuetype, typename accumulator>
+accumulator ScanBlock(const valuetype* data, size_t begin, size_t end, accumulator* prefix) {
+  accumulator sum = accumulator(0);
+  for (size_t i = begin; i < end; ++i) {
+    accumulator v = accumulator(data[i]);
+    sum += square ? v * v : v;
+    prefix[i + 1] = sum;
+  }
+  return sum;
+}
+
+// Lazily built table, shared between copies of a sequence. Invalidate only counts the modifications, which keeps it
+// cheap enough for every Add or Set; a query rebuilds the table when it was built before the last modification.
+// Queries may build the table concurrently, in which case the last one stored is kept.
+template<typename accumulator>
+class PrefixSumCache {
+public:
+  struct Table {
+    size_t version_;
+    std::vector<accumulator> values_;
+  };
+
+  template<typename function>
+  std::shared_ptr<const Table> Get(function build) const {
+    std::shared_ptr<const Table> table = std::atomic_load(&table_);
+    if (!table || table->version_ != version_) {
+      table = std::make_shared<const Table>(Table{ version_, build() });
+      std::atomic_store(&table_, table);
+    }
+    return table;
+  }
+  void Invalidate() { ++version_; }
+
+private:
+  size_t version_ = 0;
+  mutable std::shared_ptr<const Table> table_;
+};
+
+} // namespace detail
+
+// prefix[0] = 0 and prefix[i + 1] = prefix[i] + data[i] (data[i]^2 when square is set), length + 1 values in total.
+// A thread_count other than 1 splits long arrays over threads (0 uses all hardware threads).
+template<typename valuetype>
+void ComputePrefixSums(const valuetype* data, size_t length, PrefixSumType<valuetype>* prefix, bool square = false, size_t thread_count = 1) {
+  using accumulator = PrefixSumType<valuetype>;
+  const size_t block_size = detail::kReductionChunkSize;
+  prefix[0] = accumulator(0);
+  size_t blocks = (length + block_size - 1) / block_size;
+  std::vector<accumulator> offsets(blocks);
+  size_t threads = detail::ReductionThreadCount(length, thread_count);
+  ParallelFor(blocks, threads, 1, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; ++b) {
+      size_t last = (b + 1 < blocks) ? (b + 1) * block_size : length;
+      offsets[b] = square ? detail::ScanBlock<true>(data, b * block_size, last, prefix) : detail::ScanBlock<false>(data, b * block_size, last, prefix);
+    }
+  });
+  accumulator total = accumulator(0);
+  for (accumulator& offset : offsets) { accumulator block_total = offset; offset = total; total += block_total; }
+  ParallelFor(blocks, threads, 1, [&](size_t begin, size_t end) {
+    for (size_t b = (begin > 0) ? begin : 1; b < end; ++b) {
+      size_t last = (b + 1 < blocks) ? (b + 1) * block_size : length;
+      for (size_t i = b * block_size; i < last; ++i) { prefix[i + 1] += offsets[b]; }
+    }
+  });
+}
+
+// Summed-area table of a width x height grid given in row-major order: table[y * (width + 1) + x] is the sum of the
+// elements left of column x and above row y, (width + 1) * (height + 1) values in total. Rows are scanned in parallel,
+// then columns.
+template<typename valuetype>
+void ComputeSummedAreaTable(const valuetype* data, size_t width, size_t height, PrefixSumType<valuetype>* table, bool square = false, size_t thread_count = 1) {
+  using accumulator = PrefixSumType<valuetype>;
+  size_t stride = width + 1;
+  for (size_t x = 0; x < stride; ++x) { table[x] = accumulator(0); }
+  size_t threads = detail::ReductionThreadCount(width * height, thread_count);
+  ParallelFor(height, threads, 1, [&](size_t begin, size_t end) {
+    for (size_t y = begin; y < end; ++y) {
+      accumulator* row = table + (y + 1) * stride;
+      row[0] = accumulator(0);
+      if (square) { detail::ScanBlock<true>(data + y * width, 0, width, row); } else { detail::ScanBlock<false>(data + y * width, 0, width, row); }
+    }
+  });
+  // Each thread adds the rows above for its own range of columns, moving down the table row by row.
+  ParallelFor(stride, threads, 64, [&](size_t begin, size_t end) {
+    for (size_t y = 1; y < height; ++y) {
+      const accumulator* above = table + y * stride;
+      accumulator* row = table + (y + 1) * stride;
+      for (size_t x = begin; x < end; ++x) { row[x] += above[x]; }
+    }
+  });
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_PREFIX_SUM_H_
@@ -2,9 +2,13 @@
 #ifndef J_MATH_SEQUENCE_H_
 #define J_MATH_SEQUENCE_H_
 
+#include <cstddef>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <sstream>
-#include "..\utility\clamp.h"
+#include "prefix_sum.h"
+#include "sequence_reduction.h"
 
 namespace j {
 namespace math {
@@ -15,19 +19,52 @@ enum class IndexType {
   WRAP
 };
 
-// One-dimensional sequence of values.
-template<typename valuetype>
+namespace detail {
+
+// Index into a sequence of the given (non-zero) size.
+inline size_t ConvertIndex(const size_t& i, const size_t& size, IndexType index_type) {
+  switch(index_type) {
+  case IndexType::CLAMP:
+    return (i < size) ? i : size - 1;
+  case IndexType::WRAP:
+    return i % size;
+  default: 
+    return 0;
+  }
+}
+
+// Index into a sequence of the given (non-zero) size for a signed index that may lie before the start, with the
+// index type fixed at compile time for loops over many indices.
+template<bool wrap>
+size_t ExtendedIndex(ptrdiff_t i, size_t size) {
+  if (wrap) {
+    ptrdiff_t n = ptrdiff_t(size), r = i % n;
+    return size_t((r < 0) ? r + n : r);
+  }
+  return (i < 0) ? 0 : ((size_t(i) >= size) ? size - 1 : size_t(i));
+}
+
+} // namespace detail
+
+// One-dimensional sequence of values. The allocator of the storage can be replaced, e.g. by an ArenaAllocator or
+// PoolAllocator (see allocator.h) for sequences that are built and dropped every frame; copies use the same allocator.
+template<typename valuetype, typename allocator = std::allocator<valuetype>>
 struct Sequence1D {
+  using storage_type = std::vector<valuetype, allocator>;
+
   // Constructors
-  Sequence1D() : data_{ std::vector<valuetype>() } { }
+  Sequence1D() : data_{ storage_type() } { }
+  explicit Sequence1D(const allocator& alloc) : data_{ alloc } { }
   Sequence1D(const Sequence1D&) = default;
-  Sequence1D(const std::vector<valuetype>& data) : data_{ data } { }
+  template<typename other_allocator> Sequence1D(const Sequence1D<valuetype, other_allocator>& other, const allocator& alloc) : data_(other.Ptr(), other.Ptr() + other.Length(), alloc) { }
+  Sequence1D(const std::vector<valuetype>& data, const allocator& alloc = allocator()) : data_(data.begin(), data.end(), alloc) { }
+  Sequence1D(storage_type&& data) : data_{ std::move(data) } { }
   ~Sequence1D() = default;
 
   // Operators
   Sequence1D& operator=(const Sequence1D& other) = default;
-  bool operator==(const Sequence1D<valuetype>& other) const { return data_ == other.data_; }
-  bool operator!=(const Sequence1D<valuetype>& other) const { return data_ != other.data_; }
+  bool operator==(const Sequence1D& other) const { return data_ == other.data_; }
+  bool operator!=(const Sequence1D& other) const { return data_ != other.data_; }
   // Sequence1D operator+(const Sequence1D<valuetype>& vector) const { return Line2D(p_ + vector, v_); }
   // Sequence1D operator-(const Sequence1D<valuetype>& vector) const { return Line2D(p_ - vector, v_); }
   // void operator+=(const Vector2D<valuetype>& vector) { p_ += vector; }
@@ -35,13 +72,13 @@ struct Sequence1D {
   valuetype operator()(const size_t& i) const { return Get(i); }
 
   // Cast to different valuetype
-  template<typename other_valuetype> operator Sequence1D<other_valuetype>() const { return Sequence1D<other_valuetype>(other_valuetype(data_)); }
+  template<typename other_valuetype> operator Sequence1D<other_valuetype>() const { return Sequence1D<other_valuetype>(std::vector<other_valuetype>(data_.begin(), data_.end())); }
 
   // String conversion
-  friend std::ostream& operator<<(std::ostream &os, const Sequence1D<valuetype>& sequence) { 
+  friend std::ostream& operator<<(std::ostream &os, const Sequence1D& sequence) { 
     std::stringstream ss;
     ss << "Sequence1D(";
-    for (valuetype d : data_) { ss << d << ", "; }
+    for (valuetype d : sequence.data_) { ss << d << ", "; }
     ss.unget();
     ss.unget();
     ss << ")";
@@ -50,28 +87,62 @@ struct Sequence1D {
   }
 
   // Sequence-specific operations
-  void Add(const valuetype& data) { data_.push_back(data); }
+  void Add(const valuetype& data) { data_.push_back(data); InvalidatePrefixSums(); }
   valuetype Get(const size_t& index, IndexType index_type = IndexType::CLAMP) const { return data_[(ConvertIndex(index, index_type))]; }
-  void Set(const size_t& index, const valuetype& data, IndexType index_type = IndexType::CLAMP) const { data_[(ConvertIndex(index, index_type))] = data; }
-  valuetype* Ptr() { return &data_[0]; }
+  void Set(const size_t& index, const valuetype& data, IndexType index_type = IndexType::CLAMP) { data_[(ConvertIndex(index, index_type))] = data; InvalidatePrefixSums(); }
+  // Writes through the returned pointer are only seen by range queries made after this call.
+  valuetype* Ptr() { InvalidatePrefixSums(); return &data_[0]; }
+  const valuetype* Ptr() const { return data_.data(); }
   size_t Length() const { return data_.size(); }
-  valuetype Sum() const { valuetype s{ 0 }; for (auto d : data_) { s += d; } return s; }
-  valuetype SumOfSquares() const { valuetype s{ 0 }; for (auto d : data_) { s += d * d; } return s; }
-  valuetype Average() const { valuetype s{ 0 }; for (auto d : data_) { s += d; } return s / Length(); }
+  // Growing a sequence by Add reallocates its storage; with an ArenaAllocator the old storage is only reclaimed by the
+  // next Reset of the arena, so reserve the final length up front where it is known.
+  void Reserve(size_t length) { data_.reserve(length); }
+  void Clear() { data_.clear(); InvalidatePrefixSums(); }
+  allocator GetAllocator() const { return data_.get_allocator(); }
+  // Reductions, see sequence_reduction.h. A thread_count other than 1 splits long sequences over threads (0 uses all
+  // hardware threads) without changing the result.
+  valuetype Sum(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return ReduceSum(data_.data(), data_.size(), policy, thread_count); }
+  valuetype SumOfSquares(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return ReduceSumOfSquares(data_.data(), data_.size(), policy, thread_count); }
+  valuetype Average(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return Sum(policy, thread_count) / valuetype(Length()); }
+  // Sum, mean, variance, minimum and maximum in a single pass.
+  SequenceStatistics<valuetype> Statistics(size_t thread_count = 1) const { return ReduceStatistics(data_.data(), data_.size(), thread_count); }
+  // Range queries over [begin, end) (clamped to the sequence) in constant time, see prefix_sum.h. The prefix sums are
+  // built by the first query after a modification, or ahead of time by BuildPrefixSums, and kept until the next Add,
+  // Set or non-const Ptr(). Long sequences are split over all hardware threads unless BuildPrefixSums is told otherwise.
+  valuetype Sum(size_t begin, size_t end) const { return valuetype(RangeTotal(prefix_sums_, false, begin, end)); }
+  valuetype SumOfSquares(size_t begin, size_t end) const { return valuetype(RangeTotal(prefix_squares_, true, begin, end)); }
+  valuetype Average(size_t begin, size_t end) const {
+    ClampRange(&begin, &end);
+    return (end > begin) ? valuetype(RangeTotal(prefix_sums_, false, begin, end) / PrefixSumType<valuetype>(end - begin)) : valuetype(0);
+  }
+  void BuildPrefixSums(bool squares = false, size_t thread_count = 0) const { PrefixSums(squares ? prefix_squares_ : prefix_sums_, squares, thread_count); }
 
 private:
-  static size_t ConvertIndex(const size_t& i, IndexType index_type) {
-    switch(index_type) {
-    case IndexType::CLAMP:
-		  return j::math::clamp(i, 0, data_.size());
-    case IndexType::WRAP:
-      return i % data_.size();
-    default: 
-      return 0;
-    }
+  using PrefixSumCache = detail::PrefixSumCache<PrefixSumType<valuetype>>;
+
+  size_t ConvertIndex(const size_t& i, IndexType index_type) const { return detail::ConvertIndex(i, data_.size(), index_type); }
+  void InvalidatePrefixSums() { prefix_sums_.Invalidate(); prefix_squares_.Invalidate(); }
+  std::shared_ptr<const typename PrefixSumCache::Table> PrefixSums(const PrefixSumCache& cache, bool square, size_t thread_count) const {
+    return cache.Get([&]() {
+      std::vector<PrefixSumType<valuetype>> prefix(data_.size() + 1);
+      ComputePrefixSums(data_.data(), data_.size(), prefix.data(), square, thread_count);
+      return prefix;
+    });
+  }
+  void ClampRange(size_t* begin, size_t* end) const {
+    if (*end > data_.size()) { *end = data_.size(); }
+    if (*begin > *end) { *begin = *end; }
+  }
+  PrefixSumType<valuetype> RangeTotal(const PrefixSumCache& cache, bool square, size_t begin, size_t end) const {
+    ClampRange(&begin, &end);
+    if (end == begin) { return PrefixSumType<valuetype>(0); }
+    std::shared_ptr<const typename PrefixSumCache::Table> prefix = PrefixSums(cache, square, 0);
+    return prefix->values_[end] - prefix->values_[begin];
   }
 
-  std::vector<valuetype> data_;
+  storage_type data_;
+  PrefixSumCache prefix_sums_;
+  PrefixSumCache prefix_squares_;
 };
 
 using seq1i = Sequence1D<int>;
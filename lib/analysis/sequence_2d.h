@@ -0,0 +1,146 @@
+#pragma once
+#ifndef J_MATH_SEQUENCE_2D_H_
+#define J_MATH_SEQUENCE_2D_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <sstream>
+#include "grid_layout.h"
+#include "prefix_sum.h"
+#include "sequence.h"
+
+namespace j {
+namespace math {
+
+// Two-dimensional grid of values (e.g. an image), stored contiguously in one of the layouts of grid_layout.h.
+// Element (x, y) lies in column x < Width() and row y < Height(); row-major indices are y * Width() + x.
+template<typename valuetype>
+struct Sequence2D {
+  // Constructors
+  Sequence2D() : Sequence2D(0, 0) { }
+  Sequence2D(const Sequence2D&) = default;
+  Sequence2D(size_t width, size_t height, GridLayout layout = GridLayout::ROW_MAJOR, const valuetype& value = valuetype(0))
+      : indexer_{ width, height, 1, layout, kGridTileSize2D, 1 } {
+    data_.assign(indexer_.StorageSize(), valuetype(0));
+    if (value != valuetype(0)) { for (size_t y = 0; y < height; ++y) { for (size_t x = 0; x < width; ++x) { data_[indexer_.Offset(x, y, 0)] = value; } } }
+  }
+  // Values in row-major order; missing values are zero, surplus values are ignored.
+  Sequence2D(size_t width, size_t height, const std::vector<valuetype>& data, GridLayout layout = GridLayout::ROW_MAJOR) : Sequence2D(width, height, layout) {
+    if (Length() == 0) { return; }
+    indexer_.ScatterRowMajor(data.data(), 0, (data.size() < Length()) ? data.size() : Length(), data_.data());
+  }
+  // Copy of other in a different layout.
+  Sequence2D(const Sequence2D& other, GridLayout layout) : Sequence2D(other.Width(), other.Height(), other.RowMajorData(), layout) { }
+  ~Sequence2D() = default;
+
+  // Operators
+  Sequence2D& operator=(const Sequence2D& other) = default;
+  // Equal when size and values are, whatever the layouts.
+  bool operator==(const Sequence2D<valuetype>& other) const {
+    if (Width() != other.Width() || Height() != other.Height()) { return false; }
+    return (Layout() == other.Layout()) ? data_ == other.data_ : RowMajorData() == other.RowMajorData();
+  }
+  bool operator!=(const Sequence2D<valuetype>& other) const { return !(*this == other); }
+  valuetype operator()(const size_t& x, const size_t& y) const { return Get(x, y); }
+
+  // Cast to different valuetype
+  template<typename other_valuetype> operator Sequence2D<other_valuetype>() const {
+    std::vector<valuetype> data = RowMajorData();
+    return Sequence2D<other_valuetype>(Width(), Height(), std::vector<other_valuetype>(data.begin(), data.end()), Layout());
+  }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const Sequence2D<valuetype>& sequence) {
+    std::stringstream ss;
+    ss << "Sequence2D(";
+    for (size_t y = 0; y < sequence.Height(); ++y) {
+      ss << ((y > 0) ? ", (" : "(");
+      for (size_t x = 0; x < sequence.Width(); ++x) { ss << ((x > 0) ? ", " : "") << sequence.Get(x, y); }
+      ss << ")";
+    }
+    ss << ")";
+    std::string result = ss.str();
+    return os << result;
+  }
+
+  // Sequence-specific operations
+  valuetype Get(const size_t& x, const size_t& y, IndexType index_type = IndexType::CLAMP) const { return data_[Offset(x, y, index_type)]; }
+  void Set(const size_t& x, const size_t& y, const valuetype& data, IndexType index_type = IndexType::CLAMP) { data_[Offset(x, y, index_type)] = data; InvalidateSummedAreaTables(); }
+  size_t Width() const { return indexer_.Size(0); }
+  size_t Height() const { return indexer_.Size(1); }
+  size_t Length() const { return indexer_.Length(); }
+  GridLayout Layout() const { return indexer_.Layout(); }
+  // Storage, StorageSize() elements in the order of Layout(). Elements not in the grid (padding) are zero. Writes
+  // through the returned pointer are only seen by rectangle queries made after this call.
+  valuetype* Ptr() { InvalidateSummedAreaTables(); return data_.data(); }
+  const valuetype* Ptr() const { return data_.data(); }
+  size_t StorageSize() const { return data_.size(); }
+  // Offset in the storage of the element (x, y).
+  size_t Offset(const size_t& x, const size_t& y, IndexType index_type = IndexType::CLAMP) const {
+    return indexer_.Offset(detail::ConvertIndex(x, Width(), index_type), detail::ConvertIndex(y, Height(), index_type), 0);
+  }
+  std::vector<valuetype> RowMajorData() const {
+    std::vector<valuetype> result(Length());
+    indexer_.GatherRowMajor(data_.data(), 0, Length(), result.data());
+    return result;
+  }
+  // Reductions in row-major order, see sequence_reduction.h; the results do not depend on the layout. A thread_count
+  // other than 1 splits large grids over threads (0 uses all hardware threads) without changing the result.
+  valuetype Sum(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return detail::GridSum(indexer_, data_.data(), false, policy, thread_count); }
+  valuetype SumOfSquares(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return detail::GridSum(indexer_, data_.data(), true, policy, thread_count); }
+  valuetype Average(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return Sum(policy, thread_count) / valuetype(Length()); }
+  // Sum, mean, variance, minimum and maximum in a single pass; argmin_ and argmax_ are row-major indices.
+  SequenceStatistics<valuetype> Statistics(size_t thread_count = 1) const { return detail::GridStatistics(indexer_, data_.data(), thread_count); }
+  // Rectangle queries over [x0, x1) x [y0, y1) (clamped to the grid) in constant time from summed-area tables, see
+  // prefix_sum.h. The tables are built and kept like the prefix sums of Sequence1D.
+  valuetype Sum(size_t x0, size_t y0, size_t x1, size_t y1) const { return valuetype(RectangleTotal(summed_areas_, false, x0, y0, x1, y1)); }
+  valuetype SumOfSquares(size_t x0, size_t y0, size_t x1, size_t y1) const { return valuetype(RectangleTotal(summed_squares_, true, x0, y0, x1, y1)); }
+  valuetype Average(size_t x0, size_t y0, size_t x1, size_t y1) const {
+    ClampRectangle(&x0, &y0, &x1, &y1);
+    size_t count = (x1 - x0) * (y1 - y0);
+    return (count > 0) ? valuetype(RectangleTotal(summed_areas_, false, x0, y0, x1, y1) / PrefixSumType<valuetype>(count)) : valuetype(0);
+  }
+  void BuildSummedAreaTables(bool squares = false, size_t thread_count = 0) const { SummedAreas(squares ? summed_squares_ : summed_areas_, squares, thread_count); }
+
+private:
+  using PrefixSumCache = detail::PrefixSumCache<PrefixSumType<valuetype>>;
+
+  void InvalidateSummedAreaTables() { summed_areas_.Invalidate(); summed_squares_.Invalidate(); }
+  std::shared_ptr<const typename PrefixSumCache::Table> SummedAreas(const PrefixSumCache& cache, bool square, size_t thread_count) const {
+    return cache.Get([&]() {
+      std::vector<PrefixSumType<valuetype>> table((Width() + 1) * (Height() + 1));
+      if (Layout() == GridLayout::ROW_MAJOR) { ComputeSummedAreaTable(data_.data(), Width(), Height(), table.data(), square, thread_count); }
+      else { ComputeSummedAreaTable(RowMajorData().data(), Width(), Height(), table.data(), square, thread_count); }
+      return table;
+    });
+  }
+  void ClampRectangle(size_t* x0, size_t* y0, size_t* x1, size_t* y1) const {
+    if (*x1 > Width()) { *x1 = Width(); }
+    if (*y1 > Height()) { *y1 = Height(); }
+    if (*x0 > *x1) { *x0 = *x1; }
+    if (*y0 > *y1) { *y0 = *y1; }
+  }
+  PrefixSumType<valuetype> RectangleTotal(const PrefixSumCache& cache, bool square, size_t x0, size_t y0, size_t x1, size_t y1) const {
+    ClampRectangle(&x0, &y0, &x1, &y1);
+    if (x0 == x1 || y0 == y1) { return PrefixSumType<valuetype>(0); }
+    std::shared_ptr<const typename PrefixSumCache::Table> table = SummedAreas(cache, square, 0);
+    const PrefixSumType<valuetype>* t = table->values_.data();
+    size_t stride = Width() + 1;
+    return (t[y1 * stride + x1] - t[y0 * stride + x1]) - (t[y1 * stride + x0] - t[y0 * stride + x0]);
+  }
+
+  detail::GridIndexer indexer_;
+  std::vector<valuetype> data_;
+  PrefixSumCache summed_areas_;
+  PrefixSumCache summed_squares_;
+};
+
+using seq2i = Sequence2D<int>;
+using seq2f = Sequence2D<float>;
+using seq2d = Sequence2D<double>;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SEQUENCE_2D_H_
@@ -0,0 +1,114 @@
+#pragma once
+#ifndef J_MATH_SEQUENCE_3D_H_
+#define J_MATH_SEQUENCE_3D_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <sstream>
+#include "grid_layout.h"
+#include "sequence.h"
+
+namespace j {
+namespace math {
+
+// Three-dimensional grid of values (e.g. a voxel volume), stored contiguously in one of the layouts of grid_layout.h.
+// Element (x, y, z) lies in column x < Width(), row y < Height() and slice z < Depth(); row-major indices are
+// (z * Height() + y) * Width() + x.
+template<typename valuetype>
+struct Sequence3D {
+  // Constructors
+  Sequence3D() : Sequence3D(0, 0, 0) { }
+  Sequence3D(const Sequence3D&) = default;
+  Sequence3D(size_t width, size_t height, size_t depth, GridLayout layout = GridLayout::ROW_MAJOR, const valuetype& value = valuetype(0))
+      : indexer_{ width, height, depth, layout, kGridTileSize3D, kGridTileSize3D } {
+    data_.assign(indexer_.StorageSize(), valuetype(0));
+    if (value != valuetype(0)) {
+      for (size_t z = 0; z < depth; ++z) { for (size_t y = 0; y < height; ++y) { for (size_t x = 0; x < width; ++x) { data_[indexer_.Offset(x, y, z)] = value; } } }
+    }
+  }
+  // Values in row-major order; missing values are zero, surplus values are ignored.
+  Sequence3D(size_t width, size_t height, size_t depth, const std::vector<valuetype>& data, GridLayout layout = GridLayout::ROW_MAJOR) : Sequence3D(width, height, depth, layout) {
+    if (Length() == 0) { return; }
+    indexer_.ScatterRowMajor(data.data(), 0, (data.size() < Length()) ? data.size() : Length(), data_.data());
+  }
+  // Copy of other in a different layout.
+  Sequence3D(const Sequence3D& other, GridLayout layout) : Sequence3D(other.Width(), other.Height(), other.Depth(), other.RowMajorData(), layout) { }
+  ~Sequence3D() = default;
+
+  // Operators
+  Sequence3D& operator=(const Sequence3D& other) = default;
+  // Equal when size and values are, whatever the layouts.
+  bool operator==(const Sequence3D<valuetype>& other) const {
+    if (Width() != other.Width() || Height() != other.Height() || Depth() != other.Depth()) { return false; }
+    return (Layout() == other.Layout()) ? data_ == other.data_ : RowMajorData() == other.RowMajorData();
+  }
+  bool operator!=(const Sequence3D<valuetype>& other) const { return !(*this == other); }
+  valuetype operator()(const size_t& x, const size_t& y, const size_t& z) const { return Get(x, y, z); }
+
+  // Cast to different valuetype
+  template<typename other_valuetype> operator Sequence3D<other_valuetype>() const {
+    std::vector<valuetype> data = RowMajorData();
+    return Sequence3D<other_valuetype>(Width(), Height(), Depth(), std::vector<other_valuetype>(data.begin(), data.end()), Layout());
+  }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const Sequence3D<valuetype>& sequence) {
+    std::stringstream ss;
+    ss << "Sequence3D(";
+    for (size_t z = 0; z < sequence.Depth(); ++z) {
+      ss << ((z > 0) ? ", (" : "(");
+      for (size_t y = 0; y < sequence.Height(); ++y) {
+        ss << ((y > 0) ? ", (" : "(");
+        for (size_t x = 0; x < sequence.Width(); ++x) { ss << ((x > 0) ? ", " : "") << sequence.Get(x, y, z); }
+        ss << ")";
+      }
+      ss << ")";
+    }
+    ss << ")";
+    std::string result = ss.str();
+    return os << result;
+  }
+
+  // Sequence-specific operations
+  valuetype Get(const size_t& x, const size_t& y, const size_t& z, IndexType index_type = IndexType::CLAMP) const { return data_[Offset(x, y, z, index_type)]; }
+  void Set(const size_t& x, const size_t& y, const size_t& z, const valuetype& data, IndexType index_type = IndexType::CLAMP) { data_[Offset(x, y, z, index_type)] = data; }
+  size_t Width() const { return indexer_.Size(0); }
+  size_t Height() const { return indexer_.Size(1); }
+  size_t Depth() const { return indexer_.Size(2); }
+  size_t Length() const { return indexer_.Length(); }
+  GridLayout Layout() const { return indexer_.Layout(); }
+  // Storage, StorageSize() elements in the order of Layout(). Elements not in the grid (Morton padding) are zero.
+  valuetype* Ptr() { return data_.data(); }
+  const valuetype* Ptr() const { return data_.data(); }
+  size_t StorageSize() const { return data_.size(); }
+  // Offset in the storage of the element (x, y, z).
+  size_t Offset(const size_t& x, const size_t& y, const size_t& z, IndexType index_type = IndexType::CLAMP) const {
+    return indexer_.Offset(detail::ConvertIndex(x, Width(), index_type), detail::ConvertIndex(y, Height(), index_type), detail::ConvertIndex(z, Depth(), index_type));
+  }
+  std::vector<valuetype> RowMajorData() const {
+    std::vector<valuetype> result(Length());
+    indexer_.GatherRowMajor(data_.data(), 0, Length(), result.data());
+    return result;
+  }
+  // Reductions in row-major order, see sequence_reduction.h; the results do not depend on the layout. A thread_count
+  // other than 1 splits large volumes over threads (0 uses all hardware threads) without changing the result.
+  valuetype Sum(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return detail::GridSum(indexer_, data_.data(), false, policy, thread_count); }
+  valuetype SumOfSquares(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return detail::GridSum(indexer_, data_.data(), true, policy, thread_count); }
+  valuetype Average(SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) const { return Sum(policy, thread_count) / valuetype(Length()); }
+  // Sum, mean, variance, minimum and maximum in a single pass; argmin_ and argmax_ are row-major indices.
+  SequenceStatistics<valuetype> Statistics(size_t thread_count = 1) const { return detail::GridStatistics(indexer_, data_.data(), thread_count); }
+
+private:
+  detail::GridIndexer indexer_;
+  std::vector<valuetype> data_;
+};
+
+using seq3i = Sequence3D<int>;
+using seq3f = Sequence3D<float>;
+using seq3d = Sequence3D<double>;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SEQUENCE_3D_H_
@@ -0,0 +1,603 @@
+#pragma once
+#ifndef J_MATH_SEQUENCE_REDUCTION_H_
+#define J_MATH_SEQUENCE_REDUCTION_H_
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "..\utility\parallel.h"
+#include "..\utility\simd.h"
+
+namespace j {
+namespace math {
+
+// Reductions (sum, sum of squares, statistics) over contiguous arrays of values, as used by Sequence1D.
+//
+// The values are split into chunks of kReductionChunkSize elements. Within a chunk, every element is added to one of
+// kReductionLanes independent accumulators (element i to accumulator i % kReductionLanes), which is what the SSE2 and
+// AVX2 kernels keep in their registers; the accumulators are then combined pairwise, and so are the chunk results.
+// Because this order is fixed, the result is bit-for-bit the same for every instruction set and every thread count,
+// and the rounding error grows with log(length) instead of length as it does for a single running sum.
+// Compensated (Kahan) summation reduces the error further at roughly half the speed. The compensation is removed by
+// compilers that reassociate floating-point arithmetic (e.g. -ffast-math or /fp:fast).
+
+// Method of summing floating-point values.
+enum class SummationPolicy {
+  PAIRWISE,  // Independent accumulators combined pairwise, error O(log(length))
+  KAHAN      // Compensated summation per accumulator, error independent of the length
+};
+
+// Result of a single pass over a sequence. Mean and variance are floating-point even for integral values. Minimum and
+// maximum report the first index at which they occur. All members are zero for an empty sequence; results are
+// unspecified when the values contain NaN.
+template<typename valuetype>
+struct SequenceStatistics {
+  using moment_type = typename std::conditional<std::is_floating_point<valuetype>::value, valuetype, double>::type;
+
+  moment_type Variance() const { return (count_ > 0) ? m2_ / moment_type(count_) : moment_type(0); }
+  moment_type SampleVariance() const { return (count_ > 1) ? m2_ / moment_type(count_ - 1) : moment_type(0); }
+  moment_type StandardDeviation() const { return moment_type(std::sqrt(Variance())); }
+
+  size_t count_ = 0;
+  valuetype sum_ = valuetype(0);
+  moment_type mean_ = moment_type(0);
+  moment_type m2_ = moment_type(0);  // Sum of squared deviations from the mean
+  valuetype min_ = valuetype(0);
+  valuetype max_ = valuetype(0);
+  size_t argmin_ = 0;
+  size_t argmax_ = 0;
+};
+
+namespace detail {
+
+const size_t kReductionChunkSize = 4096;
+const size_t kReductionLanes = 16;
+// Below this many elements per thread, starting a thread costs more than it saves.
+const size_t kReductionMinimumPerThread = size_t(1) << 18;
+
+//
+// Generic kernels (any valuetype, elements [begin, end) of one chunk)
+//
+// Adds x[i] (or (x[i] - shift)^2 when square is set) to lanes[i % kReductionLanes]. Whole groups of kReductionLanes
+// elements go through a local copy of the accumulators, which compilers can keep in vector registers.
+template<bool square, typename valuetype, typename accumulator>
+void SumChunkGeneric(const valuetype* x, size_t begin, size_t end, accumulator shift, accumulator* lanes) {
+  auto term = [shift](valuetype value) { accumulator v = accumulator(value); if (square) { v = v - shift; v = v * v; } return v; };
+  size_t i = begin;
+  for (; i < end && i % kReductionLanes != 0; ++i) { lanes[i % kReductionLanes] += term(x[i]); }
+  accumulator block[kReductionLanes];
+  for (size_t k = 0; k < kReductionLanes; ++k) { block[k] = lanes[k]; }
+  for (; i + kReductionLanes <= end; i += kReductionLanes) {
+    for (size_t k = 0; k < kReductionLanes; ++k) { block[k] += term(x[i + k]); }
+  }
+  for (; i < end; ++i) { block[i % kReductionLanes] += term(x[i]); }
+  for (size_t k = 0; k < kReductionLanes; ++k) { lanes[k] = block[k]; }
+}
+
+template<typename valuetype, typename accumulator>
+void SumChunkGeneric(const valuetype* x, size_t begin, size_t end, bool square, accumulator shift, accumulator* lanes) {
+  if (square) { SumChunkGeneric<true>(x, begin, end, shift, lanes); } else { SumChunkGeneric<false>(x, begin, end, shift, lanes); }
+}
+
+template<typename valuetype>
+void KahanSumChunkGeneric(const valuetype* x, size_t begin, size_t end, bool square, valuetype* lanes, valuetype* compensation) {
+  for (size_t i = begin; i < end; ++i) {
+    valuetype v = x[i];
+    if (square) { v = v * v; }
+    size_t lane = i % kReductionLanes;
+    valuetype y = v - compensation[lane];
+    valuetype t = lanes[lane] + y;
+    compensation[lane] = (t - lanes[lane]) - y;
+    lanes[lane] = t;
+  }
+}
+
+// Updates the running minimum and maximum (first occurrence) with x[begin, end).
+template<typename valuetype>
+void MinMaxChunkGeneric(const valuetype* x, size_t begin, size_t end, valuetype* min, size_t* argmin, valuetype* max, size_t* argmax) {
+  for (size_t i = begin; i < end; ++i) {
+    if (x[i] < *min) { *min = x[i]; *argmin = i; }
+    if (x[i] > *max) { *max = x[i]; *argmax = i; }
+  }
+}
+
+// Reduces the per-register-lane results of a vectorized minimum/maximum and includes the scalar tail x[tail, count).
+template<typename valuetype>
+void MinMaxCombineLanes(const valuetype* mins, const valuetype* maxs, size_t lanes, const valuetype* x, size_t tail, size_t count, valuetype* min, valuetype* max) {
+  for (size_t j = 0; j < lanes; ++j) {
+    if (mins[j] < *min) { *min = mins[j]; }
+    if (maxs[j] > *max) { *max = maxs[j]; }
+  }
+  for (size_t i = tail; i < count; ++i) {
+    if (x[i] < *min) { *min = x[i]; }
+    if (x[i] > *max) { *max = x[i]; }
+  }
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+//
+// SSE2 kernels (one chunk of count elements)
+//
+// Single and compensated accumulation steps. The kernels below call these on separately named registers so that the
+// compiler keeps the independent accumulators in registers.
+template<bool square>
+J_MATH_TARGET_SSE2 inline __m128 AccumulateSse(__m128 s, __m128 v, __m128 shift) { if (square) { v = _mm_sub_ps(v, shift); v = _mm_mul_ps(v, v); } return _mm_add_ps(s, v); }
+template<bool square>
+J_MATH_TARGET_SSE2 inline __m128d AccumulateSse(__m128d s, __m128d v, __m128d shift) { if (square) { v = _mm_sub_pd(v, shift); v = _mm_mul_pd(v, v); } return _mm_add_pd(s, v); }
+template<bool square>
+J_MATH_TARGET_SSE2 inline void KahanAccumulateSse(__m128& s, __m128& c, __m128 v) {
+  if (square) { v = _mm_mul_ps(v, v); }
+  __m128 y = _mm_sub_ps(v, c);
+  __m128 t = _mm_add_ps(s, y);
+  c = _mm_sub_ps(_mm_sub_ps(t, s), y);
+  s = t;
+}
+template<bool square>
+J_MATH_TARGET_SSE2 inline void KahanAccumulateSse(__m128d& s, __m128d& c, __m128d v) {
+  if (square) { v = _mm_mul_pd(v, v); }
+  __m128d y = _mm_sub_pd(v, c);
+  __m128d t = _mm_add_pd(s, y);
+  c = _mm_sub_pd(_mm_sub_pd(t, s), y);
+  s = t;
+}
+
+template<bool square>
+J_MATH_TARGET_SSE2 inline void SumChunkSse(const float* x, size_t count, float shift, float* lanes) {
+  __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps(), s2 = _mm_setzero_ps(), s3 = _mm_setzero_ps();
+  __m128 m = _mm_set1_ps(shift);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    s0 = AccumulateSse<square>(s0, _mm_loadu_ps(x + i), m); s1 = AccumulateSse<square>(s1, _mm_loadu_ps(x + i + 4), m);
+    s2 = AccumulateSse<square>(s2, _mm_loadu_ps(x + i + 8), m); s3 = AccumulateSse<square>(s3, _mm_loadu_ps(x + i + 12), m);
+  }
+  _mm_storeu_ps(lanes, s0); _mm_storeu_ps(lanes + 4, s1); _mm_storeu_ps(lanes + 8, s2); _mm_storeu_ps(lanes + 12, s3);
+  SumChunkGeneric(x, i, count, square, shift, lanes);
+}
+
+template<bool square>
+J_MATH_TARGET_SSE2 inline void SumChunkSse(const double* x, size_t count, double shift, double* lanes) {
+  __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+  __m128d s4 = _mm_setzero_pd(), s5 = _mm_setzero_pd(), s6 = _mm_setzero_pd(), s7 = _mm_setzero_pd();
+  __m128d m = _mm_set1_pd(shift);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    s0 = AccumulateSse<square>(s0, _mm_loadu_pd(x + i), m); s1 = AccumulateSse<square>(s1, _mm_loadu_pd(x + i + 2), m);
+    s2 = AccumulateSse<square>(s2, _mm_loadu_pd(x + i + 4), m); s3 = AccumulateSse<square>(s3, _mm_loadu_pd(x + i + 6), m);
+    s4 = AccumulateSse<square>(s4, _mm_loadu_pd(x + i + 8), m); s5 = AccumulateSse<square>(s5, _mm_loadu_pd(x + i + 10), m);
+    s6 = AccumulateSse<square>(s6, _mm_loadu_pd(x + i + 12), m); s7 = AccumulateSse<square>(s7, _mm_loadu_pd(x + i + 14), m);
+  }
+  _mm_storeu_pd(lanes, s0); _mm_storeu_pd(lanes + 2, s1); _mm_storeu_pd(lanes + 4, s2); _mm_storeu_pd(lanes + 6, s3);
+  _mm_storeu_pd(lanes + 8, s4); _mm_storeu_pd(lanes + 10, s5); _mm_storeu_pd(lanes + 12, s6); _mm_storeu_pd(lanes + 14, s7);
+  SumChunkGeneric(x, i, count, square, shift, lanes);
+}
+
+template<bool square>
+J_MATH_TARGET_SSE2 inline void KahanSumChunkSse(const float* x, size_t count, float* lanes, float* compensation) {
+  __m128 s0 = _mm_setzero_ps(), s1 = _mm_setzero_ps(), s2 = _mm_setzero_ps(), s3 = _mm_setzero_ps();
+  __m128 c0 = _mm_setzero_ps(), c1 = _mm_setzero_ps(), c2 = _mm_setzero_ps(), c3 = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    KahanAccumulateSse<square>(s0, c0, _mm_loadu_ps(x + i)); KahanAccumulateSse<square>(s1, c1, _mm_loadu_ps(x + i + 4));
+    KahanAccumulateSse<square>(s2, c2, _mm_loadu_ps(x + i + 8)); KahanAccumulateSse<square>(s3, c3, _mm_loadu_ps(x + i + 12));
+  }
+  _mm_storeu_ps(lanes, s0); _mm_storeu_ps(lanes + 4, s1); _mm_storeu_ps(lanes + 8, s2); _mm_storeu_ps(lanes + 12, s3);
+  _mm_storeu_ps(compensation, c0); _mm_storeu_ps(compensation + 4, c1); _mm_storeu_ps(compensation + 8, c2); _mm_storeu_ps(compensation + 12, c3);
+  KahanSumChunkGeneric(x, i, count, square, lanes, compensation);
+}
+
+template<bool square>
+J_MATH_TARGET_SSE2 inline void KahanSumChunkSse(const double* x, size_t count, double* lanes, double* compensation) {
+  __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+  __m128d s4 = _mm_setzero_pd(), s5 = _mm_setzero_pd(), s6 = _mm_setzero_pd(), s7 = _mm_setzero_pd();
+  __m128d c0 = _mm_setzero_pd(), c1 = _mm_setzero_pd(), c2 = _mm_setzero_pd(), c3 = _mm_setzero_pd();
+  __m128d c4 = _mm_setzero_pd(), c5 = _mm_setzero_pd(), c6 = _mm_setzero_pd(), c7 = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    KahanAccumulateSse<square>(s0, c0, _mm_loadu_pd(x + i)); KahanAccumulateSse<square>(s1, c1, _mm_loadu_pd(x + i + 2));
+    KahanAccumulateSse<square>(s2, c2, _mm_loadu_pd(x + i + 4)); KahanAccumulateSse<square>(s3, c3, _mm_loadu_pd(x + i + 6));
+    KahanAccumulateSse<square>(s4, c4, _mm_loadu_pd(x + i + 8)); KahanAccumulateSse<square>(s5, c5, _mm_loadu_pd(x + i + 10));
+    KahanAccumulateSse<square>(s6, c6, _mm_loadu_pd(x + i + 12)); KahanAccumulateSse<square>(s7, c7, _mm_loadu_pd(x + i + 14));
+  }
+  _mm_storeu_pd(lanes, s0); _mm_storeu_pd(lanes + 2, s1); _mm_storeu_pd(lanes + 4, s2); _mm_storeu_pd(lanes + 6, s3);
+  _mm_storeu_pd(lanes + 8, s4); _mm_storeu_pd(lanes + 10, s5); _mm_storeu_pd(lanes + 12, s6); _mm_storeu_pd(lanes + 14, s7);
+  _mm_storeu_pd(compensation, c0); _mm_storeu_pd(compensation + 2, c1); _mm_storeu_pd(compensation + 4, c2); _mm_storeu_pd(compensation + 6, c3);
+  _mm_storeu_pd(compensation + 8, c4); _mm_storeu_pd(compensation + 10, c5); _mm_storeu_pd(compensation + 12, c6); _mm_storeu_pd(compensation + 14, c7);
+  KahanSumChunkGeneric(x, i, count, square, lanes, compensation);
+}
+
+// Minimum and maximum values first, then a scan for their first occurrence, which is cheaper than carrying indices
+// through the comparisons.
+J_MATH_TARGET_SSE2 inline size_t FindFirstSse(const float* x, size_t count, float value) {
+  __m128 v = _mm_set1_ps(value);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    int mask = _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(x + i), v));
+    if (mask != 0) { while ((mask & 1) == 0) { mask >>= 1; ++i; } return i; }
+  }
+  while (x[i] != value) { ++i; }
+  return i;
+}
+
+J_MATH_TARGET_SSE2 inline size_t FindFirstSse(const double* x, size_t count, double value) {
+  __m128d v = _mm_set1_pd(value);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    int mask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(x + i), v));
+    if (mask != 0) { return (mask & 1) ? i : i + 1; }
+  }
+  while (x[i] != value) { ++i; }
+  return i;
+}
+
+J_MATH_TARGET_SSE2 inline void MinMaxChunkSse(const float* x, size_t count, float* min, size_t* argmin, float* max, size_t* argmax) {
+  __m128 min0 = _mm_set1_ps(*min), min1 = min0, max0 = _mm_set1_ps(*max), max1 = max0;
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128 v0 = _mm_loadu_ps(x + i), v1 = _mm_loadu_ps(x + i + 4);
+    min0 = _mm_min_ps(min0, v0); min1 = _mm_min_ps(min1, v1); max0 = _mm_max_ps(max0, v0); max1 = _mm_max_ps(max1, v1);
+  }
+  float mins[8], maxs[8];
+  _mm_storeu_ps(mins, min0); _mm_storeu_ps(mins + 4, min1); _mm_storeu_ps(maxs, max0); _mm_storeu_ps(maxs + 4, max1);
+  float new_min = *min, new_max = *max;
+  MinMaxCombineLanes(mins, maxs, 8, x, i, count, &new_min, &new_max);
+  if (new_min < *min) { *argmin = FindFirstSse(x, count, new_min); *min = x[*argmin]; }
+  if (new_max > *max) { *argmax = FindFirstSse(x, count, new_max); *max = x[*argmax]; }
+}
+
+J_MATH_TARGET_SSE2 inline void MinMaxChunkSse(const double* x, size_t count, double* min, size_t* argmin, double* max, size_t* argmax) {
+  __m128d min0 = _mm_set1_pd(*min), min1 = min0, max0 = _mm_set1_pd(*max), max1 = max0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128d v0 = _mm_loadu_pd(x + i), v1 = _mm_loadu_pd(x + i + 2);
+    min0 = _mm_min_pd(min0, v0); min1 = _mm_min_pd(min1, v1); max0 = _mm_max_pd(max0, v0); max1 = _mm_max_pd(max1, v1);
+  }
+  double mins[4], maxs[4];
+  _mm_storeu_pd(mins, min0); _mm_storeu_pd(mins + 2, min1); _mm_storeu_pd(maxs, max0); _mm_storeu_pd(maxs + 2, max1);
+  double new_min = *min, new_max = *max;
+  MinMaxCombineLanes(mins, maxs, 4, x, i, count, &new_min, &new_max);
+  if (new_min < *min) { *argmin = FindFirstSse(x, count, new_min); *min = x[*argmin]; }
+  if (new_max > *max) { *argmax = FindFirstSse(x, count, new_max); *max = x[*argmax]; }
+}
+
+
+//
+// AVX2 kernels (one chunk of count elements)
+//
+template<bool square>
+J_MATH_TARGET_AVX2 inline __m256 AccumulateAvx2(__m256 s, __m256 v, __m256 shift) { if (square) { v = _mm256_sub_ps(v, shift); v = _mm256_mul_ps(v, v); } return _mm256_add_ps(s, v); }
+template<bool square>
+J_MATH_TARGET_AVX2 inline __m256d AccumulateAvx2(__m256d s, __m256d v, __m256d shift) { if (square) { v = _mm256_sub_pd(v, shift); v = _mm256_mul_pd(v, v); } return _mm256_add_pd(s, v); }
+template<bool square>
+J_MATH_TARGET_AVX2 inline void KahanAccumulateAvx2(__m256& s, __m256& c, __m256 v) {
+  if (square) { v = _mm256_mul_ps(v, v); }
+  __m256 y = _mm256_sub_ps(v, c);
+  __m256 t = _mm256_add_ps(s, y);
+  c = _mm256_sub_ps(_mm256_sub_ps(t, s), y);
+  s = t;
+}
+template<bool square>
+J_MATH_TARGET_AVX2 inline void KahanAccumulateAvx2(__m256d& s, __m256d& c, __m256d v) {
+  if (square) { v = _mm256_mul_pd(v, v); }
+  __m256d y = _mm256_sub_pd(v, c);
+  __m256d t = _mm256_add_pd(s, y);
+  c = _mm256_sub_pd(_mm256_sub_pd(t, s), y);
+  s = t;
+}
+
+template<bool square>
+J_MATH_TARGET_AVX2 inline void SumChunkAvx2(const float* x, size_t count, float shift, float* lanes) {
+  __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+  __m256 m = _mm256_set1_ps(shift);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) { s0 = AccumulateAvx2<square>(s0, _mm256_loadu_ps(x + i), m); s1 = AccumulateAvx2<square>(s1, _mm256_loadu_ps(x + i + 8), m); }
+  _mm256_storeu_ps(lanes, s0); _mm256_storeu_ps(lanes + 8, s1);
+  SumChunkGeneric(x, i, count, square, shift, lanes);
+}
+
+template<bool square>
+J_MATH_TARGET_AVX2 inline void SumChunkAvx2(const double* x, size_t count, double shift, double* lanes) {
+  __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+  __m256d m = _mm256_set1_pd(shift);
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    s0 = AccumulateAvx2<square>(s0, _mm256_loadu_pd(x + i), m); s1 = AccumulateAvx2<square>(s1, _mm256_loadu_pd(x + i + 4), m);
+    s2 = AccumulateAvx2<square>(s2, _mm256_loadu_pd(x + i + 8), m); s3 = AccumulateAvx2<square>(s3, _mm256_loadu_pd(x + i + 12), m);
+  }
+  _mm256_storeu_pd(lanes, s0); _mm256_storeu_pd(lanes + 4, s1); _mm256_storeu_pd(lanes + 8, s2); _mm256_storeu_pd(lanes + 12, s3);
+  SumChunkGeneric(x, i, count, square, shift, lanes);
+}
+
+template<bool square>
+J_MATH_TARGET_AVX2 inline void KahanSumChunkAvx2(const float* x, size_t count, float* lanes, float* compensation) {
+  __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) { KahanAccumulateAvx2<square>(s0, c0, _mm256_loadu_ps(x + i)); KahanAccumulateAvx2<square>(s1, c1, _mm256_loadu_ps(x + i + 8)); }
+  _mm256_storeu_ps(lanes, s0); _mm256_storeu_ps(lanes + 8, s1); _mm256_storeu_ps(compensation, c0); _mm256_storeu_ps(compensation + 8, c1);
+  KahanSumChunkGeneric(x, i, count, square, lanes, compensation);
+}
+
+template<bool square>
+J_MATH_TARGET_AVX2 inline void KahanSumChunkAvx2(const double* x, size_t count, double* lanes, double* compensation) {
+  __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+  __m256d c0 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd(), c2 = _mm256_setzero_pd(), c3 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    KahanAccumulateAvx2<square>(s0, c0, _mm256_loadu_pd(x + i)); KahanAccumulateAvx2<square>(s1, c1, _mm256_loadu_pd(x + i + 4));
+    KahanAccumulateAvx2<square>(s2, c2, _mm256_loadu_pd(x + i + 8)); KahanAccumulateAvx2<square>(s3, c3, _mm256_loadu_pd(x + i + 12));
+  }
+  _mm256_storeu_pd(lanes, s0); _mm256_storeu_pd(lanes + 4, s1); _mm256_storeu_pd(lanes + 8, s2); _mm256_storeu_pd(lanes + 12, s3);
+  _mm256_storeu_pd(compensation, c0); _mm256_storeu_pd(compensation + 4, c1); _mm256_storeu_pd(compensation + 8, c2); _mm256_storeu_pd(compensation + 12, c3);
+  KahanSumChunkGeneric(x, i, count, square, lanes, compensation);
+}
+
+J_MATH_TARGET_AVX2 inline size_t FindFirstAvx2(const float* x, size_t count, float value) {
+  __m256 v = _mm256_set1_ps(value);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(x + i), v, _CMP_EQ_OQ));
+    if (mask != 0) { while ((mask & 1) == 0) { mask >>= 1; ++i; } return i; }
+  }
+  while (x[i] != value) { ++i; }
+  return i;
+}
+
+J_MATH_TARGET_AVX2 inline size_t FindFirstAvx2(const double* x, size_t count, double value) {
+  __m256d v = _mm256_set1_pd(value);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    int mask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(x + i), v, _CMP_EQ_OQ));
+    if (mask != 0) { while ((mask & 1) == 0) { mask >>= 1; ++i; } return i; }
+  }
+  while (x[i] != value) { ++i; }
+  return i;
+}
+
+J_MATH_TARGET_AVX2 inline void MinMaxChunkAvx2(const float* x, size_t count, float* min, size_t* argmin, float* max, size_t* argmax) {
+  __m256 min0 = _mm256_set1_ps(*min), min1 = min0, max0 = _mm256_set1_ps(*max), max1 = max0;
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m256 v0 = _mm256_loadu_ps(x + i), v1 = _mm256_loadu_ps(x + i + 8);
+    min0 = _mm256_min_ps(min0, v0); min1 = _mm256_min_ps(min1, v1); max0 = _mm256_max_ps(max0, v0); max1 = _mm256_max_ps(max1, v1);
+  }
+  float mins[16], maxs[16];
+  _mm256_storeu_ps(mins, min0); _mm256_storeu_ps(mins + 8, min1); _mm256_storeu_ps(maxs, max0); _mm256_storeu_ps(maxs + 8, max1);
+  float new_min = *min, new_max = *max;
+  MinMaxCombineLanes(mins, maxs, 16, x, i, count, &new_min, &new_max);
+  if (new_min < *min) { *argmin = FindFirstAvx2(x, count, new_min); *min = x[*argmin]; }
+  if (new_max > *max) { *argmax = FindFirstAvx2(x, count, new_max); *max = x[*argmax]; }
+}
+
+J_MATH_TARGET_AVX2 inline void MinMaxChunkAvx2(const double* x, size_t count, double* min, size_t* argmin, double* max, size_t* argmax) {
+  __m256d min0 = _mm256_set1_pd(*min), min1 = min0, max0 = _mm256_set1_pd(*max), max1 = max0;
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256d v0 = _mm256_loadu_pd(x + i), v1 = _mm256_loadu_pd(x + i + 4);
+    min0 = _mm256_min_pd(min0, v0); min1 = _mm256_min_pd(min1, v1); max0 = _mm256_max_pd(max0, v0); max1 = _mm256_max_pd(max1, v1);
+  }
+  double mins[8], maxs[8];
+  _mm256_storeu_pd(mins, min0); _mm256_storeu_pd(mins + 4, min1); _mm256_storeu_pd(maxs, max0); _mm256_storeu_pd(maxs + 4, max1);
+  double new_min = *min, new_max = *max;
+  MinMaxCombineLanes(mins, maxs, 8, x, i, count, &new_min, &new_max);
+  if (new_min < *min) { *argmin = FindFirstAvx2(x, count, new_min); *min = x[*argmin]; }
+  if (new_max > *max) { *argmax = FindFirstAvx2(x, count, new_max); *max = x[*argmax]; }
+}
+
+
+#endif // J_MATH_SIMD_X86
+
+//
+// Runtime dispatch on the selected instruction set
+//
+template<typename valuetype, typename accumulator>
+void SumChunkDispatch(const valuetype* x, size_t count, bool square, accumulator shift, accumulator* lanes) { SumChunkGeneric(x, 0, count, square, shift, lanes); }
+template<typename valuetype>
+void KahanSumChunkDispatch(const valuetype* x, size_t count, bool square, valuetype* lanes, valuetype* compensation) { KahanSumChunkGeneric(x, 0, count, square, lanes, compensation); }
+template<typename valuetype>
+void MinMaxChunkDispatch(const valuetype* x, size_t count, valuetype* min, size_t* argmin, valuetype* max, size_t* argmax) { MinMaxChunkGeneric(x, 0, count, min, argmin, max, argmax); }
+
+#if defined(J_MATH_SIMD_X86)
+#define J_MATH_SEQUENCE_REDUCTION_DISPATCH(valuetype) \
+  inline void SumChunkDispatch(const valuetype* x, size_t count, bool square, valuetype shift, valuetype* lanes) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: if (square) { SumChunkAvx2<true>(x, count, shift, lanes); } else { SumChunkAvx2<false>(x, count, shift, lanes); } return; \
+    case SimdLevel::SSE: if (square) { SumChunkSse<true>(x, count, shift, lanes); } else { SumChunkSse<false>(x, count, shift, lanes); } return; \
+    default: SumChunkGeneric(x, 0, count, square, shift, lanes); return; \
+    } \
+  } \
+  inline void KahanSumChunkDispatch(const valuetype* x, size_t count, bool square, valuetype* lanes, valuetype* compensation) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: if (square) { KahanSumChunkAvx2<true>(x, count, lanes, compensation); } else { KahanSumChunkAvx2<false>(x, count, lanes, compensation); } return; \
+    case SimdLevel::SSE: if (square) { KahanSumChunkSse<true>(x, count, lanes, compensation); } else { KahanSumChunkSse<false>(x, count, lanes, compensation); } return; \
+    default: KahanSumChunkGeneric(x, 0, count, square, lanes, compensation); return; \
+    } \
+  } \
+  inline void MinMaxChunkDispatch(const valuetype* x, size_t count, valuetype* min, size_t* argmin, valuetype* max, size_t* argmax) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: MinMaxChunkAvx2(x, count, min, argmin, max, argmax); return; \
+    case SimdLevel::SSE: MinMaxChunkSse(x, count, min, argmin, max, argmax); return; \
+    default: MinMaxChunkGeneric(x, 0, count, min, argmin, max, argmax); return; \
+    } \
+  }
+J_MATH_SEQUENCE_REDUCTION_DISPATCH(float)
+J_MATH_SEQUENCE_REDUCTION_DISPATCH(double)
+#undef J_MATH_SEQUENCE_REDUCTION_DISPATCH
+#endif // J_MATH_SIMD_X86
+
+//
+// Combination of partial results
+//
+// Pairwise sum of the accumulators: lane i with lane i + 8, then i + 4, i + 2 and i + 1.
+template<typename accumulator>
+accumulator CombineLanes(accumulator* lanes) {
+  for (size_t width = kReductionLanes / 2; width > 0; width /= 2) {
+    for (size_t i = 0; i < width; ++i) { lanes[i] += lanes[i + width]; }
+  }
+  return lanes[0];
+}
+
+// A compensated sum, the represented value being sum_ - compensation_.
+template<typename valuetype>
+struct KahanSum {
+  void Add(valuetype v) {
+    valuetype y = v - compensation_;
+    valuetype t = sum_ + y;
+    compensation_ = (t - sum_) - y;
+    sum_ = t;
+  }
+  void Add(const KahanSum& other) { Add(other.sum_); Add(-other.compensation_); }
+
+  valuetype sum_ = valuetype(0);
+  valuetype compensation_ = valuetype(0);
+};
+
+template<typename valuetype>
+valuetype CombinePairwise(const valuetype* values, size_t begin, size_t end) {
+  if (end - begin == 1) { return values[begin]; }
+  size_t middle = begin + (end - begin) / 2;
+  return CombinePairwise(values, begin, middle) + CombinePairwise(values, middle, end);
+}
+
+// Merges the statistics of two consecutive ranges (Chan et al.), a preceding b.
+template<typename valuetype>
+SequenceStatistics<valuetype> MergeStatistics(const SequenceStatistics<valuetype>& a, const SequenceStatistics<valuetype>& b) {
+  using moment_type = typename SequenceStatistics<valuetype>::moment_type;
+  SequenceStatistics<valuetype> result = a;
+  result.count_ = a.count_ + b.count_;
+  result.sum_ = a.sum_ + b.sum_;
+  moment_type delta = b.mean_ - a.mean_;
+  moment_type weight = moment_type(b.count_) / moment_type(result.count_);
+  result.mean_ = a.mean_ + delta * weight;
+  result.m2_ = a.m2_ + b.m2_ + delta * delta * moment_type(a.count_) * weight;
+  if (b.min_ < a.min_) { result.min_ = b.min_; result.argmin_ = b.argmin_; }
+  if (b.max_ > a.max_) { result.max_ = b.max_; result.argmax_ = b.argmax_; }
+  return result;
+}
+
+template<typename valuetype>
+SequenceStatistics<valuetype> MergeStatisticsPairwise(const SequenceStatistics<valuetype>* values, size_t begin, size_t end) {
+  if (end - begin == 1) { return values[begin]; }
+  size_t middle = begin + (end - begin) / 2;
+  return MergeStatistics(MergeStatisticsPairwise(values, begin, middle), MergeStatisticsPairwise(values, middle, end));
+}
+
+//
+// Reductions over whole arrays
+//
+inline size_t ReductionThreadCount(size_t length, size_t thread_count) {
+  if (thread_count == 0) { thread_count = GetHardwareThreadCount(); }
+  size_t useful = length / kReductionMinimumPerThread;
+  if (useful < 1) { useful = 1; }
+  return (thread_count < useful) ? thread_count : useful;
+}
+
+template<typename valuetype>
+KahanSum<valuetype> KahanSumChunk(const valuetype* x, size_t count, bool square) {
+  valuetype lanes[kReductionLanes] = {}, compensation[kReductionLanes] = {};
+  KahanSumChunkDispatch(x, count, square, lanes, compensation);
+  KahanSum<valuetype> result;
+  for (size_t j = 0; j < kReductionLanes; ++j) { result.Add(lanes[j]); result.Add(-compensation[j]); }
+  return result;
+}
+
+template<typename valuetype>
+valuetype PairwiseSumChunk(const valuetype* x, size_t count, bool square) {
+  valuetype lanes[kReductionLanes] = {};
+  SumChunkDispatch(x, count, square, valuetype(0), lanes);
+  return CombineLanes(lanes);
+}
+
+// Sum of length values that are read in chunks: source(offset, count, buffer) returns a pointer to the values
+// [offset, offset + count), either where they are stored or after copying them into buffer (one per thread).
+template<typename valuetype, typename chunk_source>
+valuetype SumChunks(size_t length, bool square, SummationPolicy policy, size_t thread_count, chunk_source source) {
+  if (length == 0) { return valuetype(0); }
+  size_t chunks = (length + kReductionChunkSize - 1) / kReductionChunkSize;
+  auto chunk_length = [&](size_t c) { return (c + 1 < chunks) ? kReductionChunkSize : length - c * kReductionChunkSize; };
+  if (policy == SummationPolicy::KAHAN) {
+    std::vector<KahanSum<valuetype>> partials(chunks);
+    ParallelFor(chunks, ReductionThreadCount(length, thread_count), 1, [&](size_t begin, size_t end) {
+      std::vector<valuetype> buffer;
+      for (size_t c = begin; c < end; ++c) { partials[c] = KahanSumChunk(source(c * kReductionChunkSize, chunk_length(c), buffer), chunk_length(c), square); }
+    });
+    KahanSum<valuetype> total;
+    for (const KahanSum<valuetype>& partial : partials) { total.Add(partial); }
+    return total.sum_ - total.compensation_;
+  }
+  if (chunks == 1) { std::vector<valuetype> buffer; return PairwiseSumChunk(source(0, length, buffer), length, square); }
+  std::vector<valuetype> partials(chunks);
+  ParallelFor(chunks, ReductionThreadCount(length, thread_count), 1, [&](size_t begin, size_t end) {
+    std::vector<valuetype> buffer;
+    for (size_t c = begin; c < end; ++c) { partials[c] = PairwiseSumChunk(source(c * kReductionChunkSize, chunk_length(c), buffer), chunk_length(c), square); }
+  });
+  return CombinePairwise(partials.data(), 0, chunks);
+}
+
+template<typename valuetype>
+valuetype Sum(const valuetype* data, size_t length, bool square, SummationPolicy policy, size_t thread_count) {
+  return SumChunks<valuetype>(length, square, policy, thread_count, [data](size_t offset, size_t, std::vector<valuetype>&) { return data + offset; });
+}
+
+// Statistics of one chunk starting at index offset. The chunk is read from memory once; the sweeps for the squared
+// deviations from the chunk mean and for the minimum and maximum run on the cached chunk.
+template<typename valuetype>
+SequenceStatistics<valuetype> StatisticsChunk(const valuetype* x, size_t count, size_t offset) {
+  using moment_type = typename SequenceStatistics<valuetype>::moment_type;
+  SequenceStatistics<valuetype> result;
+  result.count_ = count;
+  result.sum_ = PairwiseSumChunk(x, count, false);
+  result.mean_ = moment_type(result.sum_) / moment_type(count);
+  moment_type lanes[kReductionLanes] = {};
+  SumChunkDispatch(x, count, true, result.mean_, lanes);
+  result.m2_ = CombineLanes(lanes);
+  result.min_ = result.max_ = x[0];
+  MinMaxChunkDispatch(x, count, &result.min_, &result.argmin_, &result.max_, &result.argmax_);
+  result.argmin_ += offset;
+  result.argmax_ += offset;
+  return result;
+}
+
+// Statistics of length values that are read in chunks, see SumChunks.
+template<typename valuetype, typename chunk_source>
+SequenceStatistics<valuetype> StatisticsChunks(size_t length, size_t thread_count, chunk_source source) {
+  using moment_type = typename SequenceStatistics<valuetype>::moment_type;
+  if (length == 0) { return SequenceStatistics<valuetype>(); }
+  if (length <= kReductionChunkSize) { std::vector<valuetype> buffer; return StatisticsChunk(source(0, length, buffer), length, 0); }
+  size_t chunks = (length + kReductionChunkSize - 1) / kReductionChunkSize;
+  std::vector<SequenceStatistics<valuetype>> partials(chunks);
+  ParallelFor(chunks, ReductionThreadCount(length, thread_count), 1, [&](size_t begin, size_t end) {
+    std::vector<valuetype> buffer;
+    for (size_t c = begin; c < end; ++c) {
+      size_t offset = c * kReductionChunkSize;
+      size_t count = (c + 1 < chunks) ? kReductionChunkSize : length - offset;
+      partials[c] = StatisticsChunk(source(offset, count, buffer), count, offset);
+    }
+  });
+  SequenceStatistics<valuetype> result = MergeStatisticsPairwise(partials.data(), 0, chunks);
+  result.mean_ = moment_type(result.sum_) / moment_type(result.count_);
+  return result;
+}
+
+} // namespace detail
+
+// Sum of data[0, length). A thread_count other than 1 splits long arrays over that many threads (0 uses all hardware
+// threads); the result does not depend on the thread count or the instruction set.
+template<typename valuetype>
+valuetype ReduceSum(const valuetype* data, size_t length, SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) { return detail::Sum(data, length, false, policy, thread_count); }
+
+// Sum of the squares of data[0, length), see ReduceSum.
+template<typename valuetype>
+valuetype ReduceSumOfSquares(const valuetype* data, size_t length, SummationPolicy policy = SummationPolicy::PAIRWISE, size_t thread_count = 1) { return detail::Sum(data, length, true, policy, thread_count); }
+
+// Count, sum, mean, variance, minimum and maximum of data[0, length) in a single pass over memory, see ReduceSum.
+// The sum equals ReduceSum with SummationPolicy::PAIRWISE.
+template<typename valuetype>
+SequenceStatistics<valuetype> ReduceStatistics(const valuetype* data, size_t length, size_t thread_count = 1) {
+  return detail::StatisticsChunks<valuetype>(length, thread_count, [data](size_t offset, size_t, std::vector<valuetype>&) { return data + offset; });
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SEQUENCE_REDUCTION_H_
@@ -0,0 +1,197 @@
+#pragma once
+#ifndef J_MATH_STREAMING_SEQUENCE_H_
+#define J_MATH_STREAMING_SEQUENCE_H_
+
+#include <cmath>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "sequence.h"
+#include "sequence_reduction.h"
+
+namespace j {
+namespace math {
+
+// One-dimensional sequence for samples that arrive continuously. Sum, sum of squares, mean, variance, minimum and
+// maximum are kept up to date while appending, so querying them is O(1) instead of a pass over all samples.
+//
+// With a capacity of 0 every sample is kept. Otherwise the sequence is a ring buffer holding the last capacity samples:
+// appending to a full buffer drops the oldest sample, and index 0 always refers to the oldest sample that is still held.
+//
+// Sums are kept relative to a reference value near the mean and with compensated summation, and are recomputed from the
+// buffer every time the ring buffer has been overwritten completely, so rounding errors from removing samples do not
+// accumulate.
+template<typename valuetype>
+class StreamingSequence1D {
+public:
+  using moment_type = typename SequenceStatistics<valuetype>::moment_type;
+
+  // Constructors
+  explicit StreamingSequence1D(size_t capacity = 0) : capacity_{ capacity } { data_.reserve(capacity); }
+  StreamingSequence1D(const StreamingSequence1D&) = default;
+  ~StreamingSequence1D() = default;
+
+  // Operators
+  StreamingSequence1D& operator=(const StreamingSequence1D&) = default;
+  valuetype operator()(const size_t& i) const { return Get(i); }
+
+  // Cast to different valuetype (copies the held samples, oldest first)
+  template<typename other_valuetype> operator Sequence1D<other_valuetype>() const {
+    std::vector<other_valuetype> data;
+    data.reserve(Length());
+    for (size_t i = 0; i < Length(); ++i) { data.push_back(other_valuetype(Get(i))); }
+    return Sequence1D<other_valuetype>(data);
+  }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const StreamingSequence1D<valuetype>& sequence) {
+    std::stringstream ss;
+    ss << "StreamingSequence1D(";
+    for (size_t i = 0; i < sequence.Length(); ++i) { ss << ((i > 0) ? ", " : "") << sequence.Get(i); }
+    ss << ")";
+    std::string result = ss.str();
+    return os << result;
+  }
+
+  // Sequence-specific operations
+  void Add(const valuetype& value) {
+    if (data_.empty()) { shift_ = moment_type(value); }
+    if (capacity_ == 0) {
+      data_.push_back(value);
+      Include(value);
+      if (data_.size() == 1 || value < min_) { min_ = value; }
+      if (data_.size() == 1 || value > max_) { max_ = value; }
+      UpdateReference();
+      return;
+    }
+    if (data_.size() < capacity_) {
+      data_.push_back(value);
+    } else {
+      Exclude(data_[head_]);
+      data_[head_] = value;
+      head_ = (head_ + 1 == capacity_) ? 0 : head_ + 1;
+    }
+    ++added_;
+    Include(value);
+    PushWindowExtrema(value);
+    UpdateReference();
+  }
+  // Append count samples. For a bounded sequence only the last capacity samples are processed.
+  void Add(const valuetype* data, size_t count) {
+    if (capacity_ > 0 && count > capacity_) {
+      added_ += count - capacity_;
+      Clear(false);
+      data += count - capacity_;
+      count = capacity_;
+    }
+    for (size_t i = 0; i < count; ++i) { Add(data[i]); }
+  }
+  void Add(const std::vector<valuetype>& data) { Add(data.data(), data.size()); }
+  // Removes all samples, keeping the capacity.
+  void Clear() { Clear(true); }
+  // Sample i, the oldest held sample being 0.
+  valuetype Get(const size_t& index, IndexType index_type = IndexType::CLAMP) const { return data_[Physical(detail::ConvertIndex(index, Length(), index_type))]; }
+  size_t Length() const { return data_.size(); }
+  size_t Capacity() const { return capacity_; }
+  bool IsFull() const { return capacity_ > 0 && data_.size() == capacity_; }
+
+  // Statistics of the held samples, all O(1). Minimum and maximum are undefined for an empty sequence.
+  valuetype Sum() const { return ToValue(moment_type(Length()) * shift_ + SumShifted()); }
+  valuetype SumOfSquares() const { return ToValue(SumOfSquaresShifted() + moment_type(2) * shift_ * SumShifted() + moment_type(Length()) * shift_ * shift_); }
+  valuetype Average() const { return Sum() / valuetype(Length()); }
+  moment_type Mean() const { return (Length() > 0) ? shift_ + SumShifted() / moment_type(Length()) : moment_type(0); }
+  moment_type Variance() const {
+    if (Length() == 0) { return moment_type(0); }
+    moment_type s = SumShifted();
+    moment_type variance = (SumOfSquaresShifted() - s * s / moment_type(Length())) / moment_type(Length());
+    return (variance > moment_type(0)) ? variance : moment_type(0);
+  }
+  moment_type StandardDeviation() const { return moment_type(std::sqrt(Variance())); }
+  valuetype Min() const { return (capacity_ == 0) ? min_ : Sample(min_window_.front()); }
+  valuetype Max() const { return (capacity_ == 0) ? max_ : Sample(max_window_.front()); }
+
+private:
+  // Position in data_ of sample i (0 is the oldest held sample).
+  size_t Physical(size_t i) const { return (capacity_ == 0) ? i : ((head_ + i < capacity_) ? head_ + i : head_ + i - capacity_); }
+  // Number of the oldest held sample among all samples added to a bounded sequence.
+  size_t Oldest() const { return added_ - data_.size(); }
+  valuetype Sample(size_t number) const { return data_[Physical(number - Oldest())]; }
+  // Integral sums are exact up to rounding of the reference value.
+  static valuetype ToValue(moment_type m) { return std::is_integral<valuetype>::value ? valuetype(std::llround(m)) : valuetype(m); }
+  moment_type SumShifted() const { return sum_.sum_ - sum_.compensation_; }
+  moment_type SumOfSquaresShifted() const { return sum_of_squares_.sum_ - sum_of_squares_.compensation_; }
+
+  void Include(const valuetype& value) {
+    moment_type d = moment_type(value) - shift_;
+    sum_.Add(d);
+    sum_of_squares_.Add(d * d);
+  }
+  void Exclude(const valuetype& value) {
+    moment_type d = moment_type(value) - shift_;
+    sum_.Add(-d);
+    sum_of_squares_.Add(-(d * d));
+  }
+  // Maintains the candidates for the window minimum and maximum after value was added: sample numbers with increasing
+  // (minimum) or decreasing (maximum) values, so the front is always the extremum. Each sample enters and leaves each
+  // queue at most once.
+  void PushWindowExtrema(const valuetype& value) {
+    size_t oldest = Oldest();
+    while (!min_window_.empty() && min_window_.front() < oldest) { min_window_.pop_front(); }
+    while (!max_window_.empty() && max_window_.front() < oldest) { max_window_.pop_front(); }
+    while (!min_window_.empty() && !(Sample(min_window_.back()) < value)) { min_window_.pop_back(); }
+    while (!max_window_.empty() && !(Sample(max_window_.back()) > value)) { max_window_.pop_back(); }
+    min_window_.push_back(added_ - 1);
+    max_window_.push_back(added_ - 1);
+  }
+  // Recomputes the sums once the ring buffer has been overwritten completely, or when the reference value is several
+  // standard deviations away from the mean (e.g. after a transient left the window), where the shifted sums lose
+  // precision to cancellation. Checked at most every Length() / 8 samples, so appending stays O(1) amortized.
+  void UpdateReference() {
+    ++since_recompute_;
+    if (since_recompute_ * 8 < Length()) { return; }
+    moment_type offset = SumShifted() / moment_type(Length());
+    if ((capacity_ > 0 && since_recompute_ >= capacity_) || offset * offset > moment_type(16) * Variance()) { Recompute(); }
+  }
+  // Exact sums of the held samples, relative to their current mean.
+  void Recompute() {
+    moment_type sum = moment_type(0);
+    for (const valuetype& value : data_) { sum += moment_type(value); }
+    shift_ = sum / moment_type(data_.size());
+    sum_ = detail::KahanSum<moment_type>();
+    sum_of_squares_ = detail::KahanSum<moment_type>();
+    for (const valuetype& value : data_) { Include(value); }
+    since_recompute_ = 0;
+  }
+  void Clear(bool reset_count) {
+    data_.clear();
+    head_ = 0;
+    since_recompute_ = 0;
+    if (reset_count) { added_ = 0; }
+    sum_ = detail::KahanSum<moment_type>();
+    sum_of_squares_ = detail::KahanSum<moment_type>();
+    min_window_.clear();
+    max_window_.clear();
+  }
+
+  std::vector<valuetype> data_;
+  size_t capacity_ = 0;
+  size_t head_ = 0;   // Position of the oldest sample once a bounded sequence is full
+  size_t added_ = 0;  // Samples added to a bounded sequence since the last Clear
+  size_t since_recompute_ = 0;
+  moment_type shift_ = moment_type(0);
+  detail::KahanSum<moment_type> sum_;
+  detail::KahanSum<moment_type> sum_of_squares_;
+  valuetype min_ = valuetype(0), max_ = valuetype(0);
+  std::deque<size_t> min_window_, max_window_;
+};
+
+using sseq1i = StreamingSequence1D<int>;
+using sseq1f = StreamingSequence1D<float>;
+using sseq1d = StreamingSequence1D<double>;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_STREAMING_SEQUENCE_H_
@@ -0,0 +1,209 @@
+#pragma once
+#ifndef J_MATH_AABB_H_
+#define J_MATH_AABB_H_
+
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "line.h"
+#include "point.h"
+#include "shape_types.h"
+#include "sphere.h"
+#include "vector.h"
+
+namespace j {
+namespace math {
+
+// Axis-aligned bounding boxes in 2D and 3D space. Unlike Rectangle2D, which keeps two arbitrary corners, the corners
+// are kept in canonical form (min_[i] <= max_[i] on every axis), so tests need no reordering. A default-constructed
+// box is empty (min_ above max_), which acts as the identity for Merge and Extend and overlaps nothing. Boxes are
+// closed: points on the boundary are contained and boxes that touch overlap.
+
+// A two-dimensional axis-aligned bounding box.
+template<typename valuetype>
+struct AABB2D {
+  // Constructors
+  AABB2D() : min_{ std::numeric_limits<valuetype>::max(), std::numeric_limits<valuetype>::max() }, max_{ std::numeric_limits<valuetype>::lowest(), std::numeric_limits<valuetype>::lowest() } { }
+  AABB2D(const AABB2D&) = default;
+  // Box spanned by two opposite corners, in any order.
+  AABB2D(const Point2D<valuetype>& p1, const Point2D<valuetype>& p2)
+      : min_{ p1.x_ < p2.x_ ? p1.x_ : p2.x_, p1.y_ < p2.y_ ? p1.y_ : p2.y_ }, max_{ p1.x_ < p2.x_ ? p2.x_ : p1.x_, p1.y_ < p2.y_ ? p2.y_ : p1.y_ } { }
+  AABB2D(valuetype x1, valuetype y1, valuetype x2, valuetype y2) : AABB2D(Point2D<valuetype>(x1, y1), Point2D<valuetype>(x2, y2)) { }
+  explicit AABB2D(const Rectangle2D<valuetype>& rectangle) : AABB2D(rectangle.p1_, rectangle.p2_) { }
+  ~AABB2D() = default;
+
+  // Operators
+  AABB2D& operator=(const AABB2D&) = default;
+  bool operator== (const AABB2D<valuetype>& other) const { return min_ == other.min_ && max_ == other.max_; }
+  bool operator!= (const AABB2D<valuetype>& other) const { return !((*this) == other); }
+  AABB2D operator+ (const Vector2D<valuetype>& vector) const { AABB2D box{ *this }; box.Move(vector); return box; }
+  AABB2D operator- (const Vector2D<valuetype>& vector) const { AABB2D box{ *this }; box.Move(-vector); return box; }
+  void operator+= (const Vector2D<valuetype>& vector) { Move(vector); }
+  void operator-= (const Vector2D<valuetype>& vector) { Move(-vector); }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const AABB2D<valuetype>& box) { return os << "AABB2D(min=" << box.min_ << ", max=" << box.max_ << ")"; }
+
+  // Box-specific operations
+  void Move(const Vector2D<valuetype>& vector) { min_ += vector; max_ += vector; }
+  bool IsEmpty() const { return min_.x_ > max_.x_ || min_.y_ > max_.y_; }
+  Vector2D<valuetype> Size() const { return Vector2D<valuetype>(max_.x_ - min_.x_, max_.y_ - min_.y_); }
+  Point2D<valuetype> Center() const { return Point2D<valuetype>((min_.x_ + max_.x_) / valuetype(2), (min_.y_ + max_.y_) / valuetype(2)); }
+  valuetype Area() const { return IsEmpty() ? valuetype(0) : (max_.x_ - min_.x_) * (max_.y_ - min_.y_); }
+  bool Contains(const Point2D<valuetype>& p) const { return min_.x_ <= p.x_ && p.x_ <= max_.x_ && min_.y_ <= p.y_ && p.y_ <= max_.y_; }
+  bool Contains(const AABB2D<valuetype>& other) const { return min_.x_ <= other.min_.x_ && other.max_.x_ <= max_.x_ && min_.y_ <= other.min_.y_ && other.max_.y_ <= max_.y_; }
+  bool Overlaps(const AABB2D<valuetype>& other) const { return min_.x_ <= other.max_.x_ && other.min_.x_ <= max_.x_ && min_.y_ <= other.max_.y_ && other.min_.y_ <= max_.y_; }
+  // Smallest box containing both boxes, and the box both boxes contain (empty if they do not overlap).
+  AABB2D Merge(const AABB2D<valuetype>& other) const { AABB2D box{ *this }; box.Extend(other); return box; }
+  AABB2D Intersection(const AABB2D<valuetype>& other) const {
+    AABB2D box;
+    box.min_ = Point2D<valuetype>(min_.x_ > other.min_.x_ ? min_.x_ : other.min_.x_, min_.y_ > other.min_.y_ ? min_.y_ : other.min_.y_);
+    box.max_ = Point2D<valuetype>(max_.x_ < other.max_.x_ ? max_.x_ : other.max_.x_, max_.y_ < other.max_.y_ ? max_.y_ : other.max_.y_);
+    return box.IsEmpty() ? AABB2D() : box;
+  }
+  // Grows the box to contain p, or other.
+  void Extend(const Point2D<valuetype>& p) {
+    if (p.x_ < min_.x_) { min_.x_ = p.x_; }
+    if (p.y_ < min_.y_) { min_.y_ = p.y_; }
+    if (p.x_ > max_.x_) { max_.x_ = p.x_; }
+    if (p.y_ > max_.y_) { max_.y_ = p.y_; }
+  }
+  void Extend(const AABB2D<valuetype>& other) {
+    if (other.min_.x_ < min_.x_) { min_.x_ = other.min_.x_; }
+    if (other.min_.y_ < min_.y_) { min_.y_ = other.min_.y_; }
+    if (other.max_.x_ > max_.x_) { max_.x_ = other.max_.x_; }
+    if (other.max_.y_ > max_.y_) { max_.y_ = other.max_.y_; }
+  }
+  // Point of the box nearest to p (p itself when inside).
+  Point2D<valuetype> FindNearestPoint(const Point2D<valuetype>& p) const {
+    return Point2D<valuetype>(p.x_ < min_.x_ ? min_.x_ : (p.x_ > max_.x_ ? max_.x_ : p.x_), p.y_ < min_.y_ ? min_.y_ : (p.y_ > max_.y_ ? max_.y_ : p.y_));
+  }
+
+  Point2D<valuetype> min_, max_;
+};
+typedef AABB2D<int> AABB2Di;
+typedef AABB2D<float> AABB2Df;
+typedef AABB2D<double> AABB2Dd;
+
+// A three-dimensional axis-aligned bounding box.
+template<typename valuetype>
+struct AABB3D {
+  // Constructors
+  AABB3D()
+      : min_{ std::numeric_limits<valuetype>::max(), std::numeric_limits<valuetype>::max(), std::numeric_limits<valuetype>::max() },
+        max_{ std::numeric_limits<valuetype>::lowest(), std::numeric_limits<valuetype>::lowest(), std::numeric_limits<valuetype>::lowest() } { }
+  AABB3D(const AABB3D&) = default;
+  // Box spanned by two opposite corners, in any order.
+  AABB3D(const Point3D<valuetype>& p1, const Point3D<valuetype>& p2)
+      : min_{ p1.x_ < p2.x_ ? p1.x_ : p2.x_, p1.y_ < p2.y_ ? p1.y_ : p2.y_, p1.z_ < p2.z_ ? p1.z_ : p2.z_ },
+        max_{ p1.x_ < p2.x_ ? p2.x_ : p1.x_, p1.y_ < p2.y_ ? p2.y_ : p1.y_, p1.z_ < p2.z_ ? p2.z_ : p1.z_ } { }
+  AABB3D(valuetype x1, valuetype y1, valuetype z1, valuetype x2, valuetype y2, valuetype z2) : AABB3D(Point3D<valuetype>(x1, y1, z1), Point3D<valuetype>(x2, y2, z2)) { }
+  ~AABB3D() = default;
+
+  // Operators
+  AABB3D& operator=(const AABB3D&) = default;
+  bool operator== (const AABB3D<valuetype>& other) const { return min_ == other.min_ && max_ == other.max_; }
+  bool operator!= (const AABB3D<valuetype>& other) const { return !((*this) == other); }
+  AABB3D operator+ (const Vector3D<valuetype>& vector) const { AABB3D box{ *this }; box.Move(vector); return box; }
+  AABB3D operator- (const Vector3D<valuetype>& vector) const { AABB3D box{ *this }; box.Move(-vector); return box; }
+  void operator+= (const Vector3D<valuetype>& vector) { Move(vector); }
+  void operator-= (const Vector3D<valuetype>& vector) { Move(-vector); }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const AABB3D<valuetype>& box) { return os << "AABB3D(min=" << box.min_ << ", max=" << box.max_ << ")"; }
+
+  // Box-specific operations
+  void Move(const Vector3D<valuetype>& vector) { min_ += vector; max_ += vector; }
+  bool IsEmpty() const { return min_.x_ > max_.x_ || min_.y_ > max_.y_ || min_.z_ > max_.z_; }
+  Vector3D<valuetype> Size() const { return Vector3D<valuetype>(max_.x_ - min_.x_, max_.y_ - min_.y_, max_.z_ - min_.z_); }
+  Point3D<valuetype> Center() const { return Point3D<valuetype>((min_.x_ + max_.x_) / valuetype(2), (min_.y_ + max_.y_) / valuetype(2), (min_.z_ + max_.z_) / valuetype(2)); }
+  valuetype Volume() const { return IsEmpty() ? valuetype(0) : (max_.x_ - min_.x_) * (max_.y_ - min_.y_) * (max_.z_ - min_.z_); }
+  valuetype SurfaceArea() const {
+    if (IsEmpty()) { return valuetype(0); }
+    Vector3D<valuetype> size{ Size() };
+    return valuetype(2) * (size.x_ * size.y_ + size.y_ * size.z_ + size.z_ * size.x_);
+  }
+  bool Contains(const Point3D<valuetype>& p) const { return min_.x_ <= p.x_ && p.x_ <= max_.x_ && min_.y_ <= p.y_ && p.y_ <= max_.y_ && min_.z_ <= p.z_ && p.z_ <= max_.z_; }
+  bool Contains(const AABB3D<valuetype>& other) const {
+    return min_.x_ <= other.min_.x_ && other.max_.x_ <= max_.x_ && min_.y_ <= other.min_.y_ && other.max_.y_ <= max_.y_ && min_.z_ <= other.min_.z_ && other.max_.z_ <= max_.z_;
+  }
+  bool Overlaps(const AABB3D<valuetype>& other) const {
+    return min_.x_ <= other.max_.x_ && other.min_.x_ <= max_.x_ && min_.y_ <= other.max_.y_ && other.min_.y_ <= max_.y_ && min_.z_ <= other.max_.z_ && other.min_.z_ <= max_.z_;
+  }
+  // Smallest box containing both boxes, and the box both boxes contain (empty if they do not overlap).
+  AABB3D Merge(const AABB3D<valuetype>& other) const { AABB3D box{ *this }; box.Extend(other); return box; }
+  AABB3D Intersection(const AABB3D<valuetype>& other) const {
+    AABB3D box;
+    for (int i = 0; i < 3; ++i) {
+      box.min_[i] = (min_[i] > other.min_[i]) ? min_[i] : other.min_[i];
+      box.max_[i] = (max_[i] < other.max_[i]) ? max_[i] : other.max_[i];
+    }
+    return box.IsEmpty() ? AABB3D() : box;
+  }
+  // Grows the box to contain p, or other.
+  void Extend(const Point3D<valuetype>& p) {
+    if (p.x_ < min_.x_) { min_.x_ = p.x_; }
+    if (p.y_ < min_.y_) { min_.y_ = p.y_; }
+    if (p.z_ < min_.z_) { min_.z_ = p.z_; }
+    if (p.x_ > max_.x_) { max_.x_ = p.x_; }
+    if (p.y_ > max_.y_) { max_.y_ = p.y_; }
+    if (p.z_ > max_.z_) { max_.z_ = p.z_; }
+  }
+  void Extend(const AABB3D<valuetype>& other) {
+    if (other.min_.x_ < min_.x_) { min_.x_ = other.min_.x_; }
+    if (other.min_.y_ < min_.y_) { min_.y_ = other.min_.y_; }
+    if (other.min_.z_ < min_.z_) { min_.z_ = other.min_.z_; }
+    if (other.max_.x_ > max_.x_) { max_.x_ = other.max_.x_; }
+    if (other.max_.y_ > max_.y_) { max_.y_ = other.max_.y_; }
+    if (other.max_.z_ > max_.z_) { max_.z_ = other.max_.z_; }
+  }
+  // Point of the box nearest to p (p itself when inside).
+  Point3D<valuetype> FindNearestPoint(const Point3D<valuetype>& p) const {
+    Point3D<valuetype> nearest{ p };
+    for (int i = 0; i < 3; ++i) { nearest[i] = (p[i] < min_[i]) ? min_[i] : ((p[i] > max_[i]) ? max_[i] : p[i]); }
+    return nearest;
+  }
+
+  Point3D<valuetype> min_, max_;
+};
+typedef AABB3D<int> AABB3Di;
+typedef AABB3D<float> AABB3Df;
+typedef AABB3D<double> AABB3Dd;
+
+// Bounding boxes of shapes. The segment of a Line3D is given by the parameter range [s1, s2] of Line3D::GetPoint.
+template<typename valuetype>
+AABB2D<valuetype> BoundingBox(const Circle<valuetype>& circle) { return AABB2D<valuetype>(circle.c_.x_ - circle.r_, circle.c_.y_ - circle.r_, circle.c_.x_ + circle.r_, circle.c_.y_ + circle.r_); }
+
+template<typename valuetype>
+AABB3D<valuetype> BoundingBox(const Sphere<valuetype>& sphere) {
+  return AABB3D<valuetype>(sphere.c_.x_ - sphere.r_, sphere.c_.y_ - sphere.r_, sphere.c_.z_ - sphere.r_, sphere.c_.x_ + sphere.r_, sphere.c_.y_ + sphere.r_, sphere.c_.z_ + sphere.r_);
+}
+
+template<typename valuetype>
+AABB2D<valuetype> BoundingBox(const Rectangle2D<valuetype>& rectangle) { return AABB2D<valuetype>(rectangle); }
+
+template<typename valuetype>
+AABB2D<valuetype> BoundingBox(const LineSegment2D<valuetype>& segment) { return AABB2D<valuetype>(segment.p1_, segment.p2_); }
+
+template<typename valuetype>
+AABB3D<valuetype> BoundingBox(const Line3D<valuetype>& line, valuetype s1, valuetype s2) { return AABB3D<valuetype>(line.GetPoint(s1), line.GetPoint(s2)); }
+
+// Bounding box of a set of points, empty for an empty set. See aabb_batch.h for Point3DArray.
+template<typename valuetype>
+AABB2D<valuetype> BoundingBox(const std::vector<Point2D<valuetype>>& points) {
+  AABB2D<valuetype> box;
+  for (const Point2D<valuetype>& p : points) { box.Extend(p); }
+  return box;
+}
+
+template<typename valuetype>
+AABB3D<valuetype> BoundingBox(const std::vector<Point3D<valuetype>>& points) {
+  AABB3D<valuetype> box;
+  for (const Point3D<valuetype>& p : points) { box.Extend(p); }
+  return box;
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_AABB_H_
@@ -0,0 +1,382 @@
+#pragma once
+#ifndef J_MATH_AABB_BATCH_H_
+#define J_MATH_AABB_BATCH_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "..\utility\simd.h"
+#include "aabb.h"
+#include "point_array.h"
+#include "shape_classification.h"
+
+namespace j {
+namespace math {
+
+// Batch kernels over arrays of axis-aligned boxes stored as a structure of arrays (AABB3DArray), for broad-phase
+// collision detection and bounding volume construction. Overlap and containment tests write the same bitmask as the
+// shape classification kernels (see shape_classification.h) and give the same answer as the matching AABB3D member
+// function for every box. Same dispatch rules as vector_batch.h.
+
+namespace detail {
+
+// Pointers to the min and max components of a structure-of-arrays batch of boxes, one buffer per axis.
+template<typename valuetype>
+struct BoxComponents3D {
+  valuetype* min_[3];
+  valuetype* max_[3];
+};
+
+//
+// Generic kernels (any valuetype, elements [begin, end))
+//
+
+// Sets the mask bit of every box with min <= a and b <= max on all three axes. Overlap with a box q is a = q.max_,
+// b = q.min_; containment of a box q is a = q.min_, b = q.max_; containment of a point p is a = b = p. begin is a
+// multiple of the SIMD width, the words covering [begin, end) must be zeroed beforehand.
+template<typename valuetype>
+void BoxBoundsMaskGeneric(BoxComponents3D<const valuetype> boxes, const valuetype* a, const valuetype* b, uint64_t* mask, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    bool set = true;
+    for (int d = 0; d < 3; ++d) { set = set && boxes.min_[d][i] <= a[d] && b[d] <= boxes.max_[d][i]; }
+    if (set) { mask[i / 64] |= uint64_t(1) << (i % 64); }
+  }
+}
+
+// result[i] = min(a[i], b[i]), or the maximum when maximum is set. Written like minps and maxps, which return b on ties
+// (-0 and +0) and on NaN, so the scalar tails agree with the SIMD lanes.
+template<typename valuetype>
+void ElementwiseMinMaxGeneric(const valuetype* a, const valuetype* b, valuetype* result, bool maximum, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) { result[i] = maximum ? ((a[i] > b[i]) ? a[i] : b[i]) : ((a[i] < b[i]) ? a[i] : b[i]); }
+}
+
+// Minimum (or maximum) of value and values[begin, end). NaN values are skipped and -0 counts as below +0, so the result
+// does not depend on the order in which the SIMD kernels visit the values.
+template<typename valuetype>
+valuetype ReduceMinMaxGeneric(const valuetype* values, valuetype value, bool maximum, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    valuetype x = values[i];
+    bool replace = maximum ? (x > value || (x == value && !std::signbit(x))) : (x < value || (x == value && std::signbit(x)));
+    if (replace) { value = x; }
+  }
+  return value;
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+//
+// SSE2 kernels
+//
+J_MATH_TARGET_SSE2 inline void BoxBoundsMaskSse(BoxComponents3D<const float> boxes, const float* a, const float* b, uint64_t* mask, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 set = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int d = 0; d < 3; ++d) {
+      set = _mm_and_ps(set, _mm_cmple_ps(_mm_loadu_ps(boxes.min_[d] + i), _mm_set1_ps(a[d])));
+      set = _mm_and_ps(set, _mm_cmple_ps(_mm_set1_ps(b[d]), _mm_loadu_ps(boxes.max_[d] + i)));
+    }
+    mask[i / 64] |= uint64_t(_mm_movemask_ps(set)) << (i % 64);
+  }
+  BoxBoundsMaskGeneric(boxes, a, b, mask, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void BoxBoundsMaskSse(BoxComponents3D<const double> boxes, const double* a, const double* b, uint64_t* mask, size_t count) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d set = _mm_castsi128_pd(_mm_set1_epi32(-1));
+    for (int d = 0; d < 3; ++d) {
+      set = _mm_and_pd(set, _mm_cmple_pd(_mm_loadu_pd(boxes.min_[d] + i), _mm_set1_pd(a[d])));
+      set = _mm_and_pd(set, _mm_cmple_pd(_mm_set1_pd(b[d]), _mm_loadu_pd(boxes.max_[d] + i)));
+    }
+    mask[i / 64] |= uint64_t(_mm_movemask_pd(set)) << (i % 64);
+  }
+  BoxBoundsMaskGeneric(boxes, a, b, mask, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void ElementwiseMinMaxSse(const float* a, const float* b, float* result, bool maximum, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 va = _mm_loadu_ps(a + i), vb = _mm_loadu_ps(b + i);
+    _mm_storeu_ps(result + i, maximum ? _mm_max_ps(va, vb) : _mm_min_ps(va, vb));
+  }
+  ElementwiseMinMaxGeneric(a, b, result, maximum, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void ElementwiseMinMaxSse(const double* a, const double* b, double* result, bool maximum, size_t count) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d va = _mm_loadu_pd(a + i), vb = _mm_loadu_pd(b + i);
+    _mm_storeu_pd(result + i, maximum ? _mm_max_pd(va, vb) : _mm_min_pd(va, vb));
+  }
+  ElementwiseMinMaxGeneric(a, b, result, maximum, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline float ReduceMinMaxSse(const float* values, float value, bool maximum, size_t count) {
+  size_t i = 0;
+  __m128 v = _mm_set1_ps(value);
+  for (; i + 4 <= count; i += 4) {
+    // minps and maxps return v for NaN x; equal values are merged bitwise so that -0 wins the minimum, +0 the maximum
+    __m128 x = _mm_loadu_ps(values + i), equal = _mm_cmpeq_ps(x, v);
+    v = maximum ? _mm_andnot_ps(_mm_andnot_ps(x, equal), _mm_max_ps(x, v)) : _mm_or_ps(_mm_min_ps(x, v), _mm_and_ps(equal, x));
+  }
+  float lanes[4];
+  _mm_storeu_ps(lanes, v);
+  return ReduceMinMaxGeneric(values, ReduceMinMaxGeneric(lanes, value, maximum, 0, 4), maximum, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline double ReduceMinMaxSse(const double* values, double value, bool maximum, size_t count) {
+  size_t i = 0;
+  __m128d v = _mm_set1_pd(value);
+  for (; i + 2 <= count; i += 2) {
+    __m128d x = _mm_loadu_pd(values + i), equal = _mm_cmpeq_pd(x, v);
+    v = maximum ? _mm_andnot_pd(_mm_andnot_pd(x, equal), _mm_max_pd(x, v)) : _mm_or_pd(_mm_min_pd(x, v), _mm_and_pd(equal, x));
+  }
+  double lanes[2];
+  _mm_storeu_pd(lanes, v);
+  return ReduceMinMaxGeneric(values, ReduceMinMaxGeneric(lanes, value, maximum, 0, 2), maximum, i, count);
+}
+
+//
+// AVX2 kernels
+//
+J_MATH_TARGET_AVX2 inline void BoxBoundsMaskAvx2(BoxComponents3D<const float> boxes, const float* a, const float* b, uint64_t* mask, size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 set = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int d = 0; d < 3; ++d) {
+      set = _mm256_and_ps(set, _mm256_cmp_ps(_mm256_loadu_ps(boxes.min_[d] + i), _mm256_set1_ps(a[d]), _CMP_LE_OQ));
+      set = _mm256_and_ps(set, _mm256_cmp_ps(_mm256_set1_ps(b[d]), _mm256_loadu_ps(boxes.max_[d] + i), _CMP_LE_OQ));
+    }
+    mask[i / 64] |= uint64_t(_mm256_movemask_ps(set)) << (i % 64);
+  }
+  BoxBoundsMaskGeneric(boxes, a, b, mask, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void BoxBoundsMaskAvx2(BoxComponents3D<const double> boxes, const double* a, const double* b, uint64_t* mask, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d set = _mm256_castsi256_pd(_mm256_set1_epi32(-1));
+    for (int d = 0; d < 3; ++d) {
+      set = _mm256_and_pd(set, _mm256_cmp_pd(_mm256_loadu_pd(boxes.min_[d] + i), _mm256_set1_pd(a[d]), _CMP_LE_OQ));
+      set = _mm256_and_pd(set, _mm256_cmp_pd(_mm256_set1_pd(b[d]), _mm256_loadu_pd(boxes.max_[d] + i), _CMP_LE_OQ));
+    }
+    mask[i / 64] |= uint64_t(_mm256_movemask_pd(set)) << (i % 64);
+  }
+  BoxBoundsMaskGeneric(boxes, a, b, mask, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void ElementwiseMinMaxAvx2(const float* a, const float* b, float* result, bool maximum, size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 va = _mm256_loadu_ps(a + i), vb = _mm256_loadu_ps(b + i);
+    _mm256_storeu_ps(result + i, maximum ? _mm256_max_ps(va, vb) : _mm256_min_ps(va, vb));
+  }
+  ElementwiseMinMaxGeneric(a, b, result, maximum, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void ElementwiseMinMaxAvx2(const double* a, const double* b, double* result, bool maximum, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d va = _mm256_loadu_pd(a + i), vb = _mm256_loadu_pd(b + i);
+    _mm256_storeu_pd(result + i, maximum ? _mm256_max_pd(va, vb) : _mm256_min_pd(va, vb));
+  }
+  ElementwiseMinMaxGeneric(a, b, result, maximum, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline float ReduceMinMaxAvx2(const float* values, float value, bool maximum, size_t count) {
+  size_t i = 0;
+  __m256 v = _mm256_set1_ps(value);
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_loadu_ps(values + i), equal = _mm256_cmp_ps(x, v, _CMP_EQ_OQ);
+    v = maximum ? _mm256_andnot_ps(_mm256_andnot_ps(x, equal), _mm256_max_ps(x, v)) : _mm256_or_ps(_mm256_min_ps(x, v), _mm256_and_ps(equal, x));
+  }
+  float lanes[8];
+  _mm256_storeu_ps(lanes, v);
+  return ReduceMinMaxGeneric(values, ReduceMinMaxGeneric(lanes, value, maximum, 0, 8), maximum, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline double ReduceMinMaxAvx2(const double* values, double value, bool maximum, size_t count) {
+  size_t i = 0;
+  __m256d v = _mm256_set1_pd(value);
+  for (; i + 4 <= count; i += 4) {
+    __m256d x = _mm256_loadu_pd(values + i), equal = _mm256_cmp_pd(x, v, _CMP_EQ_OQ);
+    v = maximum ? _mm256_andnot_pd(_mm256_andnot_pd(x, equal), _mm256_max_pd(x, v)) : _mm256_or_pd(_mm256_min_pd(x, v), _mm256_and_pd(equal, x));
+  }
+  double lanes[4];
+  _mm256_storeu_pd(lanes, v);
+  return ReduceMinMaxGeneric(values, ReduceMinMaxGeneric(lanes, value, maximum, 0, 4), maximum, i, count);
+}
+
+#endif // J_MATH_SIMD_X86
+
+//
+// Runtime dispatch on the selected instruction set
+//
+template<typename valuetype>
+void BoxBoundsMaskDispatch(BoxComponents3D<const valuetype> boxes, const valuetype* a, const valuetype* b, uint64_t* mask, size_t count) { BoxBoundsMaskGeneric(boxes, a, b, mask, 0, count); }
+template<typename valuetype>
+void ElementwiseMinMaxDispatch(const valuetype* a, const valuetype* b, valuetype* result, bool maximum, size_t count) { ElementwiseMinMaxGeneric(a, b, result, maximum, 0, count); }
+template<typename valuetype>
+valuetype ReduceMinMaxDispatch(const valuetype* values, valuetype value, bool maximum, size_t count) { return ReduceMinMaxGeneric(values, value, maximum, 0, count); }
+
+#if defined(J_MATH_SIMD_X86)
+#define J_MATH_AABB_BATCH_DISPATCH(valuetype) \
+  inline void BoxBoundsMaskDispatch(BoxComponents3D<const valuetype> boxes, const valuetype* a, const valuetype* b, uint64_t* mask, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: BoxBoundsMaskAvx2(boxes, a, b, mask, count); return; \
+    case SimdLevel::SSE: BoxBoundsMaskSse(boxes, a, b, mask, count); return; \
+    default: BoxBoundsMaskGeneric(boxes, a, b, mask, 0, count); return; \
+    } \
+  } \
+  inline void ElementwiseMinMaxDispatch(const valuetype* a, const valuetype* b, valuetype* result, bool maximum, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: ElementwiseMinMaxAvx2(a, b, result, maximum, count); return; \
+    case SimdLevel::SSE: ElementwiseMinMaxSse(a, b, result, maximum, count); return; \
+    default: ElementwiseMinMaxGeneric(a, b, result, maximum, 0, count); return; \
+    } \
+  } \
+  inline valuetype ReduceMinMaxDispatch(const valuetype* values, valuetype value, bool maximum, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: return ReduceMinMaxAvx2(values, value, maximum, count); \
+    case SimdLevel::SSE: return ReduceMinMaxSse(values, value, maximum, count); \
+    default: return ReduceMinMaxGeneric(values, value, maximum, 0, count); \
+    } \
+  }
+J_MATH_AABB_BATCH_DISPATCH(float)
+J_MATH_AABB_BATCH_DISPATCH(double)
+#undef J_MATH_AABB_BATCH_DISPATCH
+#endif // J_MATH_SIMD_X86
+
+template<typename valuetype>
+void BoxBoundsMask(BoxComponents3D<const valuetype> boxes, const valuetype* a, const valuetype* b, uint64_t* mask, size_t count) {
+  for (size_t i = 0; i < MaskWords(count); ++i) { mask[i] = 0; }
+  BoxBoundsMaskDispatch(boxes, a, b, mask, count);
+}
+
+} // namespace detail
+
+// An array of three-dimensional axis-aligned boxes stored as a structure of arrays (separate buffers for each of the
+// min and max components), which the batch kernels below process directly.
+template<typename valuetype, typename allocator = std::allocator<valuetype>>
+struct AABB3DArray {
+  // Constructors
+  AABB3DArray() = default;
+  explicit AABB3DArray(const allocator& alloc) : min_x_(alloc), min_y_(alloc), min_z_(alloc), max_x_(alloc), max_y_(alloc), max_z_(alloc) { }
+  AABB3DArray(const AABB3DArray&) = default;
+  AABB3DArray(const std::vector<AABB3D<valuetype>>& boxes, const allocator& alloc = allocator()) : AABB3DArray(alloc) { Reserve(boxes.size()); for (const AABB3D<valuetype>& box : boxes) { Add(box); } }
+  ~AABB3DArray() = default;
+
+  // Operators
+  AABB3DArray& operator=(const AABB3DArray&) = default;
+  AABB3D<valuetype> operator[](size_t i) const { return Get(i); }
+
+  // Conversion to an array of structs
+  std::vector<AABB3D<valuetype>> ToVector() const {
+    std::vector<AABB3D<valuetype>> boxes;
+    boxes.reserve(Length());
+    for (size_t i = 0; i < Length(); ++i) { boxes.push_back(Get(i)); }
+    return boxes;
+  }
+
+  // Array-specific operations
+  void Add(const AABB3D<valuetype>& box) {
+    min_x_.push_back(box.min_.x_); min_y_.push_back(box.min_.y_); min_z_.push_back(box.min_.z_);
+    max_x_.push_back(box.max_.x_); max_y_.push_back(box.max_.y_); max_z_.push_back(box.max_.z_);
+  }
+  AABB3D<valuetype> Get(size_t i) const {
+    AABB3D<valuetype> box;
+    box.min_ = Point3D<valuetype>(min_x_[i], min_y_[i], min_z_[i]);
+    box.max_ = Point3D<valuetype>(max_x_[i], max_y_[i], max_z_[i]);
+    return box;
+  }
+  void Set(size_t i, const AABB3D<valuetype>& box) {
+    min_x_[i] = box.min_.x_; min_y_[i] = box.min_.y_; min_z_[i] = box.min_.z_;
+    max_x_[i] = box.max_.x_; max_y_[i] = box.max_.y_; max_z_[i] = box.max_.z_;
+  }
+  size_t Length() const { return min_x_.size(); }
+  void Resize(size_t length) { min_x_.resize(length); min_y_.resize(length); min_z_.resize(length); max_x_.resize(length); max_y_.resize(length); max_z_.resize(length); }
+  void Reserve(size_t length) { min_x_.reserve(length); min_y_.reserve(length); min_z_.reserve(length); max_x_.reserve(length); max_y_.reserve(length); max_z_.reserve(length); }
+  void Clear() { min_x_.clear(); min_y_.clear(); min_z_.clear(); max_x_.clear(); max_y_.clear(); max_z_.clear(); }
+  allocator GetAllocator() const { return min_x_.get_allocator(); }
+
+  // Component pointers in the form expected by the batch kernels
+  detail::BoxComponents3D<const valuetype> Read() const {
+    return detail::BoxComponents3D<const valuetype>{ { min_x_.data(), min_y_.data(), min_z_.data() }, { max_x_.data(), max_y_.data(), max_z_.data() } };
+  }
+  detail::BoxComponents3D<valuetype> Write() {
+    return detail::BoxComponents3D<valuetype>{ { min_x_.data(), min_y_.data(), min_z_.data() }, { max_x_.data(), max_y_.data(), max_z_.data() } };
+  }
+
+private:
+  std::vector<valuetype, allocator> min_x_, min_y_, min_z_, max_x_, max_y_, max_z_;
+};
+
+using aabb3arrayi = AABB3DArray<int>;
+using aabb3arrayf = AABB3DArray<float>;
+using aabb3arrayd = AABB3DArray<double>;
+
+// Boxes for which boxes[i].Overlaps(box) holds.
+template<typename valuetype, typename boxes_allocator>
+void BatchOverlaps(const AABB3DArray<valuetype, boxes_allocator>& boxes, const AABB3D<valuetype>& box, std::vector<uint64_t>& mask) {
+  mask.resize(MaskWords(boxes.Length()));
+  valuetype a[3] = { box.max_.x_, box.max_.y_, box.max_.z_ }, b[3] = { box.min_.x_, box.min_.y_, box.min_.z_ };
+  detail::BoxBoundsMask(boxes.Read(), a, b, mask.data(), boxes.Length());
+}
+
+// Boxes for which boxes[i].Contains(p) / boxes[i].Contains(box) holds.
+template<typename valuetype, typename boxes_allocator>
+void BatchContains(const AABB3DArray<valuetype, boxes_allocator>& boxes, const Point3D<valuetype>& p, std::vector<uint64_t>& mask) {
+  mask.resize(MaskWords(boxes.Length()));
+  valuetype a[3] = { p.x_, p.y_, p.z_ };
+  detail::BoxBoundsMask(boxes.Read(), a, a, mask.data(), boxes.Length());
+}
+template<typename valuetype, typename boxes_allocator>
+void BatchContains(const AABB3DArray<valuetype, boxes_allocator>& boxes, const AABB3D<valuetype>& box, std::vector<uint64_t>& mask) {
+  mask.resize(MaskWords(boxes.Length()));
+  valuetype a[3] = { box.min_.x_, box.min_.y_, box.min_.z_ }, b[3] = { box.max_.x_, box.max_.y_, box.max_.z_ };
+  detail::BoxBoundsMask(boxes.Read(), a, b, mask.data(), boxes.Length());
+}
+
+// result[i] = a[i].Merge(b[i]). a and b must have the same length, the result is resized to that length.
+template<typename valuetype, typename a_allocator, typename b_allocator, typename result_allocator>
+void BatchMerge(const AABB3DArray<valuetype, a_allocator>& a, const AABB3DArray<valuetype, b_allocator>& b, AABB3DArray<valuetype, result_allocator>& result) {
+  result.Resize(a.Length());
+  detail::BoxComponents3D<const valuetype> ca = a.Read(), cb = b.Read();
+  detail::BoxComponents3D<valuetype> cr = result.Write();
+  for (int d = 0; d < 3; ++d) {
+    detail::ElementwiseMinMaxDispatch(ca.min_[d], cb.min_[d], cr.min_[d], false, a.Length());
+    detail::ElementwiseMinMaxDispatch(ca.max_[d], cb.max_[d], cr.max_[d], true, a.Length());
+  }
+}
+
+// Smallest box containing all boxes, or all points; empty for an empty array.
+template<typename valuetype, typename boxes_allocator>
+AABB3D<valuetype> BoundingBox(const AABB3DArray<valuetype, boxes_allocator>& boxes) {
+  AABB3D<valuetype> box;
+  detail::BoxComponents3D<const valuetype> components = boxes.Read();
+  for (int d = 0; d < 3; ++d) {
+    box.min_[d] = detail::ReduceMinMaxDispatch(components.min_[d], box.min_[d], false, boxes.Length());
+    box.max_[d] = detail::ReduceMinMaxDispatch(components.max_[d], box.max_[d], true, boxes.Length());
+  }
+  return box;
+}
+
+template<typename valuetype, typename points_allocator>
+AABB3D<valuetype> BoundingBox(const Point3DArray<valuetype, points_allocator>& points) {
+  AABB3D<valuetype> box;
+  detail::Components3D<const valuetype> components = points.Read();
+  const valuetype* axes[3] = { components.x_, components.y_, components.z_ };
+  for (int d = 0; d < 3; ++d) {
+    box.min_[d] = detail::ReduceMinMaxDispatch(axes[d], box.min_[d], false, points.Length());
+    box.max_[d] = detail::ReduceMinMaxDispatch(axes[d], box.max_[d], true, points.Length());
+  }
+  return box;
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_AABB_BATCH_H_
@@ -0,0 +1,73 @@
+#pragma once
+#ifndef J_MATH_AFFINE_TRANSFORM_H_
+#define J_MATH_AFFINE_TRANSFORM_H_
+
+#include <iostream>
+#include "coordinate_frame.h"
+#include "matrix.h"
+#include "point.h"
+#include "vector.h"
+
+namespace j {
+namespace math {
+
+// An affine transformation in three-dimensional space. Represented by a linear part (m) followed by a translation (t),
+// so a point p maps to m * p + t. Cheaper to compose, invert and apply than the equivalent Matrix4x4.
+template<typename valuetype>
+struct AffineTransform3D {
+  // Constructors
+  constexpr AffineTransform3D() : m_{ Matrix3x3<valuetype>::Identity() }, t_{ 0, 0, 0 } { }
+  AffineTransform3D(const AffineTransform3D&) = default;
+  constexpr AffineTransform3D(const Matrix3x3<valuetype>& m, const Vector3D<valuetype>& t) : m_{ m }, t_{ t } { }
+  // Maps coordinates in the frame to canonical coordinates, see CoordinateFrame3D::CoordinateFrameToCanonicalCoordinates.
+  constexpr explicit AffineTransform3D(const CoordinateFrame3D<valuetype>& frame) : m_{ Matrix3x3<valuetype>::FromColumns(frame.u_, frame.v_, frame.w_) }, t_{ frame.p_.x_, frame.p_.y_, frame.p_.z_ } { }
+  // Upper three rows of an affine Matrix4x4 (see Matrix4x4::IsAffine).
+  constexpr explicit AffineTransform3D(const Matrix4x4<valuetype>& m) : m_{ m.m_[0][0], m.m_[0][1], m.m_[0][2], m.m_[1][0], m.m_[1][1], m.m_[1][2], m.m_[2][0], m.m_[2][1], m.m_[2][2] }, t_{ m.m_[0][3], m.m_[1][3], m.m_[2][3] } { }
+  ~AffineTransform3D() = default;
+  static constexpr AffineTransform3D Identity() { return AffineTransform3D(); }
+  static constexpr AffineTransform3D Translation(const Vector3D<valuetype>& t) { return AffineTransform3D(Matrix3x3<valuetype>::Identity(), t); }
+  static constexpr AffineTransform3D Scale(const Vector3D<valuetype>& s) { return AffineTransform3D(Matrix3x3<valuetype>::Scale(s), Vector3D<valuetype>(0, 0, 0)); }
+  static AffineTransform3D Rotation(const Vector3D<valuetype>& axis, valuetype angle_radians) { return AffineTransform3D(Matrix3x3<valuetype>::Rotation(axis, angle_radians), Vector3D<valuetype>(0, 0, 0)); }
+
+  // Operators
+  AffineTransform3D& operator=(const AffineTransform3D&) = default;
+  constexpr bool operator== (const AffineTransform3D& other) const { return (m_ == other.m_ && t_ == other.t_); }
+  constexpr bool operator!= (const AffineTransform3D& other) const { return (m_ != other.m_ || t_ != other.t_); }
+  // Composition, (a * b)(p) == a(b(p))
+  constexpr AffineTransform3D operator* (const AffineTransform3D& other) const { return AffineTransform3D(m_ * other.m_, m_ * other.t_ + t_); }
+  constexpr void operator*= (const AffineTransform3D& other) { *this = operator*(other); }
+  constexpr Point3D<valuetype> operator()(const Point3D<valuetype>& p) const { return TransformPoint(p); }
+
+  // Cast to different valuetype
+  template<typename other_valuetype> constexpr operator AffineTransform3D<other_valuetype>() const { return AffineTransform3D<other_valuetype>(Matrix3x3<other_valuetype>(m_), Vector3D<other_valuetype>(t_)); }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const AffineTransform3D& transform) { return os << "AffineTransform3D(m=" << transform.m_ << ", t=" << transform.t_ << ")"; }
+
+  // Transform-specific functions
+  constexpr Point3D<valuetype> TransformPoint(const Point3D<valuetype>& p) const {
+    return Point3D<valuetype>(m_.m_[0][0] * p.x_ + m_.m_[0][1] * p.y_ + m_.m_[0][2] * p.z_ + t_.x_, m_.m_[1][0] * p.x_ + m_.m_[1][1] * p.y_ + m_.m_[1][2] * p.z_ + t_.y_, m_.m_[2][0] * p.x_ + m_.m_[2][1] * p.y_ + m_.m_[2][2] * p.z_ + t_.z_);
+  }
+  constexpr Vector3D<valuetype> TransformVector(const Vector3D<valuetype>& v) const { return m_ * v; }
+  constexpr bool IsInvertible() const { return m_.IsInvertible(); }
+  // Only meaningful when IsInvertible().
+  constexpr AffineTransform3D Inverse() const { Matrix3x3<valuetype> inverse = m_.Inverse(); return AffineTransform3D(inverse, -(inverse * t_)); }
+  // Inverse of a rotation followed by a translation, using the transpose instead of a full inversion. Only meaningful
+  // when the linear part is orthonormal.
+  constexpr AffineTransform3D InverseRigid() const { Matrix3x3<valuetype> inverse = m_.Transpose(); return AffineTransform3D(inverse, -(inverse * t_)); }
+  constexpr Matrix4x4<valuetype> ToMatrix4x4() const {
+    return Matrix4x4<valuetype>(m_.m_[0][0], m_.m_[0][1], m_.m_[0][2], t_.x_, m_.m_[1][0], m_.m_[1][1], m_.m_[1][2], t_.y_, m_.m_[2][0], m_.m_[2][1], m_.m_[2][2], t_.z_, 0, 0, 0, 1);
+  }
+  // Frame whose origin and base vectors are the images of the canonical origin and base vectors.
+  constexpr CoordinateFrame3D<valuetype> ToCoordinateFrame() const { return CoordinateFrame3D<valuetype>(Point3D<valuetype>(t_.x_, t_.y_, t_.z_), m_.Column(0), m_.Column(1), m_.Column(2)); }
+
+  Matrix3x3<valuetype> m_;
+  Vector3D<valuetype> t_;
+};
+typedef AffineTransform3D<float> AffineTransform3f;
+typedef AffineTransform3D<double> AffineTransform3d;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_AFFINE_TRANSFORM_H_
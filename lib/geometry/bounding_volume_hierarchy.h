@@ -0,0 +1,424 @@
+#pragma once
+#ifndef J_MATH_BOUNDING_VOLUME_HIERARCHY_H_
+#define J_MATH_BOUNDING_VOLUME_HIERARCHY_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "point.h"
+#include "shape_types.h"
+#include "sphere.h"
+#include "vector.h"
+
+namespace j {
+namespace math {
+
+namespace detail {
+
+// Slab test of the ray o + t * d against an axis-aligned box. Returns the parameter interval [t_enter, t_exit] of the
+// ray inside the box, clipped to [0, t_max].
+template<typename valuetype, int dimensions, typename point, typename vector>
+bool IntersectSlabs(const valuetype* min, const valuetype* max, const point& o, const vector& d, valuetype t_max, valuetype* t_enter, valuetype* t_exit) {
+  valuetype t0 = valuetype(0), t1 = t_max;
+  for (int i = 0; i < dimensions; ++i) {
+    if (d[i] == valuetype(0)) {
+      if (o[i] < min[i] || o[i] > max[i]) { return false; }
+      continue;
+    }
+    valuetype inverse = valuetype(1) / d[i];
+    valuetype t_near = (min[i] - o[i]) * inverse;
+    valuetype t_far = (max[i] - o[i]) * inverse;
+    if (t_near > t_far) { std::swap(t_near, t_far); }
+    if (t_near > t0) { t0 = t_near; }
+    if (t_far < t1) { t1 = t_far; }
+    if (t0 > t1) { return false; }
+  }
+  *t_enter = t0;
+  *t_exit = t1;
+  return true;
+}
+
+} // namespace detail
+
+// Describes how the bounding volume hierarchy handles a primitive type: its value and point types, dimensionality, bounding box,
+// containment test, nearest surface point and first surface hit of a ray o + t * d (t >= 0).
+// Specialized for Sphere, Circle and Rectangle2D. Planes are unbounded and cannot be stored in a hierarchy.
+template<typename primitive>
+struct BvhPrimitiveTraits;
+
+template<typename valuetype>
+struct BvhPrimitiveTraits<Sphere<valuetype>> {
+  using scalar = valuetype;
+  using point = Point3D<valuetype>;
+  using vector = Vector3D<valuetype>;
+  static const int kDimensions = 3;
+
+  static void Bounds(const Sphere<valuetype>& s, valuetype* min, valuetype* max) {
+    for (int i = 0; i < kDimensions; ++i) { min[i] = s.c_[i] - s.r_; max[i] = s.c_[i] + s.r_; }
+  }
+  static bool Contains(const Sphere<valuetype>& s, const point& p) { return s.IsInside(p); }
+  static point FindNearestPoint(const Sphere<valuetype>& s, const point& p) { return s.FindNearestPoint(p); }
+  static bool IntersectRay(const Sphere<valuetype>& s, const point& o, const vector& d, valuetype t_max, valuetype* t) {
+    vector oc(o.x_ - s.c_.x_, o.y_ - s.c_.y_, o.z_ - s.c_.z_);
+    return IntersectQuadric(d.LengthSquared(), oc.ScalarProduct(d), oc.LengthSquared() - s.r_ * s.r_, t_max, t);
+  }
+
+  // Smallest root t in [0, t_max] of a * t^2 + 2 * half_b * t + c = 0.
+  static bool IntersectQuadric(valuetype a, valuetype half_b, valuetype c, valuetype t_max, valuetype* t) {
+    valuetype discriminant = half_b * half_b - a * c;
+    if (discriminant < valuetype(0) || a == valuetype(0)) { return false; }
+    valuetype root = std::sqrt(discriminant);
+    valuetype t0 = (-half_b - root) / a;
+    valuetype t1 = (-half_b + root) / a;
+    valuetype hit = (t0 >= valuetype(0)) ? t0 : t1;
+    if (hit < valuetype(0) || hit > t_max) { return false; }
+    *t = hit;
+    return true;
+  }
+};
+
+template<typename valuetype>
+struct BvhPrimitiveTraits<Circle<valuetype>> {
+  using scalar = valuetype;
+  using point = Point2D<valuetype>;
+  using vector = Vector2D<valuetype>;
+  static const int kDimensions = 2;
+
+  static void Bounds(const Circle<valuetype>& c, valuetype* min, valuetype* max) {
+    for (int i = 0; i < kDimensions; ++i) { min[i] = c.c_[i] - c.r_; max[i] = c.c_[i] + c.r_; }
+  }
+  static bool Contains(const Circle<valuetype>& c, const point& p) { return c.IsInside(p); }
+  static point FindNearestPoint(const Circle<valuetype>& c, const point& p) { return c.FindNearestPoint(p); }
+  static bool IntersectRay(const Circle<valuetype>& c, const point& o, const vector& d, valuetype t_max, valuetype* t) {
+    vector oc(o.x_ - c.c_.x_, o.y_ - c.c_.y_);
+    return BvhPrimitiveTraits<Sphere<valuetype>>::IntersectQuadric(d.LengthSquared(), oc.ScalarProduct(d), oc.LengthSquared() - c.r_ * c.r_, t_max, t);
+  }
+};
+
+template<typename valuetype>
+struct BvhPrimitiveTraits<Rectangle2D<valuetype>> {
+  using scalar = valuetype;
+  using point = Point2D<valuetype>;
+  using vector = Vector2D<valuetype>;
+  static const int kDimensions = 2;
+
+  static void Bounds(const Rectangle2D<valuetype>& r, valuetype* min, valuetype* max) {
+    Rectangle2D<valuetype> ordered{ r.ReorderPoints() };
+    for (int i = 0; i < kDimensions; ++i) { min[i] = ordered.p1_[i]; max[i] = ordered.p2_[i]; }
+  }
+  static bool Contains(const Rectangle2D<valuetype>& r, const point& p) { return r.Contains(p); }
+  static point FindNearestPoint(const Rectangle2D<valuetype>& r, const point& p) { return r.FindNearestPoint(p); }
+  static bool IntersectRay(const Rectangle2D<valuetype>& r, const point& o, const vector& d, valuetype t_max, valuetype* t) {
+    valuetype min[kDimensions], max[kDimensions], t_enter, t_exit;
+    Bounds(r, min, max);
+    if (!detail::IntersectSlabs<valuetype, kDimensions>(min, max, o, d, t_max, &t_enter, &t_exit)) { return false; }
+    valuetype hit = (t_enter > valuetype(0)) ? t_enter : t_exit;
+    if (hit > t_max) { return false; }
+    *t = hit;
+    return true;
+  }
+};
+
+// A bounding volume hierarchy over a set of bounded primitives (Sphere, Circle, Rectangle2D). Built top-down with the
+// binned surface area heuristic and stored as a flat depth-first array of nodes: the first child of an interior node
+// directly follows it, the second child is referenced by index. Leaves reference a contiguous range of the primitives,
+// which are stored in leaf order. All queries report primitive indices in the order the primitives were passed in.
+template<typename primitive>
+class BoundingVolumeHierarchy {
+public:
+  using traits = BvhPrimitiveTraits<primitive>;
+  using point = typename traits::point;
+  using vector = typename traits::vector;
+  using valuetype = typename traits::scalar;
+  static const int kDimensions = traits::kDimensions;
+
+  // A node of the hierarchy. Leaves have count_ > 0 and cover primitives [offset_, offset_ + count_), interior nodes
+  // have count_ == 0 and their second child at index offset_.
+  struct Node {
+    valuetype min_[kDimensions];
+    valuetype max_[kDimensions];
+    uint32_t offset_;
+    uint32_t count_;
+  };
+
+  // Constructors
+  BoundingVolumeHierarchy() = default;
+  BoundingVolumeHierarchy(const BoundingVolumeHierarchy&) = default;
+  explicit BoundingVolumeHierarchy(const std::vector<primitive>& primitives) { Build(primitives); }
+  ~BoundingVolumeHierarchy() = default;
+
+  // Operators
+  BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy&) = default;
+
+  // Construction and updates
+  void Build(const std::vector<primitive>& primitives) {
+    primitives_ = primitives;
+    indices_.resize(primitives.size());
+    positions_.resize(primitives.size());
+    nodes_.clear();
+    if (primitives.empty()) { return; }
+    std::vector<BuildEntry> entries(primitives.size());
+    for (size_t i = 0; i < primitives.size(); ++i) {
+      traits::Bounds(primitives[i], entries[i].min_, entries[i].max_);
+      for (int a = 0; a < kDimensions; ++a) { entries[i].centroid_[a] = (entries[i].min_[a] + entries[i].max_[a]) / valuetype(2); }
+      entries[i].index_ = i;
+    }
+    nodes_.reserve(2 * primitives.size());
+    BuildNode(entries, 0, entries.size(), 0);
+    for (size_t i = 0; i < entries.size(); ++i) { indices_[i] = entries[i].index_; }
+    std::vector<primitive> ordered;
+    ordered.reserve(primitives.size());
+    for (size_t i = 0; i < indices_.size(); ++i) { ordered.push_back(primitives[indices_[i]]); positions_[indices_[i]] = i; }
+    primitives_.swap(ordered);
+  }
+  // Replace a primitive while keeping the tree topology. Call Refit() once all primitives are updated.
+  void Set(size_t index, const primitive& p) { primitives_[positions_[index]] = p; }
+  // Recompute the node bounds bottom-up after primitives were moved with Set(). Cheaper than a rebuild, but the tree
+  // quality degrades when primitives move far from their original position.
+  void Refit() {
+    for (size_t n = nodes_.size(); n-- > 0;) {
+      Node& node = nodes_[n];
+      if (node.count_ > 0) {
+        SetBounds(node, node.offset_, node.offset_ + node.count_);
+      } else {
+        const Node& left = nodes_[n + 1];
+        const Node& right = nodes_[node.offset_];
+        for (int a = 0; a < kDimensions; ++a) {
+          node.min_[a] = std::min(left.min_[a], right.min_[a]);
+          node.max_[a] = std::max(left.max_[a], right.max_[a]);
+        }
+      }
+    }
+  }
+
+  // Accessors
+  const primitive& Get(size_t index) const { return primitives_[positions_[index]]; }
+  size_t Size() const { return primitives_.size(); }
+  const std::vector<Node>& Nodes() const { return nodes_; }
+
+  // Indices of all primitives that contain p.
+  void FindContaining(const point& p, std::vector<size_t>& indices) const {
+    indices.clear();
+    if (nodes_.empty()) { return; }
+    uint32_t stack[kStackSize];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+      uint32_t n = stack[--top];
+      const Node& node = nodes_[n];
+      if (!BoxContains(node, p)) { continue; }
+      if (node.count_ > 0) {
+        for (uint32_t i = node.offset_; i < node.offset_ + node.count_; ++i) {
+          if (traits::Contains(primitives_[i], p)) { indices.push_back(indices_[i]); }
+        }
+      } else {
+        stack[top++] = node.offset_;
+        stack[top++] = n + 1;
+      }
+    }
+  }
+
+  // Nearest point on the surface of any primitive. Returns false when the hierarchy is empty.
+  bool FindNearestPoint(const point& p, point* nearest, size_t* index = nullptr) const {
+    if (nodes_.empty()) { return false; }
+    valuetype best = std::numeric_limits<valuetype>::max();
+    uint32_t stack[kStackSize];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+      uint32_t n = stack[--top];
+      const Node& node = nodes_[n];
+      if (BoxDistanceSquared(node, p) >= best) { continue; }
+      if (node.count_ > 0) {
+        for (uint32_t i = node.offset_; i < node.offset_ + node.count_; ++i) {
+          point candidate = traits::FindNearestPoint(primitives_[i], p);
+          valuetype d = (candidate - p).LengthSquared();
+          if (d < best) {
+            best = d;
+            *nearest = candidate;
+            if (index != nullptr) { *index = indices_[i]; }
+          }
+        }
+      } else {
+        // Visit the closer child first
+        uint32_t first = n + 1, second = node.offset_;
+        if (BoxDistanceSquared(nodes_[first], p) > BoxDistanceSquared(nodes_[second], p)) { std::swap(first, second); }
+        stack[top++] = second;
+        stack[top++] = first;
+      }
+    }
+    return true;
+  }
+
+  // First surface hit of the ray o + t * d with t in [0, t_max]. Returns false when nothing is hit.
+  bool IntersectRay(const point& o, const vector& d, valuetype* t, size_t* index = nullptr, valuetype t_max = std::numeric_limits<valuetype>::max()) const {
+    if (nodes_.empty()) { return false; }
+    bool hit = false;
+    uint32_t stack[kStackSize];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+      uint32_t n = stack[--top];
+      const Node& node = nodes_[n];
+      valuetype t_enter, t_exit;
+      if (!detail::IntersectSlabs<valuetype, kDimensions>(node.min_, node.max_, o, d, t_max, &t_enter, &t_exit)) { continue; }
+      if (node.count_ > 0) {
+        for (uint32_t i = node.offset_; i < node.offset_ + node.count_; ++i) {
+          valuetype t_hit;
+          if (traits::IntersectRay(primitives_[i], o, d, t_max, &t_hit)) {
+            t_max = t_hit;
+            hit = true;
+            if (index != nullptr) { *index = indices_[i]; }
+          }
+        }
+      } else {
+        stack[top++] = node.offset_;
+        stack[top++] = n + 1;
+      }
+    }
+    if (hit) { *t = t_max; }
+    return hit;
+  }
+
+private:
+  static const int kMaxDepth = 60; // Bounds the traversal stack
+  static const int kStackSize = kMaxDepth + 2;
+  static const size_t kMaxLeafSize = 4;
+  static const int kBins = 12;
+
+  struct BuildEntry {
+    valuetype min_[kDimensions];
+    valuetype max_[kDimensions];
+    valuetype centroid_[kDimensions];
+    size_t index_;
+  };
+
+  // Box extent in a form proportional to the probability that a random ray hits it (surface area in 3D,
+  // perimeter in 2D). The constant factor cancels out in the heuristic.
+  static valuetype SurfaceMeasure(const valuetype* min, const valuetype* max) {
+    valuetype e[kDimensions];
+    for (int a = 0; a < kDimensions; ++a) { e[a] = (max[a] > min[a]) ? max[a] - min[a] : valuetype(0); }
+    if (kDimensions == 2) { return e[0] + e[1]; }
+    return e[0] * e[1] + e[1] * e[kDimensions - 1] + e[kDimensions - 1] * e[0];
+  }
+
+  static bool BoxContains(const Node& node, const point& p) {
+    for (int a = 0; a < kDimensions; ++a) { if (p[a] < node.min_[a] || p[a] > node.max_[a]) { return false; } }
+    return true;
+  }
+
+  static valuetype BoxDistanceSquared(const Node& node, const point& p) {
+    valuetype d = valuetype(0);
+    for (int a = 0; a < kDimensions; ++a) {
+      valuetype e = (p[a] < node.min_[a]) ? node.min_[a] - p[a] : ((p[a] > node.max_[a]) ? p[a] - node.max_[a] : valuetype(0));
+      d += e * e;
+    }
+    return d;
+  }
+
+  void SetBounds(Node& node, size_t begin, size_t end) const {
+    for (int a = 0; a < kDimensions; ++a) { node.min_[a] = std::numeric_limits<valuetype>::max(); node.max_[a] = std::numeric_limits<valuetype>::lowest(); }
+    for (size_t i = begin; i < end; ++i) {
+      valuetype min[kDimensions], max[kDimensions];
+      traits::Bounds(primitives_[i], min, max);
+      for (int a = 0; a < kDimensions; ++a) { node.min_[a] = std::min(node.min_[a], min[a]); node.max_[a] = std::max(node.max_[a], max[a]); }
+    }
+  }
+
+  uint32_t BuildNode(std::vector<BuildEntry>& entries, size_t begin, size_t end, int depth) {
+    uint32_t n = uint32_t(nodes_.size());
+    nodes_.push_back(Node());
+    valuetype min[kDimensions], max[kDimensions], centroid_min[kDimensions], centroid_max[kDimensions];
+    for (int a = 0; a < kDimensions; ++a) {
+      min[a] = centroid_min[a] = std::numeric_limits<valuetype>::max();
+      max[a] = centroid_max[a] = std::numeric_limits<valuetype>::lowest();
+    }
+    for (size_t i = begin; i < end; ++i) {
+      for (int a = 0; a < kDimensions; ++a) {
+        min[a] = std::min(min[a], entries[i].min_[a]);
+        max[a] = std::max(max[a], entries[i].max_[a]);
+        centroid_min[a] = std::min(centroid_min[a], entries[i].centroid_[a]);
+        centroid_max[a] = std::max(centroid_max[a], entries[i].centroid_[a]);
+      }
+    }
+    for (int a = 0; a < kDimensions; ++a) { nodes_[n].min_[a] = min[a]; nodes_[n].max_[a] = max[a]; }
+
+    size_t count = end - begin;
+    int split_axis = -1;
+    int split_bin = 0;
+    if (count > kMaxLeafSize && depth < kMaxDepth) {
+      // Binned surface area heuristic: cost = traversal + sum(area(child) / area(node) * primitives(child))
+      valuetype best_cost = valuetype(count) * SurfaceMeasure(min, max);
+      for (int a = 0; a < kDimensions; ++a) {
+        valuetype extent = centroid_max[a] - centroid_min[a];
+        if (extent <= valuetype(0)) { continue; }
+        size_t bin_count[kBins] = {};
+        valuetype bin_min[kBins][kDimensions], bin_max[kBins][kDimensions];
+        for (int b = 0; b < kBins; ++b) {
+          for (int k = 0; k < kDimensions; ++k) { bin_min[b][k] = std::numeric_limits<valuetype>::max(); bin_max[b][k] = std::numeric_limits<valuetype>::lowest(); }
+        }
+        for (size_t i = begin; i < end; ++i) {
+          int b = BinIndex(entries[i].centroid_[a], centroid_min[a], extent);
+          ++bin_count[b];
+          for (int k = 0; k < kDimensions; ++k) { bin_min[b][k] = std::min(bin_min[b][k], entries[i].min_[k]); bin_max[b][k] = std::max(bin_max[b][k], entries[i].max_[k]); }
+        }
+        // Sweep from the right to get the cost of every right-hand side, then from the left to evaluate each split
+        valuetype right_cost[kBins];
+        valuetype sweep_min[kDimensions], sweep_max[kDimensions];
+        size_t sweep_count = 0;
+        for (int k = 0; k < kDimensions; ++k) { sweep_min[k] = std::numeric_limits<valuetype>::max(); sweep_max[k] = std::numeric_limits<valuetype>::lowest(); }
+        for (int b = kBins - 1; b > 0; --b) {
+          sweep_count += bin_count[b];
+          for (int k = 0; k < kDimensions; ++k) { sweep_min[k] = std::min(sweep_min[k], bin_min[b][k]); sweep_max[k] = std::max(sweep_max[k], bin_max[b][k]); }
+          right_cost[b] = valuetype(sweep_count) * SurfaceMeasure(sweep_min, sweep_max);
+        }
+        sweep_count = 0;
+        for (int k = 0; k < kDimensions; ++k) { sweep_min[k] = std::numeric_limits<valuetype>::max(); sweep_max[k] = std::numeric_limits<valuetype>::lowest(); }
+        for (int b = 0; b < kBins - 1; ++b) {
+          sweep_count += bin_count[b];
+          for (int k = 0; k < kDimensions; ++k) { sweep_min[k] = std::min(sweep_min[k], bin_min[b][k]); sweep_max[k] = std::max(sweep_max[k], bin_max[b][k]); }
+          if (sweep_count == 0 || sweep_count == count) { continue; }
+          valuetype cost = SurfaceMeasure(min, max) + valuetype(sweep_count) * SurfaceMeasure(sweep_min, sweep_max) + right_cost[b + 1];
+          if (cost < best_cost) { best_cost = cost; split_axis = a; split_bin = b; }
+        }
+      }
+    }
+
+    if (split_axis < 0) {
+      nodes_[n].offset_ = uint32_t(begin);
+      nodes_[n].count_ = uint32_t(count);
+      return n;
+    }
+    valuetype extent = centroid_max[split_axis] - centroid_min[split_axis];
+    BuildEntry* middle = std::partition(entries.data() + begin, entries.data() + end, [&](const BuildEntry& e) {
+      return BinIndex(e.centroid_[split_axis], centroid_min[split_axis], extent) <= split_bin;
+    });
+    size_t mid = size_t(middle - entries.data());
+    BuildNode(entries, begin, mid, depth + 1);
+    uint32_t second = BuildNode(entries, mid, end, depth + 1);
+    nodes_[n].offset_ = second;
+    nodes_[n].count_ = 0;
+    return n;
+  }
+
+  static int BinIndex(valuetype centroid, valuetype centroid_min, valuetype extent) {
+    int b = int(valuetype(kBins) * (centroid - centroid_min) / extent);
+    return (b < 0) ? 0 : ((b >= kBins) ? kBins - 1 : b);
+  }
+
+  std::vector<Node> nodes_;
+  std::vector<primitive> primitives_; // In leaf order
+  std::vector<size_t> indices_;       // Original index of the primitive at each leaf position
+  std::vector<size_t> positions_;     // Leaf position of each original primitive index
+};
+
+template<typename valuetype> using SphereBvh = BoundingVolumeHierarchy<Sphere<valuetype>>;
+template<typename valuetype> using CircleBvh = BoundingVolumeHierarchy<Circle<valuetype>>;
+template<typename valuetype> using Rectangle2DBvh = BoundingVolumeHierarchy<Rectangle2D<valuetype>>;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_BOUNDING_VOLUME_HIERARCHY_H_
@@ -14,9 +14,9 @@ template<typename valuetype>
 struct CoordinateFrame3D {
   // Constructors
   CoordinateFrame3D(const CoordinateFrame3D&) = default;
-  CoordinateFrame3D(Point3D<valuetype> p, Vector3D<valuetype> u, Vector3D<valuetype> v, Vector3D<valuetype> w) : p_(p), u_(u), v_(v), w_(w) { }
+  constexpr CoordinateFrame3D(Point3D<valuetype> p, Vector3D<valuetype> u, Vector3D<valuetype> v, Vector3D<valuetype> w) : p_(p), u_(u), v_(v), w_(w) { }
   ~CoordinateFrame3D() = default;
-  static CoordinateFrame3D CarthesianCanonicalOrthonormal() { return CoordinateFrame3D(Point3D<valuetype>(0, 0, 0), Vector3D<valuetype>(1, 0, 0), Vector3D<valuetype>(0, 1, 0), Vector3D<valuetype>(0, 0, 1)); }
+  static constexpr CoordinateFrame3D CarthesianCanonicalOrthonormal() { return CoordinateFrame3D(Point3D<valuetype>(0, 0, 0), Vector3D<valuetype>(1, 0, 0), Vector3D<valuetype>(0, 1, 0), Vector3D<valuetype>(0, 0, 1)); }
   static CoordinateFrame3D FromOneVector(Point3D<valuetype> p, Vector3D<valuetype> a) {
     Vector3D<valuetype> w = a.Normalize();
     Vector3D<valuetype> t(w);
@@ -30,7 +30,7 @@ struct CoordinateFrame3D {
     return CoordinateFrame3D(p, u, v, w);
   }
   static CoordinateFrame3D FromTwoVectors(Point3D<valuetype> p, Vector3D<valuetype> a, Vector3D<valuetype> b) {
-    if (a.IsCollinear(b)) { return FromOneVector(a); }
+    if (a.IsCollinear(b)) { return FromOneVector(p, a); }
     Vector3D<valuetype> w = a.Normalize();
     Vector3D<valuetype> u = b.CrossProduct(w).Normalize();
     Vector3D<valuetype> v = w.CrossProduct(u);
@@ -39,21 +39,21 @@ struct CoordinateFrame3D {
 
   // Operators
   CoordinateFrame3D& operator=(const CoordinateFrame3D& other) = default;
-  bool operator== (const CoordinateFrame3D& other) const { return (p_ == other.p_ && u_ == other.u_ && v_ == other.v_ && w_ == other.w_); }
-  bool operator!= (const CoordinateFrame3D& other) const { return (p_ != other.p_ || u_ != other.u_ || v_ != other.v_ || w_ != other.w_); }
+  constexpr bool operator== (const CoordinateFrame3D& other) const { return (p_ == other.p_ && u_ == other.u_ && v_ == other.v_ && w_ == other.w_); }
+  constexpr bool operator!= (const CoordinateFrame3D& other) const { return (p_ != other.p_ || u_ != other.u_ || v_ != other.v_ || w_ != other.w_); }
 
   // Cast to different valuetype
-  template<typename other_valuetype> operator CoordinateFrame3D<other_valuetype>() const { return CoordinateFrame3D<other_valuetype>(other_valuetype(p_), other_valuetype(u_), other_valuetype(v_), other_valuetype(w_)); }
+  template<typename other_valuetype> constexpr operator CoordinateFrame3D<other_valuetype>() const { return CoordinateFrame3D<other_valuetype>(other_valuetype(p_), other_valuetype(u_), other_valuetype(v_), other_valuetype(w_)); }
 
   // String conversion
   friend std::ostream& operator<<(std::ostream &os, const CoordinateFrame3D& cf) { return os << "CoordinateFrame3D(p=" << cf.p_ << ", u=" << cf.u_ << ", v=" << cf.v_ << ", w=" << cf.w_ << ")"; }
 
   // Coordinate frame specific functions
-  bool IsOrthonormal() const { return (u_.IsNormalized() && v_.IsNormalized() && w_.IsNormalized() && u_.IsOrthogonal(v_) && v_.IsOrthogonal(w_) && w_.IsOrthogonal(u_)); }
-  bool IsRightHandedOrthonormal() const { return (IsOrthonormal() && u_.CrossProduct(v_) == w_); }
+  constexpr bool IsOrthonormal() const { return (u_.IsNormalized() && v_.IsNormalized() && w_.IsNormalized() && u_.IsOrthogonal(v_) && v_.IsOrthogonal(w_) && w_.IsOrthogonal(u_)); }
+  constexpr bool IsRightHandedOrthonormal() const { return (IsOrthonormal() && u_.CrossProduct(v_) == w_); }
   void Reorthonormalize() { CoordinateFrame3D cf = FromTwoVectors(p_, w_, v_); operator=(cf); }
-  Vector3D<valuetype> CoordinateFrameToCanonicalCoordinates(const Vector3D<valuetype>& vector) const { return (vector.x_ * u_) + (vector.y_ * v_) + (vector.z_ * w_); }
-  Vector3D<valuetype> CanonicalCoordinatesToCoordinateFrame(const Vector3D<valuetype>& vector) const { return Vector3D<valuetype>(u_ * vector, v_ * vector, w_ * vector); }
+  constexpr Vector3D<valuetype> CoordinateFrameToCanonicalCoordinates(const Vector3D<valuetype>& vector) const { return (u_ * vector.x_) + (v_ * vector.y_) + (w_ * vector.z_); }
+  constexpr Vector3D<valuetype> CanonicalCoordinatesToCoordinateFrame(const Vector3D<valuetype>& vector) const { return Vector3D<valuetype>(u_ * vector, v_ * vector, w_ * vector); }
 
   Point3D<valuetype> p_;
   Vector3D<valuetype> u_, v_, w_;
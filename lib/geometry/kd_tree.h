@@ -0,0 +1,296 @@
+#pragma once
+#ifndef J_MATH_KD_TREE_H_
+#define J_MATH_KD_TREE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "..\utility\parallel.h"
+#include "..\utility\simd.h"
+#include "point.h"
+
+namespace j {
+namespace math {
+
+namespace detail {
+
+// Squared distances from q to the points [begin + first, begin + count) of a structure of arrays with one coordinate
+// array per dimension, written to result[first, count).
+template<typename valuetype, int dimensions>
+void KdTreeLeafDistanceGeneric(const valuetype* const* coordinates, const valuetype* q, valuetype* result, size_t begin, size_t first, size_t count) {
+  for (size_t i = first; i < count; ++i) {
+    valuetype d2 = valuetype(0);
+    for (int d = 0; d < dimensions; ++d) { valuetype e = q[d] - coordinates[d][begin + i]; d2 += e * e; }
+    result[i] = d2;
+  }
+}
+
+// Leaf scan of the KD-tree: squared distances from q to the points [begin, begin + count). Specialized for float and
+// double to use the instruction set selected in simd.h.
+template<typename valuetype, int dimensions>
+struct KdTreeLeafKernel {
+  static void DistanceSquared(const valuetype* const* coordinates, const valuetype* q, valuetype* result, size_t begin, size_t count) { KdTreeLeafDistanceGeneric<valuetype, dimensions>(coordinates, q, result, begin, 0, count); }
+};
+
+#if defined(J_MATH_SIMD_X86)
+
+template<int dimensions>
+struct KdTreeLeafKernel<float, dimensions> {
+  static void DistanceSquared(const float* const* coordinates, const float* q, float* result, size_t begin, size_t count) {
+    switch (GetSimdLevel()) {
+    case SimdLevel::AVX2: Avx2(coordinates, q, result, begin, count); return;
+    case SimdLevel::SSE: Sse(coordinates, q, result, begin, count); return;
+    default: KdTreeLeafDistanceGeneric<float, dimensions>(coordinates, q, result, begin, 0, count); return;
+    }
+  }
+
+  J_MATH_TARGET_SSE2 static void Sse(const float* const* coordinates, const float* q, float* result, size_t begin, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m128 d2 = _mm_setzero_ps();
+      for (int d = 0; d < dimensions; ++d) {
+        __m128 e = _mm_sub_ps(_mm_set1_ps(q[d]), _mm_loadu_ps(coordinates[d] + begin + i));
+        d2 = _mm_add_ps(d2, _mm_mul_ps(e, e));
+      }
+      _mm_storeu_ps(result + i, d2);
+    }
+    KdTreeLeafDistanceGeneric<float, dimensions>(coordinates, q, result, begin, i, count);
+  }
+
+  J_MATH_TARGET_AVX2 static void Avx2(const float* const* coordinates, const float* q, float* result, size_t begin, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+      __m256 d2 = _mm256_setzero_ps();
+      for (int d = 0; d < dimensions; ++d) {
+        __m256 e = _mm256_sub_ps(_mm256_set1_ps(q[d]), _mm256_loadu_ps(coordinates[d] + begin + i));
+        d2 = _mm256_add_ps(d2, _mm256_mul_ps(e, e));
+      }
+      _mm256_storeu_ps(result + i, d2);
+    }
+    KdTreeLeafDistanceGeneric<float, dimensions>(coordinates, q, result, begin, i, count);
+  }
+};
+
+template<int dimensions>
+struct KdTreeLeafKernel<double, dimensions> {
+  static void DistanceSquared(const double* const* coordinates, const double* q, double* result, size_t begin, size_t count) {
+    switch (GetSimdLevel()) {
+    case SimdLevel::AVX2: Avx2(coordinates, q, result, begin, count); return;
+    case SimdLevel::SSE: Sse(coordinates, q, result, begin, count); return;
+    default: KdTreeLeafDistanceGeneric<double, dimensions>(coordinates, q, result, begin, 0, count); return;
+    }
+  }
+
+  J_MATH_TARGET_SSE2 static void Sse(const double* const* coordinates, const double* q, double* result, size_t begin, size_t count) {
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+      __m128d d2 = _mm_setzero_pd();
+      for (int d = 0; d < dimensions; ++d) {
+        __m128d e = _mm_sub_pd(_mm_set1_pd(q[d]), _mm_loadu_pd(coordinates[d] + begin + i));
+        d2 = _mm_add_pd(d2, _mm_mul_pd(e, e));
+      }
+      _mm_storeu_pd(result + i, d2);
+    }
+    KdTreeLeafDistanceGeneric<double, dimensions>(coordinates, q, result, begin, i, count);
+  }
+
+  J_MATH_TARGET_AVX2 static void Avx2(const double* const* coordinates, const double* q, double* result, size_t begin, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+      __m256d d2 = _mm256_setzero_pd();
+      for (int d = 0; d < dimensions; ++d) {
+        __m256d e = _mm256_sub_pd(_mm256_set1_pd(q[d]), _mm256_loadu_pd(coordinates[d] + begin + i));
+        d2 = _mm256_add_pd(d2, _mm256_mul_pd(e, e));
+      }
+      _mm256_storeu_pd(result + i, d2);
+    }
+    KdTreeLeafDistanceGeneric<double, dimensions>(coordinates, q, result, begin, i, count);
+  }
+};
+
+#endif // J_MATH_SIMD_X86
+
+} // namespace detail
+
+// Balanced KD-tree over a static set of points for k nearest neighbor queries. Unlike a grid, it adapts to how the
+// points are distributed, so clustered data costs no more to query than uniform data.
+//
+// The tree is implicit: every node splits its range of points in half at the median along the axis of largest extent,
+// so node i has children 2i + 1 and 2i + 2 and the range of a node follows from its position. Only the split planes
+// are stored. The points are stored in tree order as one coordinate array per axis, so that the points of a leaf
+// (at most kLeafSize) are contiguous and their distances are computed with the batch instruction set (see simd.h).
+//
+// Points are referred to by their position in the vector passed to Build. Queries compare squared distances only.
+template<typename point>
+class KdTree {
+public:
+  using traits = PointTraits<point>;
+  using valuetype = typename traits::scalar;
+  static const int kDimensions = traits::kDimensions;
+  static const size_t kLeafSize = 32;
+
+  // Constructors
+  KdTree() = default;
+  explicit KdTree(const std::vector<point>& points, size_t thread_count = 1) { Build(points, thread_count); }
+  KdTree(const KdTree&) = default;
+  ~KdTree() = default;
+
+  // Operators
+  KdTree& operator=(const KdTree&) = default;
+
+  // Construction
+  // Replaces the contents by points, with indices 0 to points.size() - 1. A thread_count other than 1 splits the nodes
+  // of each level over threads (0 uses all hardware threads); the result does not depend on the thread count.
+  void Build(const std::vector<point>& points, size_t thread_count = 1) {
+    size_t n = points.size();
+    size_t leaves = 1;
+    while (n > leaves * kLeafSize) { leaves *= 2; }
+    split_values_.assign(leaves - 1, valuetype(0));
+    split_dimensions_.assign(leaves - 1, 0);
+    std::vector<std::pair<point, size_t>> items(n);
+    for (size_t i = 0; i < n; ++i) { items[i] = std::make_pair(points[i], i); }
+    size_t threads = (thread_count == 0) ? GetHardwareThreadCount() : thread_count;
+    // Ranges of the nodes of the current level, level by level from the root
+    std::vector<size_t> bounds{ 0, n }, next;
+    for (size_t first = 0; first < leaves - 1; first = 2 * first + 1) {
+      size_t count = bounds.size() - 1;
+      ParallelFor(count, threads, 1, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) { Split(first + j, items, bounds[j], bounds[j + 1]); }
+      });
+      next.assign(1, 0);
+      for (size_t j = 0; j < count; ++j) { next.push_back(Middle(bounds[j], bounds[j + 1])); next.push_back(bounds[j + 1]); }
+      bounds.swap(next);
+    }
+    for (int d = 0; d < kDimensions; ++d) { coordinates_[d].resize(n); }
+    indices_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      for (int d = 0; d < kDimensions; ++d) { coordinates_[d][i] = items[i].first[d]; }
+      indices_[i] = items[i].second;
+    }
+  }
+
+  // Accessors
+  size_t Size() const { return indices_.size(); }
+
+  // Queries
+  // Indices of the k points nearest to p (fewer if the tree holds fewer), nearest first; points at equal distance are
+  // ordered by index. With epsilon > 0 the search is approximate: the i-th point reported is at most 1 + epsilon times
+  // as far from p as the true i-th nearest point, and whole subtrees are skipped once that is guaranteed.
+  void FindNearest(const point& p, size_t k, std::vector<size_t>& indices, valuetype epsilon = valuetype(0)) const {
+    std::vector<std::pair<valuetype, size_t>> nearest;
+    Search(p, k, epsilon, nearest);
+    indices.clear();
+    for (const std::pair<valuetype, size_t>& n : nearest) { indices.push_back(n.second); }
+  }
+  // FindNearest for each of the queries, split over threads (0 uses all hardware threads). indices holds
+  // min(k, Size()) results per query, those of query q starting at q * min(k, Size()).
+  void FindNearest(const std::vector<point>& queries, size_t k, std::vector<size_t>& indices, size_t thread_count = 1, valuetype epsilon = valuetype(0)) const {
+    size_t stride = std::min(k, Size());
+    indices.resize(queries.size() * stride);
+    size_t threads = (thread_count == 0) ? GetHardwareThreadCount() : thread_count;
+    ParallelFor(queries.size(), threads, kQueryGrain, [&](size_t begin, size_t end) {
+      std::vector<std::pair<valuetype, size_t>> nearest;
+      for (size_t q = begin; q < end; ++q) {
+        Search(queries[q], k, epsilon, nearest);
+        for (size_t i = 0; i < stride; ++i) { indices[q * stride + i] = nearest[i].second; }
+      }
+    });
+  }
+
+private:
+  static const size_t kQueryGrain = 64;
+
+  static size_t Middle(size_t begin, size_t end) { return begin + (end - begin) / 2; }
+
+  // Splits the points [begin, end) of node at the median along the axis of largest extent.
+  void Split(size_t node, std::vector<std::pair<point, size_t>>& items, size_t begin, size_t end) {
+    valuetype min[kDimensions], max[kDimensions];
+    for (int d = 0; d < kDimensions; ++d) { min[d] = items[begin].first[d]; max[d] = min[d]; }
+    for (size_t i = begin + 1; i < end; ++i) {
+      for (int d = 0; d < kDimensions; ++d) { min[d] = std::min(min[d], items[i].first[d]); max[d] = std::max(max[d], items[i].first[d]); }
+    }
+    int axis = 0;
+    for (int d = 1; d < kDimensions; ++d) { if (max[d] - min[d] > max[axis] - min[axis]) { axis = d; } }
+    size_t middle = Middle(begin, end);
+    std::nth_element(items.begin() + ptrdiff_t(begin), items.begin() + ptrdiff_t(middle), items.begin() + ptrdiff_t(end),
+      [axis](const std::pair<point, size_t>& a, const std::pair<point, size_t>& b) { return a.first[axis] < b.first[axis]; });
+    split_dimensions_[node] = uint8_t(axis);
+    split_values_[node] = items[middle].first[axis];
+  }
+
+  // The min(k, Size()) nearest points as (squared distance, index), nearest first.
+  void Search(const point& p, size_t k, valuetype epsilon, std::vector<std::pair<valuetype, size_t>>& nearest) const {
+    nearest.clear();
+    k = std::min(k, Size());
+    if (k == 0) { return; }
+    Query query;
+    for (int d = 0; d < kDimensions; ++d) { query.p_[d] = p[d]; query.offsets_[d] = valuetype(0); query.coordinates_[d] = coordinates_[d].data(); }
+    query.scale_ = (valuetype(1) + epsilon) * (valuetype(1) + epsilon);
+    query.k_ = k;
+    query.nearest_ = &nearest;
+    Visit(query, 0, 0, Size(), valuetype(0));
+    std::sort_heap(nearest.begin(), nearest.end());
+  }
+
+  struct Query {
+    valuetype p_[kDimensions];
+    valuetype offsets_[kDimensions];  // Offset from p to the region of the node being visited, per axis
+    const valuetype* coordinates_[kDimensions];
+    valuetype scale_;                 // (1 + epsilon)^2
+    size_t k_;
+    std::vector<std::pair<valuetype, size_t>>* nearest_;  // Max-heap of the nearest points found so far
+  };
+
+  // Visits the nearer child first, then the farther one unless the region it covers (at squared distance
+  // distance_squared, accumulated one axis at a time) cannot hold a point nearer than the current k-th.
+  void Visit(Query& query, size_t node, size_t begin, size_t end, valuetype distance_squared) const {
+    if (node >= split_values_.size()) {
+      ScanLeaf(query, begin, end);
+      return;
+    }
+    int axis = split_dimensions_[node];
+    valuetype offset = query.p_[axis] - split_values_[node];
+    size_t middle = Middle(begin, end);
+    bool left_first = offset <= valuetype(0);
+    if (left_first) { Visit(query, 2 * node + 1, begin, middle, distance_squared); } else { Visit(query, 2 * node + 2, middle, end, distance_squared); }
+    valuetype previous = query.offsets_[axis];
+    valuetype far_distance_squared = distance_squared - previous * previous + offset * offset;
+    std::vector<std::pair<valuetype, size_t>>& nearest = *query.nearest_;
+    if (nearest.size() == query.k_ && far_distance_squared * query.scale_ > nearest.front().first) { return; }
+    query.offsets_[axis] = offset;
+    if (left_first) { Visit(query, 2 * node + 2, middle, end, far_distance_squared); } else { Visit(query, 2 * node + 1, begin, middle, far_distance_squared); }
+    query.offsets_[axis] = previous;
+  }
+
+  void ScanLeaf(Query& query, size_t begin, size_t end) const {
+    valuetype distances[kLeafSize];
+    detail::KdTreeLeafKernel<valuetype, kDimensions>::DistanceSquared(query.coordinates_, query.p_, distances, begin, end - begin);
+    std::vector<std::pair<valuetype, size_t>>& nearest = *query.nearest_;
+    for (size_t i = 0; i < end - begin; ++i) {
+      std::pair<valuetype, size_t> candidate(distances[i], indices_[begin + i]);
+      if (nearest.size() < query.k_) {
+        nearest.push_back(candidate);
+        std::push_heap(nearest.begin(), nearest.end());
+      } else if (candidate < nearest.front()) {
+        std::pop_heap(nearest.begin(), nearest.end());
+        nearest.back() = candidate;
+        std::push_heap(nearest.begin(), nearest.end());
+      }
+    }
+  }
+
+  std::vector<valuetype> split_values_;      // Split plane of each internal node, in breadth-first order
+  std::vector<uint8_t> split_dimensions_;    // Axis of the split plane of each internal node
+  std::vector<valuetype> coordinates_[kDimensions];  // Points in tree order, one array per axis
+  std::vector<size_t> indices_;              // Index of each point in tree order
+};
+
+template<typename valuetype> using KdTree2D = KdTree<Point2D<valuetype>>;
+template<typename valuetype> using KdTree3D = KdTree<Point3D<valuetype>>;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_KD_TREE_H_
@@ -0,0 +1,191 @@
+#pragma once
+#ifndef J_MATH_MATRIX_H_
+#define J_MATH_MATRIX_H_
+
+#include <cmath>
+#include <iostream>
+#include "..\utility\numeric_comparison.h"
+#include "point.h"
+#include "vector.h"
+
+namespace j {
+namespace math {
+
+// A 3x3 matrix, stored row-major. Multiplying a column vector applies the linear map, m * v.
+template<typename valuetype>
+struct Matrix3x3 {
+  // Constructors
+  constexpr Matrix3x3() : m_{ { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } } { }
+  Matrix3x3(const Matrix3x3&) = default;
+  constexpr Matrix3x3(valuetype m00, valuetype m01, valuetype m02, valuetype m10, valuetype m11, valuetype m12, valuetype m20, valuetype m21, valuetype m22) : m_{ { m00, m01, m02 }, { m10, m11, m12 }, { m20, m21, m22 } } { }
+  ~Matrix3x3() = default;
+  static constexpr Matrix3x3 Identity() { return Matrix3x3(1, 0, 0, 0, 1, 0, 0, 0, 1); }
+  static constexpr Matrix3x3 FromRows(const Vector3D<valuetype>& r0, const Vector3D<valuetype>& r1, const Vector3D<valuetype>& r2) { return Matrix3x3(r0.x_, r0.y_, r0.z_, r1.x_, r1.y_, r1.z_, r2.x_, r2.y_, r2.z_); }
+  static constexpr Matrix3x3 FromColumns(const Vector3D<valuetype>& c0, const Vector3D<valuetype>& c1, const Vector3D<valuetype>& c2) { return Matrix3x3(c0.x_, c1.x_, c2.x_, c0.y_, c1.y_, c2.y_, c0.z_, c1.z_, c2.z_); }
+  static constexpr Matrix3x3 Scale(const Vector3D<valuetype>& s) { return Matrix3x3(s.x_, 0, 0, 0, s.y_, 0, 0, 0, s.z_); }
+  // Rotation by angle_radians around axis, counter-clockwise when looking down the axis.
+  static Matrix3x3 Rotation(const Vector3D<valuetype>& axis, valuetype angle_radians) {
+    Vector3D<valuetype> a = axis.Normalize();
+    valuetype c = valuetype(std::cos(angle_radians)), s = valuetype(std::sin(angle_radians)), t = valuetype(1) - c;
+    return Matrix3x3(t * a.x_ * a.x_ + c, t * a.x_ * a.y_ - s * a.z_, t * a.x_ * a.z_ + s * a.y_,
+                     t * a.x_ * a.y_ + s * a.z_, t * a.y_ * a.y_ + c, t * a.y_ * a.z_ - s * a.x_,
+                     t * a.x_ * a.z_ - s * a.y_, t * a.y_ * a.z_ + s * a.x_, t * a.z_ * a.z_ + c);
+  }
+
+  // Operators
+  Matrix3x3& operator=(const Matrix3x3&) = default;
+  constexpr bool operator== (const Matrix3x3& other) const {
+    for (int r = 0; r < 3; ++r) { for (int c = 0; c < 3; ++c) { if (!AreEqual(m_[r][c], other.m_[r][c])) { return false; } } }
+    return true;
+  }
+  constexpr bool operator!= (const Matrix3x3& other) const { return !operator==(other); }
+  constexpr const valuetype& operator()(int row, int column) const { return m_[row][column]; }
+  constexpr valuetype& operator()(int row, int column) { return m_[row][column]; }
+  constexpr Matrix3x3 operator+ (const Matrix3x3& other) const { Matrix3x3 result; for (int r = 0; r < 3; ++r) { for (int c = 0; c < 3; ++c) { result.m_[r][c] = m_[r][c] + other.m_[r][c]; } } return result; }
+  constexpr Matrix3x3 operator- (const Matrix3x3& other) const { Matrix3x3 result; for (int r = 0; r < 3; ++r) { for (int c = 0; c < 3; ++c) { result.m_[r][c] = m_[r][c] - other.m_[r][c]; } } return result; }
+  constexpr Matrix3x3 operator* (valuetype scalar) const { Matrix3x3 result; for (int r = 0; r < 3; ++r) { for (int c = 0; c < 3; ++c) { result.m_[r][c] = m_[r][c] * scalar; } } return result; }
+  constexpr Matrix3x3 operator* (const Matrix3x3& other) const {
+    Matrix3x3 result;
+    for (int r = 0; r < 3; ++r) { for (int c = 0; c < 3; ++c) { result.m_[r][c] = m_[r][0] * other.m_[0][c] + m_[r][1] * other.m_[1][c] + m_[r][2] * other.m_[2][c]; } }
+    return result;
+  }
+  constexpr Vector3D<valuetype> operator* (const Vector3D<valuetype>& v) const {
+    return Vector3D<valuetype>(m_[0][0] * v.x_ + m_[0][1] * v.y_ + m_[0][2] * v.z_, m_[1][0] * v.x_ + m_[1][1] * v.y_ + m_[1][2] * v.z_, m_[2][0] * v.x_ + m_[2][1] * v.y_ + m_[2][2] * v.z_);
+  }
+  constexpr void operator*= (const Matrix3x3& other) { *this = operator*(other); }
+
+  // Cast to different valuetype
+  template<typename other_valuetype> constexpr operator Matrix3x3<other_valuetype>() const {
+    Matrix3x3<other_valuetype> result;
+    for (int r = 0; r < 3; ++r) { for (int c = 0; c < 3; ++c) { result.m_[r][c] = other_valuetype(m_[r][c]); } }
+    return result;
+  }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const Matrix3x3& m) {
+    return os << "Matrix3x3((" << m.m_[0][0] << ", " << m.m_[0][1] << ", " << m.m_[0][2] << "), (" << m.m_[1][0] << ", " << m.m_[1][1] << ", " << m.m_[1][2] << "), (" << m.m_[2][0] << ", " << m.m_[2][1] << ", " << m.m_[2][2] << "))";
+  }
+
+  // Matrix-specific functions
+  constexpr Vector3D<valuetype> Row(int i) const { return Vector3D<valuetype>(m_[i][0], m_[i][1], m_[i][2]); }
+  constexpr Vector3D<valuetype> Column(int i) const { return Vector3D<valuetype>(m_[0][i], m_[1][i], m_[2][i]); }
+  constexpr Matrix3x3 Transpose() const { return Matrix3x3(m_[0][0], m_[1][0], m_[2][0], m_[0][1], m_[1][1], m_[2][1], m_[0][2], m_[1][2], m_[2][2]); }
+  constexpr valuetype Trace() const { return m_[0][0] + m_[1][1] + m_[2][2]; }
+  constexpr valuetype Determinant() const { return m_[0][0] * (m_[1][1] * m_[2][2] - m_[1][2] * m_[2][1]) - m_[0][1] * (m_[1][0] * m_[2][2] - m_[1][2] * m_[2][0]) + m_[0][2] * (m_[1][0] * m_[2][1] - m_[1][1] * m_[2][0]); }
+  constexpr bool IsInvertible() const { return !AreEqual(Determinant(), valuetype(0)); }
+  // Inverse through the adjugate. Only meaningful when IsInvertible().
+  constexpr Matrix3x3 Inverse() const {
+    valuetype c00 = m_[1][1] * m_[2][2] - m_[1][2] * m_[2][1];
+    valuetype c01 = m_[1][2] * m_[2][0] - m_[1][0] * m_[2][2];
+    valuetype c02 = m_[1][0] * m_[2][1] - m_[1][1] * m_[2][0];
+    valuetype inverse_determinant = valuetype(1) / (m_[0][0] * c00 + m_[0][1] * c01 + m_[0][2] * c02);
+    return Matrix3x3(c00, m_[0][2] * m_[2][1] - m_[0][1] * m_[2][2], m_[0][1] * m_[1][2] - m_[0][2] * m_[1][1],
+                     c01, m_[0][0] * m_[2][2] - m_[0][2] * m_[2][0], m_[0][2] * m_[1][0] - m_[0][0] * m_[1][2],
+                     c02, m_[0][1] * m_[2][0] - m_[0][0] * m_[2][1], m_[0][0] * m_[1][1] - m_[0][1] * m_[1][0]) * inverse_determinant;
+  }
+  constexpr bool IsOrthonormal() const { return Column(0).IsNormalized() && Column(1).IsNormalized() && Column(2).IsNormalized() && Column(0).IsOrthogonal(Column(1)) && Column(1).IsOrthogonal(Column(2)) && Column(2).IsOrthogonal(Column(0)); }
+
+  valuetype m_[3][3];
+};
+typedef Matrix3x3<float> mat3f;
+typedef Matrix3x3<double> mat3d;
+
+// A 4x4 matrix, stored row-major. Acts on homogeneous coordinates: points have w = 1, vectors have w = 0.
+template<typename valuetype>
+struct Matrix4x4 {
+  // Constructors
+  constexpr Matrix4x4() : m_{ { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } } { }
+  Matrix4x4(const Matrix4x4&) = default;
+  constexpr Matrix4x4(valuetype m00, valuetype m01, valuetype m02, valuetype m03, valuetype m10, valuetype m11, valuetype m12, valuetype m13, valuetype m20, valuetype m21, valuetype m22, valuetype m23, valuetype m30, valuetype m31, valuetype m32, valuetype m33)
+    : m_{ { m00, m01, m02, m03 }, { m10, m11, m12, m13 }, { m20, m21, m22, m23 }, { m30, m31, m32, m33 } } { }
+  ~Matrix4x4() = default;
+  static constexpr Matrix4x4 Identity() { return Matrix4x4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1); }
+
+  // Operators
+  Matrix4x4& operator=(const Matrix4x4&) = default;
+  constexpr bool operator== (const Matrix4x4& other) const {
+    for (int r = 0; r < 4; ++r) { for (int c = 0; c < 4; ++c) { if (!AreEqual(m_[r][c], other.m_[r][c])) { return false; } } }
+    return true;
+  }
+  constexpr bool operator!= (const Matrix4x4& other) const { return !operator==(other); }
+  constexpr const valuetype& operator()(int row, int column) const { return m_[row][column]; }
+  constexpr valuetype& operator()(int row, int column) { return m_[row][column]; }
+  constexpr Matrix4x4 operator* (valuetype scalar) const { Matrix4x4 result; for (int r = 0; r < 4; ++r) { for (int c = 0; c < 4; ++c) { result.m_[r][c] = m_[r][c] * scalar; } } return result; }
+  constexpr Matrix4x4 operator* (const Matrix4x4& other) const {
+    Matrix4x4 result;
+    for (int r = 0; r < 4; ++r) { for (int c = 0; c < 4; ++c) { result.m_[r][c] = m_[r][0] * other.m_[0][c] + m_[r][1] * other.m_[1][c] + m_[r][2] * other.m_[2][c] + m_[r][3] * other.m_[3][c]; } }
+    return result;
+  }
+  constexpr void operator*= (const Matrix4x4& other) { *this = operator*(other); }
+
+  // Cast to different valuetype
+  template<typename other_valuetype> constexpr operator Matrix4x4<other_valuetype>() const {
+    Matrix4x4<other_valuetype> result;
+    for (int r = 0; r < 4; ++r) { for (int c = 0; c < 4; ++c) { result.m_[r][c] = other_valuetype(m_[r][c]); } }
+    return result;
+  }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const Matrix4x4& m) {
+    os << "Matrix4x4(";
+    for (int r = 0; r < 4; ++r) { os << (r > 0 ? ", (" : "(") << m.m_[r][0] << ", " << m.m_[r][1] << ", " << m.m_[r][2] << ", " << m.m_[r][3] << ")"; }
+    return os << ")";
+  }
+
+  // Matrix-specific functions
+  // Transform a point (w = 1), followed by the perspective division when the bottom row is not (0, 0, 0, 1).
+  constexpr Point3D<valuetype> TransformPoint(const Point3D<valuetype>& p) const {
+    valuetype x = m_[0][0] * p.x_ + m_[0][1] * p.y_ + m_[0][2] * p.z_ + m_[0][3];
+    valuetype y = m_[1][0] * p.x_ + m_[1][1] * p.y_ + m_[1][2] * p.z_ + m_[1][3];
+    valuetype z = m_[2][0] * p.x_ + m_[2][1] * p.y_ + m_[2][2] * p.z_ + m_[2][3];
+    valuetype w = m_[3][0] * p.x_ + m_[3][1] * p.y_ + m_[3][2] * p.z_ + m_[3][3];
+    return (w == valuetype(1)) ? Point3D<valuetype>(x, y, z) : Point3D<valuetype>(x / w, y / w, z / w);
+  }
+  // Transform a vector (w = 0), ignoring the translation.
+  constexpr Vector3D<valuetype> TransformVector(const Vector3D<valuetype>& v) const {
+    return Vector3D<valuetype>(m_[0][0] * v.x_ + m_[0][1] * v.y_ + m_[0][2] * v.z_, m_[1][0] * v.x_ + m_[1][1] * v.y_ + m_[1][2] * v.z_, m_[2][0] * v.x_ + m_[2][1] * v.y_ + m_[2][2] * v.z_);
+  }
+  constexpr Matrix4x4 Transpose() const {
+    Matrix4x4 result;
+    for (int r = 0; r < 4; ++r) { for (int c = 0; c < 4; ++c) { result.m_[r][c] = m_[c][r]; } }
+    return result;
+  }
+  constexpr bool IsAffine() const { return m_[3][0] == valuetype(0) && m_[3][1] == valuetype(0) && m_[3][2] == valuetype(0) && m_[3][3] == valuetype(1); }
+  constexpr valuetype Determinant() const {
+    Minors minors = ComputeMinors();
+    return minors.s_[0] * minors.c_[5] - minors.s_[1] * minors.c_[4] + minors.s_[2] * minors.c_[3] + minors.s_[3] * minors.c_[2] - minors.s_[4] * minors.c_[1] + minors.s_[5] * minors.c_[0];
+  }
+  constexpr bool IsInvertible() const { return !AreEqual(Determinant(), valuetype(0)); }
+  // Inverse through the 2x2 minors of the upper and lower row pairs. Only meaningful when IsInvertible().
+  constexpr Matrix4x4 Inverse() const {
+    Minors n = ComputeMinors();
+    const valuetype* s = n.s_;
+    const valuetype* c = n.c_;
+    valuetype inverse_determinant = valuetype(1) / (s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0]);
+    return Matrix4x4(
+      m_[1][1] * c[5] - m_[1][2] * c[4] + m_[1][3] * c[3], -m_[0][1] * c[5] + m_[0][2] * c[4] - m_[0][3] * c[3], m_[3][1] * s[5] - m_[3][2] * s[4] + m_[3][3] * s[3], -m_[2][1] * s[5] + m_[2][2] * s[4] - m_[2][3] * s[3],
+      -m_[1][0] * c[5] + m_[1][2] * c[2] - m_[1][3] * c[1], m_[0][0] * c[5] - m_[0][2] * c[2] + m_[0][3] * c[1], -m_[3][0] * s[5] + m_[3][2] * s[2] - m_[3][3] * s[1], m_[2][0] * s[5] - m_[2][2] * s[2] + m_[2][3] * s[1],
+      m_[1][0] * c[4] - m_[1][1] * c[2] + m_[1][3] * c[0], -m_[0][0] * c[4] + m_[0][1] * c[2] - m_[0][3] * c[0], m_[3][0] * s[4] - m_[3][1] * s[2] + m_[3][3] * s[0], -m_[2][0] * s[4] + m_[2][1] * s[2] - m_[2][3] * s[0],
+      -m_[1][0] * c[3] + m_[1][1] * c[1] - m_[1][2] * c[0], m_[0][0] * c[3] - m_[0][1] * c[1] + m_[0][2] * c[0], -m_[3][0] * s[3] + m_[3][1] * s[1] - m_[3][2] * s[0], m_[2][0] * s[3] - m_[2][1] * s[1] + m_[2][2] * s[0]) * inverse_determinant;
+  }
+
+  valuetype m_[4][4];
+
+private:
+  // 2x2 minors of rows 0-1 (s) and rows 2-3 (c), shared by Determinant and Inverse
+  struct Minors { valuetype s_[6]; valuetype c_[6]; };
+  constexpr Minors ComputeMinors() const {
+    return Minors{
+      { m_[0][0] * m_[1][1] - m_[1][0] * m_[0][1], m_[0][0] * m_[1][2] - m_[1][0] * m_[0][2], m_[0][0] * m_[1][3] - m_[1][0] * m_[0][3],
+        m_[0][1] * m_[1][2] - m_[1][1] * m_[0][2], m_[0][1] * m_[1][3] - m_[1][1] * m_[0][3], m_[0][2] * m_[1][3] - m_[1][2] * m_[0][3] },
+      { m_[2][0] * m_[3][1] - m_[3][0] * m_[2][1], m_[2][0] * m_[3][2] - m_[3][0] * m_[2][2], m_[2][0] * m_[3][3] - m_[3][0] * m_[2][3],
+        m_[2][1] * m_[3][2] - m_[3][1] * m_[2][2], m_[2][1] * m_[3][3] - m_[3][1] * m_[2][3], m_[2][2] * m_[3][3] - m_[3][2] * m_[2][3] } };
+  }
+};
+typedef Matrix4x4<float> mat4f;
+typedef Matrix4x4<double> mat4d;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_MATRIX_H_
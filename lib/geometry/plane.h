@@ -41,16 +41,15 @@ struct Plane {
   friend std::ostream& operator<<(std::ostream &os, const Plane<valuetype>& plane) { return os << "Plane(p=" << plane.p_ << ", n=" << plane.n_ << ")"; }
 
   // Plane-specific operations
-  Vector2D<valuetype> Normal() const { return n_; }
-  void SetNormal(const Vector3D<valuetype>& v) { n_ = n_.Normalize(); }
+  Vector3D<valuetype> Normal() const { return n_; }
+  void SetNormal(const Vector3D<valuetype>& v) { n_ = v.Normalize(); }
   valuetype EvaluateImplicitEquation(const Point3D<valuetype>& p) const { return((p - p_).ScalarProduct(n_)); }
   bool IsOnSurface(const Point3D<valuetype>& p) const { return AreEqual(EvaluateImplicitEquation(p), valuetype(0)); }
   bool IsBelowPlane(const Point3D<valuetype>& p) const { return EvaluateImplicitEquation(p) < 0; }
   bool IsAbovePlane(const Point3D<valuetype>& p) const { return EvaluateImplicitEquation(p) > 0; }
   valuetype SignedDistanceToSurface(const Point3D<valuetype>& p) const { return EvaluateImplicitEquation(p); }
-  valuetype DistanceToSurface(const Point3D<valuetype>& p) const { valuetype d = SignedDistanceToCurve(p); return (d >= 0) ? d : -d; }
-  Point2D<valuetype> EvaluateParametricSpecification(valuetype s) const { return(p_ + (v_ * s)); }
-  Point3D<valuetype> FindNearestPoint(const Point3D<valuetype>& p) const { return(p - (p - p_).ScalarProduct(n_)); }
+  valuetype DistanceToSurface(const Point3D<valuetype>& p) const { valuetype d = SignedDistanceToSurface(p); return (d >= 0) ? d : -d; }
+  Point3D<valuetype> FindNearestPoint(const Point3D<valuetype>& p) const { return(p + (n_ * EvaluateImplicitEquation(p))); }
 
   Point3D<valuetype> p_;
 private:
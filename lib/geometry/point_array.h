@@ -0,0 +1,115 @@
+#pragma once
+#ifndef J_MATH_POINT_ARRAY_H_
+#define J_MATH_POINT_ARRAY_H_
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "point.h"
+#include "point_batch.h"
+
+namespace j {
+namespace math {
+
+// An array of three-dimensional points stored as a structure of arrays (separate x, y and z buffers). Element access
+// returns a proxy that behaves like a Point3D, the component buffers can be handed directly to the batch kernels.
+template<typename valuetype, typename allocator = std::allocator<valuetype>>
+struct Point3DArray {
+  // Proxy referencing a single element of the array. Reads convert to Point3D, writes go through to the buffers.
+  struct Reference {
+    Reference(valuetype& x, valuetype& y, valuetype& z) : x_(x), y_(y), z_(z) { }
+    Reference(const Reference&) = default;
+
+    // Operators
+    Reference& operator=(const Point3D<valuetype>& point) { x_ = point.x_; y_ = point.y_; z_ = point.z_; return *this; }
+    Reference& operator=(const Reference& other) { return operator=(other.Get()); }
+    operator Point3D<valuetype>() const { return Get(); }
+    bool operator== (const Point3D<valuetype>& other) const { return Get() == other; }
+    bool operator!= (const Point3D<valuetype>& other) const { return Get() != other; }
+    Point3D<valuetype> operator+ (const Vector3D<valuetype>& vector) const { return Get() + vector; }
+    Point3D<valuetype> operator- (const Vector3D<valuetype>& vector) const { return Get() - vector; }
+    Vector3D<valuetype> operator- (const Point3D<valuetype>& other) const { return Get() - other; }
+    void operator+= (const Vector3D<valuetype>& vector) { x_ += vector.x_; y_ += vector.y_; z_ += vector.z_; }
+    void operator-= (const Vector3D<valuetype>& vector) { x_ -= vector.x_; y_ -= vector.y_; z_ -= vector.z_; }
+
+    // String conversion
+    friend std::ostream& operator<<(std::ostream &os, const Reference& reference) { return os << reference.Get(); }
+
+    Point3D<valuetype> Get() const { return Point3D<valuetype>(x_, y_, z_); }
+    float Distance(const Point3D<valuetype>& other) const { return Get().Distance(other); }
+
+    valuetype& x_;
+    valuetype& y_;
+    valuetype& z_;
+  };
+
+  // Constructors
+  Point3DArray() = default;
+  explicit Point3DArray(const allocator& alloc) : x_(alloc), y_(alloc), z_(alloc) { }
+  Point3DArray(const Point3DArray&) = default;
+  explicit Point3DArray(size_t length, const allocator& alloc = allocator()) : x_(length, alloc), y_(length, alloc), z_(length, alloc) { }
+  Point3DArray(const std::vector<Point3D<valuetype>>& points, const allocator& alloc = allocator()) : Point3DArray(alloc) { Reserve(points.size()); for (const Point3D<valuetype>& p : points) { Add(p); } }
+  ~Point3DArray() = default;
+
+  // Operators
+  Point3DArray& operator=(const Point3DArray&) = default;
+  bool operator==(const Point3DArray& other) const { return x_ == other.x_ && y_ == other.y_ && z_ == other.z_; }
+  bool operator!=(const Point3DArray& other) const { return !operator==(other); }
+  Reference operator[](size_t i) { return Reference(x_[i], y_[i], z_[i]); }
+  Point3D<valuetype> operator[](size_t i) const { return Get(i); }
+
+  // Conversion to an array of structs
+  std::vector<Point3D<valuetype>> ToVector() const {
+    std::vector<Point3D<valuetype>> points;
+    points.reserve(Length());
+    for (size_t i = 0; i < Length(); ++i) { points.push_back(Get(i)); }
+    return points;
+  }
+  operator std::vector<Point3D<valuetype>>() const { return ToVector(); }
+
+  // Array-specific operations
+  void Add(const Point3D<valuetype>& point) { x_.push_back(point.x_); y_.push_back(point.y_); z_.push_back(point.z_); }
+  Point3D<valuetype> Get(size_t i) const { return Point3D<valuetype>(x_[i], y_[i], z_[i]); }
+  void Set(size_t i, const Point3D<valuetype>& point) { x_[i] = point.x_; y_[i] = point.y_; z_[i] = point.z_; }
+  size_t Length() const { return x_.size(); }
+  void Resize(size_t length) { x_.resize(length); y_.resize(length); z_.resize(length); }
+  void Reserve(size_t length) { x_.reserve(length); y_.reserve(length); z_.reserve(length); }
+  void Clear() { x_.clear(); y_.clear(); z_.clear(); }
+  allocator GetAllocator() const { return x_.get_allocator(); }
+  valuetype* X() { return x_.data(); }
+  valuetype* Y() { return y_.data(); }
+  valuetype* Z() { return z_.data(); }
+  const valuetype* X() const { return x_.data(); }
+  const valuetype* Y() const { return y_.data(); }
+  const valuetype* Z() const { return z_.data(); }
+
+  // Component pointers in the form expected by the batch kernels
+  detail::Components3D<const valuetype> Read() const { return detail::Components3D<const valuetype>{ X(), Y(), Z() }; }
+  detail::Components3D<valuetype> Write() { return detail::Components3D<valuetype>{ X(), Y(), Z() }; }
+
+private:
+  std::vector<valuetype, allocator> x_, y_, z_;
+};
+
+using p3arrayi = Point3DArray<int>;
+using p3arrayf = Point3DArray<float>;
+using p3arrayd = Point3DArray<double>;
+
+// Batch kernels operating directly on the component buffers (see point_batch.h). The result is resized to the number
+// of points.
+template<typename valuetype, typename points_allocator>
+void BatchDistance(const Point3DArray<valuetype, points_allocator>& points, const Point3D<valuetype>& p, std::vector<valuetype>& result) {
+  result.resize(points.Length());
+  detail::DistanceDispatch(points.Read(), p, result.data(), true, points.Length());
+}
+
+template<typename valuetype, typename points_allocator>
+void BatchDistanceSquared(const Point3DArray<valuetype, points_allocator>& points, const Point3D<valuetype>& p, std::vector<valuetype>& result) {
+  result.resize(points.Length());
+  detail::DistanceDispatch(points.Read(), p, result.data(), false, points.Length());
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_POINT_ARRAY_H_
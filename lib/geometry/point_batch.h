@@ -0,0 +1,146 @@
+#pragma once
+#ifndef J_MATH_POINT_BATCH_H_
+#define J_MATH_POINT_BATCH_H_
+
+#include <cmath>
+#include <cstddef>
+#include "..\utility\simd.h"
+#include "point.h"
+#include "vector_batch.h"
+
+namespace j {
+namespace math {
+
+// Batch kernels for Point3D operations over arrays of points. Same dispatch and exactness rules as vector_batch.h.
+
+namespace detail {
+
+//
+// Generic kernels (any valuetype, elements [begin, end))
+//
+template<typename valuetype>
+void DistanceGeneric(Components3D<const valuetype> points, const Point3D<valuetype>& p, valuetype* result, bool square_root, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    valuetype dx = p.x_ - points.x_[i];
+    valuetype dy = p.y_ - points.y_[i];
+    valuetype dz = p.z_ - points.z_[i];
+    valuetype d2 = dx * dx + dy * dy + dz * dz;
+    result[i] = square_root ? valuetype(std::sqrt(d2)) : d2;
+  }
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+//
+// SSE2 kernels
+//
+J_MATH_TARGET_SSE2 inline void DistanceSse(Components3D<const float> points, const Point3D<float>& p, float* result, bool square_root, size_t count) {
+  __m128 px = _mm_set1_ps(p.x_), py = _mm_set1_ps(p.y_), pz = _mm_set1_ps(p.z_);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 dx = _mm_sub_ps(px, _mm_loadu_ps(points.x_ + i));
+    __m128 dy = _mm_sub_ps(py, _mm_loadu_ps(points.y_ + i));
+    __m128 dz = _mm_sub_ps(pz, _mm_loadu_ps(points.z_ + i));
+    __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+    _mm_storeu_ps(result + i, square_root ? _mm_sqrt_ps(d2) : d2);
+  }
+  DistanceGeneric(points, p, result, square_root, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void DistanceSse(Components3D<const double> points, const Point3D<double>& p, double* result, bool square_root, size_t count) {
+  __m128d px = _mm_set1_pd(p.x_), py = _mm_set1_pd(p.y_), pz = _mm_set1_pd(p.z_);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d dx = _mm_sub_pd(px, _mm_loadu_pd(points.x_ + i));
+    __m128d dy = _mm_sub_pd(py, _mm_loadu_pd(points.y_ + i));
+    __m128d dz = _mm_sub_pd(pz, _mm_loadu_pd(points.z_ + i));
+    __m128d d2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+    _mm_storeu_pd(result + i, square_root ? _mm_sqrt_pd(d2) : d2);
+  }
+  DistanceGeneric(points, p, result, square_root, i, count);
+}
+
+//
+// AVX2 kernels
+//
+J_MATH_TARGET_AVX2 inline void DistanceAvx2(Components3D<const float> points, const Point3D<float>& p, float* result, bool square_root, size_t count) {
+  __m256 px = _mm256_set1_ps(p.x_), py = _mm256_set1_ps(p.y_), pz = _mm256_set1_ps(p.z_);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 dx = _mm256_sub_ps(px, _mm256_loadu_ps(points.x_ + i));
+    __m256 dy = _mm256_sub_ps(py, _mm256_loadu_ps(points.y_ + i));
+    __m256 dz = _mm256_sub_ps(pz, _mm256_loadu_ps(points.z_ + i));
+    __m256 d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+    _mm256_storeu_ps(result + i, square_root ? _mm256_sqrt_ps(d2) : d2);
+  }
+  DistanceGeneric(points, p, result, square_root, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void DistanceAvx2(Components3D<const double> points, const Point3D<double>& p, double* result, bool square_root, size_t count) {
+  __m256d px = _mm256_set1_pd(p.x_), py = _mm256_set1_pd(p.y_), pz = _mm256_set1_pd(p.z_);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d dx = _mm256_sub_pd(px, _mm256_loadu_pd(points.x_ + i));
+    __m256d dy = _mm256_sub_pd(py, _mm256_loadu_pd(points.y_ + i));
+    __m256d dz = _mm256_sub_pd(pz, _mm256_loadu_pd(points.z_ + i));
+    __m256d d2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+    _mm256_storeu_pd(result + i, square_root ? _mm256_sqrt_pd(d2) : d2);
+  }
+  DistanceGeneric(points, p, result, square_root, i, count);
+}
+
+#endif // J_MATH_SIMD_X86
+
+//
+// Runtime dispatch on the selected instruction set
+//
+template<typename valuetype>
+void DistanceDispatch(Components3D<const valuetype> points, const Point3D<valuetype>& p, valuetype* result, bool square_root, size_t count) { DistanceGeneric(points, p, result, square_root, 0, count); }
+
+#if defined(J_MATH_SIMD_X86)
+#define J_MATH_POINT_BATCH_DISPATCH(valuetype) \
+  inline void DistanceDispatch(Components3D<const valuetype> points, const Point3D<valuetype>& p, valuetype* result, bool square_root, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: DistanceAvx2(points, p, result, square_root, count); return; \
+    case SimdLevel::SSE: DistanceSse(points, p, result, square_root, count); return; \
+    default: DistanceGeneric(points, p, result, square_root, 0, count); return; \
+    } \
+  }
+J_MATH_POINT_BATCH_DISPATCH(float)
+J_MATH_POINT_BATCH_DISPATCH(double)
+#undef J_MATH_POINT_BATCH_DISPATCH
+#endif // J_MATH_SIMD_X86
+
+// Stack buffer holding a block of points in structure-of-arrays form.
+template<typename valuetype>
+struct PointBlock3D {
+  void Load(const Point3D<valuetype>* points, size_t count) { for (size_t i = 0; i < count; ++i) { x_[i] = points[i].x_; y_[i] = points[i].y_; z_[i] = points[i].z_; } }
+  Components3D<const valuetype> Read() const { return Components3D<const valuetype>{ x_, y_, z_ }; }
+
+  valuetype x_[kBatchBlockSize], y_[kBatchBlockSize], z_[kBatchBlockSize];
+};
+
+template<typename valuetype>
+void BatchDistance(const Point3D<valuetype>* points, const Point3D<valuetype>& p, valuetype* result, bool square_root, size_t count) {
+  PointBlock3D<valuetype> block;
+  for (size_t offset = 0; offset < count; offset += kBatchBlockSize) {
+    size_t n = (count - offset < kBatchBlockSize) ? count - offset : kBatchBlockSize;
+    block.Load(points + offset, n);
+    DistanceDispatch(block.Read(), p, result + offset, square_root, n);
+  }
+}
+
+} // namespace detail
+
+// Distance from points[i] to p for i in [0, count). Equivalent to (p - points[i]).Length().
+template<typename valuetype>
+void BatchDistance(const Point3D<valuetype>* points, const Point3D<valuetype>& p, valuetype* result, size_t count) { detail::BatchDistance(points, p, result, true, count); }
+
+// Squared distance from points[i] to p for i in [0, count). Equivalent to (p - points[i]).LengthSquared().
+template<typename valuetype>
+void BatchDistanceSquared(const Point3D<valuetype>* points, const Point3D<valuetype>& p, valuetype* result, size_t count) { detail::BatchDistance(points, p, result, false, count); }
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_POINT_BATCH_H_
@@ -0,0 +1,135 @@
+#pragma once
+#ifndef J_MATH_QUATERNION_H_
+#define J_MATH_QUATERNION_H_
+
+#include <cmath>
+#include <iostream>
+#include "..\utility\numeric_comparison.h"
+#include "..\utility\sqrt.h"
+#include "coordinate_frame.h"
+#include "matrix.h"
+#include "point.h"
+#include "vector.h"
+
+namespace j {
+namespace math {
+
+// A quaternion w + xi + yj + zk. Unit quaternions represent rotations in three-dimensional space: composing and
+// renormalizing them is cheaper and drifts less than doing the same with rotation matrices or coordinate frames.
+template<typename valuetype>
+struct Quaternion {
+  // Constructors
+  constexpr Quaternion() : w_(valuetype(1)), x_(valuetype(0)), y_(valuetype(0)), z_(valuetype(0)) { }
+  Quaternion(const Quaternion&) = default;
+  constexpr Quaternion(valuetype w, valuetype x, valuetype y, valuetype z) : w_(w), x_(x), y_(y), z_(z) { }
+  constexpr Quaternion(valuetype w, const Vector3D<valuetype>& v) : w_(w), x_(v.x_), y_(v.y_), z_(v.z_) { }
+  ~Quaternion() = default;
+  static constexpr Quaternion Identity() { return Quaternion(); }
+  // Rotation by angle_radians around axis, counter-clockwise when looking down the axis.
+  static Quaternion FromAxisAngle(const Vector3D<valuetype>& axis, valuetype angle_radians) {
+    valuetype half = angle_radians / valuetype(2);
+    return Quaternion(valuetype(std::cos(half)), axis.Normalize() * valuetype(std::sin(half)));
+  }
+  // Rotation represented by an orthonormal matrix with determinant 1 (Shepperd's method).
+  static constexpr Quaternion FromRotationMatrix(const Matrix3x3<valuetype>& m) {
+    valuetype trace = m.Trace();
+    if (trace > valuetype(0)) {
+      valuetype s = valuetype(Sqrt(trace + valuetype(1))) * valuetype(2);
+      return Quaternion(s / valuetype(4), (m.m_[2][1] - m.m_[1][2]) / s, (m.m_[0][2] - m.m_[2][0]) / s, (m.m_[1][0] - m.m_[0][1]) / s);
+    }
+    if (m.m_[0][0] > m.m_[1][1] && m.m_[0][0] > m.m_[2][2]) {
+      valuetype s = valuetype(Sqrt(valuetype(1) + m.m_[0][0] - m.m_[1][1] - m.m_[2][2])) * valuetype(2);
+      return Quaternion((m.m_[2][1] - m.m_[1][2]) / s, s / valuetype(4), (m.m_[0][1] + m.m_[1][0]) / s, (m.m_[0][2] + m.m_[2][0]) / s);
+    }
+    if (m.m_[1][1] > m.m_[2][2]) {
+      valuetype s = valuetype(Sqrt(valuetype(1) + m.m_[1][1] - m.m_[0][0] - m.m_[2][2])) * valuetype(2);
+      return Quaternion((m.m_[0][2] - m.m_[2][0]) / s, (m.m_[0][1] + m.m_[1][0]) / s, s / valuetype(4), (m.m_[1][2] + m.m_[2][1]) / s);
+    }
+    valuetype s = valuetype(Sqrt(valuetype(1) + m.m_[2][2] - m.m_[0][0] - m.m_[1][1])) * valuetype(2);
+    return Quaternion((m.m_[1][0] - m.m_[0][1]) / s, (m.m_[0][2] + m.m_[2][0]) / s, (m.m_[1][2] + m.m_[2][1]) / s, s / valuetype(4));
+  }
+  // Rotation that maps the canonical base vectors onto the base vectors of a right-handed orthonormal frame.
+  static constexpr Quaternion FromCoordinateFrame(const CoordinateFrame3D<valuetype>& frame) { return FromRotationMatrix(Matrix3x3<valuetype>::FromColumns(frame.u_, frame.v_, frame.w_)); }
+
+  // Operators
+  Quaternion& operator=(const Quaternion&) = default;
+  constexpr bool operator== (const Quaternion& other) const { return (AreEqual(w_, other.w_) && AreEqual(x_, other.x_) && AreEqual(y_, other.y_) && AreEqual(z_, other.z_)); }
+  constexpr bool operator!= (const Quaternion& other) const { return !operator==(other); }
+  constexpr Quaternion operator+ () const { return Quaternion(*this); }
+  constexpr Quaternion operator- () const { return Quaternion(-w_, -x_, -y_, -z_); }
+  constexpr Quaternion operator+ (const Quaternion& other) const { return Quaternion(w_ + other.w_, x_ + other.x_, y_ + other.y_, z_ + other.z_); }
+  constexpr Quaternion operator- (const Quaternion& other) const { return Quaternion(w_ - other.w_, x_ - other.x_, y_ - other.y_, z_ - other.z_); }
+  constexpr Quaternion operator* (valuetype scalar) const { return Quaternion(w_ * scalar, x_ * scalar, y_ * scalar, z_ * scalar); }
+  constexpr Quaternion operator/ (valuetype scalar) const { return Quaternion(w_ / scalar, x_ / scalar, y_ / scalar, z_ / scalar); }
+  // Hamilton product. As rotations, (a * b) first rotates by b, then by a.
+  constexpr Quaternion operator* (const Quaternion& other) const {
+    return Quaternion(w_ * other.w_ - x_ * other.x_ - y_ * other.y_ - z_ * other.z_,
+                      w_ * other.x_ + x_ * other.w_ + y_ * other.z_ - z_ * other.y_,
+                      w_ * other.y_ - x_ * other.z_ + y_ * other.w_ + z_ * other.x_,
+                      w_ * other.z_ + x_ * other.y_ - y_ * other.x_ + z_ * other.w_);
+  }
+  constexpr void operator*= (const Quaternion& other) { *this = operator*(other); }
+  constexpr void operator*= (valuetype scalar) { w_ *= scalar; x_ *= scalar; y_ *= scalar; z_ *= scalar; }
+
+  // Cast to different valuetype
+  template<typename other_valuetype> constexpr operator Quaternion<other_valuetype>() const { return Quaternion<other_valuetype>(other_valuetype(w_), other_valuetype(x_), other_valuetype(y_), other_valuetype(z_)); }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const Quaternion& q) { return os << "Quaternion(" << q.w_ << ", " << q.x_ << ", " << q.y_ << ", " << q.z_ << ")"; }
+
+  // Quaternion-specific functions
+  constexpr Vector3D<valuetype> VectorPart() const { return Vector3D<valuetype>(x_, y_, z_); }
+  constexpr valuetype ScalarProduct(const Quaternion& other) const { return w_ * other.w_ + x_ * other.x_ + y_ * other.y_ + z_ * other.z_; }
+  constexpr valuetype LengthSquared() const { return ScalarProduct(*this); }
+  constexpr valuetype Length() const { return valuetype(Sqrt(LengthSquared())); }
+  constexpr Quaternion Normalize() const { return operator/(Length()); }
+  constexpr bool IsNormalized() const { return AreEqual(Length(), valuetype(1)); }
+  // First-order renormalization without a square root. Brings a quaternion that has drifted slightly from unit length
+  // (e.g. after many compositions) back to unit length, the remaining error being quadratic in the drift.
+  constexpr Quaternion RenormalizeFast() const { return operator*((valuetype(3) - LengthSquared()) / valuetype(2)); }
+  constexpr Quaternion Conjugate() const { return Quaternion(w_, -x_, -y_, -z_); }
+  constexpr Quaternion Inverse() const { return Conjugate() / LengthSquared(); }
+  // Rotate a vector by a unit quaternion, using v + w * t + q x t with t = 2 * (q x v).
+  constexpr Vector3D<valuetype> Rotate(const Vector3D<valuetype>& v) const {
+    Vector3D<valuetype> t = VectorPart().CrossProduct(v) * valuetype(2);
+    return v + t * w_ + VectorPart().CrossProduct(t);
+  }
+  constexpr Point3D<valuetype> Rotate(const Point3D<valuetype>& p) const { Vector3D<valuetype> v = Rotate(Vector3D<valuetype>(p.x_, p.y_, p.z_)); return Point3D<valuetype>(v.x_, v.y_, v.z_); }
+  constexpr Matrix3x3<valuetype> ToRotationMatrix() const {
+    valuetype xx = x_ * x_, yy = y_ * y_, zz = z_ * z_, xy = x_ * y_, xz = x_ * z_, yz = y_ * z_, wx = w_ * x_, wy = w_ * y_, wz = w_ * z_;
+    return Matrix3x3<valuetype>(valuetype(1) - valuetype(2) * (yy + zz), valuetype(2) * (xy - wz), valuetype(2) * (xz + wy),
+                                valuetype(2) * (xy + wz), valuetype(1) - valuetype(2) * (xx + zz), valuetype(2) * (yz - wx),
+                                valuetype(2) * (xz - wy), valuetype(2) * (yz + wx), valuetype(1) - valuetype(2) * (xx + yy));
+  }
+  constexpr CoordinateFrame3D<valuetype> ToCoordinateFrame(const Point3D<valuetype>& p) const { return CoordinateFrame3D<valuetype>(p, Rotate(Vector3D<valuetype>::Xn()), Rotate(Vector3D<valuetype>::Yn()), Rotate(Vector3D<valuetype>::Zn())); }
+  // Rotation angle in [0, 2 * pi] and normalized axis. The axis is undefined for the identity rotation.
+  valuetype Angle() const { return valuetype(2) * valuetype(std::acos(w_ > valuetype(1) ? valuetype(1) : (w_ < valuetype(-1) ? valuetype(-1) : w_))); }
+  Vector3D<valuetype> Axis() const { return VectorPart().Normalize(); }
+
+  // Interpolation between unit quaternions along the shortest path, with t in [0, 1].
+  // Normalized linear interpolation: cheap, but the angular velocity is not constant.
+  static constexpr Quaternion Nlerp(const Quaternion& a, const Quaternion& b, valuetype t) {
+    Quaternion end = (a.ScalarProduct(b) < valuetype(0)) ? -b : b;
+    return (a * (valuetype(1) - t) + end * t).Normalize();
+  }
+  // Spherical linear interpolation: constant angular velocity. Falls back to Nlerp for nearly identical rotations,
+  // where the two are indistinguishable and the division by sin(angle) becomes unstable.
+  static Quaternion Slerp(const Quaternion& a, const Quaternion& b, valuetype t) {
+    valuetype cos_angle = a.ScalarProduct(b);
+    Quaternion end = (cos_angle < valuetype(0)) ? -b : b;
+    cos_angle = std::fabs(cos_angle);
+    if (cos_angle > valuetype(0.9995)) { return Nlerp(a, end, t); }
+    valuetype angle = valuetype(std::acos(cos_angle));
+    valuetype sin_angle = valuetype(std::sin(angle));
+    return (a * valuetype(std::sin((valuetype(1) - t) * angle)) + end * valuetype(std::sin(t * angle))) / sin_angle;
+  }
+
+  valuetype w_, x_, y_, z_;
+};
+typedef Quaternion<float> quatf;
+typedef Quaternion<double> quatd;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_QUATERNION_H_
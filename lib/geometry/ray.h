@@ -0,0 +1,350 @@
+#pragma once
+#ifndef J_MATH_RAY_H_
+#define J_MATH_RAY_H_
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include "..\utility\simd.h"
+#include "line.h"
+#include "plane.h"
+#include "point.h"
+#include "sphere.h"
+#include "vector.h"
+
+namespace j {
+namespace math {
+
+namespace detail {
+
+// Minimum and maximum with the operand order of the SSE/AVX min and max instructions, so scalar and packet
+// intersections agree exactly.
+template<typename valuetype> valuetype RayMin(valuetype a, valuetype b) { return (a < b) ? a : b; }
+template<typename valuetype> valuetype RayMax(valuetype a, valuetype b) { return (a > b) ? a : b; }
+
+// Nearest surface hit t in [0, t_max] of the ray o + t * d (d normalized) with a sphere. From inside the sphere the
+// exit point is reported.
+template<typename valuetype>
+bool IntersectRaySphere(valuetype ox, valuetype oy, valuetype oz, valuetype dx, valuetype dy, valuetype dz, const Sphere<valuetype>& s, valuetype t_max, valuetype* t) {
+  valuetype ocx = ox - s.c_.x_, ocy = oy - s.c_.y_, ocz = oz - s.c_.z_;
+  valuetype b = ocx * dx + ocy * dy + ocz * dz;
+  valuetype c = (ocx * ocx + ocy * ocy + ocz * ocz) - s.r_ * s.r_;
+  valuetype discriminant = b * b - c;
+  if (!(discriminant >= valuetype(0))) { return false; }
+  valuetype root = std::sqrt(discriminant);
+  valuetype t0 = -b - root;
+  valuetype t1 = -b + root;
+  valuetype hit = (t0 >= valuetype(0)) ? t0 : t1;
+  if (!(hit >= valuetype(0) && hit <= t_max)) { return false; }
+  *t = hit;
+  return true;
+}
+
+// Hit t in [0, t_max] of the ray o + t * d with a plane. Rays parallel to the plane never hit.
+template<typename valuetype>
+bool IntersectRayPlane(valuetype ox, valuetype oy, valuetype oz, valuetype dx, valuetype dy, valuetype dz, const Point3D<valuetype>& p, const Vector3D<valuetype>& n, valuetype t_max, valuetype* t) {
+  valuetype denominator = n.x_ * dx + n.y_ * dy + n.z_ * dz;
+  valuetype numerator = (p.x_ - ox) * n.x_ + (p.y_ - oy) * n.y_ + (p.z_ - oz) * n.z_;
+  valuetype hit = numerator / denominator;
+  if (!(denominator != valuetype(0) && hit >= valuetype(0) && hit <= t_max)) { return false; }
+  *t = hit;
+  return true;
+}
+
+// Slab test of the ray o + t * d, given its inverse direction, with the box [min, max]. Reports the interval
+// [t_enter, t_exit] of the ray inside the box, clipped to [0, t_max].
+template<typename valuetype>
+bool IntersectRayBox(valuetype ox, valuetype oy, valuetype oz, valuetype ix, valuetype iy, valuetype iz, const Point3D<valuetype>& min, const Point3D<valuetype>& max, valuetype t_max, valuetype* t_enter, valuetype* t_exit) {
+  valuetype x1 = (min.x_ - ox) * ix, x2 = (max.x_ - ox) * ix;
+  valuetype y1 = (min.y_ - oy) * iy, y2 = (max.y_ - oy) * iy;
+  valuetype z1 = (min.z_ - oz) * iz, z2 = (max.z_ - oz) * iz;
+  valuetype enter = RayMax(RayMax(RayMin(x1, x2), RayMin(y1, y2)), RayMax(RayMin(z1, z2), valuetype(0)));
+  valuetype exit = RayMin(RayMin(RayMax(x1, x2), RayMax(y1, y2)), RayMin(RayMax(z1, z2), t_max));
+  if (!(enter <= exit)) { return false; }
+  *t_enter = enter;
+  *t_exit = exit;
+  return true;
+}
+
+} // namespace detail
+
+// A three-dimensional ray. Represented by an origin point and a unit direction vector, along with the precomputed
+// inverse of the direction used by box intersections.
+template<typename valuetype>
+struct Ray3D {
+  // Constructors
+  Ray3D() : p_{ 0, 0, 0 } { SetDirection(Vector3D<valuetype>(0, 0, 1)); }
+  Ray3D(const Ray3D&) = default;
+  Ray3D(Point3D<valuetype> p, Vector3D<valuetype> v) : p_{ p } { SetDirection(v); }
+  explicit Ray3D(const Line3D<valuetype>& line) : p_{ line.p_ } { SetDirection(line.GetDirection()); }
+  ~Ray3D() = default;
+
+  // Operators
+  Ray3D& operator=(const Ray3D& other) = default;
+  bool operator==(const Ray3D<valuetype>& other) const { return (p_ == other.p_ && v_ == other.v_); }
+  bool operator!=(const Ray3D<valuetype>& other) const { return (p_ != other.p_ || v_ != other.v_); }
+  Ray3D operator+(const Vector3D<valuetype>& vector) const { return Ray3D(p_ + vector, v_); }
+  Ray3D operator-(const Vector3D<valuetype>& vector) const { return Ray3D(p_ - vector, v_); }
+  void operator+=(const Vector3D<valuetype>& vector) { p_ += vector; }
+  void operator-=(const Vector3D<valuetype>& vector) { p_ -= vector; }
+  Point3D<valuetype> operator()(valuetype t) const { return EvaluateParametricSpecification(t); }
+
+  // Cast to different valuetype
+  template<typename other_valuetype> operator Ray3D<other_valuetype>() const { return Ray3D<other_valuetype>(Point3D<other_valuetype>(p_), Vector3D<other_valuetype>(v_)); }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const Ray3D<valuetype>& ray) { return os << "Ray3D(p=" << ray.p_ << ", v=" << ray.v_ << ")"; }
+
+  // Ray-specific operations
+  Vector3D<valuetype> GetDirection() const { return v_; }
+  Vector3D<valuetype> GetInverseDirection() const { return inv_v_; }
+  void SetDirection(const Vector3D<valuetype>& v) {
+    v_ = v.Normalize();
+    inv_v_ = Vector3D<valuetype>(valuetype(1) / v_.x_, valuetype(1) / v_.y_, valuetype(1) / v_.z_);
+  }
+  Point3D<valuetype> EvaluateParametricSpecification(valuetype t) const { return(p_ + (v_ * t)); }
+  valuetype FindNearestParameterValue(const Point3D<valuetype>& p) const { valuetype t = (p_ - p).ScalarProduct(v_); return (t > valuetype(0)) ? t : valuetype(0); }
+  Point3D<valuetype> FindNearestPoint(const Point3D<valuetype>& p) const { return EvaluateParametricSpecification(FindNearestParameterValue(p)); }
+
+  // Intersections. Each reports the nearest hit t in [0, t_max] along the ray, or returns false when there is none.
+  bool Intersect(const Sphere<valuetype>& sphere, valuetype* t, valuetype t_max = std::numeric_limits<valuetype>::max()) const {
+    return detail::IntersectRaySphere(p_.x_, p_.y_, p_.z_, v_.x_, v_.y_, v_.z_, sphere, t_max, t);
+  }
+  bool Intersect(const Plane<valuetype>& plane, valuetype* t, valuetype t_max = std::numeric_limits<valuetype>::max()) const {
+    return detail::IntersectRayPlane(p_.x_, p_.y_, p_.z_, v_.x_, v_.y_, v_.z_, plane.p_, plane.Normal(), t_max, t);
+  }
+  // Axis-aligned box [min, max]. t is the entry point, or 0 when the origin lies inside the box.
+  bool IntersectBox(const Point3D<valuetype>& min, const Point3D<valuetype>& max, valuetype* t, valuetype t_max = std::numeric_limits<valuetype>::max()) const {
+    valuetype t_exit;
+    return detail::IntersectRayBox(p_.x_, p_.y_, p_.z_, inv_v_.x_, inv_v_.y_, inv_v_.z_, min, max, t_max, t, &t_exit);
+  }
+
+  Point3D<valuetype> p_;
+private:
+  Vector3D<valuetype> v_;     // Only accessible via getter and setter to keep it a unit vector to simplify calculations
+  Vector3D<valuetype> inv_v_; // Component-wise inverse of v_, kept in sync by SetDirection
+};
+typedef Ray3D<float> Ray3f;
+typedef Ray3D<double> Ray3d;
+
+// A packet of rays in structure-of-arrays form, traced together against the same primitive. The packet intersections
+// return a bitmask with bit i set when ray i hits, and write the hit parameters to t[0, size). They give exactly the
+// same results as the Ray3D member functions; packets of 4 and 8 floats run on SSE2 and AVX2.
+template<typename valuetype, int size>
+struct RayPacket3D {
+  // Constructors
+  RayPacket3D() = default;
+  explicit RayPacket3D(const Ray3D<valuetype>* rays) { for (int i = 0; i < size; ++i) { Set(i, rays[i]); } }
+
+  // Packet-specific operations
+  void Set(int i, const Ray3D<valuetype>& ray) {
+    Vector3D<valuetype> d = ray.GetDirection(), inv = ray.GetInverseDirection();
+    ox_[i] = ray.p_.x_; oy_[i] = ray.p_.y_; oz_[i] = ray.p_.z_;
+    dx_[i] = d.x_; dy_[i] = d.y_; dz_[i] = d.z_;
+    ix_[i] = inv.x_; iy_[i] = inv.y_; iz_[i] = inv.z_;
+  }
+  Ray3D<valuetype> Get(int i) const { return Ray3D<valuetype>(Point3D<valuetype>(ox_[i], oy_[i], oz_[i]), Vector3D<valuetype>(dx_[i], dy_[i], dz_[i])); }
+  static int Size() { return size; }
+
+  alignas(32) valuetype ox_[size];
+  alignas(32) valuetype oy_[size];
+  alignas(32) valuetype oz_[size];
+  alignas(32) valuetype dx_[size];
+  alignas(32) valuetype dy_[size];
+  alignas(32) valuetype dz_[size];
+  alignas(32) valuetype ix_[size];
+  alignas(32) valuetype iy_[size];
+  alignas(32) valuetype iz_[size];
+};
+using RayPacket4f = RayPacket3D<float, 4>;
+using RayPacket8f = RayPacket3D<float, 8>;
+using RayPacket4d = RayPacket3D<double, 4>;
+
+namespace detail {
+
+//
+// Generic packet kernels (any valuetype and packet size)
+//
+template<typename valuetype, int size>
+int IntersectSphereGeneric(const RayPacket3D<valuetype, size>& r, const Sphere<valuetype>& s, valuetype t_max, valuetype* t) {
+  int mask = 0;
+  for (int i = 0; i < size; ++i) { if (IntersectRaySphere(r.ox_[i], r.oy_[i], r.oz_[i], r.dx_[i], r.dy_[i], r.dz_[i], s, t_max, t + i)) { mask |= 1 << i; } }
+  return mask;
+}
+
+template<typename valuetype, int size>
+int IntersectPlaneGeneric(const RayPacket3D<valuetype, size>& r, const Plane<valuetype>& plane, valuetype t_max, valuetype* t) {
+  int mask = 0;
+  Vector3D<valuetype> n = plane.Normal();
+  for (int i = 0; i < size; ++i) { if (IntersectRayPlane(r.ox_[i], r.oy_[i], r.oz_[i], r.dx_[i], r.dy_[i], r.dz_[i], plane.p_, n, t_max, t + i)) { mask |= 1 << i; } }
+  return mask;
+}
+
+template<typename valuetype, int size>
+int IntersectBoxGeneric(const RayPacket3D<valuetype, size>& r, const Point3D<valuetype>& min, const Point3D<valuetype>& max, valuetype t_max, valuetype* t) {
+  int mask = 0;
+  for (int i = 0; i < size; ++i) {
+    valuetype t_exit;
+    if (IntersectRayBox(r.ox_[i], r.oy_[i], r.oz_[i], r.ix_[i], r.iy_[i], r.iz_[i], min, max, t_max, t + i, &t_exit)) { mask |= 1 << i; }
+  }
+  return mask;
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+//
+// SSE2 kernels (4 float rays)
+//
+J_MATH_TARGET_SSE2 inline int IntersectSphereSse(const RayPacket4f& r, const Sphere<float>& s, float t_max, float* t) {
+  __m128 ox = _mm_load_ps(r.ox_), oy = _mm_load_ps(r.oy_), oz = _mm_load_ps(r.oz_);
+  __m128 dx = _mm_load_ps(r.dx_), dy = _mm_load_ps(r.dy_), dz = _mm_load_ps(r.dz_);
+  __m128 ocx = _mm_sub_ps(ox, _mm_set1_ps(s.c_.x_)), ocy = _mm_sub_ps(oy, _mm_set1_ps(s.c_.y_)), ocz = _mm_sub_ps(oz, _mm_set1_ps(s.c_.z_));
+  __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, dx), _mm_mul_ps(ocy, dy)), _mm_mul_ps(ocz, dz));
+  __m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, ocx), _mm_mul_ps(ocy, ocy)), _mm_mul_ps(ocz, ocz)), _mm_set1_ps(s.r_ * s.r_));
+  __m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), c);
+  __m128 zero = _mm_setzero_ps();
+  __m128 valid = _mm_cmpge_ps(discriminant, zero);
+  __m128 root = _mm_sqrt_ps(discriminant);
+  __m128 minus_b = _mm_xor_ps(b, _mm_set1_ps(-0.0f));
+  __m128 t0 = _mm_sub_ps(minus_b, root);
+  __m128 t1 = _mm_add_ps(minus_b, root);
+  __m128 use_t0 = _mm_cmpge_ps(t0, zero);
+  __m128 hit = _mm_or_ps(_mm_and_ps(use_t0, t0), _mm_andnot_ps(use_t0, t1));
+  valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(hit, zero), _mm_cmple_ps(hit, _mm_set1_ps(t_max))));
+  int mask = _mm_movemask_ps(valid);
+  alignas(16) float hits[4];
+  _mm_store_ps(hits, hit);
+  for (int i = 0; i < 4; ++i) { if (mask & (1 << i)) { t[i] = hits[i]; } }
+  return mask;
+}
+
+J_MATH_TARGET_SSE2 inline int IntersectPlaneSse(const RayPacket4f& r, const Plane<float>& plane, float t_max, float* t) {
+  Vector3D<float> normal = plane.Normal();
+  __m128 nx = _mm_set1_ps(normal.x_), ny = _mm_set1_ps(normal.y_), nz = _mm_set1_ps(normal.z_);
+  __m128 denominator = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_load_ps(r.dx_)), _mm_mul_ps(ny, _mm_load_ps(r.dy_))), _mm_mul_ps(nz, _mm_load_ps(r.dz_)));
+  __m128 px = _mm_sub_ps(_mm_set1_ps(plane.p_.x_), _mm_load_ps(r.ox_));
+  __m128 py = _mm_sub_ps(_mm_set1_ps(plane.p_.y_), _mm_load_ps(r.oy_));
+  __m128 pz = _mm_sub_ps(_mm_set1_ps(plane.p_.z_), _mm_load_ps(r.oz_));
+  __m128 numerator = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, nx), _mm_mul_ps(py, ny)), _mm_mul_ps(pz, nz));
+  __m128 hit = _mm_div_ps(numerator, denominator);
+  __m128 zero = _mm_setzero_ps();
+  __m128 valid = _mm_and_ps(_mm_cmpneq_ps(denominator, zero), _mm_and_ps(_mm_cmpge_ps(hit, zero), _mm_cmple_ps(hit, _mm_set1_ps(t_max))));
+  int mask = _mm_movemask_ps(valid);
+  alignas(16) float hits[4];
+  _mm_store_ps(hits, hit);
+  for (int i = 0; i < 4; ++i) { if (mask & (1 << i)) { t[i] = hits[i]; } }
+  return mask;
+}
+
+J_MATH_TARGET_SSE2 inline int IntersectBoxSse(const RayPacket4f& r, const Point3D<float>& min, const Point3D<float>& max, float t_max, float* t) {
+  __m128 ox = _mm_load_ps(r.ox_), oy = _mm_load_ps(r.oy_), oz = _mm_load_ps(r.oz_);
+  __m128 ix = _mm_load_ps(r.ix_), iy = _mm_load_ps(r.iy_), iz = _mm_load_ps(r.iz_);
+  __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min.x_), ox), ix), x2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(max.x_), ox), ix);
+  __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min.y_), oy), iy), y2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(max.y_), oy), iy);
+  __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min.z_), oz), iz), z2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(max.z_), oz), iz);
+  __m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)), _mm_max_ps(_mm_min_ps(z1, z2), _mm_setzero_ps()));
+  __m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)), _mm_min_ps(_mm_max_ps(z1, z2), _mm_set1_ps(t_max)));
+  int mask = _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+  alignas(16) float hits[4];
+  _mm_store_ps(hits, enter);
+  for (int i = 0; i < 4; ++i) { if (mask & (1 << i)) { t[i] = hits[i]; } }
+  return mask;
+}
+
+//
+// AVX2 kernels (8 float rays)
+//
+J_MATH_TARGET_AVX2 inline int IntersectSphereAvx2(const RayPacket8f& r, const Sphere<float>& s, float t_max, float* t) {
+  __m256 ox = _mm256_load_ps(r.ox_), oy = _mm256_load_ps(r.oy_), oz = _mm256_load_ps(r.oz_);
+  __m256 dx = _mm256_load_ps(r.dx_), dy = _mm256_load_ps(r.dy_), dz = _mm256_load_ps(r.dz_);
+  __m256 ocx = _mm256_sub_ps(ox, _mm256_set1_ps(s.c_.x_)), ocy = _mm256_sub_ps(oy, _mm256_set1_ps(s.c_.y_)), ocz = _mm256_sub_ps(oz, _mm256_set1_ps(s.c_.z_));
+  __m256 b = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ocx, dx), _mm256_mul_ps(ocy, dy)), _mm256_mul_ps(ocz, dz));
+  __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ocx, ocx), _mm256_mul_ps(ocy, ocy)), _mm256_mul_ps(ocz, ocz)), _mm256_set1_ps(s.r_ * s.r_));
+  __m256 discriminant = _mm256_sub_ps(_mm256_mul_ps(b, b), c);
+  __m256 zero = _mm256_setzero_ps();
+  __m256 valid = _mm256_cmp_ps(discriminant, zero, _CMP_GE_OQ);
+  __m256 root = _mm256_sqrt_ps(discriminant);
+  __m256 minus_b = _mm256_xor_ps(b, _mm256_set1_ps(-0.0f));
+  __m256 t0 = _mm256_sub_ps(minus_b, root);
+  __m256 t1 = _mm256_add_ps(minus_b, root);
+  __m256 hit = _mm256_blendv_ps(t1, t0, _mm256_cmp_ps(t0, zero, _CMP_GE_OQ));
+  valid = _mm256_and_ps(valid, _mm256_and_ps(_mm256_cmp_ps(hit, zero, _CMP_GE_OQ), _mm256_cmp_ps(hit, _mm256_set1_ps(t_max), _CMP_LE_OQ)));
+  int mask = _mm256_movemask_ps(valid);
+  alignas(32) float hits[8];
+  _mm256_store_ps(hits, hit);
+  for (int i = 0; i < 8; ++i) { if (mask & (1 << i)) { t[i] = hits[i]; } }
+  return mask;
+}
+
+J_MATH_TARGET_AVX2 inline int IntersectPlaneAvx2(const RayPacket8f& r, const Plane<float>& plane, float t_max, float* t) {
+  Vector3D<float> normal = plane.Normal();
+  __m256 nx = _mm256_set1_ps(normal.x_), ny = _mm256_set1_ps(normal.y_), nz = _mm256_set1_ps(normal.z_);
+  __m256 denominator = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, _mm256_load_ps(r.dx_)), _mm256_mul_ps(ny, _mm256_load_ps(r.dy_))), _mm256_mul_ps(nz, _mm256_load_ps(r.dz_)));
+  __m256 px = _mm256_sub_ps(_mm256_set1_ps(plane.p_.x_), _mm256_load_ps(r.ox_));
+  __m256 py = _mm256_sub_ps(_mm256_set1_ps(plane.p_.y_), _mm256_load_ps(r.oy_));
+  __m256 pz = _mm256_sub_ps(_mm256_set1_ps(plane.p_.z_), _mm256_load_ps(r.oz_));
+  __m256 numerator = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, nx), _mm256_mul_ps(py, ny)), _mm256_mul_ps(pz, nz));
+  __m256 hit = _mm256_div_ps(numerator, denominator);
+  __m256 zero = _mm256_setzero_ps();
+  __m256 valid = _mm256_and_ps(_mm256_cmp_ps(denominator, zero, _CMP_NEQ_UQ), _mm256_and_ps(_mm256_cmp_ps(hit, zero, _CMP_GE_OQ), _mm256_cmp_ps(hit, _mm256_set1_ps(t_max), _CMP_LE_OQ)));
+  int mask = _mm256_movemask_ps(valid);
+  alignas(32) float hits[8];
+  _mm256_store_ps(hits, hit);
+  for (int i = 0; i < 8; ++i) { if (mask & (1 << i)) { t[i] = hits[i]; } }
+  return mask;
+}
+
+J_MATH_TARGET_AVX2 inline int IntersectBoxAvx2(const RayPacket8f& r, const Point3D<float>& min, const Point3D<float>& max, float t_max, float* t) {
+  __m256 ox = _mm256_load_ps(r.ox_), oy = _mm256_load_ps(r.oy_), oz = _mm256_load_ps(r.oz_);
+  __m256 ix = _mm256_load_ps(r.ix_), iy = _mm256_load_ps(r.iy_), iz = _mm256_load_ps(r.iz_);
+  __m256 x1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(min.x_), ox), ix), x2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(max.x_), ox), ix);
+  __m256 y1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(min.y_), oy), iy), y2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(max.y_), oy), iy);
+  __m256 z1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(min.z_), oz), iz), z2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(max.z_), oz), iz);
+  __m256 enter = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(x1, x2), _mm256_min_ps(y1, y2)), _mm256_max_ps(_mm256_min_ps(z1, z2), _mm256_setzero_ps()));
+  __m256 exit = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(x1, x2), _mm256_max_ps(y1, y2)), _mm256_min_ps(_mm256_max_ps(z1, z2), _mm256_set1_ps(t_max)));
+  int mask = _mm256_movemask_ps(_mm256_cmp_ps(enter, exit, _CMP_LE_OQ));
+  alignas(32) float hits[8];
+  _mm256_store_ps(hits, enter);
+  for (int i = 0; i < 8; ++i) { if (mask & (1 << i)) { t[i] = hits[i]; } }
+  return mask;
+}
+
+#endif // J_MATH_SIMD_X86
+
+} // namespace detail
+
+// Intersect every ray of the packet with a sphere, see Ray3D::Intersect.
+template<typename valuetype, int size>
+int Intersect(const RayPacket3D<valuetype, size>& rays, const Sphere<valuetype>& sphere, valuetype* t, valuetype t_max = std::numeric_limits<valuetype>::max()) { return detail::IntersectSphereGeneric(rays, sphere, t_max, t); }
+// Intersect every ray of the packet with a plane, see Ray3D::Intersect.
+template<typename valuetype, int size>
+int Intersect(const RayPacket3D<valuetype, size>& rays, const Plane<valuetype>& plane, valuetype* t, valuetype t_max = std::numeric_limits<valuetype>::max()) { return detail::IntersectPlaneGeneric(rays, plane, t_max, t); }
+// Intersect every ray of the packet with the axis-aligned box [min, max], see Ray3D::IntersectBox.
+template<typename valuetype, int size>
+int IntersectBox(const RayPacket3D<valuetype, size>& rays, const Point3D<valuetype>& min, const Point3D<valuetype>& max, valuetype* t, valuetype t_max = std::numeric_limits<valuetype>::max()) { return detail::IntersectBoxGeneric(rays, min, max, t_max, t); }
+
+#if defined(J_MATH_SIMD_X86)
+inline int Intersect(const RayPacket4f& rays, const Sphere<float>& sphere, float* t, float t_max = std::numeric_limits<float>::max()) {
+  return (GetSimdLevel() >= SimdLevel::SSE) ? detail::IntersectSphereSse(rays, sphere, t_max, t) : detail::IntersectSphereGeneric(rays, sphere, t_max, t);
+}
+inline int Intersect(const RayPacket4f& rays, const Plane<float>& plane, float* t, float t_max = std::numeric_limits<float>::max()) {
+  return (GetSimdLevel() >= SimdLevel::SSE) ? detail::IntersectPlaneSse(rays, plane, t_max, t) : detail::IntersectPlaneGeneric(rays, plane, t_max, t);
+}
+inline int IntersectBox(const RayPacket4f& rays, const Point3D<float>& min, const Point3D<float>& max, float* t, float t_max = std::numeric_limits<float>::max()) {
+  return (GetSimdLevel() >= SimdLevel::SSE) ? detail::IntersectBoxSse(rays, min, max, t_max, t) : detail::IntersectBoxGeneric(rays, min, max, t_max, t);
+}
+inline int Intersect(const RayPacket8f& rays, const Sphere<float>& sphere, float* t, float t_max = std::numeric_limits<float>::max()) {
+  return (GetSimdLevel() >= SimdLevel::AVX2) ? detail::IntersectSphereAvx2(rays, sphere, t_max, t) : detail::IntersectSphereGeneric(rays, sphere, t_max, t);
+}
+inline int Intersect(const RayPacket8f& rays, const Plane<float>& plane, float* t, float t_max = std::numeric_limits<float>::max()) {
+  return (GetSimdLevel() >= SimdLevel::AVX2) ? detail::IntersectPlaneAvx2(rays, plane, t_max, t) : detail::IntersectPlaneGeneric(rays, plane, t_max, t);
+}
+inline int IntersectBox(const RayPacket8f& rays, const Point3D<float>& min, const Point3D<float>& max, float* t, float t_max = std::numeric_limits<float>::max()) {
+  return (GetSimdLevel() >= SimdLevel::AVX2) ? detail::IntersectBoxAvx2(rays, min, max, t_max, t) : detail::IntersectBoxGeneric(rays, min, max, t_max, t);
+}
+#endif // J_MATH_SIMD_X86
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_RAY_H_
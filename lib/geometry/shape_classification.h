@@ -0,0 +1,376 @@
+#pragma once
+#ifndef J_MATH_SHAPE_CLASSIFICATION_H_
+#define J_MATH_SHAPE_CLASSIFICATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "..\utility\simd.h"
+#include "plane.h"
+#include "point.h"
+#include "point_array.h"
+#include "point_batch.h"
+#include "sphere.h"
+
+namespace j {
+namespace math {
+
+// Batch classification of points against Sphere, Circle and Plane.
+//
+// Results are written as a bitmask: bit (i % 64) of mask[i / 64] is set when point i passes the test. The caller
+// provides MaskWords(count) words, or passes a std::vector that is resized. MaskToIndices turns a mask into an index
+// list. The tests compare squared distances, so no square root is taken, and give the same answer as the matching
+// member function (Sphere::IsInside, Plane::IsAbovePlane, ...) for every point.
+
+// Number of 64-bit mask words needed to classify count points.
+inline size_t MaskWords(size_t count) { return (count + 63) / 64; }
+
+namespace detail {
+
+// Pointers to the x and y components of a structure-of-arrays batch of points.
+template<typename valuetype>
+struct Components2D {
+  valuetype* x_;
+  valuetype* y_;
+};
+
+inline size_t CountTrailingZeros(uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+  unsigned long index;
+  _BitScanForward64(&index, word);
+  return size_t(index);
+#elif defined(__GNUC__) || defined(__clang__)
+  return size_t(__builtin_ctzll(word));
+#else
+  size_t index = 0;
+  while ((word & 1) == 0) { word >>= 1; ++index; }
+  return index;
+#endif
+}
+
+//
+// Generic kernels (any valuetype, elements [begin, end))
+//
+template<typename valuetype>
+void CircleDistanceSquaredGeneric(Components2D<const valuetype> points, const Point2D<valuetype>& c, valuetype* result, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    valuetype dx = c.x_ - points.x_[i];
+    valuetype dy = c.y_ - points.y_[i];
+    result[i] = dx * dx + dy * dy;
+  }
+}
+
+template<typename valuetype>
+void PlaneEquationGeneric(Components3D<const valuetype> points, const Point3D<valuetype>& p, const Vector3D<valuetype>& n, valuetype* result, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) { result[i] = (p.x_ - points.x_[i]) * n.x_ + (p.y_ - points.y_[i]) * n.y_ + (p.z_ - points.z_[i]) * n.z_; }
+}
+
+// Sets the mask bit of every value below (or above, when greater is set) the threshold. begin is a multiple of the
+// SIMD width, the words covering [begin, end) must be zeroed beforehand.
+template<typename valuetype>
+void CompareMaskGeneric(const valuetype* values, valuetype threshold, bool greater, uint64_t* mask, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    bool set = greater ? (values[i] > threshold) : (values[i] < threshold);
+    if (set) { mask[i / 64] |= uint64_t(1) << (i % 64); }
+  }
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+//
+// SSE2 kernels
+//
+J_MATH_TARGET_SSE2 inline void CircleDistanceSquaredSse(Components2D<const float> points, const Point2D<float>& c, float* result, size_t count) {
+  __m128 cx = _mm_set1_ps(c.x_), cy = _mm_set1_ps(c.y_);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 dx = _mm_sub_ps(cx, _mm_loadu_ps(points.x_ + i));
+    __m128 dy = _mm_sub_ps(cy, _mm_loadu_ps(points.y_ + i));
+    _mm_storeu_ps(result + i, _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+  }
+  CircleDistanceSquaredGeneric(points, c, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void CircleDistanceSquaredSse(Components2D<const double> points, const Point2D<double>& c, double* result, size_t count) {
+  __m128d cx = _mm_set1_pd(c.x_), cy = _mm_set1_pd(c.y_);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d dx = _mm_sub_pd(cx, _mm_loadu_pd(points.x_ + i));
+    __m128d dy = _mm_sub_pd(cy, _mm_loadu_pd(points.y_ + i));
+    _mm_storeu_pd(result + i, _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+  }
+  CircleDistanceSquaredGeneric(points, c, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void PlaneEquationSse(Components3D<const float> points, const Point3D<float>& p, const Vector3D<float>& n, float* result, size_t count) {
+  __m128 px = _mm_set1_ps(p.x_), py = _mm_set1_ps(p.y_), pz = _mm_set1_ps(p.z_);
+  __m128 nx = _mm_set1_ps(n.x_), ny = _mm_set1_ps(n.y_), nz = _mm_set1_ps(n.z_);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_mul_ps(_mm_sub_ps(px, _mm_loadu_ps(points.x_ + i)), nx);
+    __m128 y = _mm_mul_ps(_mm_sub_ps(py, _mm_loadu_ps(points.y_ + i)), ny);
+    __m128 z = _mm_mul_ps(_mm_sub_ps(pz, _mm_loadu_ps(points.z_ + i)), nz);
+    _mm_storeu_ps(result + i, _mm_add_ps(_mm_add_ps(x, y), z));
+  }
+  PlaneEquationGeneric(points, p, n, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void PlaneEquationSse(Components3D<const double> points, const Point3D<double>& p, const Vector3D<double>& n, double* result, size_t count) {
+  __m128d px = _mm_set1_pd(p.x_), py = _mm_set1_pd(p.y_), pz = _mm_set1_pd(p.z_);
+  __m128d nx = _mm_set1_pd(n.x_), ny = _mm_set1_pd(n.y_), nz = _mm_set1_pd(n.z_);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d x = _mm_mul_pd(_mm_sub_pd(px, _mm_loadu_pd(points.x_ + i)), nx);
+    __m128d y = _mm_mul_pd(_mm_sub_pd(py, _mm_loadu_pd(points.y_ + i)), ny);
+    __m128d z = _mm_mul_pd(_mm_sub_pd(pz, _mm_loadu_pd(points.z_ + i)), nz);
+    _mm_storeu_pd(result + i, _mm_add_pd(_mm_add_pd(x, y), z));
+  }
+  PlaneEquationGeneric(points, p, n, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void CompareMaskSse(const float* values, float threshold, bool greater, uint64_t* mask, size_t count) {
+  __m128 t = _mm_set1_ps(threshold);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 v = _mm_loadu_ps(values + i);
+    int bits = _mm_movemask_ps(greater ? _mm_cmpgt_ps(v, t) : _mm_cmplt_ps(v, t));
+    mask[i / 64] |= uint64_t(bits) << (i % 64);
+  }
+  CompareMaskGeneric(values, threshold, greater, mask, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void CompareMaskSse(const double* values, double threshold, bool greater, uint64_t* mask, size_t count) {
+  __m128d t = _mm_set1_pd(threshold);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d v = _mm_loadu_pd(values + i);
+    int bits = _mm_movemask_pd(greater ? _mm_cmpgt_pd(v, t) : _mm_cmplt_pd(v, t));
+    mask[i / 64] |= uint64_t(bits) << (i % 64);
+  }
+  CompareMaskGeneric(values, threshold, greater, mask, i, count);
+}
+
+//
+// AVX2 kernels
+//
+J_MATH_TARGET_AVX2 inline void CircleDistanceSquaredAvx2(Components2D<const float> points, const Point2D<float>& c, float* result, size_t count) {
+  __m256 cx = _mm256_set1_ps(c.x_), cy = _mm256_set1_ps(c.y_);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 dx = _mm256_sub_ps(cx, _mm256_loadu_ps(points.x_ + i));
+    __m256 dy = _mm256_sub_ps(cy, _mm256_loadu_ps(points.y_ + i));
+    _mm256_storeu_ps(result + i, _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+  }
+  CircleDistanceSquaredGeneric(points, c, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void CircleDistanceSquaredAvx2(Components2D<const double> points, const Point2D<double>& c, double* result, size_t count) {
+  __m256d cx = _mm256_set1_pd(c.x_), cy = _mm256_set1_pd(c.y_);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d dx = _mm256_sub_pd(cx, _mm256_loadu_pd(points.x_ + i));
+    __m256d dy = _mm256_sub_pd(cy, _mm256_loadu_pd(points.y_ + i));
+    _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+  }
+  CircleDistanceSquaredGeneric(points, c, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void PlaneEquationAvx2(Components3D<const float> points, const Point3D<float>& p, const Vector3D<float>& n, float* result, size_t count) {
+  __m256 px = _mm256_set1_ps(p.x_), py = _mm256_set1_ps(p.y_), pz = _mm256_set1_ps(p.z_);
+  __m256 nx = _mm256_set1_ps(n.x_), ny = _mm256_set1_ps(n.y_), nz = _mm256_set1_ps(n.z_);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_mul_ps(_mm256_sub_ps(px, _mm256_loadu_ps(points.x_ + i)), nx);
+    __m256 y = _mm256_mul_ps(_mm256_sub_ps(py, _mm256_loadu_ps(points.y_ + i)), ny);
+    __m256 z = _mm256_mul_ps(_mm256_sub_ps(pz, _mm256_loadu_ps(points.z_ + i)), nz);
+    _mm256_storeu_ps(result + i, _mm256_add_ps(_mm256_add_ps(x, y), z));
+  }
+  PlaneEquationGeneric(points, p, n, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void PlaneEquationAvx2(Components3D<const double> points, const Point3D<double>& p, const Vector3D<double>& n, double* result, size_t count) {
+  __m256d px = _mm256_set1_pd(p.x_), py = _mm256_set1_pd(p.y_), pz = _mm256_set1_pd(p.z_);
+  __m256d nx = _mm256_set1_pd(n.x_), ny = _mm256_set1_pd(n.y_), nz = _mm256_set1_pd(n.z_);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d x = _mm256_mul_pd(_mm256_sub_pd(px, _mm256_loadu_pd(points.x_ + i)), nx);
+    __m256d y = _mm256_mul_pd(_mm256_sub_pd(py, _mm256_loadu_pd(points.y_ + i)), ny);
+    __m256d z = _mm256_mul_pd(_mm256_sub_pd(pz, _mm256_loadu_pd(points.z_ + i)), nz);
+    _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_add_pd(x, y), z));
+  }
+  PlaneEquationGeneric(points, p, n, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void CompareMaskAvx2(const float* values, float threshold, bool greater, uint64_t* mask, size_t count) {
+  __m256 t = _mm256_set1_ps(threshold);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 v = _mm256_loadu_ps(values + i);
+    int bits = _mm256_movemask_ps(greater ? _mm256_cmp_ps(v, t, _CMP_GT_OQ) : _mm256_cmp_ps(v, t, _CMP_LT_OQ));
+    mask[i / 64] |= uint64_t(bits) << (i % 64);
+  }
+  CompareMaskGeneric(values, threshold, greater, mask, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void CompareMaskAvx2(const double* values, double threshold, bool greater, uint64_t* mask, size_t count) {
+  __m256d t = _mm256_set1_pd(threshold);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d v = _mm256_loadu_pd(values + i);
+    int bits = _mm256_movemask_pd(greater ? _mm256_cmp_pd(v, t, _CMP_GT_OQ) : _mm256_cmp_pd(v, t, _CMP_LT_OQ));
+    mask[i / 64] |= uint64_t(bits) << (i % 64);
+  }
+  CompareMaskGeneric(values, threshold, greater, mask, i, count);
+}
+
+#endif // J_MATH_SIMD_X86
+
+//
+// Runtime dispatch on the selected instruction set
+//
+template<typename valuetype>
+void CircleDistanceSquaredDispatch(Components2D<const valuetype> points, const Point2D<valuetype>& c, valuetype* result, size_t count) { CircleDistanceSquaredGeneric(points, c, result, 0, count); }
+template<typename valuetype>
+void PlaneEquationDispatch(Components3D<const valuetype> points, const Point3D<valuetype>& p, const Vector3D<valuetype>& n, valuetype* result, size_t count) { PlaneEquationGeneric(points, p, n, result, 0, count); }
+template<typename valuetype>
+void CompareMaskDispatch(const valuetype* values, valuetype threshold, bool greater, uint64_t* mask, size_t count) { CompareMaskGeneric(values, threshold, greater, mask, 0, count); }
+
+#if defined(J_MATH_SIMD_X86)
+#define J_MATH_SHAPE_CLASSIFICATION_DISPATCH(valuetype) \
+  inline void CircleDistanceSquaredDispatch(Components2D<const valuetype> points, const Point2D<valuetype>& c, valuetype* result, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: CircleDistanceSquaredAvx2(points, c, result, count); return; \
+    case SimdLevel::SSE: CircleDistanceSquaredSse(points, c, result, count); return; \
+    default: CircleDistanceSquaredGeneric(points, c, result, 0, count); return; \
+    } \
+  } \
+  inline void PlaneEquationDispatch(Components3D<const valuetype> points, const Point3D<valuetype>& p, const Vector3D<valuetype>& n, valuetype* result, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: PlaneEquationAvx2(points, p, n, result, count); return; \
+    case SimdLevel::SSE: PlaneEquationSse(points, p, n, result, count); return; \
+    default: PlaneEquationGeneric(points, p, n, result, 0, count); return; \
+    } \
+  } \
+  inline void CompareMaskDispatch(const valuetype* values, valuetype threshold, bool greater, uint64_t* mask, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: CompareMaskAvx2(values, threshold, greater, mask, count); return; \
+    case SimdLevel::SSE: CompareMaskSse(values, threshold, greater, mask, count); return; \
+    default: CompareMaskGeneric(values, threshold, greater, mask, 0, count); return; \
+    } \
+  }
+J_MATH_SHAPE_CLASSIFICATION_DISPATCH(float)
+J_MATH_SHAPE_CLASSIFICATION_DISPATCH(double)
+#undef J_MATH_SHAPE_CLASSIFICATION_DISPATCH
+#endif // J_MATH_SIMD_X86
+
+// Evaluates a per-point value for blocks of points and turns it into mask bits by comparing it with a threshold.
+// evaluate(offset, n, values) fills values[0, n) for the points [offset, offset + n).
+template<typename valuetype, typename evaluator>
+void ClassifyBlocks(size_t count, valuetype threshold, bool greater, uint64_t* mask, evaluator evaluate) {
+  static_assert(kBatchBlockSize % 64 == 0, "Blocks must cover whole mask words.");
+  valuetype values[kBatchBlockSize];
+  for (size_t i = 0; i < MaskWords(count); ++i) { mask[i] = 0; }
+  for (size_t offset = 0; offset < count; offset += kBatchBlockSize) {
+    size_t n = (count - offset < kBatchBlockSize) ? count - offset : kBatchBlockSize;
+    evaluate(offset, n, values);
+    CompareMaskDispatch(values, threshold, greater, mask + offset / 64, n);
+  }
+}
+
+template<typename valuetype>
+void ClassifySphere(const Sphere<valuetype>& sphere, const Point3D<valuetype>* points, size_t count, bool outside, uint64_t* mask) {
+  PointBlock3D<valuetype> block;
+  ClassifyBlocks(count, sphere.r_ * sphere.r_, outside, mask, [&](size_t offset, size_t n, valuetype* values) {
+    block.Load(points + offset, n);
+    DistanceDispatch(block.Read(), sphere.c_, values, false, n);
+  });
+}
+
+template<typename valuetype, typename points_allocator>
+void ClassifySphere(const Sphere<valuetype>& sphere, const Point3DArray<valuetype, points_allocator>& points, bool outside, uint64_t* mask) {
+  Components3D<const valuetype> components = points.Read();
+  ClassifyBlocks(points.Length(), sphere.r_ * sphere.r_, outside, mask, [&](size_t offset, size_t n, valuetype* values) {
+    Components3D<const valuetype> block{ components.x_ + offset, components.y_ + offset, components.z_ + offset };
+    DistanceDispatch(block, sphere.c_, values, false, n);
+  });
+}
+
+template<typename valuetype>
+void ClassifyCircle(const Circle<valuetype>& circle, const Point2D<valuetype>* points, size_t count, bool outside, uint64_t* mask) {
+  valuetype x[kBatchBlockSize], y[kBatchBlockSize];
+  ClassifyBlocks(count, circle.r_ * circle.r_, outside, mask, [&](size_t offset, size_t n, valuetype* values) {
+    for (size_t i = 0; i < n; ++i) { x[i] = points[offset + i].x_; y[i] = points[offset + i].y_; }
+    CircleDistanceSquaredDispatch(Components2D<const valuetype>{ x, y }, circle.c_, values, n);
+  });
+}
+
+template<typename valuetype>
+void ClassifyPlane(const Plane<valuetype>& plane, const Point3D<valuetype>* points, size_t count, bool above, uint64_t* mask) {
+  PointBlock3D<valuetype> block;
+  Vector3D<valuetype> n = plane.Normal();
+  ClassifyBlocks(count, valuetype(0), above, mask, [&](size_t offset, size_t block_length, valuetype* values) {
+    block.Load(points + offset, block_length);
+    PlaneEquationDispatch(block.Read(), plane.p_, n, values, block_length);
+  });
+}
+
+template<typename valuetype, typename points_allocator>
+void ClassifyPlane(const Plane<valuetype>& plane, const Point3DArray<valuetype, points_allocator>& points, bool above, uint64_t* mask) {
+  Components3D<const valuetype> components = points.Read();
+  Vector3D<valuetype> n = plane.Normal();
+  ClassifyBlocks(points.Length(), valuetype(0), above, mask, [&](size_t offset, size_t block_length, valuetype* values) {
+    Components3D<const valuetype> block{ components.x_ + offset, components.y_ + offset, components.z_ + offset };
+    PlaneEquationDispatch(block, plane.p_, n, values, block_length);
+  });
+}
+
+} // namespace detail
+
+// Sphere: points for which Sphere::IsInside / Sphere::IsOutside holds.
+template<typename valuetype>
+void BatchIsInside(const Sphere<valuetype>& sphere, const Point3D<valuetype>* points, size_t count, uint64_t* mask) { detail::ClassifySphere(sphere, points, count, false, mask); }
+template<typename valuetype>
+void BatchIsOutside(const Sphere<valuetype>& sphere, const Point3D<valuetype>* points, size_t count, uint64_t* mask) { detail::ClassifySphere(sphere, points, count, true, mask); }
+template<typename valuetype, typename points_allocator>
+void BatchIsInside(const Sphere<valuetype>& sphere, const Point3DArray<valuetype, points_allocator>& points, std::vector<uint64_t>& mask) { mask.resize(MaskWords(points.Length())); detail::ClassifySphere(sphere, points, false, mask.data()); }
+template<typename valuetype, typename points_allocator>
+void BatchIsOutside(const Sphere<valuetype>& sphere, const Point3DArray<valuetype, points_allocator>& points, std::vector<uint64_t>& mask) { mask.resize(MaskWords(points.Length())); detail::ClassifySphere(sphere, points, true, mask.data()); }
+
+// Circle: points for which Circle::IsInside / Circle::IsOutside holds.
+template<typename valuetype>
+void BatchIsInside(const Circle<valuetype>& circle, const Point2D<valuetype>* points, size_t count, uint64_t* mask) { detail::ClassifyCircle(circle, points, count, false, mask); }
+template<typename valuetype>
+void BatchIsOutside(const Circle<valuetype>& circle, const Point2D<valuetype>* points, size_t count, uint64_t* mask) { detail::ClassifyCircle(circle, points, count, true, mask); }
+
+// Plane: points for which Plane::IsAbovePlane / Plane::IsBelowPlane holds.
+template<typename valuetype>
+void BatchIsAbovePlane(const Plane<valuetype>& plane, const Point3D<valuetype>* points, size_t count, uint64_t* mask) { detail::ClassifyPlane(plane, points, count, true, mask); }
+template<typename valuetype>
+void BatchIsBelowPlane(const Plane<valuetype>& plane, const Point3D<valuetype>* points, size_t count, uint64_t* mask) { detail::ClassifyPlane(plane, points, count, false, mask); }
+template<typename valuetype, typename points_allocator>
+void BatchIsAbovePlane(const Plane<valuetype>& plane, const Point3DArray<valuetype, points_allocator>& points, std::vector<uint64_t>& mask) { mask.resize(MaskWords(points.Length())); detail::ClassifyPlane(plane, points, true, mask.data()); }
+template<typename valuetype, typename points_allocator>
+void BatchIsBelowPlane(const Plane<valuetype>& plane, const Point3DArray<valuetype, points_allocator>& points, std::vector<uint64_t>& mask) { mask.resize(MaskWords(points.Length())); detail::ClassifyPlane(plane, points, false, mask.data()); }
+
+// Indices of the set bits of a classification mask over count points, in increasing order.
+inline void MaskToIndices(const uint64_t* mask, size_t count, std::vector<size_t>& indices) {
+  indices.clear();
+  for (size_t w = 0; w < MaskWords(count); ++w) {
+    uint64_t word = mask[w];
+    while (word != 0) {
+      size_t i = w * 64 + detail::CountTrailingZeros(word);
+      if (i >= count) { break; }
+      indices.push_back(i);
+      word &= word - 1;
+    }
+  }
+}
+inline std::vector<size_t> MaskToIndices(const std::vector<uint64_t>& mask, size_t count) { std::vector<size_t> indices; MaskToIndices(mask.data(), count, indices); return indices; }
+
+// Whether point i is set in a classification mask.
+inline bool IsMaskSet(const uint64_t* mask, size_t i) { return ((mask[i / 64] >> (i % 64)) & 1) != 0; }
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SHAPE_CLASSIFICATION_H_
@@ -0,0 +1,304 @@
+#pragma once
+#ifndef J_MATH_SIGNED_DISTANCE_FIELD_H_
+#define J_MATH_SIGNED_DISTANCE_FIELD_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "..\utility\parallel.h"
+#include "aabb.h"
+#include "affine_transform.h"
+#include "line.h"
+#include "plane.h"
+#include "ray.h"
+#include "shape_classification.h"
+#include "sphere.h"
+
+namespace j {
+namespace math {
+
+namespace detail {
+
+// Signed distance from p to each supported shape, negative inside. Lines are signed as by
+// Line2D::SignedDistanceToCurve; planes are positive on the side their normal points to.
+template<typename valuetype>
+valuetype SdfDistance(const Sphere<valuetype>& s, const Point3D<valuetype>& p) { return s.SignedDistanceToSurface(p); }
+template<typename valuetype>
+valuetype SdfDistance(const Circle<valuetype>& c, const Point2D<valuetype>& p) { return c.SignedDistanceToSurface(p); }
+template<typename valuetype>
+valuetype SdfDistance(const Line2D<valuetype>& l, const Point2D<valuetype>& p) { return l.SignedDistanceToCurve(p); }
+template<typename valuetype>
+valuetype SdfDistance(const Plane<valuetype>& plane, const Point3D<valuetype>& p) {
+  // Spelled out since Point3D subtraction yields the vector towards the left operand
+  Vector3D<valuetype> n = plane.Normal();
+  return (p.x_ - plane.p_.x_) * n.x_ + (p.y_ - plane.p_.y_) * n.y_ + (p.z_ - plane.p_.z_) * n.z_;
+}
+// Distance to the nearest face: Euclidean outside the box, minus the distance to the nearest face inside.
+template<typename valuetype>
+valuetype SdfDistance(const AABB2D<valuetype>& b, const Point2D<valuetype>& p) {
+  valuetype qx = std::max(b.min_.x_ - p.x_, p.x_ - b.max_.x_), qy = std::max(b.min_.y_ - p.y_, p.y_ - b.max_.y_);
+  valuetype ox = std::max(qx, valuetype(0)), oy = std::max(qy, valuetype(0));
+  return std::sqrt(ox * ox + oy * oy) + std::min(std::max(qx, qy), valuetype(0));
+}
+template<typename valuetype>
+valuetype SdfDistance(const AABB3D<valuetype>& b, const Point3D<valuetype>& p) {
+  valuetype qx = std::max(b.min_.x_ - p.x_, p.x_ - b.max_.x_), qy = std::max(b.min_.y_ - p.y_, p.y_ - b.max_.y_), qz = std::max(b.min_.z_ - p.z_, p.z_ - b.max_.z_);
+  valuetype ox = std::max(qx, valuetype(0)), oy = std::max(qy, valuetype(0)), oz = std::max(qz, valuetype(0));
+  return std::sqrt(ox * ox + oy * oy + oz * oz) + std::min(std::max(std::max(qx, qy), qz), valuetype(0));
+}
+
+// Point type of the space each shape lives in
+template<typename shape> struct SdfShapeTraits;
+template<typename v> struct SdfShapeTraits<Sphere<v>> { using valuetype = v; using point = Point3D<v>; };
+template<typename v> struct SdfShapeTraits<Plane<v>> { using valuetype = v; using point = Point3D<v>; };
+template<typename v> struct SdfShapeTraits<AABB3D<v>> { using valuetype = v; using point = Point3D<v>; };
+template<typename v> struct SdfShapeTraits<Circle<v>> { using valuetype = v; using point = Point2D<v>; };
+template<typename v> struct SdfShapeTraits<Line2D<v>> { using valuetype = v; using point = Point2D<v>; };
+template<typename v> struct SdfShapeTraits<AABB2D<v>> { using valuetype = v; using point = Point2D<v>; };
+
+template<typename valuetype> Point2D<valuetype> SdfScalePoint(const Point2D<valuetype>& p, valuetype s) { return Point2D<valuetype>(p.x_ * s, p.y_ * s); }
+template<typename valuetype> Point3D<valuetype> SdfScalePoint(const Point3D<valuetype>& p, valuetype s) { return Point3D<valuetype>(p.x_ * s, p.y_ * s, p.z_ * s); }
+
+} // namespace detail
+
+// Signed distance fields, composed at compile time. Each node is a small value type whose operator() evaluates the
+// field at a point, so a composite field such as Difference(Sdf(box), Sdf(sphere)) is a single type whose evaluation
+// inlines into one function without any virtual calls or allocation.
+//
+// Fields are negative inside a shape and positive outside. Shapes, union, intersection, difference, translation,
+// rigid transforms and uniform scaling give fields that never overestimate the distance to the surface, which is what
+// SphereTrace relies on; SmoothUnion and non-rigid transforms do not and need a smaller step.
+//
+// SdfExpression is the base of all nodes and only serves to restrict the composing functions and operators to fields.
+template<typename expression>
+struct SdfExpression {
+  const expression& Self() const { return static_cast<const expression&>(*this); }
+};
+
+// Field of a Sphere, Circle, Plane, Line2D, AABB2D or AABB3D
+template<typename shape>
+struct SdfShape : SdfExpression<SdfShape<shape>> {
+  using valuetype = typename detail::SdfShapeTraits<shape>::valuetype;
+  using point = typename detail::SdfShapeTraits<shape>::point;
+  explicit SdfShape(const shape& s) : shape_{ s } { }
+  valuetype operator()(const point& p) const { return detail::SdfDistance(shape_, p); }
+  shape shape_;
+};
+
+template<typename a, typename b>
+struct SdfUnion : SdfExpression<SdfUnion<a, b>> {
+  using valuetype = typename a::valuetype;
+  using point = typename a::point;
+  static_assert(std::is_same<point, typename b::point>::value, "Fields must be over the same space.");
+  SdfUnion(const a& first, const b& second) : a_{ first }, b_{ second } { }
+  valuetype operator()(const point& p) const { return std::min(a_(p), b_(p)); }
+  a a_;
+  b b_;
+};
+
+template<typename a, typename b>
+struct SdfIntersection : SdfExpression<SdfIntersection<a, b>> {
+  using valuetype = typename a::valuetype;
+  using point = typename a::point;
+  static_assert(std::is_same<point, typename b::point>::value, "Fields must be over the same space.");
+  SdfIntersection(const a& first, const b& second) : a_{ first }, b_{ second } { }
+  valuetype operator()(const point& p) const { return std::max(a_(p), b_(p)); }
+  a a_;
+  b b_;
+};
+
+// The part of a outside b
+template<typename a, typename b>
+struct SdfDifference : SdfExpression<SdfDifference<a, b>> {
+  using valuetype = typename a::valuetype;
+  using point = typename a::point;
+  static_assert(std::is_same<point, typename b::point>::value, "Fields must be over the same space.");
+  SdfDifference(const a& first, const b& second) : a_{ first }, b_{ second } { }
+  valuetype operator()(const point& p) const { return std::max(a_(p), -b_(p)); }
+  a a_;
+  b b_;
+};
+
+// Union blended with a polynomial smooth minimum over a band of width k around the seam. Lies at most k / 4 below the
+// plain union; a k of zero or less gives the plain union.
+template<typename a, typename b>
+struct SdfSmoothUnion : SdfExpression<SdfSmoothUnion<a, b>> {
+  using valuetype = typename a::valuetype;
+  using point = typename a::point;
+  static_assert(std::is_same<point, typename b::point>::value, "Fields must be over the same space.");
+  SdfSmoothUnion(const a& first, const b& second, valuetype k) : a_{ first }, b_{ second }, k_{ (k > valuetype(0)) ? k : valuetype(0) } { }
+  valuetype operator()(const point& p) const {
+    valuetype da = a_(p), db = b_(p);
+    if (k_ == valuetype(0)) { return std::min(da, db); }
+    valuetype h = std::min(std::max(valuetype(0.5) + valuetype(0.5) * (db - da) / k_, valuetype(0)), valuetype(1));
+    return db + (da - db) * h - k_ * h * (valuetype(1) - h);
+  }
+  a a_;
+  b b_;
+  valuetype k_;
+};
+
+// Field a moved by offset
+template<typename a>
+struct SdfTranslation : SdfExpression<SdfTranslation<a>> {
+  using valuetype = typename a::valuetype;
+  using point = typename a::point;
+  using vector = typename std::decay<decltype(std::declval<point>() - std::declval<point>())>::type;
+  SdfTranslation(const a& field, const vector& offset) : a_{ field }, offset_{ offset } { }
+  valuetype operator()(const point& p) const { return a_(p - offset_); }
+  a a_;
+  vector offset_;
+};
+
+// Field a placed by an affine transform (3D). Distances are exact for rigid transforms only.
+template<typename a>
+struct SdfTransform : SdfExpression<SdfTransform<a>> {
+  using valuetype = typename a::valuetype;
+  using point = typename a::point;
+  static_assert(std::is_same<point, Point3D<valuetype>>::value, "Affine transforms apply to three-dimensional fields.");
+  // A transform that is not invertible is replaced by the identity.
+  SdfTransform(const a& field, const AffineTransform3D<valuetype>& transform) : a_{ field }, inverse_{ transform.IsInvertible() ? transform.Inverse() : AffineTransform3D<valuetype>() } { }
+  valuetype operator()(const point& p) const { return a_(inverse_.TransformPoint(p)); }
+  a a_;
+  AffineTransform3D<valuetype> inverse_;  // Maps points into the space of a
+};
+
+// Field a scaled uniformly about the origin
+template<typename a>
+struct SdfScale : SdfExpression<SdfScale<a>> {
+  using valuetype = typename a::valuetype;
+  using point = typename a::point;
+  // A scale of zero or less is replaced by 1.
+  SdfScale(const a& field, valuetype scale) : a_{ field }, scale_{ (scale > valuetype(0)) ? scale : valuetype(1) } { }
+  valuetype operator()(const point& p) const { return a_(detail::SdfScalePoint(p, valuetype(1) / scale_)) * scale_; }
+  a a_;
+  valuetype scale_;
+};
+
+// Construction of fields
+template<typename shape>
+SdfShape<shape> Sdf(const shape& s) { return SdfShape<shape>(s); }
+template<typename a, typename b>
+SdfUnion<a, b> Union(const SdfExpression<a>& first, const SdfExpression<b>& second) { return SdfUnion<a, b>(first.Self(), second.Self()); }
+template<typename a, typename b>
+SdfIntersection<a, b> Intersection(const SdfExpression<a>& first, const SdfExpression<b>& second) { return SdfIntersection<a, b>(first.Self(), second.Self()); }
+template<typename a, typename b>
+SdfDifference<a, b> Difference(const SdfExpression<a>& first, const SdfExpression<b>& second) { return SdfDifference<a, b>(first.Self(), second.Self()); }
+template<typename a, typename b>
+SdfSmoothUnion<a, b> SmoothUnion(const SdfExpression<a>& first, const SdfExpression<b>& second, typename a::valuetype k) { return SdfSmoothUnion<a, b>(first.Self(), second.Self(), k); }
+template<typename a>
+SdfTranslation<a> Translate(const SdfExpression<a>& field, const typename SdfTranslation<a>::vector& offset) { return SdfTranslation<a>(field.Self(), offset); }
+template<typename a>
+SdfTransform<a> Transform(const SdfExpression<a>& field, const AffineTransform3D<typename a::valuetype>& transform) { return SdfTransform<a>(field.Self(), transform); }
+template<typename a>
+SdfScale<a> Scale(const SdfExpression<a>& field, typename a::valuetype scale) { return SdfScale<a>(field.Self(), scale); }
+
+// Operators: a | b is the union, a & b the intersection and a - b the difference
+template<typename a, typename b>
+SdfUnion<a, b> operator|(const SdfExpression<a>& first, const SdfExpression<b>& second) { return Union(first, second); }
+template<typename a, typename b>
+SdfIntersection<a, b> operator&(const SdfExpression<a>& first, const SdfExpression<b>& second) { return Intersection(first, second); }
+template<typename a, typename b>
+SdfDifference<a, b> operator-(const SdfExpression<a>& first, const SdfExpression<b>& second) { return Difference(first, second); }
+
+// Evaluation
+// Values of the field at each point. A thread_count other than 1 splits the points over threads (0 uses all
+// hardware threads).
+template<typename expression>
+void Evaluate(const SdfExpression<expression>& field, const std::vector<typename expression::point>& points, std::vector<typename expression::valuetype>& values, size_t thread_count = 1) {
+  const expression& f = field.Self();
+  values.resize(points.size());
+  ParallelFor(points.size(), thread_count, 1024, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) { values[i] = f(points[i]); }
+  });
+}
+
+// Values of the field at the width x height grid points origin + (x * spacing.x_, y * spacing.y_), in row-major order
+// (index y * width + x). Rows are split over threads as by Evaluate.
+template<typename expression>
+void EvaluateGrid(const SdfExpression<expression>& field, const Point2D<typename expression::valuetype>& origin, const Vector2D<typename expression::valuetype>& spacing, size_t width, size_t height, std::vector<typename expression::valuetype>& values, size_t thread_count = 1) {
+  using valuetype = typename expression::valuetype;
+  const expression& f = field.Self();
+  values.resize(width * height);
+  ParallelFor(height, thread_count, 4, [&](size_t begin, size_t end) {
+    for (size_t y = begin; y < end; ++y) {
+      valuetype* row = values.data() + y * width;
+      valuetype py = origin.y_ + valuetype(y) * spacing.y_;
+      for (size_t x = 0; x < width; ++x) { row[x] = f(Point2D<valuetype>(origin.x_ + valuetype(x) * spacing.x_, py)); }
+    }
+  });
+}
+
+// Values of the field at the width x height x depth grid points origin + (x * spacing.x_, y * spacing.y_,
+// z * spacing.z_), in row-major order (index (z * height + y) * width + x). Rows are split over threads as by Evaluate.
+template<typename expression>
+void EvaluateGrid(const SdfExpression<expression>& field, const Point3D<typename expression::valuetype>& origin, const Vector3D<typename expression::valuetype>& spacing, size_t width, size_t height, size_t depth, std::vector<typename expression::valuetype>& values, size_t thread_count = 1) {
+  using valuetype = typename expression::valuetype;
+  const expression& f = field.Self();
+  values.resize(width * height * depth);
+  ParallelFor(height * depth, thread_count, 4, [&](size_t begin, size_t end) {
+    for (size_t r = begin; r < end; ++r) {
+      valuetype* row = values.data() + r * width;
+      valuetype py = origin.y_ + valuetype(r % height) * spacing.y_, pz = origin.z_ + valuetype(r / height) * spacing.z_;
+      for (size_t x = 0; x < width; ++x) { row[x] = f(Point3D<valuetype>(origin.x_ + valuetype(x) * spacing.x_, py, pz)); }
+    }
+  });
+}
+
+// Unit normal of the surface through p, estimated from the central differences of the field over a step h.
+template<typename expression>
+Vector3D<typename expression::valuetype> EstimateNormal(const SdfExpression<expression>& field, const Point3D<typename expression::valuetype>& p, typename expression::valuetype h = typename expression::valuetype(1e-4)) {
+  using valuetype = typename expression::valuetype;
+  const expression& f = field.Self();
+  return Vector3D<valuetype>(f(Point3D<valuetype>(p.x_ + h, p.y_, p.z_)) - f(Point3D<valuetype>(p.x_ - h, p.y_, p.z_)),
+                             f(Point3D<valuetype>(p.x_, p.y_ + h, p.z_)) - f(Point3D<valuetype>(p.x_, p.y_ - h, p.z_)),
+                             f(Point3D<valuetype>(p.x_, p.y_, p.z_ + h)) - f(Point3D<valuetype>(p.x_, p.y_, p.z_ - h))).Normalize();
+}
+
+// Sphere tracing: marches along the ray by the value of the field, which is a safe step as long as the field never
+// overestimates the distance to the surface. Reports the first t in [0, t_max] where the field drops below epsilon, or
+// returns false when the ray leaves [0, t_max] or max_steps steps run out first. Rays that start inside hit at t = 0.
+template<typename expression>
+bool SphereTrace(const SdfExpression<expression>& field, const Ray3D<typename expression::valuetype>& ray, typename expression::valuetype* t,
+                 typename expression::valuetype t_max = std::numeric_limits<typename expression::valuetype>::max(),
+                 typename expression::valuetype epsilon = typename expression::valuetype(1e-4), int max_steps = 256) {
+  using valuetype = typename expression::valuetype;
+  const expression& f = field.Self();
+  Point3D<valuetype> o = ray.p_;
+  Vector3D<valuetype> d = ray.GetDirection();
+  valuetype s = valuetype(0);
+  for (int step = 0; step < max_steps && s <= t_max; ++step) {
+    valuetype distance = f(Point3D<valuetype>(o.x_ + d.x_ * s, o.y_ + d.y_ * s, o.z_ + d.z_ * s));
+    if (distance < epsilon) { *t = s; return true; }
+    s += distance;
+  }
+  return false;
+}
+
+// Sphere tracing of many rays. Sets bit i of hits (see shape_classification.h) when ray i hits, and then writes its t
+// to t[i]; t of the other rays is undefined. Rays are split over threads in blocks of 64 as by Evaluate.
+template<typename expression>
+void SphereTrace(const SdfExpression<expression>& field, const std::vector<Ray3D<typename expression::valuetype>>& rays, std::vector<typename expression::valuetype>& t, std::vector<uint64_t>& hits,
+                 typename expression::valuetype t_max = std::numeric_limits<typename expression::valuetype>::max(),
+                 typename expression::valuetype epsilon = typename expression::valuetype(1e-4), int max_steps = 256, size_t thread_count = 1) {
+  t.resize(rays.size());
+  hits.assign(MaskWords(rays.size()), 0);
+  ParallelFor(hits.size(), thread_count, 1, [&](size_t begin, size_t end) {
+    for (size_t word = begin; word < end; ++word) {
+      uint64_t bits = 0;
+      for (size_t i = word * 64; i < rays.size() && i < (word + 1) * 64; ++i) {
+        if (SphereTrace(field, rays[i], &t[i], t_max, epsilon, max_steps)) { bits |= uint64_t(1) << (i % 64); }
+      }
+      hits[word] = bits;
+    }
+  });
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SIGNED_DISTANCE_FIELD_H_
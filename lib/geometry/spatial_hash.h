@@ -0,0 +1,394 @@
+#pragma once
+#ifndef J_MATH_SPATIAL_HASH_H_
+#define J_MATH_SPATIAL_HASH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "..\utility\parallel.h"
+#include "point.h"
+
+namespace j {
+namespace math {
+
+namespace detail {
+
+// End of a bucket list, or a removed point
+const uint32_t kSpatialHashNone = std::numeric_limits<uint32_t>::max();
+
+} // namespace detail
+
+// Uniform grid over unbounded space for radius and nearest neighbor queries over points. Space is divided into cubic
+// cells of a fixed size, and cells are hashed into a table with about one bucket per point, so that only occupied cells
+// take memory. Each bucket is a linked list of entries; a bulk build sorts the entries by bucket, which places the
+// points of a bucket next to each other. A cell size close to the typical query radius works best.
+//
+// Points are referred to by the index they were given: their position in the vector passed to Build, or the value
+// returned by Insert. Indices of removed points are not reused. Queries compare squared distances only.
+template<typename point>
+class SpatialHash {
+public:
+  using traits = PointTraits<point>;
+  using valuetype = typename traits::scalar;
+  static const int kDimensions = traits::kDimensions;
+
+  // Constructors
+  // A cell_size that is not positive is replaced by 1.
+  explicit SpatialHash(valuetype cell_size = valuetype(1)) {
+    cell_size_ = (cell_size > valuetype(0)) ? cell_size : valuetype(1);
+    inverse_cell_size_ = 1. / double(cell_size_);
+    Rehash(kMinBuckets, 1);
+  }
+  SpatialHash(valuetype cell_size, const std::vector<point>& points, size_t thread_count = 1) : SpatialHash(cell_size) { Build(points, thread_count); }
+  SpatialHash(const SpatialHash&) = default;
+  ~SpatialHash() = default;
+
+  // Operators
+  SpatialHash& operator=(const SpatialHash&) = default;
+
+  // Construction and updates
+  // Replaces the contents by points, with indices 0 to points.size() - 1. A thread_count other than 1 splits large
+  // builds over threads (0 uses all hardware threads); the result does not depend on the thread count.
+  void Build(const std::vector<point>& points, size_t thread_count = 1) {
+    entries_.resize(points.size());
+    slots_.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) { entries_[i] = Entry{ points[i], i, detail::kSpatialHashNone }; }
+    Rehash(BucketCount(points.size()), thread_count);
+  }
+  // Adds a point and returns its index.
+  size_t Insert(const point& p) {
+    size_t index = slots_.size();
+    uint32_t e = uint32_t(entries_.size());
+    entries_.push_back(Entry{ p, index, detail::kSpatialHashNone });
+    slots_.push_back(e);
+    if (entries_.size() > heads_.size()) {
+      Rehash(2 * heads_.size(), 1);
+    } else {
+      uint32_t b = Bucket(p);
+      entries_[e].next_ = heads_[b];
+      heads_[b] = e;
+    }
+    return index;
+  }
+  // Removes the point with the given index. Returns false when there is no such point.
+  bool Remove(size_t index) {
+    if (!Contains(index)) { return false; }
+    uint32_t e = slots_[index];
+    *FindLink(e) = entries_[e].next_;
+    uint32_t last = uint32_t(entries_.size() - 1);
+    if (e != last) {
+      // Move the last entry into the gap
+      uint32_t* link = FindLink(last);
+      entries_[e] = entries_[last];
+      *link = e;
+      slots_[entries_[e].index_] = e;
+    }
+    entries_.pop_back();
+    slots_[index] = detail::kSpatialHashNone;
+    return true;
+  }
+  // Moves the point with the given index to p. Returns false when there is no such point.
+  bool Move(size_t index, const point& p) {
+    if (!Contains(index)) { return false; }
+    uint32_t e = slots_[index];
+    uint32_t b = Bucket(p);
+    if (b != Bucket(entries_[e].position_)) {
+      *FindLink(e) = entries_[e].next_;
+      entries_[e].next_ = heads_[b];
+      heads_[b] = e;
+    }
+    entries_[e].position_ = p;
+    return true;
+  }
+  void Clear() {
+    entries_.clear();
+    slots_.clear();
+    Rehash(kMinBuckets, 1);
+  }
+
+  // Accessors
+  bool Contains(size_t index) const { return index < slots_.size() && slots_[index] != detail::kSpatialHashNone; }
+  // Position of the point with the given index, which must be contained.
+  const point& Get(size_t index) const { return entries_[slots_[index]].position_; }
+  size_t Size() const { return entries_.size(); }
+  valuetype CellSize() const { return cell_size_; }
+
+  // Indices of all points within radius of p (distance <= radius), in no particular order.
+  void FindInRadius(const point& p, valuetype radius, std::vector<size_t>& indices) const {
+    indices.clear();
+    if (radius < valuetype(0)) { return; }
+    valuetype radius_squared = radius * radius;
+    ForEachInBox(p, radius, [&](const Entry& entry) {
+      if (DistanceSquared(entry.position_, p) <= radius_squared) { indices.push_back(entry.index_); }
+    });
+  }
+
+  // Indices of the k points nearest to p, nearest first (ties in order of index). Fewer when the hash holds fewer than
+  // k points. Cells are visited in rings of growing distance around the cell of p, until the k nearest points found
+  // are closer than any cell not yet visited.
+  void FindNearest(const point& p, size_t k, std::vector<size_t>& indices) const {
+    indices.clear();
+    if (k > Size()) { k = Size(); }
+    if (k == 0) { return; }
+    // Max-heap of the k nearest points found so far
+    std::vector<std::pair<valuetype, size_t>> nearest;
+    nearest.reserve(k);
+    auto consider = [&](const Entry& entry) {
+      std::pair<valuetype, size_t> candidate(DistanceSquared(entry.position_, p), entry.index_);
+      if (nearest.size() < k) {
+        nearest.push_back(candidate);
+        std::push_heap(nearest.begin(), nearest.end());
+      } else if (candidate < nearest.front()) {
+        std::pop_heap(nearest.begin(), nearest.end());
+        nearest.back() = candidate;
+        std::push_heap(nearest.begin(), nearest.end());
+      }
+    };
+    int64_t center[kDimensions];
+    for (int i = 0; i < kDimensions; ++i) { center[i] = Cell(p[i]); }
+    for (int64_t r = 0;; ++r) {
+      if (std::pow(double(2 * r + 1), double(kDimensions)) * kCellCost >= double(entries_.size())) {
+        // Visiting the cells costs more than a scan over all points
+        nearest.clear();
+        for (const Entry& entry : entries_) { consider(entry); }
+        break;
+      }
+      ForEachCellInRing(center, r, [&](const int64_t* cell) {
+        // Other cells may share the bucket
+        for (uint32_t e = heads_[HashCell(cell)]; e != detail::kSpatialHashNone; e = entries_[e].next_) {
+          if (InCell(entries_[e].position_, cell)) { consider(entries_[e]); }
+        }
+      });
+      if (nearest.size() == k) {
+        // Distance from p to the nearest face of the rings visited so far, which no point outside them is closer than.
+        // Slightly reduced to allow for rounding of the cell coordinates and distances.
+        double bound = std::numeric_limits<double>::max();
+        for (int i = 0; i < kDimensions; ++i) {
+          double x = double(p[i]) * inverse_cell_size_;
+          bound = std::min(bound, std::min(x - double(center[i] - r), double(center[i] + r + 1) - x));
+        }
+        bound *= double(cell_size_) * (1. - 1e-5);
+        if (double(nearest.front().first) < bound * bound) { break; }
+      }
+    }
+    std::sort_heap(nearest.begin(), nearest.end());
+    for (const std::pair<valuetype, size_t>& n : nearest) { indices.push_back(n.second); }
+  }
+
+private:
+  static const size_t kMinBuckets = 256;
+  static const int kPartitionBits = 8;           // Buckets are sorted in 2^kPartitionBits independent ranges
+  static const size_t kParallelBuildSize = 1 << 15;
+  static const int kCellCost = 8;                // Cost of visiting a cell, in distance computations
+
+  struct Entry {
+    point position_;
+    size_t index_;
+    uint32_t next_;  // Next entry in the same bucket
+  };
+
+  struct KeyedEntry {
+    uint64_t key_;   // Bucket in the high, position before sorting in the low 32 bits
+    Entry entry_;
+  };
+
+  static valuetype DistanceSquared(const point& a, const point& b) {
+    valuetype d = valuetype(0);
+    for (int i = 0; i < kDimensions; ++i) { valuetype e = a[i] - b[i]; d += e * e; }
+    return d;
+  }
+
+  static size_t BucketCount(size_t count) {
+    size_t buckets = kMinBuckets;
+    while (buckets < count) { buckets *= 2; }
+    return buckets;
+  }
+
+  // floor(x / cell_size), without the library call std::floor compiles to on older instruction sets.
+  int64_t Cell(valuetype x) const {
+    double c = double(x) * inverse_cell_size_;
+    int64_t i = int64_t(c);
+    return (double(i) > c) ? i - 1 : i;
+  }
+
+  // Multiplicative (Fibonacci) hash of the cell coordinates, taking the top bits.
+  uint32_t HashCell(const int64_t* cell) const {
+    uint64_t h = 0;
+    for (int i = 0; i < kDimensions; ++i) { h = (h + uint64_t(cell[i])) * 0x9E3779B97F4A7C15ull; }
+    return uint32_t(h >> (64 - bucket_bits_));
+  }
+
+  uint32_t Bucket(const point& p) const {
+    int64_t cell[kDimensions];
+    for (int i = 0; i < kDimensions; ++i) { cell[i] = Cell(p[i]); }
+    return HashCell(cell);
+  }
+
+  bool InCell(const point& p, const int64_t* cell) const {
+    for (int i = 0; i < kDimensions; ++i) { if (Cell(p[i]) != cell[i]) { return false; } }
+    return true;
+  }
+
+  // The link (bucket head or next_ of another entry) that points to entry e.
+  uint32_t* FindLink(uint32_t e) {
+    uint32_t* link = &heads_[Bucket(entries_[e].position_)];
+    while (*link != e) { link = &entries_[*link].next_; }
+    return link;
+  }
+
+  // Calls f for every entry in the buckets of the cells overlapping the box of half size radius around p, visiting each
+  // bucket once, or for all entries when that is cheaper.
+  template<typename function>
+  void ForEachInBox(const point& p, valuetype radius, function f) const {
+    int64_t low[kDimensions], high[kDimensions];
+    double cells = 1.;
+    for (int i = 0; i < kDimensions; ++i) {
+      low[i] = Cell(p[i] - radius);
+      high[i] = Cell(p[i] + radius);
+      cells *= double(high[i] - low[i] + 1);
+    }
+    if (cells * kCellCost >= double(entries_.size())) {
+      for (const Entry& entry : entries_) { f(entry); }
+      return;
+    }
+    std::vector<uint32_t> buckets;
+    buckets.reserve(size_t(cells));
+    int64_t cell[kDimensions];
+    std::copy(low, low + kDimensions, cell);
+    for (;;) {
+      buckets.push_back(HashCell(cell));
+      int i = 0;
+      for (; i < kDimensions && cell[i] == high[i]; ++i) { cell[i] = low[i]; }
+      if (i == kDimensions) { break; }
+      ++cell[i];
+    }
+    // Distinct cells may share a bucket
+    std::sort(buckets.begin(), buckets.end());
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    for (uint32_t b : buckets) {
+      for (uint32_t e = heads_[b]; e != detail::kSpatialHashNone; e = entries_[e].next_) { f(entries_[e]); }
+    }
+  }
+
+  // Calls f for every cell at Chebyshev distance r from center: the faces of the block of (2r + 1)^kDimensions cells.
+  template<typename function>
+  static void ForEachCellInRing(const int64_t* center, int64_t r, function f) {
+    int64_t offset[kDimensions], cell[kDimensions];
+    for (int i = 0; i < kDimensions; ++i) { offset[i] = -r; }
+    for (;;) {
+      bool face = false;
+      for (int i = 1; i < kDimensions; ++i) { face = face || offset[i] == -r || offset[i] == r; }
+      // Along the first axis, the whole row on a face and only its two ends inside the block
+      for (int64_t x = -r; x <= r; x += (face || x == r) ? 1 : 2 * r) {
+        cell[0] = center[0] + x;
+        for (int i = 1; i < kDimensions; ++i) { cell[i] = center[i] + offset[i]; }
+        f(static_cast<const int64_t*>(cell));
+        if (r == 0) { break; }
+      }
+      int i = 1;
+      for (; i < kDimensions && offset[i] == r; ++i) { offset[i] = -r; }
+      if (i == kDimensions) { break; }
+      ++offset[i];
+    }
+  }
+
+  // Reorders items so that those in the same of the 2^kPartitionBits partitions given by partition_of are contiguous,
+  // keeping their relative order, and returns where each partition starts. Each thread distributes a contiguous chunk
+  // into one sequential stream per partition, rather than writing to random addresses.
+  template<typename item, typename function>
+  static std::vector<size_t> Distribute(std::vector<item>& items, size_t threads, function partition_of) {
+    const size_t partitions = size_t(1) << kPartitionBits;
+    size_t n = items.size(), chunk = (n + threads - 1) / threads;
+    std::vector<size_t> offsets(threads * partitions, 0), starts(partitions + 1, 0);
+    ParallelFor(threads, threads, 1, [&](size_t begin, size_t end) {
+      for (size_t t = begin; t < end; ++t) {
+        for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i) { ++offsets[t * partitions + partition_of(items[i])]; }
+      }
+    });
+    size_t offset = 0;
+    for (size_t r = 0; r < partitions; ++r) {
+      starts[r] = offset;
+      for (size_t t = 0; t < threads; ++t) { size_t count = offsets[t * partitions + r]; offsets[t * partitions + r] = offset; offset += count; }
+    }
+    starts[partitions] = n;
+    std::vector<item> distributed(n);
+    ParallelFor(threads, threads, 1, [&](size_t begin, size_t end) {
+      for (size_t t = begin; t < end; ++t) {
+        for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); ++i) { distributed[offsets[t * partitions + partition_of(items[i])]++] = items[i]; }
+      }
+    });
+    items.swap(distributed);
+    return starts;
+  }
+
+  // Rebuilds the table with the given (power of two) number of buckets, ordering the entries by bucket. Entries are
+  // sorted on 64-bit keys holding the bucket and the current position, which are unique, so the order does not
+  // depend on the thread count. Large tables are built in steps that each access memory in cache-friendly order: the
+  // entries are distributed over ranges of buckets, each of which is then sorted on its own, and the entry of each
+  // index is recorded per range of indices.
+  void Rehash(size_t bucket_count, size_t thread_count) {
+    bucket_bits_ = 0;
+    while ((size_t(1) << bucket_bits_) < bucket_count) { ++bucket_bits_; }
+    heads_.assign(bucket_count, detail::kSpatialHashNone);
+    size_t n = entries_.size();
+    if (n == 0) { return; }
+    size_t threads = (thread_count == 0) ? GetHardwareThreadCount() : thread_count;
+    bool partitioned = n >= kParallelBuildSize;
+    if (!partitioned) { threads = 1; }
+    std::vector<KeyedEntry> keyed(n);
+    ParallelFor(n, threads, 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) { keyed[i] = KeyedEntry{ (uint64_t(Bucket(entries_[i].position_)) << 32) | uint64_t(i), entries_[i] }; }
+    });
+    auto by_key = [](const KeyedEntry& a, const KeyedEntry& b) { return a.key_ < b.key_; };
+    if (!partitioned) {
+      std::sort(keyed.begin(), keyed.end(), by_key);
+    } else {
+      const int shift = 32 + bucket_bits_ - kPartitionBits;
+      std::vector<size_t> starts = Distribute(keyed, threads, [shift](const KeyedEntry& e) { return size_t(e.key_ >> shift); });
+      ParallelFor(starts.size() - 1, threads, 1, [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) { std::sort(keyed.begin() + ptrdiff_t(starts[r]), keyed.begin() + ptrdiff_t(starts[r + 1]), by_key); }
+      });
+    }
+    ParallelFor(n, threads, 1, [&](size_t begin, size_t end) {
+      for (size_t j = begin; j < end; ++j) {
+        uint32_t b = uint32_t(keyed[j].key_ >> 32);
+        entries_[j] = keyed[j].entry_;
+        entries_[j].next_ = (j + 1 < n && uint32_t(keyed[j + 1].key_ >> 32) == b) ? uint32_t(j + 1) : detail::kSpatialHashNone;
+        if (j == 0 || uint32_t(keyed[j - 1].key_ >> 32) != b) { heads_[b] = uint32_t(j); }
+        if (!partitioned) { slots_[entries_[j].index_] = uint32_t(j); }
+      }
+    });
+    if (partitioned) {
+      // (index, entry) pairs, distributed over ranges of indices before writing the slots
+      int index_bits = 0;
+      while ((size_t(1) << index_bits) < slots_.size()) { ++index_bits; }
+      const int shift = 32 + std::max(index_bits - kPartitionBits, 0);
+      std::vector<uint64_t> pairs(n);
+      ParallelFor(n, threads, 1, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) { pairs[j] = (uint64_t(entries_[j].index_) << 32) | uint64_t(j); }
+      });
+      std::vector<size_t> starts = Distribute(pairs, threads, [shift](uint64_t pair) { return size_t(pair >> shift); });
+      ParallelFor(starts.size() - 1, threads, 1, [&](size_t begin, size_t end) {
+        for (size_t i = starts[begin]; i < starts[end]; ++i) { slots_[size_t(pairs[i] >> 32)] = uint32_t(pairs[i]); }
+      });
+    }
+  }
+
+  valuetype cell_size_;
+  double inverse_cell_size_;
+  int bucket_bits_ = 0;
+  std::vector<uint32_t> heads_;   // First entry of each bucket
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> slots_;   // Entry of each point index, kSpatialHashNone once removed
+};
+
+template<typename valuetype> using SpatialHash2D = SpatialHash<Point2D<valuetype>>;
+template<typename valuetype> using SpatialHash3D = SpatialHash<Point3D<valuetype>>;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SPATIAL_HASH_H_
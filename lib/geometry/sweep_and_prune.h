@@ -0,0 +1,174 @@
+#pragma once
+#ifndef J_MATH_SWEEP_AND_PRUNE_H_
+#define J_MATH_SWEEP_AND_PRUNE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "..\utility\parallel.h"
+#include "aabb.h"
+#include "plane.h"
+#include "shape_types.h"
+#include "sphere.h"
+
+namespace j {
+namespace math {
+
+// Broad phase collision detection by sweep and prune (sort and sweep) over axis-aligned boxes, for scenes that change
+// little from one frame to the next.
+//
+// Boxes are kept sorted by their lower bound along one axis. FindPairs first restores that order with an insertion
+// sort, which takes about linear time when the boxes moved little since the previous call, and then sweeps the sorted
+// boxes: each box is only tested against the boxes that start before it ends along the axis. The sweep axis should be
+// the one along which the boxes are spread out most.
+//
+// Boxes are referred to by the id returned by Add. Ids of removed boxes are not reused.
+template<typename box>
+class SweepAndPrune {
+public:
+  using valuetype = typename std::decay<decltype(std::declval<box>().min_.x_)>::type;
+
+  // Constructors
+  // An axis outside [0, 3) is replaced by 0. For AABB2D boxes, use 0 or 1.
+  explicit SweepAndPrune(int axis = 0) : axis_{ (axis >= 0 && axis < 3) ? axis : 0 } { }
+  SweepAndPrune(const SweepAndPrune&) = default;
+  ~SweepAndPrune() = default;
+
+  // Operators
+  SweepAndPrune& operator=(const SweepAndPrune&) = default;
+
+  // Construction and updates
+  // Adds a box and returns its id. New boxes are placed at the end of the order and sorted in by the next FindPairs.
+  size_t Add(const box& b) {
+    boxes_.push_back(b);
+    alive_.push_back(true);
+    order_.push_back(boxes_.size() - 1);
+    keys_.push_back(b.min_[axis_]);
+    ++size_;
+    return boxes_.size() - 1;
+  }
+  // Replaces the box of id; returns false if there is no such box. Takes effect at the next FindPairs.
+  bool Update(size_t id, const box& b) {
+    if (!Contains(id)) { return false; }
+    boxes_[id] = b;
+    return true;
+  }
+  // Removes the box of id; returns false if there is no such box. The id stays in the order until the next FindPairs
+  // drops all removed ids in one pass, so removing many boxes takes linear rather than quadratic time.
+  bool Remove(size_t id) {
+    if (!Contains(id)) { return false; }
+    alive_[id] = false;
+    --size_;
+    return true;
+  }
+  void Clear() { boxes_.clear(); alive_.clear(); order_.clear(); keys_.clear(); size_ = 0; }
+
+  // Accessors
+  bool Contains(size_t id) const { return id < alive_.size() && alive_[id]; }
+  const box& Get(size_t id) const { return boxes_[id]; }
+  size_t Size() const { return size_; }
+  int Axis() const { return axis_; }
+
+  // Queries
+  // Pairs of ids (a, b) with a < b of all overlapping boxes (see AABB3D::Overlaps), in no particular order.
+  void FindPairs(std::vector<std::pair<size_t, size_t>>& pairs) {
+    pairs.clear();
+    Sort();
+    sorted_.resize(order_.size());
+    for (size_t k = 0; k < order_.size(); ++k) { sorted_[k] = boxes_[order_[k]]; }
+    for (size_t k = 0; k < sorted_.size(); ++k) {
+      const box& a = sorted_[k];
+      for (size_t l = k + 1; l < sorted_.size() && keys_[l] <= a.max_[axis_]; ++l) {
+        if (a.Overlaps(sorted_[l])) { pairs.push_back(std::minmax(order_[k], order_[l])); }
+      }
+    }
+  }
+
+private:
+  // Insertion sort of the boxes on their (updated) lower bounds, after dropping removed ids. Stable, so the order of
+  // equal bounds is kept.
+  void Sort() {
+    if (order_.size() != size_) {
+      order_.erase(std::remove_if(order_.begin(), order_.end(), [this](size_t id) { return !alive_[id]; }), order_.end());
+      keys_.resize(order_.size());
+    }
+    for (size_t k = 0; k < order_.size(); ++k) { keys_[k] = boxes_[order_[k]].min_[axis_]; }
+    for (size_t k = 1; k < order_.size(); ++k) {
+      size_t id = order_[k];
+      valuetype key = keys_[k];
+      size_t l = k;
+      for (; l > 0 && key < keys_[l - 1]; --l) { order_[l] = order_[l - 1]; keys_[l] = keys_[l - 1]; }
+      order_[l] = id;
+      keys_[l] = key;
+    }
+  }
+
+  int axis_;
+  size_t size_ = 0;
+  std::vector<box> boxes_;         // Box of each id
+  std::vector<bool> alive_;        // Whether each id is in use
+  std::vector<size_t> order_;      // Ids of the boxes, sorted on their lower bound along the axis; may hold removed ids
+  std::vector<valuetype> keys_;    // Lower bound of each box in order_
+  std::vector<box> sorted_;        // Boxes in sorted order, for the sweep
+};
+
+template<typename valuetype> using SweepAndPrune2D = SweepAndPrune<AABB2D<valuetype>>;
+template<typename valuetype> using SweepAndPrune3D = SweepAndPrune<AABB3D<valuetype>>;
+
+// Exact overlap tests for the narrow phase. Shapes are closed, so touching shapes overlap. A Plane is treated as the
+// half-space below it (opposite its normal), like a ground plane; it has no bounding box and is not handled by the
+// broad phase.
+template<typename valuetype>
+bool Overlap(const Sphere<valuetype>& a, const Sphere<valuetype>& b) { return a.SignedDistanceToSurface(b.c_) <= b.r_; }
+template<typename valuetype>
+bool Overlap(const Circle<valuetype>& a, const Circle<valuetype>& b) { return a.SignedDistanceToSurface(b.c_) <= b.r_; }
+template<typename valuetype>
+bool Overlap(const Rectangle2D<valuetype>& a, const Rectangle2D<valuetype>& b) { return AABB2D<valuetype>(a).Overlaps(AABB2D<valuetype>(b)); }
+template<typename valuetype>
+bool Overlap(const Circle<valuetype>& a, const Rectangle2D<valuetype>& b) { return b.Contains(a.c_) || a.SignedDistanceToSurface(AABB2D<valuetype>(b).FindNearestPoint(a.c_)) <= valuetype(0); }
+template<typename valuetype>
+bool Overlap(const Rectangle2D<valuetype>& a, const Circle<valuetype>& b) { return Overlap(b, a); }
+template<typename valuetype>
+bool Overlap(const Sphere<valuetype>& a, const Plane<valuetype>& b) {
+  // Height of the center above the plane; spelled out since Point3D subtraction yields the vector towards the left operand
+  Vector3D<valuetype> offset(a.c_.x_ - b.p_.x_, a.c_.y_ - b.p_.y_, a.c_.z_ - b.p_.z_);
+  return offset.ScalarProduct(b.Normal()) <= a.r_;
+}
+template<typename valuetype>
+bool Overlap(const Plane<valuetype>& a, const Sphere<valuetype>& b) { return Overlap(b, a); }
+
+// Narrow phase: the candidate pairs (i, j) for which Overlap(a[i], b[j]) holds, in the order of the candidates. Pass
+// the same vector as a and b for pairs within one set of shapes. A thread_count other than 1 splits the candidates
+// over threads (0 uses all hardware threads); the result does not depend on the thread count.
+template<typename shape_a, typename shape_b>
+void NarrowPhase(const std::vector<shape_a>& a, const std::vector<shape_b>& b, const std::vector<std::pair<size_t, size_t>>& candidates, std::vector<std::pair<size_t, size_t>>& collisions, size_t thread_count = 1) {
+  std::vector<uint8_t> overlap(candidates.size());
+  ParallelFor(candidates.size(), thread_count, 256, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) { overlap[i] = Overlap(a[candidates[i].first], b[candidates[i].second]) ? 1 : 0; }
+  });
+  collisions.clear();
+  for (size_t i = 0; i < candidates.size(); ++i) { if (overlap[i] != 0) { collisions.push_back(candidates[i]); } }
+}
+
+// Broad and narrow phase for one frame of a set of shapes with bounding boxes (Sphere, Circle, Rectangle2D): the pairs
+// of indices (i, j) with i < j of overlapping shapes. On the first call the shapes are added to broad_phase with their
+// index as id; on later calls, which must pass the same number of shapes, their boxes are updated.
+template<typename shape, typename box>
+void FindCollisions(const std::vector<shape>& shapes, SweepAndPrune<box>& broad_phase, std::vector<std::pair<size_t, size_t>>& collisions, size_t thread_count = 1) {
+  if (broad_phase.Size() == 0) {
+    for (const shape& s : shapes) { broad_phase.Add(box(BoundingBox(s))); }
+  } else {
+    for (size_t i = 0; i < shapes.size(); ++i) { broad_phase.Update(i, box(BoundingBox(shapes[i]))); }
+  }
+  std::vector<std::pair<size_t, size_t>> candidates;
+  broad_phase.FindPairs(candidates);
+  NarrowPhase(shapes, shapes, candidates, collisions, thread_count);
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SWEEP_AND_PRUNE_H_
@@ -0,0 +1,193 @@
+#pragma once
+#ifndef J_MATH_TRANSFORM_BATCH_H_
+#define J_MATH_TRANSFORM_BATCH_H_
+
+#include <cstddef>
+#include "..\utility\parallel.h"
+#include "..\utility\simd.h"
+#include "affine_transform.h"
+#include "point.h"
+#include "point_array.h"
+#include "vector.h"
+#include "vector_array.h"
+#include "vector_batch.h"
+
+namespace j {
+namespace math {
+
+// Batch kernels applying an AffineTransform3D to arrays of points and vectors. Same dispatch and exactness rules as
+// vector_batch.h: results are bit-for-bit identical to TransformPoint and TransformVector. The work can optionally be
+// split over several threads (see ParallelFor).
+
+namespace detail {
+
+//
+// Generic kernels (any valuetype, elements [begin, end))
+//
+template<typename valuetype>
+void TransformGeneric(Components3D<const valuetype> in, const AffineTransform3D<valuetype>& t, bool translate, Components3D<valuetype> out, size_t begin, size_t end) {
+  const valuetype (&m)[3][3] = t.m_.m_;
+  for (size_t i = begin; i < end; ++i) {
+    valuetype x = m[0][0] * in.x_[i] + m[0][1] * in.y_[i] + m[0][2] * in.z_[i];
+    valuetype y = m[1][0] * in.x_[i] + m[1][1] * in.y_[i] + m[1][2] * in.z_[i];
+    valuetype z = m[2][0] * in.x_[i] + m[2][1] * in.y_[i] + m[2][2] * in.z_[i];
+    if (translate) { x = x + t.t_.x_; y = y + t.t_.y_; z = z + t.t_.z_; }
+    out.x_[i] = x; out.y_[i] = y; out.z_[i] = z;
+  }
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+//
+// SSE2 kernels
+//
+J_MATH_TARGET_SSE2 inline void TransformSse(Components3D<const float> in, const AffineTransform3D<float>& t, bool translate, Components3D<float> out, size_t count) {
+  const float (&m)[3][3] = t.m_.m_;
+  __m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]);
+  __m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]);
+  __m128 m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]), m22 = _mm_set1_ps(m[2][2]);
+  __m128 tx = _mm_set1_ps(t.t_.x_), ty = _mm_set1_ps(t.t_.y_), tz = _mm_set1_ps(t.t_.z_);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 vx = _mm_loadu_ps(in.x_ + i), vy = _mm_loadu_ps(in.y_ + i), vz = _mm_loadu_ps(in.z_ + i);
+    __m128 x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, vx), _mm_mul_ps(m01, vy)), _mm_mul_ps(m02, vz));
+    __m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, vx), _mm_mul_ps(m11, vy)), _mm_mul_ps(m12, vz));
+    __m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, vx), _mm_mul_ps(m21, vy)), _mm_mul_ps(m22, vz));
+    if (translate) { x = _mm_add_ps(x, tx); y = _mm_add_ps(y, ty); z = _mm_add_ps(z, tz); }
+    _mm_storeu_ps(out.x_ + i, x); _mm_storeu_ps(out.y_ + i, y); _mm_storeu_ps(out.z_ + i, z);
+  }
+  TransformGeneric(in, t, translate, out, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void TransformSse(Components3D<const double> in, const AffineTransform3D<double>& t, bool translate, Components3D<double> out, size_t count) {
+  const double (&m)[3][3] = t.m_.m_;
+  __m128d m00 = _mm_set1_pd(m[0][0]), m01 = _mm_set1_pd(m[0][1]), m02 = _mm_set1_pd(m[0][2]);
+  __m128d m10 = _mm_set1_pd(m[1][0]), m11 = _mm_set1_pd(m[1][1]), m12 = _mm_set1_pd(m[1][2]);
+  __m128d m20 = _mm_set1_pd(m[2][0]), m21 = _mm_set1_pd(m[2][1]), m22 = _mm_set1_pd(m[2][2]);
+  __m128d tx = _mm_set1_pd(t.t_.x_), ty = _mm_set1_pd(t.t_.y_), tz = _mm_set1_pd(t.t_.z_);
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d vx = _mm_loadu_pd(in.x_ + i), vy = _mm_loadu_pd(in.y_ + i), vz = _mm_loadu_pd(in.z_ + i);
+    __m128d x = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m00, vx), _mm_mul_pd(m01, vy)), _mm_mul_pd(m02, vz));
+    __m128d y = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m10, vx), _mm_mul_pd(m11, vy)), _mm_mul_pd(m12, vz));
+    __m128d z = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m20, vx), _mm_mul_pd(m21, vy)), _mm_mul_pd(m22, vz));
+    if (translate) { x = _mm_add_pd(x, tx); y = _mm_add_pd(y, ty); z = _mm_add_pd(z, tz); }
+    _mm_storeu_pd(out.x_ + i, x); _mm_storeu_pd(out.y_ + i, y); _mm_storeu_pd(out.z_ + i, z);
+  }
+  TransformGeneric(in, t, translate, out, i, count);
+}
+
+//
+// AVX2 kernels
+//
+J_MATH_TARGET_AVX2 inline void TransformAvx2(Components3D<const float> in, const AffineTransform3D<float>& t, bool translate, Components3D<float> out, size_t count) {
+  const float (&m)[3][3] = t.m_.m_;
+  __m256 m00 = _mm256_set1_ps(m[0][0]), m01 = _mm256_set1_ps(m[0][1]), m02 = _mm256_set1_ps(m[0][2]);
+  __m256 m10 = _mm256_set1_ps(m[1][0]), m11 = _mm256_set1_ps(m[1][1]), m12 = _mm256_set1_ps(m[1][2]);
+  __m256 m20 = _mm256_set1_ps(m[2][0]), m21 = _mm256_set1_ps(m[2][1]), m22 = _mm256_set1_ps(m[2][2]);
+  __m256 tx = _mm256_set1_ps(t.t_.x_), ty = _mm256_set1_ps(t.t_.y_), tz = _mm256_set1_ps(t.t_.z_);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 vx = _mm256_loadu_ps(in.x_ + i), vy = _mm256_loadu_ps(in.y_ + i), vz = _mm256_loadu_ps(in.z_ + i);
+    __m256 x = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, vx), _mm256_mul_ps(m01, vy)), _mm256_mul_ps(m02, vz));
+    __m256 y = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10, vx), _mm256_mul_ps(m11, vy)), _mm256_mul_ps(m12, vz));
+    __m256 z = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m20, vx), _mm256_mul_ps(m21, vy)), _mm256_mul_ps(m22, vz));
+    if (translate) { x = _mm256_add_ps(x, tx); y = _mm256_add_ps(y, ty); z = _mm256_add_ps(z, tz); }
+    _mm256_storeu_ps(out.x_ + i, x); _mm256_storeu_ps(out.y_ + i, y); _mm256_storeu_ps(out.z_ + i, z);
+  }
+  TransformGeneric(in, t, translate, out, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void TransformAvx2(Components3D<const double> in, const AffineTransform3D<double>& t, bool translate, Components3D<double> out, size_t count) {
+  const double (&m)[3][3] = t.m_.m_;
+  __m256d m00 = _mm256_set1_pd(m[0][0]), m01 = _mm256_set1_pd(m[0][1]), m02 = _mm256_set1_pd(m[0][2]);
+  __m256d m10 = _mm256_set1_pd(m[1][0]), m11 = _mm256_set1_pd(m[1][1]), m12 = _mm256_set1_pd(m[1][2]);
+  __m256d m20 = _mm256_set1_pd(m[2][0]), m21 = _mm256_set1_pd(m[2][1]), m22 = _mm256_set1_pd(m[2][2]);
+  __m256d tx = _mm256_set1_pd(t.t_.x_), ty = _mm256_set1_pd(t.t_.y_), tz = _mm256_set1_pd(t.t_.z_);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d vx = _mm256_loadu_pd(in.x_ + i), vy = _mm256_loadu_pd(in.y_ + i), vz = _mm256_loadu_pd(in.z_ + i);
+    __m256d x = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m00, vx), _mm256_mul_pd(m01, vy)), _mm256_mul_pd(m02, vz));
+    __m256d y = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m10, vx), _mm256_mul_pd(m11, vy)), _mm256_mul_pd(m12, vz));
+    __m256d z = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m20, vx), _mm256_mul_pd(m21, vy)), _mm256_mul_pd(m22, vz));
+    if (translate) { x = _mm256_add_pd(x, tx); y = _mm256_add_pd(y, ty); z = _mm256_add_pd(z, tz); }
+    _mm256_storeu_pd(out.x_ + i, x); _mm256_storeu_pd(out.y_ + i, y); _mm256_storeu_pd(out.z_ + i, z);
+  }
+  TransformGeneric(in, t, translate, out, i, count);
+}
+
+#endif // J_MATH_SIMD_X86
+
+//
+// Runtime dispatch on the selected instruction set
+//
+template<typename valuetype>
+void TransformDispatch(Components3D<const valuetype> in, const AffineTransform3D<valuetype>& t, bool translate, Components3D<valuetype> out, size_t count) { TransformGeneric(in, t, translate, out, 0, count); }
+
+#if defined(J_MATH_SIMD_X86)
+#define J_MATH_TRANSFORM_BATCH_DISPATCH(valuetype) \
+  inline void TransformDispatch(Components3D<const valuetype> in, const AffineTransform3D<valuetype>& t, bool translate, Components3D<valuetype> out, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: TransformAvx2(in, t, translate, out, count); return; \
+    case SimdLevel::SSE: TransformSse(in, t, translate, out, count); return; \
+    default: TransformGeneric(in, t, translate, out, 0, count); return; \
+    } \
+  }
+J_MATH_TRANSFORM_BATCH_DISPATCH(float)
+J_MATH_TRANSFORM_BATCH_DISPATCH(double)
+#undef J_MATH_TRANSFORM_BATCH_DISPATCH
+#endif // J_MATH_SIMD_X86
+
+// Transform an array of structs (Point3D or Vector3D) block by block through a structure-of-arrays stack buffer.
+template<typename element, typename valuetype>
+void BatchTransform(const element* in, const AffineTransform3D<valuetype>& t, bool translate, element* out, size_t count, size_t thread_count) {
+  ParallelFor(count, thread_count, kBatchBlockSize, [&](size_t begin, size_t end) {
+    valuetype x[kBatchBlockSize], y[kBatchBlockSize], z[kBatchBlockSize];
+    for (size_t offset = begin; offset < end; offset += kBatchBlockSize) {
+      size_t n = (end - offset < kBatchBlockSize) ? end - offset : kBatchBlockSize;
+      for (size_t i = 0; i < n; ++i) { x[i] = in[offset + i].x_; y[i] = in[offset + i].y_; z[i] = in[offset + i].z_; }
+      TransformDispatch(Components3D<const valuetype>{ x, y, z }, t, translate, Components3D<valuetype>{ x, y, z }, n);
+      for (size_t i = 0; i < n; ++i) { out[offset + i] = element(x[i], y[i], z[i]); }
+    }
+  });
+}
+
+// Transform structure-of-arrays buffers, each thread handling a contiguous range.
+template<typename valuetype>
+void BatchTransform(Components3D<const valuetype> in, const AffineTransform3D<valuetype>& t, bool translate, Components3D<valuetype> out, size_t count, size_t thread_count) {
+  ParallelFor(count, thread_count, kBatchBlockSize, [&](size_t begin, size_t end) {
+    Components3D<const valuetype> range_in{ in.x_ + begin, in.y_ + begin, in.z_ + begin };
+    Components3D<valuetype> range_out{ out.x_ + begin, out.y_ + begin, out.z_ + begin };
+    TransformDispatch(range_in, t, translate, range_out, end - begin);
+  });
+}
+
+} // namespace detail
+
+// Transformed copy of points[i] for i in [0, count). Equivalent to t.TransformPoint(points[i]). A thread_count other
+// than 1 splits the points over that many threads (0 uses all hardware threads).
+template<typename valuetype>
+void BatchTransformPoints(const Point3D<valuetype>* points, const AffineTransform3D<valuetype>& t, Point3D<valuetype>* result, size_t count, size_t thread_count = 1) { detail::BatchTransform(points, t, true, result, count, thread_count); }
+
+// Transformed copy of vectors[i] for i in [0, count). Equivalent to t.TransformVector(vectors[i]).
+template<typename valuetype>
+void BatchTransformVectors(const Vector3D<valuetype>* vectors, const AffineTransform3D<valuetype>& t, Vector3D<valuetype>* result, size_t count, size_t thread_count = 1) { detail::BatchTransform(vectors, t, false, result, count, thread_count); }
+
+// Structure-of-arrays versions operating directly on the component buffers. The result is resized to the input length
+// and may be the input itself.
+template<typename valuetype, typename points_allocator, typename result_allocator>
+void BatchTransformPoints(const Point3DArray<valuetype, points_allocator>& points, const AffineTransform3D<valuetype>& t, Point3DArray<valuetype, result_allocator>& result, size_t thread_count = 1) {
+  result.Resize(points.Length());
+  detail::BatchTransform(points.Read(), t, true, result.Write(), points.Length(), thread_count);
+}
+
+template<typename valuetype, typename vectors_allocator, typename result_allocator>
+void BatchTransformVectors(const Vector3DArray<valuetype, vectors_allocator>& vectors, const AffineTransform3D<valuetype>& t, Vector3DArray<valuetype, result_allocator>& result, size_t thread_count = 1) {
+  result.Resize(vectors.Length());
+  detail::BatchTransform(vectors.Read(), t, false, result.Write(), vectors.Length(), thread_count);
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_TRANSFORM_BATCH_H_
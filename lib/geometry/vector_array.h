@@ -0,0 +1,126 @@
+#pragma once
+#ifndef J_MATH_VECTOR_ARRAY_H_
+#define J_MATH_VECTOR_ARRAY_H_
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "vector.h"
+#include "vector_batch.h"
+
+namespace j {
+namespace math {
+
+// An array of three-dimensional vectors stored as a structure of arrays (separate x, y and z buffers). Element access
+// returns a proxy that behaves like a Vector3D, the component buffers can be handed directly to the batch kernels.
+template<typename valuetype, typename allocator = std::allocator<valuetype>>
+struct Vector3DArray {
+  // Proxy referencing a single element of the array. Reads convert to Vector3D, writes go through to the buffers.
+  struct Reference {
+    Reference(valuetype& x, valuetype& y, valuetype& z) : x_(x), y_(y), z_(z) { }
+    Reference(const Reference&) = default;
+
+    // Operators
+    Reference& operator=(const Vector3D<valuetype>& vector) { x_ = vector.x_; y_ = vector.y_; z_ = vector.z_; return *this; }
+    Reference& operator=(const Reference& other) { return operator=(other.Get()); }
+    operator Vector3D<valuetype>() const { return Get(); }
+    bool operator== (const Vector3D<valuetype>& other) const { return Get() == other; }
+    bool operator!= (const Vector3D<valuetype>& other) const { return Get() != other; }
+    Vector3D<valuetype> operator+ () const { return Get(); }
+    Vector3D<valuetype> operator- () const { return -Get(); }
+    Vector3D<valuetype> operator+ (const Vector3D<valuetype>& other) const { return Get() + other; }
+    Vector3D<valuetype> operator- (const Vector3D<valuetype>& other) const { return Get() - other; }
+    Vector3D<valuetype> operator* (valuetype scalar) const { return Get() * scalar; }
+    valuetype operator* (const Vector3D<valuetype>& other) const { return Get() * other; }
+    Vector3D<valuetype> operator/ (valuetype scalar) const { return Get() / scalar; }
+    void operator+= (const Vector3D<valuetype>& other) { x_ += other.x_; y_ += other.y_; z_ += other.z_; }
+    void operator-= (const Vector3D<valuetype>& other) { x_ -= other.x_; y_ -= other.y_; z_ -= other.z_; }
+    void operator*= (const valuetype& scalar) { x_ *= scalar; y_ *= scalar; z_ *= scalar; }
+    void operator/= (const valuetype& scalar) { x_ /= scalar; y_ /= scalar; z_ /= scalar; }
+
+    // String conversion
+    friend std::ostream& operator<<(std::ostream &os, const Reference& reference) { return os << reference.Get(); }
+
+    Vector3D<valuetype> Get() const { return Vector3D<valuetype>(x_, y_, z_); }
+
+    valuetype& x_;
+    valuetype& y_;
+    valuetype& z_;
+  };
+
+  // Constructors
+  Vector3DArray() = default;
+  explicit Vector3DArray(const allocator& alloc) : x_(alloc), y_(alloc), z_(alloc) { }
+  Vector3DArray(const Vector3DArray&) = default;
+  explicit Vector3DArray(size_t length, const allocator& alloc = allocator()) : x_(length, alloc), y_(length, alloc), z_(length, alloc) { }
+  Vector3DArray(const std::vector<Vector3D<valuetype>>& vectors, const allocator& alloc = allocator()) : Vector3DArray(alloc) { Reserve(vectors.size()); for (const Vector3D<valuetype>& v : vectors) { Add(v); } }
+  ~Vector3DArray() = default;
+
+  // Operators
+  Vector3DArray& operator=(const Vector3DArray&) = default;
+  bool operator==(const Vector3DArray& other) const { return x_ == other.x_ && y_ == other.y_ && z_ == other.z_; }
+  bool operator!=(const Vector3DArray& other) const { return !operator==(other); }
+  Reference operator[](size_t i) { return Reference(x_[i], y_[i], z_[i]); }
+  Vector3D<valuetype> operator[](size_t i) const { return Get(i); }
+
+  // Conversion to an array of structs
+  std::vector<Vector3D<valuetype>> ToVector() const {
+    std::vector<Vector3D<valuetype>> vectors;
+    vectors.reserve(Length());
+    for (size_t i = 0; i < Length(); ++i) { vectors.push_back(Get(i)); }
+    return vectors;
+  }
+  operator std::vector<Vector3D<valuetype>>() const { return ToVector(); }
+
+  // Array-specific operations
+  void Add(const Vector3D<valuetype>& vector) { x_.push_back(vector.x_); y_.push_back(vector.y_); z_.push_back(vector.z_); }
+  Vector3D<valuetype> Get(size_t i) const { return Vector3D<valuetype>(x_[i], y_[i], z_[i]); }
+  void Set(size_t i, const Vector3D<valuetype>& vector) { x_[i] = vector.x_; y_[i] = vector.y_; z_[i] = vector.z_; }
+  size_t Length() const { return x_.size(); }
+  void Resize(size_t length) { x_.resize(length); y_.resize(length); z_.resize(length); }
+  void Reserve(size_t length) { x_.reserve(length); y_.reserve(length); z_.reserve(length); }
+  void Clear() { x_.clear(); y_.clear(); z_.clear(); }
+  allocator GetAllocator() const { return x_.get_allocator(); }
+  valuetype* X() { return x_.data(); }
+  valuetype* Y() { return y_.data(); }
+  valuetype* Z() { return z_.data(); }
+  const valuetype* X() const { return x_.data(); }
+  const valuetype* Y() const { return y_.data(); }
+  const valuetype* Z() const { return z_.data(); }
+
+  // Component pointers in the form expected by the batch kernels
+  detail::Components3D<const valuetype> Read() const { return detail::Components3D<const valuetype>{ X(), Y(), Z() }; }
+  detail::Components3D<valuetype> Write() { return detail::Components3D<valuetype>{ X(), Y(), Z() }; }
+
+private:
+  std::vector<valuetype, allocator> x_, y_, z_;
+};
+
+using vec3arrayi = Vector3DArray<int>;
+using vec3arrayf = Vector3DArray<float>;
+using vec3arrayd = Vector3DArray<double>;
+
+// Batch kernels operating directly on the component buffers (see vector_batch.h). a and b must have the same length,
+// the result is resized to that length.
+template<typename valuetype, typename a_allocator, typename b_allocator>
+void BatchScalarProduct(const Vector3DArray<valuetype, a_allocator>& a, const Vector3DArray<valuetype, b_allocator>& b, std::vector<valuetype>& result) {
+  result.resize(a.Length());
+  detail::ScalarProductDispatch(a.Read(), b.Read(), result.data(), a.Length());
+}
+
+template<typename valuetype, typename a_allocator, typename b_allocator, typename result_allocator>
+void BatchCrossProduct(const Vector3DArray<valuetype, a_allocator>& a, const Vector3DArray<valuetype, b_allocator>& b, Vector3DArray<valuetype, result_allocator>& result) {
+  result.Resize(a.Length());
+  detail::CrossProductDispatch(a.Read(), b.Read(), result.Write(), a.Length());
+}
+
+template<typename valuetype, typename v_allocator, typename result_allocator>
+void BatchNormalize(const Vector3DArray<valuetype, v_allocator>& v, Vector3DArray<valuetype, result_allocator>& result) {
+  result.Resize(v.Length());
+  detail::NormalizeDispatch(v.Read(), result.Write(), v.Length());
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_VECTOR_ARRAY_H_
@@ -0,0 +1,304 @@
+#pragma once
+#ifndef J_MATH_VECTOR_BATCH_H_
+#define J_MATH_VECTOR_BATCH_H_
+
+#include <cmath>
+#include <cstddef>
+#include "..\utility\simd.h"
+#include "vector.h"
+
+namespace j {
+namespace math {
+
+// Batch kernels for Vector3D operations over arrays of vectors.
+//
+// The kernels use SSE2 or AVX2 when the CPU supports them (see GetSimdLevel) and fall back to a scalar loop otherwise.
+// Every kernel performs the same IEEE operations in the same order as the matching Vector3D member function (no fused
+// multiply-add, no reciprocal approximations), so for float and double the results are bit-for-bit identical to the
+// scalar versions (0 ULP) on every path, as long as the scalar code itself is not built with floating-point contraction
+// (e.g. GCC's -ffp-contract=fast together with -mfma). Input and output arrays may be the same array (in-place operation).
+
+namespace detail {
+
+// Pointers to the x, y and z components of a structure-of-arrays batch of vectors.
+template<typename valuetype>
+struct Components3D {
+  valuetype* x_;
+  valuetype* y_;
+  valuetype* z_;
+};
+
+//
+// Generic kernels (any valuetype, elements [begin, end))
+//
+template<typename valuetype>
+void ScalarProductGeneric(Components3D<const valuetype> a, Components3D<const valuetype> b, valuetype* result, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) { result[i] = a.x_[i] * b.x_[i] + a.y_[i] * b.y_[i] + a.z_[i] * b.z_[i]; }
+}
+
+template<typename valuetype>
+void CrossProductGeneric(Components3D<const valuetype> a, Components3D<const valuetype> b, Components3D<valuetype> result, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    valuetype x = a.y_[i] * b.z_[i] - a.z_[i] * b.y_[i];
+    valuetype y = a.z_[i] * b.x_[i] - a.x_[i] * b.z_[i];
+    valuetype z = a.x_[i] * b.y_[i] - a.y_[i] * b.x_[i];
+    result.x_[i] = x; result.y_[i] = y; result.z_[i] = z;
+  }
+}
+
+template<typename valuetype>
+void NormalizeGeneric(Components3D<const valuetype> v, Components3D<valuetype> result, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    valuetype length = valuetype(std::sqrt(v.x_[i] * v.x_[i] + v.y_[i] * v.y_[i] + v.z_[i] * v.z_[i]));
+    valuetype x = v.x_[i] / length;
+    valuetype y = v.y_[i] / length;
+    valuetype z = v.z_[i] / length;
+    result.x_[i] = x; result.y_[i] = y; result.z_[i] = z;
+  }
+}
+
+#if defined(J_MATH_SIMD_X86)
+
+//
+// SSE2 kernels
+//
+J_MATH_TARGET_SSE2 inline void ScalarProductSse(Components3D<const float> a, Components3D<const float> b, float* result, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 xx = _mm_mul_ps(_mm_loadu_ps(a.x_ + i), _mm_loadu_ps(b.x_ + i));
+    __m128 yy = _mm_mul_ps(_mm_loadu_ps(a.y_ + i), _mm_loadu_ps(b.y_ + i));
+    __m128 zz = _mm_mul_ps(_mm_loadu_ps(a.z_ + i), _mm_loadu_ps(b.z_ + i));
+    _mm_storeu_ps(result + i, _mm_add_ps(_mm_add_ps(xx, yy), zz));
+  }
+  ScalarProductGeneric(a, b, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void ScalarProductSse(Components3D<const double> a, Components3D<const double> b, double* result, size_t count) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d xx = _mm_mul_pd(_mm_loadu_pd(a.x_ + i), _mm_loadu_pd(b.x_ + i));
+    __m128d yy = _mm_mul_pd(_mm_loadu_pd(a.y_ + i), _mm_loadu_pd(b.y_ + i));
+    __m128d zz = _mm_mul_pd(_mm_loadu_pd(a.z_ + i), _mm_loadu_pd(b.z_ + i));
+    _mm_storeu_pd(result + i, _mm_add_pd(_mm_add_pd(xx, yy), zz));
+  }
+  ScalarProductGeneric(a, b, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void CrossProductSse(Components3D<const float> a, Components3D<const float> b, Components3D<float> result, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 ax = _mm_loadu_ps(a.x_ + i), ay = _mm_loadu_ps(a.y_ + i), az = _mm_loadu_ps(a.z_ + i);
+    __m128 bx = _mm_loadu_ps(b.x_ + i), by = _mm_loadu_ps(b.y_ + i), bz = _mm_loadu_ps(b.z_ + i);
+    _mm_storeu_ps(result.x_ + i, _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by)));
+    _mm_storeu_ps(result.y_ + i, _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz)));
+    _mm_storeu_ps(result.z_ + i, _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx)));
+  }
+  CrossProductGeneric(a, b, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void CrossProductSse(Components3D<const double> a, Components3D<const double> b, Components3D<double> result, size_t count) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d ax = _mm_loadu_pd(a.x_ + i), ay = _mm_loadu_pd(a.y_ + i), az = _mm_loadu_pd(a.z_ + i);
+    __m128d bx = _mm_loadu_pd(b.x_ + i), by = _mm_loadu_pd(b.y_ + i), bz = _mm_loadu_pd(b.z_ + i);
+    _mm_storeu_pd(result.x_ + i, _mm_sub_pd(_mm_mul_pd(ay, bz), _mm_mul_pd(az, by)));
+    _mm_storeu_pd(result.y_ + i, _mm_sub_pd(_mm_mul_pd(az, bx), _mm_mul_pd(ax, bz)));
+    _mm_storeu_pd(result.z_ + i, _mm_sub_pd(_mm_mul_pd(ax, by), _mm_mul_pd(ay, bx)));
+  }
+  CrossProductGeneric(a, b, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void NormalizeSse(Components3D<const float> v, Components3D<float> result, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_loadu_ps(v.x_ + i), y = _mm_loadu_ps(v.y_ + i), z = _mm_loadu_ps(v.z_ + i);
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+    _mm_storeu_ps(result.x_ + i, _mm_div_ps(x, length));
+    _mm_storeu_ps(result.y_ + i, _mm_div_ps(y, length));
+    _mm_storeu_ps(result.z_ + i, _mm_div_ps(z, length));
+  }
+  NormalizeGeneric(v, result, i, count);
+}
+
+J_MATH_TARGET_SSE2 inline void NormalizeSse(Components3D<const double> v, Components3D<double> result, size_t count) {
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d x = _mm_loadu_pd(v.x_ + i), y = _mm_loadu_pd(v.y_ + i), z = _mm_loadu_pd(v.z_ + i);
+    __m128d length = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y)), _mm_mul_pd(z, z)));
+    _mm_storeu_pd(result.x_ + i, _mm_div_pd(x, length));
+    _mm_storeu_pd(result.y_ + i, _mm_div_pd(y, length));
+    _mm_storeu_pd(result.z_ + i, _mm_div_pd(z, length));
+  }
+  NormalizeGeneric(v, result, i, count);
+}
+
+//
+// AVX2 kernels
+//
+J_MATH_TARGET_AVX2 inline void ScalarProductAvx2(Components3D<const float> a, Components3D<const float> b, float* result, size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 xx = _mm256_mul_ps(_mm256_loadu_ps(a.x_ + i), _mm256_loadu_ps(b.x_ + i));
+    __m256 yy = _mm256_mul_ps(_mm256_loadu_ps(a.y_ + i), _mm256_loadu_ps(b.y_ + i));
+    __m256 zz = _mm256_mul_ps(_mm256_loadu_ps(a.z_ + i), _mm256_loadu_ps(b.z_ + i));
+    _mm256_storeu_ps(result + i, _mm256_add_ps(_mm256_add_ps(xx, yy), zz));
+  }
+  ScalarProductGeneric(a, b, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void ScalarProductAvx2(Components3D<const double> a, Components3D<const double> b, double* result, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d xx = _mm256_mul_pd(_mm256_loadu_pd(a.x_ + i), _mm256_loadu_pd(b.x_ + i));
+    __m256d yy = _mm256_mul_pd(_mm256_loadu_pd(a.y_ + i), _mm256_loadu_pd(b.y_ + i));
+    __m256d zz = _mm256_mul_pd(_mm256_loadu_pd(a.z_ + i), _mm256_loadu_pd(b.z_ + i));
+    _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_add_pd(xx, yy), zz));
+  }
+  ScalarProductGeneric(a, b, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void CrossProductAvx2(Components3D<const float> a, Components3D<const float> b, Components3D<float> result, size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 ax = _mm256_loadu_ps(a.x_ + i), ay = _mm256_loadu_ps(a.y_ + i), az = _mm256_loadu_ps(a.z_ + i);
+    __m256 bx = _mm256_loadu_ps(b.x_ + i), by = _mm256_loadu_ps(b.y_ + i), bz = _mm256_loadu_ps(b.z_ + i);
+    _mm256_storeu_ps(result.x_ + i, _mm256_sub_ps(_mm256_mul_ps(ay, bz), _mm256_mul_ps(az, by)));
+    _mm256_storeu_ps(result.y_ + i, _mm256_sub_ps(_mm256_mul_ps(az, bx), _mm256_mul_ps(ax, bz)));
+    _mm256_storeu_ps(result.z_ + i, _mm256_sub_ps(_mm256_mul_ps(ax, by), _mm256_mul_ps(ay, bx)));
+  }
+  CrossProductGeneric(a, b, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void CrossProductAvx2(Components3D<const double> a, Components3D<const double> b, Components3D<double> result, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d ax = _mm256_loadu_pd(a.x_ + i), ay = _mm256_loadu_pd(a.y_ + i), az = _mm256_loadu_pd(a.z_ + i);
+    __m256d bx = _mm256_loadu_pd(b.x_ + i), by = _mm256_loadu_pd(b.y_ + i), bz = _mm256_loadu_pd(b.z_ + i);
+    _mm256_storeu_pd(result.x_ + i, _mm256_sub_pd(_mm256_mul_pd(ay, bz), _mm256_mul_pd(az, by)));
+    _mm256_storeu_pd(result.y_ + i, _mm256_sub_pd(_mm256_mul_pd(az, bx), _mm256_mul_pd(ax, bz)));
+    _mm256_storeu_pd(result.z_ + i, _mm256_sub_pd(_mm256_mul_pd(ax, by), _mm256_mul_pd(ay, bx)));
+  }
+  CrossProductGeneric(a, b, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void NormalizeAvx2(Components3D<const float> v, Components3D<float> result, size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_loadu_ps(v.x_ + i), y = _mm256_loadu_ps(v.y_ + i), z = _mm256_loadu_ps(v.z_ + i);
+    __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+    _mm256_storeu_ps(result.x_ + i, _mm256_div_ps(x, length));
+    _mm256_storeu_ps(result.y_ + i, _mm256_div_ps(y, length));
+    _mm256_storeu_ps(result.z_ + i, _mm256_div_ps(z, length));
+  }
+  NormalizeGeneric(v, result, i, count);
+}
+
+J_MATH_TARGET_AVX2 inline void NormalizeAvx2(Components3D<const double> v, Components3D<double> result, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d x = _mm256_loadu_pd(v.x_ + i), y = _mm256_loadu_pd(v.y_ + i), z = _mm256_loadu_pd(v.z_ + i);
+    __m256d length = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)));
+    _mm256_storeu_pd(result.x_ + i, _mm256_div_pd(x, length));
+    _mm256_storeu_pd(result.y_ + i, _mm256_div_pd(y, length));
+    _mm256_storeu_pd(result.z_ + i, _mm256_div_pd(z, length));
+  }
+  NormalizeGeneric(v, result, i, count);
+}
+
+#endif // J_MATH_SIMD_X86
+
+//
+// Runtime dispatch on the selected instruction set (float and double only, other types use the generic kernels)
+//
+template<typename valuetype>
+void ScalarProductDispatch(Components3D<const valuetype> a, Components3D<const valuetype> b, valuetype* result, size_t count) { ScalarProductGeneric(a, b, result, 0, count); }
+template<typename valuetype>
+void CrossProductDispatch(Components3D<const valuetype> a, Components3D<const valuetype> b, Components3D<valuetype> result, size_t count) { CrossProductGeneric(a, b, result, 0, count); }
+template<typename valuetype>
+void NormalizeDispatch(Components3D<const valuetype> v, Components3D<valuetype> result, size_t count) { NormalizeGeneric(v, result, 0, count); }
+
+#if defined(J_MATH_SIMD_X86)
+#define J_MATH_VECTOR_BATCH_DISPATCH(valuetype) \
+  inline void ScalarProductDispatch(Components3D<const valuetype> a, Components3D<const valuetype> b, valuetype* result, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: ScalarProductAvx2(a, b, result, count); return; \
+    case SimdLevel::SSE: ScalarProductSse(a, b, result, count); return; \
+    default: ScalarProductGeneric(a, b, result, 0, count); return; \
+    } \
+  } \
+  inline void CrossProductDispatch(Components3D<const valuetype> a, Components3D<const valuetype> b, Components3D<valuetype> result, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: CrossProductAvx2(a, b, result, count); return; \
+    case SimdLevel::SSE: CrossProductSse(a, b, result, count); return; \
+    default: CrossProductGeneric(a, b, result, 0, count); return; \
+    } \
+  } \
+  inline void NormalizeDispatch(Components3D<const valuetype> v, Components3D<valuetype> result, size_t count) { \
+    switch (GetSimdLevel()) { \
+    case SimdLevel::AVX2: NormalizeAvx2(v, result, count); return; \
+    case SimdLevel::SSE: NormalizeSse(v, result, count); return; \
+    default: NormalizeGeneric(v, result, 0, count); return; \
+    } \
+  }
+J_MATH_VECTOR_BATCH_DISPATCH(float)
+J_MATH_VECTOR_BATCH_DISPATCH(double)
+#undef J_MATH_VECTOR_BATCH_DISPATCH
+#endif // J_MATH_SIMD_X86
+
+// Number of array-of-structs vectors transposed per step before they are handed to the component kernels.
+constexpr size_t kBatchBlockSize = 128;
+
+// Stack buffer holding a block of vectors in structure-of-arrays form.
+template<typename valuetype>
+struct ComponentBlock3D {
+  void Load(const Vector3D<valuetype>* vectors, size_t count) { for (size_t i = 0; i < count; ++i) { x_[i] = vectors[i].x_; y_[i] = vectors[i].y_; z_[i] = vectors[i].z_; } }
+  void Store(Vector3D<valuetype>* vectors, size_t count) const { for (size_t i = 0; i < count; ++i) { vectors[i] = Vector3D<valuetype>(x_[i], y_[i], z_[i]); } }
+  Components3D<const valuetype> Read() const { return Components3D<const valuetype>{ x_, y_, z_ }; }
+  Components3D<valuetype> Write() { return Components3D<valuetype>{ x_, y_, z_ }; }
+
+  valuetype x_[kBatchBlockSize], y_[kBatchBlockSize], z_[kBatchBlockSize];
+};
+
+} // namespace detail
+
+// Scalar product of a[i] and b[i] for i in [0, count). Equivalent to a[i].ScalarProduct(b[i]).
+template<typename valuetype>
+void BatchScalarProduct(const Vector3D<valuetype>* a, const Vector3D<valuetype>* b, valuetype* result, size_t count) {
+  detail::ComponentBlock3D<valuetype> block_a, block_b;
+  for (size_t offset = 0; offset < count; offset += detail::kBatchBlockSize) {
+    size_t n = (count - offset < detail::kBatchBlockSize) ? count - offset : detail::kBatchBlockSize;
+    block_a.Load(a + offset, n);
+    block_b.Load(b + offset, n);
+    detail::ScalarProductDispatch(block_a.Read(), block_b.Read(), result + offset, n);
+  }
+}
+
+// Cross product of a[i] and b[i] for i in [0, count). Equivalent to a[i].CrossProduct(b[i]).
+template<typename valuetype>
+void BatchCrossProduct(const Vector3D<valuetype>* a, const Vector3D<valuetype>* b, Vector3D<valuetype>* result, size_t count) {
+  detail::ComponentBlock3D<valuetype> block_a, block_b;
+  for (size_t offset = 0; offset < count; offset += detail::kBatchBlockSize) {
+    size_t n = (count - offset < detail::kBatchBlockSize) ? count - offset : detail::kBatchBlockSize;
+    block_a.Load(a + offset, n);
+    block_b.Load(b + offset, n);
+    detail::CrossProductDispatch(block_a.Read(), block_b.Read(), block_a.Write(), n);
+    block_a.Store(result + offset, n);
+  }
+}
+
+// Normalized copy of v[i] for i in [0, count). Equivalent to v[i].Normalize().
+template<typename valuetype>
+void BatchNormalize(const Vector3D<valuetype>* v, Vector3D<valuetype>* result, size_t count) {
+  detail::ComponentBlock3D<valuetype> block;
+  for (size_t offset = 0; offset < count; offset += detail::kBatchBlockSize) {
+    size_t n = (count - offset < detail::kBatchBlockSize) ? count - offset : detail::kBatchBlockSize;
+    block.Load(v + offset, n);
+    detail::NormalizeDispatch(block.Read(), block.Write(), n);
+    block.Store(result + offset, n);
+  }
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_VECTOR_BATCH_H_
@@ -0,0 +1,189 @@
+#pragma once
+#ifndef J_MATH_VECTOR_N_H_
+#define J_MATH_VECTOR_N_H_
+
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+#include <utility>
+#include "..\utility\numeric_comparison.h"
+#include "..\utility\sqrt.h"
+#include "vector.h"
+
+namespace j {
+namespace math {
+
+template<typename valuetype, size_t dimensions> struct VectorN;
+template<typename operand, typename operation, typename valuetype, size_t dimensions> struct VectorScalarExpression;
+
+namespace detail {
+
+// Leaf vectors are referenced by expressions, intermediate expressions are small and stored by value
+template<typename expression> struct VectorExpressionStorage { using type = const expression; };
+template<typename valuetype, size_t dimensions> struct VectorExpressionStorage<VectorN<valuetype, dimensions>> { using type = const VectorN<valuetype, dimensions>&; };
+
+// Element-wise operations of the expression nodes
+struct VectorAssign { template<typename valuetype> static constexpr valuetype Apply(valuetype, valuetype b) { return b; } };
+struct VectorAdd { template<typename valuetype> static constexpr valuetype Apply(valuetype a, valuetype b) { return a + b; } };
+struct VectorSubtract { template<typename valuetype> static constexpr valuetype Apply(valuetype a, valuetype b) { return a - b; } };
+struct VectorMultiply { template<typename valuetype> static constexpr valuetype Apply(valuetype a, valuetype b) { return a * b; } };
+struct VectorDivide { template<typename valuetype> static constexpr valuetype Apply(valuetype a, valuetype b) { return a / b; } };
+
+template<typename... values> struct AllArithmetic : std::true_type { };
+template<typename value, typename... values> struct AllArithmetic<value, values...> : std::integral_constant<bool, std::is_arithmetic<value>::value && AllArithmetic<values...>::value> { };
+
+} // namespace detail
+
+// Base of every vector expression. A chain of vector arithmetic such as a + b * s - c builds a tree of lightweight
+// expression nodes instead of temporaries, and is evaluated element by element in a single unrolled pass once it is
+// assigned to a VectorN. Expressions reference their leaf vectors, so evaluate them before the operands go out of
+// scope rather than storing them in auto variables.
+template<typename expression, typename valuetype, size_t dimensions>
+struct VectorExpression {
+  constexpr const expression& Get() const { return static_cast<const expression&>(*this); }
+  static constexpr size_t Dimensions() { return dimensions; }
+  constexpr VectorN<valuetype, dimensions> Evaluate() const { return VectorN<valuetype, dimensions>(*this); }
+
+  // Operators with a scalar operand
+  friend constexpr auto operator* (const VectorExpression& e, valuetype scalar) { return VectorScalarExpression<expression, detail::VectorMultiply, valuetype, dimensions>(e.Get(), scalar); }
+  friend constexpr auto operator/ (const VectorExpression& e, valuetype scalar) { return VectorScalarExpression<expression, detail::VectorDivide, valuetype, dimensions>(e.Get(), scalar); }
+  constexpr auto operator+ () const { return Get(); }
+  constexpr auto operator- () const { return VectorScalarExpression<expression, detail::VectorMultiply, valuetype, dimensions>(Get(), valuetype(-1)); }
+
+  // String conversion
+  friend std::ostream& operator<<(std::ostream &os, const VectorExpression& e) {
+    os << "VectorN(";
+    for (size_t i = 0; i < dimensions; ++i) { os << (i > 0 ? ", " : "") << e.Get()[i]; }
+    return os << ")";
+  }
+
+  // Vector-specific functions
+  template<typename other>
+  constexpr valuetype ScalarProduct(const VectorExpression<other, valuetype, dimensions>& o) const {
+    valuetype sum = Get()[0] * o.Get()[0];
+    for (size_t i = 1; i < dimensions; ++i) { sum += Get()[i] * o.Get()[i]; }
+    return sum;
+  }
+  template<typename other> constexpr bool IsOrthogonal(const VectorExpression<other, valuetype, dimensions>& o) const { return AreEqual(ScalarProduct(o), valuetype(0)); }
+  template<typename other> constexpr bool IsCollinear(const VectorExpression<other, valuetype, dimensions>& o) const { return AreEqual(ScalarProduct(o) * ScalarProduct(o), LengthSquared() * o.LengthSquared()); }
+  constexpr valuetype LengthSquared() const { return ScalarProduct(*this); }
+  constexpr valuetype Length() const { return valuetype(Sqrt(LengthSquared())); }
+  constexpr VectorN<valuetype, dimensions> Normalize() const { return VectorN<valuetype, dimensions>(*this / Length()); }
+  constexpr bool IsNormalized() const { return AreEqual(Length(), valuetype(1)); }
+  template<typename other> constexpr VectorN<valuetype, dimensions> Project(const VectorExpression<other, valuetype, dimensions>& o) const { return VectorN<valuetype, dimensions>(o * (ScalarProduct(o) / o.LengthSquared())); }
+};
+
+// Element-wise combination of two vector expressions
+template<typename left, typename right, typename operation, typename valuetype, size_t dimensions>
+struct VectorBinaryExpression : VectorExpression<VectorBinaryExpression<left, right, operation, valuetype, dimensions>, valuetype, dimensions> {
+  constexpr VectorBinaryExpression(const left& l, const right& r) : l_(l), r_(r) { }
+  constexpr valuetype operator[](size_t i) const { return operation::Apply(l_[i], r_[i]); }
+
+  typename detail::VectorExpressionStorage<left>::type l_;
+  typename detail::VectorExpressionStorage<right>::type r_;
+};
+
+// Element-wise combination of a vector expression with a scalar
+template<typename operand, typename operation, typename valuetype, size_t dimensions>
+struct VectorScalarExpression : VectorExpression<VectorScalarExpression<operand, operation, valuetype, dimensions>, valuetype, dimensions> {
+  constexpr VectorScalarExpression(const operand& o, valuetype s) : o_(o), s_(s) { }
+  constexpr valuetype operator[](size_t i) const { return operation::Apply(o_[i], s_); }
+
+  typename detail::VectorExpressionStorage<operand>::type o_;
+  valuetype s_;
+};
+
+// Operators combining two vector expressions
+template<typename left, typename right, typename valuetype, size_t dimensions>
+constexpr VectorBinaryExpression<left, right, detail::VectorAdd, valuetype, dimensions> operator+ (const VectorExpression<left, valuetype, dimensions>& l, const VectorExpression<right, valuetype, dimensions>& r) {
+  return VectorBinaryExpression<left, right, detail::VectorAdd, valuetype, dimensions>(l.Get(), r.Get());
+}
+template<typename left, typename right, typename valuetype, size_t dimensions>
+constexpr VectorBinaryExpression<left, right, detail::VectorSubtract, valuetype, dimensions> operator- (const VectorExpression<left, valuetype, dimensions>& l, const VectorExpression<right, valuetype, dimensions>& r) {
+  return VectorBinaryExpression<left, right, detail::VectorSubtract, valuetype, dimensions>(l.Get(), r.Get());
+}
+template<typename left, typename right, typename valuetype, size_t dimensions>
+constexpr valuetype operator* (const VectorExpression<left, valuetype, dimensions>& l, const VectorExpression<right, valuetype, dimensions>& r) { return l.ScalarProduct(r); }
+template<typename left, typename right, typename valuetype, size_t dimensions>
+constexpr bool operator== (const VectorExpression<left, valuetype, dimensions>& l, const VectorExpression<right, valuetype, dimensions>& r) {
+  for (size_t i = 0; i < dimensions; ++i) { if (!AreEqual(l.Get()[i], r.Get()[i])) { return false; } }
+  return true;
+}
+template<typename left, typename right, typename valuetype, size_t dimensions>
+constexpr bool operator!= (const VectorExpression<left, valuetype, dimensions>& l, const VectorExpression<right, valuetype, dimensions>& r) { return !(l == r); }
+
+// A vector of any fixed dimension. Interoperates with Vector2D and Vector3D, and evaluates vector expressions without
+// intermediate temporaries.
+template<typename valuetype, size_t dimensions>
+struct VectorN : VectorExpression<VectorN<valuetype, dimensions>, valuetype, dimensions> {
+  static_assert(dimensions > 0, "VectorN needs at least one dimension.");
+
+  // Constructors
+  constexpr VectorN() : data_{ } { }
+  VectorN(const VectorN&) = default;
+  template<typename... values, typename std::enable_if<sizeof...(values) == dimensions && detail::AllArithmetic<values...>::value, int>::type = 0>
+  constexpr VectorN(values... v) : data_{ valuetype(v)... } { }
+  template<typename expression>
+  constexpr VectorN(const VectorExpression<expression, valuetype, dimensions>& e) : VectorN(e.Get(), std::make_index_sequence<dimensions>()) { }
+  template<size_t n = dimensions, typename std::enable_if<n == 2, int>::type = 0>
+  constexpr VectorN(const Vector2D<valuetype>& v) : data_{ v.x_, v.y_ } { }
+  template<size_t n = dimensions, typename std::enable_if<n == 3, int>::type = 0>
+  constexpr VectorN(const Vector3D<valuetype>& v) : data_{ v.x_, v.y_, v.z_ } { }
+  ~VectorN() = default;
+  static constexpr VectorN Unit(size_t axis) { VectorN v; v.data_[axis] = valuetype(1); return v; }
+
+  // Operators
+  VectorN& operator=(const VectorN&) = default;
+  template<typename expression>
+  constexpr VectorN& operator=(const VectorExpression<expression, valuetype, dimensions>& e) { Assign<detail::VectorAssign>(e.Get(), std::make_index_sequence<dimensions>()); return *this; }
+  constexpr const valuetype& operator[](size_t i) const { return data_[i]; }
+  constexpr valuetype& operator[](size_t i) { return data_[i]; }
+  template<typename expression>
+  constexpr void operator+= (const VectorExpression<expression, valuetype, dimensions>& e) { Assign<detail::VectorAdd>(e.Get(), std::make_index_sequence<dimensions>()); }
+  template<typename expression>
+  constexpr void operator-= (const VectorExpression<expression, valuetype, dimensions>& e) { Assign<detail::VectorSubtract>(e.Get(), std::make_index_sequence<dimensions>()); }
+  constexpr void operator*= (const valuetype& scalar) { for (size_t i = 0; i < dimensions; ++i) { data_[i] *= scalar; } }
+  constexpr void operator/= (const valuetype& scalar) { for (size_t i = 0; i < dimensions; ++i) { data_[i] /= scalar; } }
+
+  // Cast to different valuetype
+  template<typename other_valuetype> constexpr operator VectorN<other_valuetype, dimensions>() const {
+    VectorN<other_valuetype, dimensions> v;
+    for (size_t i = 0; i < dimensions; ++i) { v.data_[i] = other_valuetype(data_[i]); }
+    return v;
+  }
+
+  // Conversion to the hand-written vector types
+  template<size_t n = dimensions, typename std::enable_if<n == 2, int>::type = 0>
+  constexpr Vector2D<valuetype> ToVector2D() const { return Vector2D<valuetype>(data_[0], data_[1]); }
+  template<size_t n = dimensions, typename std::enable_if<n == 3, int>::type = 0>
+  constexpr Vector3D<valuetype> ToVector3D() const { return Vector3D<valuetype>(data_[0], data_[1], data_[2]); }
+
+  // Vector-specific functions
+  template<size_t n = dimensions, typename std::enable_if<n == 3, int>::type = 0>
+  constexpr VectorN CrossProduct(const VectorN& other) const { return VectorN(data_[1] * other.data_[2] - data_[2] * other.data_[1], data_[2] * other.data_[0] - data_[0] * other.data_[2], data_[0] * other.data_[1] - data_[1] * other.data_[0]); }
+  constexpr valuetype* Data() { return data_; }
+  constexpr const valuetype* Data() const { return data_; }
+
+  valuetype data_[dimensions];
+
+private:
+  // Unrolled evaluation of an expression into the elements. Element i of an expression only reads element i of its
+  // operands, so assigning an expression that references this vector is safe.
+  template<typename expression, size_t... i>
+  constexpr VectorN(const expression& e, std::index_sequence<i...>) : data_{ e[i]... } { }
+  template<typename operation, typename expression, size_t... i>
+  constexpr void Assign(const expression& e, std::index_sequence<i...>) {
+    int unroll[] = { 0, (data_[i] = operation::Apply(data_[i], e[i]), 0)... };
+    (void)unroll;
+  }
+};
+
+template<typename valuetype> using Vector4D = VectorN<valuetype, 4>;
+using vec4i = Vector4D<int>;
+using vec4f = Vector4D<float>;
+using vec4d = Vector4D<double>;
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_VECTOR_N_H_
@@ -0,0 +1,207 @@
+#pragma once
+#ifndef J_MATH_ALLOCATOR_H_
+#define J_MATH_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace j {
+namespace math {
+
+// Memory for short-lived buffers (e.g. per-frame scratch sequences) without a call to the heap per allocation, and
+// standard allocators on top of it for Sequence1D, Point3DArray, Vector3DArray or any standard container.
+//
+// MemoryArena hands out memory from large blocks by moving an offset forward; freeing is a no-op and all memory is
+// reclaimed at once by Reset. MemoryPool hands out blocks of one fixed size from a free list. Neither is thread-safe:
+// use one per thread, or per frame. Both must outlive the containers using them. The saving is per allocation, so it
+// matters most for many small buffers; an arena also never reuses memory within a frame, which for large buffers costs
+// more in cache misses than it saves.
+
+const size_t kDefaultArenaBlockSize = size_t(1) << 16;
+const size_t kDefaultPoolChunkSize = 64;
+
+namespace detail {
+
+inline size_t AlignUp(size_t n, size_t alignment) { return (n + alignment - 1) / alignment * alignment; }
+
+} // namespace detail
+
+// Monotonic arena. Memory is never returned to the system before Release or destruction, so that after the first frame
+// Reset-Allocate cycles of a similar size do not touch the heap at all.
+class MemoryArena {
+public:
+  // Constructors
+  explicit MemoryArena(size_t block_size = kDefaultArenaBlockSize) : block_size_{ (block_size > 0) ? block_size : 1 } { }
+  MemoryArena(const MemoryArena&) = delete;
+  ~MemoryArena() { Release(); }
+
+  // Operators
+  MemoryArena& operator=(const MemoryArena&) = delete;
+
+  // Arena-specific operations
+  // Memory for size bytes aligned to alignment (a power of two). Never fails except when the heap does.
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    for (; current_ < blocks_.size(); ++current_, offset_ = 0) {
+      Block& block = blocks_[current_];
+      size_t begin = AlignedOffset(block, offset_, alignment);
+      if (begin + size <= block.size_) {
+        offset_ = begin + size;
+        used_ += size;
+        return block.data_ + begin;
+      }
+    }
+    size_t block_size = (size + alignment > block_size_) ? size + alignment : block_size_;
+    blocks_.push_back(Block{ static_cast<char*>(::operator new(block_size)), block_size });
+    capacity_ += block_size;
+    size_t begin = AlignedOffset(blocks_.back(), 0, alignment);
+    offset_ = begin + size;
+    used_ += size;
+    return blocks_.back().data_ + begin;
+  }
+  // Makes all memory available again, invalidating everything allocated before. Blocks are kept for reuse; when more
+  // than one was needed, they are merged into a single block of the same total size.
+  void Reset() {
+    if (blocks_.size() > 1) {
+      size_t capacity = capacity_;
+      Release();
+      blocks_.push_back(Block{ static_cast<char*>(::operator new(capacity)), capacity });
+      capacity_ = capacity;
+    }
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+  }
+  // Returns all memory to the system.
+  void Release() {
+    for (Block& block : blocks_) { ::operator delete(block.data_); }
+    blocks_.clear();
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+    capacity_ = 0;
+  }
+  // Bytes handed out since the last Reset, and bytes held in blocks.
+  size_t Used() const { return used_; }
+  size_t Capacity() const { return capacity_; }
+
+private:
+  struct Block {
+    char* data_;
+    size_t size_;
+  };
+
+  static size_t AlignedOffset(const Block& block, size_t offset, size_t alignment) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(block.data_) + offset;
+    return offset + size_t(((address + alignment - 1) & ~uintptr_t(alignment - 1)) - address);
+  }
+
+  std::vector<Block> blocks_;
+  size_t block_size_;
+  size_t current_ = 0;  // Block being filled
+  size_t offset_ = 0;   // First free byte in the block being filled
+  size_t used_ = 0;
+  size_t capacity_ = 0;
+};
+
+// Pool of equally sized blocks, allocated from the heap chunk_size blocks at a time. Freed blocks are reused last in,
+// first out, so a buffer freed and allocated again within a frame is likely still in cache.
+class MemoryPool {
+public:
+  // Constructors
+  explicit MemoryPool(size_t block_size, size_t chunk_size = kDefaultPoolChunkSize)
+      : block_size_{ detail::AlignUp((block_size > sizeof(void*)) ? block_size : sizeof(void*), alignof(std::max_align_t)) }, chunk_size_{ (chunk_size > 0) ? chunk_size : 1 } { }
+  MemoryPool(const MemoryPool&) = delete;
+  ~MemoryPool() { for (void* chunk : chunks_) { ::operator delete(chunk); } }
+
+  // Operators
+  MemoryPool& operator=(const MemoryPool&) = delete;
+
+  // Pool-specific operations
+  void* Allocate() {
+    if (free_ == nullptr) { AddChunk(); }
+    void* block = free_;
+    free_ = *static_cast<void**>(free_);
+    return block;
+  }
+  void Deallocate(void* block) {
+    *static_cast<void**>(block) = free_;
+    free_ = block;
+  }
+  // Size of the blocks in bytes (the requested size rounded up to the fundamental alignment).
+  size_t BlockSize() const { return block_size_; }
+  size_t Capacity() const { return chunks_.size() * chunk_size_; }
+
+private:
+  void AddChunk() {
+    char* chunk = static_cast<char*>(::operator new(block_size_ * chunk_size_));
+    chunks_.push_back(chunk);
+    for (size_t i = chunk_size_; i > 0; --i) { Deallocate(chunk + (i - 1) * block_size_); }
+  }
+
+  size_t block_size_;
+  size_t chunk_size_;
+  void* free_ = nullptr;
+  std::vector<void*> chunks_;
+};
+
+// Standard allocator drawing from a MemoryArena; deallocation is a no-op. A default-constructed allocator uses the
+// heap, so that containers with this allocator can be default-constructed.
+template<typename valuetype>
+struct ArenaAllocator {
+  using value_type = valuetype;
+
+  // Constructors
+  ArenaAllocator() = default;
+  ArenaAllocator(MemoryArena& arena) : arena_{ &arena } { }
+  template<typename other_valuetype> ArenaAllocator(const ArenaAllocator<other_valuetype>& other) : arena_{ other.arena_ } { }
+
+  // Operators
+  template<typename other_valuetype> bool operator==(const ArenaAllocator<other_valuetype>& other) const { return arena_ == other.arena_; }
+  template<typename other_valuetype> bool operator!=(const ArenaAllocator<other_valuetype>& other) const { return arena_ != other.arena_; }
+
+  // Allocator-specific operations
+  valuetype* allocate(size_t count) {
+    if (arena_ == nullptr) { return static_cast<valuetype*>(::operator new(count * sizeof(valuetype))); }
+    return static_cast<valuetype*>(arena_->Allocate(count * sizeof(valuetype), alignof(valuetype)));
+  }
+  void deallocate(valuetype* p, size_t) { if (arena_ == nullptr) { ::operator delete(p); } }
+
+  MemoryArena* arena_ = nullptr;
+};
+
+// Standard allocator drawing single-element and small array allocations that fit in a block from a MemoryPool, and
+// larger ones from the heap. A default-constructed allocator uses the heap.
+template<typename valuetype>
+struct PoolAllocator {
+  using value_type = valuetype;
+
+  // Constructors
+  PoolAllocator() = default;
+  PoolAllocator(MemoryPool& pool) : pool_{ &pool } { }
+  template<typename other_valuetype> PoolAllocator(const PoolAllocator<other_valuetype>& other) : pool_{ other.pool_ } { }
+
+  // Operators
+  template<typename other_valuetype> bool operator==(const PoolAllocator<other_valuetype>& other) const { return pool_ == other.pool_; }
+  template<typename other_valuetype> bool operator!=(const PoolAllocator<other_valuetype>& other) const { return pool_ != other.pool_; }
+
+  // Allocator-specific operations
+  valuetype* allocate(size_t count) {
+    if (FromPool(count)) { return static_cast<valuetype*>(pool_->Allocate()); }
+    return static_cast<valuetype*>(::operator new(count * sizeof(valuetype)));
+  }
+  void deallocate(valuetype* p, size_t count) {
+    if (FromPool(count)) { pool_->Deallocate(p); } else { ::operator delete(p); }
+  }
+
+  MemoryPool* pool_ = nullptr;
+
+private:
+  bool FromPool(size_t count) const { return pool_ != nullptr && count * sizeof(valuetype) <= pool_->BlockSize() && alignof(valuetype) <= alignof(std::max_align_t); }
+};
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_ALLOCATOR_H_
@@ -0,0 +1,124 @@
+#pragma once
+#ifndef J_MATH_MAPPED_FILE_H_
+#define J_MATH_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace j {
+namespace math {
+
+// Access to the pages of a mapped file
+enum class MapMode {
+  READ_ONLY,     // Pages are shared with the file and cannot be written
+  COPY_ON_WRITE  // Pages can be written, a written page becomes a private copy and the file is never modified
+};
+
+// A whole file mapped into memory. Pages are loaded by the operating system on first access, so files larger than the
+// available memory can be processed. Failure to open or map the file leaves the object closed (see IsOpen).
+class MappedFile {
+public:
+  // Constructors
+  MappedFile() = default;
+  MappedFile(const std::string& path, MapMode mode = MapMode::READ_ONLY) { Open(path, mode); }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) { *this = std::move(other); }
+  ~MappedFile() { Close(); }
+
+  // Operators
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&& other) {
+    if (this != &other) {
+      Close();
+      data_ = other.data_; size_ = other.size_; mode_ = other.mode_; open_ = other.open_;
+      other.data_ = nullptr; other.size_ = 0; other.open_ = false;
+    }
+    return *this;
+  }
+
+  // File-specific functions
+  // Maps the file at path, closing the previous mapping. Returns false if the file cannot be opened or mapped. An empty
+  // file opens successfully without a mapping (Data() is null).
+  bool Open(const std::string& path, MapMode mode = MapMode::READ_ONLY) {
+    Close();
+    mode_ = mode;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) { CloseHandle(file); return false; }
+    size_ = size_t(size.QuadPart);
+    if (size_ > 0) {
+      HANDLE mapping = CreateFileMappingA(file, nullptr, (mode == MapMode::READ_ONLY) ? PAGE_READONLY : PAGE_WRITECOPY, 0, 0, nullptr);
+      if (mapping != nullptr) {
+        data_ = MapViewOfFile(mapping, (mode == MapMode::READ_ONLY) ? FILE_MAP_READ : FILE_MAP_COPY, 0, 0, 0);
+        CloseHandle(mapping);
+      }
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) { return false; }
+    struct stat status;
+    if (fstat(file, &status) != 0) { ::close(file); return false; }
+    size_ = size_t(status.st_size);
+    if (size_ > 0) {
+      void* data = mmap(nullptr, size_, (mode == MapMode::READ_ONLY) ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_PRIVATE, file, 0);
+      if (data != MAP_FAILED) {
+        data_ = data;
+        madvise(data_, size_, MADV_SEQUENTIAL);
+      }
+    }
+    ::close(file);  // The mapping keeps its own reference to the file
+#endif
+    if (size_ > 0 && data_ == nullptr) { size_ = 0; return false; }
+    open_ = true;
+    return true;
+  }
+  void Close() {
+    if (data_ != nullptr) {
+#if defined(_WIN32)
+      UnmapViewOfFile(data_);
+#else
+      munmap(data_, size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+  }
+  bool IsOpen() const { return open_; }
+  bool IsWritable() const { return open_ && mode_ == MapMode::COPY_ON_WRITE; }
+  MapMode Mode() const { return mode_; }
+  const void* Data() const { return data_; }
+  // Writable only in MapMode::COPY_ON_WRITE.
+  void* Data() { return data_; }
+  // Size in bytes.
+  size_t Size() const { return size_; }
+
+private:
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  MapMode mode_ = MapMode::READ_ONLY;
+  bool open_ = false;
+};
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_MAPPED_FILE_H_
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef J_MATH_PARALLEL_H_
+#define J_MATH_PARALLEL_H_
+
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace j {
+namespace math {
+
+// Number of threads the hardware runs concurrently, at least one.
+inline size_t GetHardwareThreadCount() {
+  unsigned int count = std::thread::hardware_concurrency();
+  return (count > 0) ? size_t(count) : size_t(1);
+}
+
+namespace detail {
+
+// Joins the threads it was given when it goes out of scope, also while an exception unwinds the stack, so no thread is
+// left running (or destroyed while joinable, which terminates the program).
+class ThreadJoiner {
+public:
+  explicit ThreadJoiner(std::vector<std::thread>& threads) : threads_(threads) { }
+  ThreadJoiner(const ThreadJoiner&) = delete;
+  ~ThreadJoiner() { for (std::thread& thread : threads_) { if (thread.joinable()) { thread.join(); } } }
+  ThreadJoiner& operator=(const ThreadJoiner&) = delete;
+
+private:
+  std::vector<std::thread>& threads_;
+};
+
+} // namespace detail
+
+// Split [0, count) into at most thread_count contiguous ranges and call body(begin, end) for each of them on its own
+// thread. Range boundaries are multiples of grain so that every thread works on whole blocks. The calling thread
+// processes the last range itself. A thread_count of 0 uses all hardware threads, 1 runs body(0, count) directly.
+// If body throws, the other ranges still run to completion and the first exception is rethrown once all threads have
+// been joined; the same holds when a thread cannot be started.
+template<typename function>
+void ParallelFor(size_t count, size_t thread_count, size_t grain, function body) {
+  if (thread_count == 0) { thread_count = GetHardwareThreadCount(); }
+  if (grain == 0) { grain = 1; }
+  size_t blocks = (count + grain - 1) / grain;
+  if (thread_count > blocks) { thread_count = blocks; }
+  if (thread_count <= 1) { if (count > 0) { body(size_t(0), count); } return; }
+  size_t range = ((blocks + thread_count - 1) / thread_count) * grain;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  // Every thread gets its own copy of body, like std::thread would make.
+  auto run = [&error, &error_mutex](function range_body, size_t begin, size_t end) {
+    try {
+      range_body(begin, end);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) { error = std::current_exception(); }
+    }
+  };
+  {
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    detail::ThreadJoiner joiner(threads);
+    size_t begin = 0;
+    for (; begin + range < count; begin += range) { threads.emplace_back(run, body, begin, begin + range); }
+    run(body, begin, count);
+  }
+  if (error) { std::rethrow_exception(error); }
+}
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_PARALLEL_H_
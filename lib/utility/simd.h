@@ -0,0 +1,77 @@
+#pragma once
+#ifndef J_MATH_SIMD_H_
+#define J_MATH_SIMD_H_
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define J_MATH_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// Compile a single function for a specific instruction set. MSVC accepts the intrinsics without a compiler switch,
+// GCC and Clang need the target attribute so the rest of the program keeps running on CPUs without that extension.
+#if defined(J_MATH_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define J_MATH_TARGET_SSE2 __attribute__((target("sse2")))
+#define J_MATH_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define J_MATH_TARGET_SSE2
+#define J_MATH_TARGET_AVX2
+#endif
+
+namespace j {
+namespace math {
+
+// Instruction set used by the batch kernels. Ordered from least to most capable.
+enum class SimdLevel {
+  SCALAR,
+  SSE,
+  AVX2
+};
+
+namespace detail {
+
+// Query the CPU for the most capable instruction set the batch kernels can use.
+inline SimdLevel DetectSimdLevel() {
+#if !defined(J_MATH_SIMD_X86)
+  return SimdLevel::SCALAR;
+#elif defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  int max_leaf = info[0];
+  if (max_leaf < 1) { return SimdLevel::SCALAR; }
+  __cpuid(info, 1);
+  bool sse2 = (info[3] & (1 << 26)) != 0;
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  if (osxsave && avx && max_leaf >= 7 && (_xgetbv(0) & 0x6) == 0x6) {
+    __cpuidex(info, 7, 0);
+    if ((info[1] & (1 << 5)) != 0) { return SimdLevel::AVX2; }
+  }
+  return sse2 ? SimdLevel::SSE : SimdLevel::SCALAR;
+#else
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) { return SimdLevel::AVX2; }
+  if (__builtin_cpu_supports("sse2")) { return SimdLevel::SSE; }
+  return SimdLevel::SCALAR;
+#endif
+}
+
+inline SimdLevel& ActiveSimdLevel() { static SimdLevel level = DetectSimdLevel(); return level; }
+
+} // namespace detail
+
+// Most capable instruction set supported by the CPU running the program.
+inline SimdLevel GetSupportedSimdLevel() { static const SimdLevel level = detail::DetectSimdLevel(); return level; }
+
+// Instruction set currently selected for the batch kernels. Defaults to the supported level.
+inline SimdLevel GetSimdLevel() { return detail::ActiveSimdLevel(); }
+
+// Select the instruction set for the batch kernels (e.g. to force the scalar fallback). Capped at the supported level.
+inline void SetSimdLevel(SimdLevel level) { detail::ActiveSimdLevel() = (level < GetSupportedSimdLevel()) ? level : GetSupportedSimdLevel(); }
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SIMD_H_
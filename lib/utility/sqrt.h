@@ -0,0 +1,85 @@
+#pragma once
+#ifndef J_MATH_SQRT_H_
+#define J_MATH_SQRT_H_
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+// Detect whether the compiler can tell constant evaluation apart from run-time evaluation. Only then can Sqrt be
+// constexpr: it uses a constexpr iteration inside constant expressions and std::sqrt at run time.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define J_MATH_HAS_CONSTANT_EVALUATED
+#endif
+#endif
+#if !defined(J_MATH_HAS_CONSTANT_EVALUATED) && ((defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#define J_MATH_HAS_CONSTANT_EVALUATED
+#endif
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+#define J_MATH_SQRT_CONSTEXPR constexpr
+#else
+#define J_MATH_SQRT_CONSTEXPR inline
+#endif
+
+namespace j {
+namespace math {
+
+namespace detail {
+
+// Square root by Newton iteration, usable in constant expressions. Starts above the root and stops as soon as the
+// iteration no longer decreases, which leaves the result within one ulp of the correctly rounded root.
+template<typename valuetype>
+constexpr valuetype SqrtNewton(valuetype x) {
+  if (x != x || x < valuetype(0)) { return std::numeric_limits<valuetype>::quiet_NaN(); }
+  if (x == valuetype(0) || x == std::numeric_limits<valuetype>::infinity()) { return x; }
+  valuetype root = (x > valuetype(1)) ? x : valuetype(1);
+  while (true) {
+    valuetype next = valuetype(0.5) * (root + x / root);
+    if (!(next < root)) { return root; }
+    root = next;
+  }
+}
+
+} // namespace detail
+
+// Square root for constant expressions only, such as lookup tables built at compile time. It always runs the Newton
+// iteration, which is far slower than std::sqrt, so run-time code uses Sqrt instead.
+constexpr double ConstexprSqrt(double x) { return detail::SqrtNewton(x); }
+constexpr float ConstexprSqrt(float x) { return float(detail::SqrtNewton(double(x))); }
+constexpr long double ConstexprSqrt(long double x) { return detail::SqrtNewton(x); }
+template<typename valuetype, typename std::enable_if<std::is_integral<valuetype>::value, int>::type = 0>
+constexpr double ConstexprSqrt(valuetype x) { return ConstexprSqrt(double(x)); }
+
+// Square root that is std::sqrt at run time, so results match the rest of the library bit for bit. Where the compiler
+// can detect constant evaluation (J_MATH_HAS_CONSTANT_EVALUATED) it is constexpr as well and uses ConstexprSqrt inside
+// constant expressions; elsewhere it is a plain inline function.
+J_MATH_SQRT_CONSTEXPR double Sqrt(double x) {
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  if (__builtin_is_constant_evaluated()) { return ConstexprSqrt(x); }
+#endif
+  return std::sqrt(x);
+}
+
+J_MATH_SQRT_CONSTEXPR float Sqrt(float x) {
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  if (__builtin_is_constant_evaluated()) { return ConstexprSqrt(x); }
+#endif
+  return std::sqrt(x);
+}
+
+J_MATH_SQRT_CONSTEXPR long double Sqrt(long double x) {
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  if (__builtin_is_constant_evaluated()) { return ConstexprSqrt(x); }
+#endif
+  return std::sqrt(x);
+}
+
+// Integers are promoted to double, like std::sqrt does
+template<typename valuetype, typename std::enable_if<std::is_integral<valuetype>::value, int>::type = 0>
+J_MATH_SQRT_CONSTEXPR double Sqrt(valuetype x) { return Sqrt(double(x)); }
+
+} // namespace
+} // namespace
+
+#endif // J_MATH_SQRT_H_
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\convolution.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+// Direct evaluation of the definition, summing the taps in the same order as the library.
+template<typename valuetype>
+std::vector<valuetype> ReferenceConvolution(const std::vector<valuetype>& x, const std::vector<valuetype>& h, size_t origin, IndexType index_type) {
+  std::vector<valuetype> y(x.size());
+  ptrdiff_t n = ptrdiff_t(x.size());
+  for (ptrdiff_t i = 0; i < n; ++i) {
+    valuetype sum = valuetype(0);
+    for (size_t k = 0; k < h.size(); ++k) {
+      ptrdiff_t j = i + ptrdiff_t(origin) - ptrdiff_t(k);
+      j = (index_type == IndexType::WRAP) ? ((j % n) + n) % n : std::min(std::max(j, ptrdiff_t(0)), n - 1);
+      sum += h[k] * x[size_t(j)];
+    }
+    y[size_t(i)] = sum;
+  }
+  return y;
+}
+
+template<typename valuetype>
+bool BitwiseEqual(const std::vector<valuetype>& a, const std::vector<valuetype>& b) { return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(valuetype)) == 0); }
+
+template<typename valuetype>
+void ExpectDirectEqualToReference(size_t length, size_t taps, size_t origin, IndexType index_type) {
+  std::vector<valuetype> x = RandomValues<valuetype>(length, unsigned(length), -10., 10.), h = RandomValues<valuetype>(taps, unsigned(taps + 100), -10., 10.);
+  std::vector<valuetype> expected = ReferenceConvolution(x, h, origin, index_type);
+  ForEachSimdLevel([&](SimdLevel level) {
+    std::vector<valuetype> y(length);
+    Convolve(x.data(), length, h.data(), taps, y.data(), origin, index_type, ConvolutionMethod::DIRECT);
+    EXPECT_TRUE(BitwiseEqual(y, expected)) << "Direct convolution of " << length << " samples with " << taps << " taps (origin " << origin << ") differs on SIMD level " << int(level) << ".";
+  });
+}
+
+} // namespace
+
+//
+// ConvolutionTests
+//
+TEST(ConvolutionTests, Direct) {
+  for (IndexType index_type : { IndexType::CLAMP, IndexType::WRAP }) {
+    ExpectDirectEqualToReference<float>(1003, 7, 0, index_type);
+    ExpectDirectEqualToReference<float>(1003, 31, 15, index_type);
+    ExpectDirectEqualToReference<float>(200, 100, 99, index_type);
+    ExpectDirectEqualToReference<double>(517, 9, 4, index_type);
+    ExpectDirectEqualToReference<double>(5, 12, 6, index_type);
+    ExpectDirectEqualToReference<int>(300, 5, 2, index_type);
+  }
+}
+
+TEST(ConvolutionTests, Fft) {
+  for (IndexType index_type : { IndexType::CLAMP, IndexType::WRAP }) {
+    for (size_t taps : { 1, 64, 129, 700 }) {
+      std::vector<double> x = RandomValues<double>(5000, 1, -10., 10.), h = RandomValues<double>(taps, 2, -10., 10.), y(x.size());
+      std::vector<double> expected = ReferenceConvolution(x, h, taps / 2, index_type);
+      Convolve(x.data(), x.size(), h.data(), taps, y.data(), taps / 2, index_type, ConvolutionMethod::FFT);
+      for (size_t i = 0; i < y.size(); ++i) { ASSERT_NEAR(y[i], expected[i], 1e-10 * double(taps)) << "FFT convolution with " << taps << " taps differs at " << i << "."; }
+    }
+  }
+}
+
+TEST(ConvolutionTests, Sequence) {
+  seq1f sequence(std::vector<float>{ 1.f, 2.f, 3.f, 4.f });
+  seq1f smoothed = Convolve(sequence, seq1f(std::vector<float>{ 0.25f, 0.5f, 0.25f }), 1);
+  EXPECT_TRUE(smoothed == seq1f(std::vector<float>{ 1.25f, 2.f, 3.f, 3.75f })) << "Wrong centered convolution with clamped ends.";
+  seq1f wrapped = Convolve(sequence, seq1f(std::vector<float>{ 0.f, 1.f }), 0, IndexType::WRAP);
+  EXPECT_TRUE(wrapped == seq1f(std::vector<float>{ 4.f, 1.f, 2.f, 3.f })) << "Wrong delay with wrapped ends.";
+  seq1i integers(std::vector<int>{ 1, 2, 3, 4 });
+  std::vector<int> long_kernel(kFftConvolutionThreshold, 0);
+  long_kernel[0] = 2;
+  EXPECT_TRUE(Convolve(integers, seq1i(long_kernel)) == seq1i(std::vector<int>{ 2, 4, 6, 8 })) << "Integral values not convolved exactly.";
+  std::vector<float> long_float(kFftConvolutionThreshold, 0.f);
+  long_float[1] = 1.f;
+  seq1f delayed = Convolve(sequence, seq1f(long_float));
+  for (size_t i = 0; i < 4; ++i) { EXPECT_NEAR(delayed(i), sequence((i > 0) ? i - 1 : 0), 1e-5f) << "Wrong automatic convolution with a long kernel."; }
+  EXPECT_EQ(Convolve(seq1f(), seq1f(std::vector<float>{ 1.f })).Length(), 0u) << "Convolution of an empty sequence not empty.";
+}
+
+//
+// FirFilterTests
+//
+TEST(FirFilterTests, Chunks) {
+  for (ConvolutionMethod method : { ConvolutionMethod::DIRECT, ConvolutionMethod::FFT }) {
+    std::vector<double> x = RandomValues<double>(3000, 3, -10., 10.), h = RandomValues<double>(150, 4, -10., 10.);
+    // Zeros before the first sample
+    std::vector<double> padded(h.size() - 1, 0.);
+    padded.insert(padded.end(), x.begin(), x.end());
+    std::vector<double> expected = ReferenceConvolution(padded, h, 0, IndexType::CLAMP);
+    expected.erase(expected.begin(), expected.begin() + ptrdiff_t(h.size() - 1));
+    FirFilter<double> filter(h, method);
+    std::vector<double> y(x.size());
+    size_t begin = 0;
+    for (size_t chunk : { 1, 7, 100, 149, 150, 1000, 1593 }) {
+      filter.Process(x.data() + begin, y.data() + begin, chunk);
+      begin += chunk;
+    }
+    ASSERT_EQ(begin, x.size());
+    for (size_t i = 0; i < y.size(); ++i) { ASSERT_NEAR(y[i], expected[i], 1e-9) << "Chunked filtering differs at " << i << "."; }
+  }
+}
+
+TEST(FirFilterTests, InPlaceAndReset) {
+  FirFilter<float> filter(std::vector<float>{ 0.5f, 0.5f });
+  std::vector<float> data{ 2.f, 4.f, 6.f };
+  filter.Process(data.data(), data.data(), data.size());
+  EXPECT_TRUE(data == std::vector<float>({ 1.f, 3.f, 5.f })) << "Wrong in-place filtering.";
+  seq1f next = filter.Process(seq1f(std::vector<float>{ 8.f }));
+  EXPECT_EQ(next(0), 7.f) << "History not kept between chunks.";
+  filter.Reset();
+  EXPECT_EQ(filter.Process(seq1f(std::vector<float>{ 8.f }))(0), 4.f) << "History not cleared by Reset.";
+  EXPECT_EQ(filter.Taps(), 2u) << "Wrong number of taps.";
+}
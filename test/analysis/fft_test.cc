@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\fft.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<std::complex<double>> RandomComplex(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(-1., 1.);
+  std::vector<std::complex<double>> values;
+  for (size_t i = 0; i < count; ++i) { values.push_back(std::complex<double>(distribution(generator), distribution(generator))); }
+  return values;
+}
+
+std::vector<std::complex<double>> NaiveDft(const std::vector<std::complex<double>>& x) {
+  std::vector<std::complex<double>> result(x.size());
+  for (size_t k = 0; k < x.size(); ++k) {
+    std::complex<long double> sum = 0;
+    for (size_t j = 0; j < x.size(); ++j) {
+      long double angle = -2.L * PI * (long double)((j * k) % x.size()) / (long double)(x.size());
+      sum += std::complex<long double>(x[j]) * std::complex<long double>(std::cos(angle), std::sin(angle));
+    }
+    result[k] = std::complex<double>(sum);
+  }
+  return result;
+}
+
+double MaxDifference(const std::complex<double>* a, const std::complex<double>* b, size_t count) {
+  double difference = 0.;
+  for (size_t i = 0; i < count; ++i) { difference = std::max(difference, std::abs(a[i] - b[i])); }
+  return difference;
+}
+
+// 61 is the largest prime below kBluesteinThreshold, 67, 97, 202 (2 * 101) and 1009 use Bluestein's algorithm.
+const size_t kSizes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 30, 60, 61, 64, 67, 97, 100, 128, 202, 210, 243, 256, 1000, 1009, 1024 };
+
+} // namespace
+
+//
+// FftTests
+//
+TEST(FftTests, NaiveDft) {
+  for (size_t size : kSizes) {
+    std::vector<std::complex<double>> x = RandomComplex(size, unsigned(size)), result(size);
+    FftPlan<double>(size).Forward(x.data(), result.data());
+    EXPECT_LT(MaxDifference(result.data(), NaiveDft(x).data(), size), 1e-12 * double(size)) << "Transform of size " << size << " differs from the DFT.";
+  }
+}
+
+TEST(FftTests, Inverse) {
+  for (size_t size : kSizes) {
+    std::vector<std::complex<double>> x = RandomComplex(size, unsigned(size)), data = x;
+    FftPlan<double> plan(size);
+    plan.Forward(data.data());
+    plan.Inverse(data.data());
+    EXPECT_LT(MaxDifference(data.data(), x.data(), size), 1e-13 * double(size)) << "Inverse of size " << size << " does not restore the input.";
+  }
+}
+
+TEST(FftTests, Float) {
+  std::vector<std::complex<double>> x = RandomComplex(360, 1);
+  std::vector<std::complex<float>> xf(x.begin(), x.end()), result(x.size());
+  FftPlan<float>(x.size()).Forward(xf.data(), result.data());
+  std::vector<std::complex<double>> expected = NaiveDft(x), converted(result.begin(), result.end());
+  EXPECT_LT(MaxDifference(converted.data(), expected.data(), x.size()), 1e-4) << "Single precision transform inaccurate.";
+}
+
+TEST(FftTests, RealInput) {
+  for (size_t size : kSizes) {
+    std::vector<std::complex<double>> x = RandomComplex(size, unsigned(size));
+    std::vector<double> real;
+    for (std::complex<double>& v : x) { v = std::complex<double>(v.real(), 0.); real.push_back(v.real()); }
+    RealFftPlan<double> plan(size);
+    std::vector<std::complex<double>> spectrum(plan.SpectrumSize());
+    plan.Forward(real.data(), spectrum.data());
+    EXPECT_LT(MaxDifference(spectrum.data(), NaiveDft(x).data(), spectrum.size()), 1e-12 * double(size)) << "Real transform of size " << size << " differs from the DFT.";
+    std::vector<double> restored(size);
+    plan.Inverse(spectrum.data(), restored.data());
+    double difference = 0.;
+    for (size_t i = 0; i < size; ++i) { difference = std::max(difference, std::abs(restored[i] - real[i])); }
+    EXPECT_LT(difference, 1e-13 * double(size)) << "Real inverse of size " << size << " does not restore the input.";
+  }
+}
+
+TEST(FftTests, PlanCache) {
+  EXPECT_EQ(GetFftPlan<float>(480).get(), GetFftPlan<float>(480).get()) << "Plan not reused.";
+  EXPECT_NE(GetFftPlan<float>(480).get(), GetFftPlan<float>(512).get()) << "Plans of different sizes shared.";
+  EXPECT_EQ(GetRealFftPlan<double>(480)->Size(), 480u) << "Wrong size of cached real plan.";
+}
+
+TEST(FftTests, PlanCacheBounded) {
+  ClearFftPlanCache<double>();
+  std::shared_ptr<const FftPlan<double>> first = GetFftPlan<double>(1);
+  for (size_t size = 2; size <= 2 * kFftPlanCacheSize; ++size) { GetFftPlan<double>(size); }
+  EXPECT_EQ(detail::FftPlanCache<FftPlan<double>>::Instance().Size(), kFftPlanCacheSize) << "Plan cache grows beyond its capacity.";
+  EXPECT_NE(GetFftPlan<double>(1).get(), first.get()) << "Least recently used plan not evicted.";
+  EXPECT_EQ(first->Size(), 1u) << "Evicted plan no longer valid for its holder.";
+  std::shared_ptr<const FftPlan<double>> recent = GetFftPlan<double>(2 * kFftPlanCacheSize);
+  EXPECT_EQ(GetFftPlan<double>(2 * kFftPlanCacheSize).get(), recent.get()) << "Recently used plan evicted.";
+  ClearFftPlanCache<double>();
+  EXPECT_EQ(detail::FftPlanCache<FftPlan<double>>::Instance().Size(), 0u) << "Plan cache not cleared.";
+}
+
+TEST(FftTests, Sequence) {
+  std::vector<std::complex<double>> x = RandomComplex(96, 2);
+  Sequence1D<std::complex<double>> sequence(x);
+  Fft(sequence);
+  std::vector<std::complex<double>> expected = NaiveDft(x);
+  EXPECT_LT(MaxDifference(sequence.Ptr(), expected.data(), x.size()), 1e-12) << "In-place transform of a sequence differs from the DFT.";
+  InverseFft(sequence);
+  EXPECT_LT(MaxDifference(sequence.Ptr(), x.data(), x.size()), 1e-14) << "In-place inverse does not restore the sequence.";
+
+  seq1f signal;
+  for (size_t i = 0; i < 64; ++i) { signal.Add(std::cos(2.f * float(PI) * 5.f * float(i) / 64.f)); }
+  Sequence1D<std::complex<float>> spectrum = RealFft(signal);
+  EXPECT_EQ(spectrum.Length(), 33u) << "Wrong number of bins.";
+  EXPECT_NEAR(std::abs(spectrum(5)), 32.f, 1e-4f) << "Cosine not found in its bin.";
+  EXPECT_NEAR(std::abs(spectrum(6)), 0.f, 1e-4f) << "Energy leaked into another bin.";
+  seq1f restored = InverseRealFft(spectrum, 64);
+  for (size_t i = 0; i < 64; ++i) { EXPECT_NEAR(restored(i), signal(i), 1e-5f) << "Real inverse does not restore the sequence."; }
+}
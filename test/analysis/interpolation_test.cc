@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\interpolation.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+template<typename valuetype>
+Sequence1D<valuetype> RandomSequence(size_t length, unsigned int seed) {
+  return Sequence1D<valuetype>(RandomValues<valuetype>(length, seed));
+}
+
+// Positions inside the sequence, including both ends, half-way points and a count that is not a multiple of any SIMD
+// width.
+std::vector<float> InsidePositions(size_t length, unsigned int seed) {
+  std::vector<float> positions{ 0.f, float(length - 1), 0.5f, 1.5f, float(length) - 1.5f };
+  std::vector<float> random = RandomValues<float>(1001, seed, 0., double(length - 1));
+  positions.insert(positions.end(), random.begin(), random.end());
+  return positions;
+}
+
+template<typename valuetype>
+bool BitwiseEqual(valuetype a, valuetype b) { return std::memcmp(&a, &b, sizeof(valuetype)) == 0; }
+
+// Batch resampling equals the single-position functions at every position inside the sequence.
+template<typename valuetype>
+void ExpectEqualToSingle(const Sequence1D<valuetype>& sequence, const std::vector<float>& positions) {
+  ForEachSimdLevel([&](SimdLevel level) {
+    Sequence1D<valuetype> nearest = Interpolation::NearestNeighborResample(sequence, positions);
+    Sequence1D<valuetype> linear = Interpolation::LinearResample(sequence, positions);
+    ASSERT_EQ(linear.Length(), positions.size()) << "Wrong resampled length.";
+    for (size_t i = 0; i < positions.size(); ++i) {
+      EXPECT_TRUE(BitwiseEqual(nearest(i), Interpolation::NearestNeighborInterpolation(sequence, positions[i]))) << "Nearest neighbor differs at " << positions[i] << " on SIMD level " << int(level) << ".";
+      EXPECT_TRUE(BitwiseEqual(linear(i), Interpolation::LinearInterpolation(sequence, positions[i]))) << "Linear interpolation differs at " << positions[i] << " on SIMD level " << int(level) << ".";
+    }
+  });
+}
+
+} // namespace
+
+//
+// InterpolationTests
+//
+TEST(InterpolationTests, Single) {
+  seq1f sequence(std::vector<float>{ 1.f, 3.f, -1.f });
+  EXPECT_EQ(Interpolation::NearestNeighborInterpolation(sequence, 0.6f), 3.f) << "Wrong nearest neighbor.";
+  EXPECT_EQ(Interpolation::NearestNeighborInterpolation(sequence, 1.5f), -1.f) << "Half-way point not rounded up.";
+  EXPECT_EQ(Interpolation::LinearInterpolation(sequence, 0.25f), 1.5f) << "Wrong linear interpolation.";
+  EXPECT_EQ(Interpolation::LinearInterpolation(sequence, 2.f), -1.f) << "Wrong linear interpolation at the last sample.";
+}
+
+//
+// ResampleTests
+//
+TEST(ResampleTests, EqualToSingle) {
+  ExpectEqualToSingle(RandomSequence<float>(1000, 1), InsidePositions(1000, 2));
+  ExpectEqualToSingle(RandomSequence<double>(1000, 3), InsidePositions(1000, 4));
+  ExpectEqualToSingle(RandomSequence<int>(1000, 5), InsidePositions(1000, 6));
+  ExpectEqualToSingle(RandomSequence<float>(1, 7), std::vector<float>(9, 0.f));
+}
+
+TEST(ResampleTests, Clamp) {
+  seq1f sequence(std::vector<float>{ 1.f, 3.f, -1.f, 5.f });
+  std::vector<float> positions{ -2.f, -0.4f, 3.f, 3.5f, 100.f, std::numeric_limits<float>::quiet_NaN(), 2.5f, 1e30f, -1e30f };
+  ForEachSimdLevel([&](SimdLevel level) {
+    seq1f nearest = Interpolation::NearestNeighborResample(sequence, positions);
+    seq1f linear = Interpolation::LinearResample(sequence, positions);
+    EXPECT_TRUE(nearest == seq1f(std::vector<float>{ 1.f, 1.f, 5.f, 5.f, 5.f, 1.f, 5.f, 5.f, 1.f })) << "Wrong clamped nearest neighbors on SIMD level " << int(level) << ".";
+    EXPECT_TRUE(linear == seq1f(std::vector<float>{ 1.f, 1.f, 5.f, 5.f, 5.f, 1.f, 2.f, 5.f, 1.f })) << "Wrong clamped linear interpolation on SIMD level " << int(level) << ".";
+  });
+}
+
+TEST(ResampleTests, Wrap) {
+  seq1f sequence(std::vector<float>{ 1.f, 3.f, -1.f, 5.f });
+  std::vector<float> positions{ 3.5f, 4.f, 4.25f, -0.5f, -4.f, 9.75f, std::numeric_limits<float>::quiet_NaN(), 3.75f, -1.f };
+  ForEachSimdLevel([&](SimdLevel level) {
+    seq1f nearest = Interpolation::NearestNeighborResample(sequence, positions, IndexType::WRAP);
+    seq1f linear = Interpolation::LinearResample(sequence, positions, IndexType::WRAP);
+    EXPECT_TRUE(nearest == seq1f(std::vector<float>{ 1.f, 1.f, 1.f, 1.f, 1.f, -1.f, 1.f, 1.f, 5.f })) << "Wrong wrapped nearest neighbors on SIMD level " << int(level) << ".";
+    EXPECT_TRUE(linear == seq1f(std::vector<float>{ 3.f, 1.f, 1.5f, 3.f, 1.f, 0.f, 1.f, 2.f, 5.f })) << "Wrong wrapped linear interpolation on SIMD level " << int(level) << ".";
+  });
+}
+
+TEST(ResampleTests, WrapLargePositions) {
+  // Quotients beyond the 32-bit integer range, where floor may not go through a conversion to int.
+  seq1f sequence(std::vector<float>{ 1.f, 3.f, -1.f });
+  const float infinity = std::numeric_limits<float>::infinity();
+  std::vector<float> positions{ 1e10f, -1e10f, 3e9f, -6442450944.f, 2147483648.f, 1e20f, -3e38f, 25165827.f, 12582913.f, -12582914.5f, infinity, -infinity };
+  SimdLevel original = GetSimdLevel();
+  SetSimdLevel(SimdLevel::SCALAR);
+  seq1f expected_nearest = Interpolation::NearestNeighborResample(sequence, positions, IndexType::WRAP);
+  seq1f expected_linear = Interpolation::LinearResample(sequence, positions, IndexType::WRAP);
+  SetSimdLevel(original);
+  for (size_t i = 0; i < positions.size(); ++i) {
+    EXPECT_TRUE(expected_nearest(i) == 1.f || expected_nearest(i) == 3.f || expected_nearest(i) == -1.f) << "Wrapped position " << positions[i] << " outside the sequence.";
+  }
+  ForEachSimdLevel([&](SimdLevel level) {
+    seq1f nearest = Interpolation::NearestNeighborResample(sequence, positions, IndexType::WRAP);
+    seq1f linear = Interpolation::LinearResample(sequence, positions, IndexType::WRAP);
+    for (size_t i = 0; i < positions.size(); ++i) {
+      EXPECT_TRUE(BitwiseEqual(nearest(i), expected_nearest(i))) << "Wrapped nearest neighbor at " << positions[i] << " differs on SIMD level " << int(level) << ".";
+      EXPECT_TRUE(BitwiseEqual(linear(i), expected_linear(i))) << "Wrapped linear interpolation at " << positions[i] << " differs on SIMD level " << int(level) << ".";
+    }
+  });
+}
+
+TEST(ResampleTests, Uniform) {
+  seq1d sequence = RandomSequence<double>(777, 8);
+  std::vector<float> positions;
+  for (size_t i = 0; i < 1500; ++i) { positions.push_back(float(2.25 + double(i) * 0.5)); }
+  EXPECT_TRUE(Interpolation::LinearResampleUniform(sequence, 2.25, 0.5, positions.size()) == Interpolation::LinearResample(sequence, positions)) << "Uniform linear resampling differs from explicit positions.";
+  EXPECT_TRUE(Interpolation::NearestNeighborResampleUniform(sequence, 2.25, 0.5, positions.size(), IndexType::WRAP) == Interpolation::NearestNeighborResample(sequence, positions, IndexType::WRAP)) << "Uniform nearest neighbor resampling differs from explicit positions.";
+}
+
+TEST(ResampleTests, Ratio) {
+  seq1f sequence(std::vector<float>{ 0.f, 2.f, 4.f, 6.f, 8.f });
+  EXPECT_TRUE(Interpolation::LinearResampleRatio(sequence, 2.) == seq1f(std::vector<float>{ 0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f })) << "Wrong upsampling.";
+  EXPECT_TRUE(Interpolation::NearestNeighborResampleRatio(sequence, 0.5) == seq1f(std::vector<float>{ 0.f, 4.f, 8.f })) << "Wrong downsampling.";
+  EXPECT_EQ(Interpolation::LinearResampleRatio(sequence, 0.3).Length(), 2u) << "Wrong resampled length.";
+  EXPECT_EQ(Interpolation::LinearResampleRatio(seq1f(), 2.).Length(), 0u) << "Resampling an empty sequence is not empty.";
+  EXPECT_EQ(Interpolation::LinearResample(seq1f(), std::vector<float>(3, 1.f)), seq1f(std::vector<float>(3, 0.f))) << "Resampling an empty sequence does not give zeros.";
+}
+
+//
+// KernelInterpolationTests
+//
+TEST(KernelInterpolationTests, Samples) {
+  seq1d sequence = RandomSequence<double>(50, 9);
+  for (size_t i = 0; i < sequence.Length(); ++i) {
+    EXPECT_EQ(Interpolation::CubicInterpolation(sequence, float(i)), sequence(i)) << "Catmull-Rom does not pass through sample " << i << ".";
+    EXPECT_EQ(Interpolation::LanczosInterpolation(sequence, float(i)), sequence(i)) << "Lanczos does not pass through sample " << i << ".";
+  }
+  EXPECT_NEAR(Interpolation::CubicBSplineInterpolation(seq1d(std::vector<double>{ 0., 0., 6., 0., 0. }), 2.f), 4., 1e-12) << "Wrong B-spline smoothing.";
+}
+
+TEST(KernelInterpolationTests, Polynomials) {
+  std::vector<double> line, parabola;
+  for (size_t i = 0; i < 20; ++i) { line.push_back(3. * double(i) - 7.); parabola.push_back(double(i) * double(i)); }
+  for (float x = 2.f; x < 17.f; x += 0.3f) {
+    EXPECT_NEAR(Interpolation::CubicInterpolation(seq1d(line), x), 3. * x - 7., 1e-9) << "Catmull-Rom does not reproduce a line.";
+    EXPECT_NEAR(Interpolation::CubicBSplineInterpolation(seq1d(line), x), 3. * x - 7., 1e-9) << "B-spline does not reproduce a line.";
+    EXPECT_NEAR(Interpolation::CubicInterpolation(seq1d(parabola), x), double(x) * x, 0.13) << "Catmull-Rom far from a parabola.";
+    EXPECT_NEAR(Interpolation::LanczosInterpolation(seq1d(std::vector<double>(20, 2.5)), x, 4), 2.5, 1e-12) << "Lanczos does not reproduce a constant.";
+  }
+}
+
+TEST(KernelInterpolationTests, Sine) {
+  std::vector<double> samples;
+  for (size_t i = 0; i < 64; ++i) { samples.push_back(std::sin(0.3 * double(i))); }
+  seq1d sequence(samples);
+  double linear_error = 0., cubic_error = 0., lanczos_error = 0.;
+  for (float x = 8.f; x < 56.f; x += 0.37f) {
+    double expected = std::sin(0.3 * double(x));
+    linear_error = std::max(linear_error, std::abs(Interpolation::LinearInterpolation(sequence, x) - expected));
+    cubic_error = std::max(cubic_error, std::abs(Interpolation::CubicInterpolation(sequence, x) - expected));
+    lanczos_error = std::max(lanczos_error, std::abs(Interpolation::LanczosInterpolation(sequence, x, 8) - expected));
+  }
+  EXPECT_LT(cubic_error, linear_error) << "Catmull-Rom less accurate than linear interpolation.";
+  EXPECT_LT(lanczos_error, linear_error) << "Lanczos less accurate than linear interpolation.";
+}
+
+TEST(KernelInterpolationTests, Boundaries) {
+  seq1f sequence(std::vector<float>{ 1.f, 3.f, -1.f, 5.f, 2.f });
+  std::vector<float> positions{ -3.f, 0.25f, 4.f, 7.f, 4.5f };
+  seq1f clamped = Interpolation::KernelResample(sequence, positions, InterpolationKernel::CATMULL_ROM);
+  EXPECT_EQ(clamped(0), 1.f) << "Position before the sequence not clamped.";
+  EXPECT_EQ(clamped(1), 1.5f) << "Wrong Catmull-Rom interpolation with clamped taps.";
+  EXPECT_EQ(clamped(1), Interpolation::CubicInterpolation(sequence, 0.25f)) << "Batch differs from the single-position function.";
+  EXPECT_EQ(clamped(3), 2.f) << "Position after the sequence not clamped.";
+  seq1f wrapped = Interpolation::KernelResample(sequence, positions, InterpolationKernel::CATMULL_ROM, IndexType::WRAP);
+  seq1f periodic = Interpolation::KernelResample(seq1f(std::vector<float>{ 5.f, 2.f, 1.f, 3.f, -1.f, 5.f, 2.f, 1.f, 3.f }), std::vector<float>{ 6.5f }, InterpolationKernel::CATMULL_ROM);
+  EXPECT_EQ(wrapped(2), 2.f) << "Wrong wrapped sample.";
+  EXPECT_EQ(wrapped(3), -1.f) << "Position after the sequence not wrapped.";
+  EXPECT_FLOAT_EQ(wrapped(4), periodic(0)) << "Taps beyond the end not wrapped.";
+  seq1i integers(std::vector<int>{ 0, 10, 20, 30 });
+  EXPECT_EQ(Interpolation::LanczosInterpolation(integers, 1.5f), 15) << "Integer interpolation not rounded.";
+}
+
+TEST(KernelInterpolationTests, Table) {
+  seq1d sequence = RandomSequence<double>(300, 10);
+  std::vector<float> exact, between;
+  for (size_t i = 0; i < 1196; ++i) { exact.push_back(float(i) * 0.25f); between.push_back(float(i) * 0.25f + 0.01f); }
+  for (InterpolationKernel kernel : { InterpolationKernel::CATMULL_ROM, InterpolationKernel::CUBIC_B_SPLINE, InterpolationKernel::LANCZOS }) {
+    InterpolationTable table(kernel, 4);
+    EXPECT_TRUE(Interpolation::KernelResample(sequence, exact, table) == Interpolation::KernelResample(sequence, exact, kernel)) << "Table differs from the kernel at its phases.";
+    EXPECT_TRUE(Interpolation::KernelResample(sequence, between, table) == Interpolation::KernelResample(sequence, exact, kernel)) << "Positions not rounded to the nearest phase.";
+    InterpolationTable fine(kernel, 1024);
+    seq1d approximated = Interpolation::KernelResample(sequence, between, fine), evaluated = Interpolation::KernelResample(sequence, between, kernel);
+    for (size_t i = 0; i < between.size(); ++i) { EXPECT_NEAR(approximated(i), evaluated(i), 0.5) << "Fine table far from the kernel."; }
+  }
+}
+
+TEST(KernelInterpolationTests, Rational) {
+  seq1f sequence = RandomSequence<float>(101, 11);
+  InterpolationTable table(InterpolationKernel::LANCZOS, 4);
+  seq1f resampled = Interpolation::KernelResampleRational(sequence, table, 3);
+  std::vector<float> positions;
+  for (size_t i = 0; i * 3 <= 100 * 4; ++i) { positions.push_back(float(i) * 0.75f); }
+  EXPECT_EQ(resampled.Length(), positions.size()) << "Wrong rational resampled length.";
+  EXPECT_TRUE(resampled == Interpolation::KernelResample(sequence, positions, InterpolationKernel::LANCZOS)) << "Polyphase resampling differs from evaluating the kernel.";
+  EXPECT_TRUE(Interpolation::KernelResampleRational(sequence, InterpolationTable(InterpolationKernel::CATMULL_ROM, 1), 1) == sequence) << "Resampling by 1 changed the sequence.";
+  seq1f wrapped = Interpolation::KernelResampleRational(sequence, table, 3, IndexType::WRAP);
+  EXPECT_TRUE(wrapped(0) == resampled(0)) << "Wrong first wrapped sample.";
+}
+
+//
+// GridInterpolationTests
+//
+TEST(GridInterpolationTests, Bilinear) {
+  // f(x, y) = 1 + 2x + 3y + xy is reproduced exactly by bilinear interpolation.
+  for (GridLayout layout : { GridLayout::ROW_MAJOR, GridLayout::TILED, GridLayout::MORTON }) {
+    seq2d grid(20, 18, layout);
+    for (size_t y = 0; y < 18; ++y) { for (size_t x = 0; x < 20; ++x) { grid.Set(x, y, 1. + 2. * double(x) + 3. * double(y) + double(x * y)); } }
+    for (float x : { 0.f, 0.25f, 7.5f, 18.9f, 19.f }) {
+      for (float y : { 0.f, 3.75f, 16.5f, 17.f }) {
+        EXPECT_NEAR(Interpolation::BilinearInterpolation(grid, x, y), 1. + 2. * x + 3. * y + double(x) * double(y), 1e-4) << "Wrong bilinear interpolation at (" << x << ", " << y << ").";
+      }
+    }
+    EXPECT_EQ(Interpolation::BilinearInterpolation(grid, -5.f, 100.f), grid(0, 17)) << "Position not clamped.";
+    EXPECT_EQ(Interpolation::NearestNeighborInterpolation(grid, 2.5f, 3.4f), grid(3, 3)) << "Wrong nearest neighbor.";
+  }
+  seq2f wrapped(2, 2, std::vector<float>{ 0.f, 1.f, 2.f, 3.f });
+  EXPECT_EQ(Interpolation::BilinearInterpolation(wrapped, 1.5f, 0.f, IndexType::WRAP), 0.5f) << "Wrong wrapped interpolation between the last and first column.";
+  EXPECT_EQ(Interpolation::BilinearInterpolation(wrapped, -0.5f, -1.f, IndexType::WRAP), 2.5f) << "Negative position not wrapped.";
+  EXPECT_EQ(Interpolation::NearestNeighborInterpolation(wrapped, -1.f, 1.6f, IndexType::WRAP), 1.f) << "Wrong wrapped nearest neighbor.";
+}
+
+TEST(GridInterpolationTests, Trilinear) {
+  seq3f grid(5, 6, 7, GridLayout::MORTON);
+  for (size_t z = 0; z < 7; ++z) { for (size_t y = 0; y < 6; ++y) { for (size_t x = 0; x < 5; ++x) { grid.Set(x, y, z, float(x + 10 * y + 100 * z)); } } }
+  EXPECT_NEAR(Interpolation::TrilinearInterpolation(grid, 1.5f, 2.25f, 3.75f), 1.5f + 22.5f + 375.f, 1e-3f) << "Wrong trilinear interpolation.";
+  EXPECT_EQ(Interpolation::TrilinearInterpolation(grid, 4.f, 5.f, 6.f), 654.f) << "Wrong interpolation at the last sample.";
+  EXPECT_EQ(Interpolation::NearestNeighborInterpolation(grid, 0.6f, 0.4f, 9.f), 601.f) << "Wrong nearest neighbor.";
+}
+
+TEST(GridInterpolationTests, Resize) {
+  seq2f image(3, 2, std::vector<float>{ 0.f, 2.f, 4.f, 6.f, 8.f, 10.f }, GridLayout::TILED);
+  seq2f resized = Interpolation::BilinearResize(image, 5, 3);
+  EXPECT_EQ(resized.Layout(), GridLayout::TILED) << "Layout not kept.";
+  EXPECT_TRUE(resized == seq2f(5, 3, std::vector<float>{ 0.f, 1.f, 2.f, 3.f, 4.f, 3.f, 4.f, 5.f, 6.f, 7.f, 6.f, 7.f, 8.f, 9.f, 10.f })) << "Wrong bilinear resize.";
+  EXPECT_TRUE(Interpolation::BilinearResize(image, 3, 2) == image) << "Resizing to the same size changed the image.";
+  seq1d values = RandomSequence<double>(64, 5);
+  seq3d volume(4, 4, 4, std::vector<double>(values.Ptr(), values.Ptr() + 64));
+  seq3d halved = Interpolation::TrilinearResize(volume, 2, 2, 2);
+  EXPECT_EQ(halved(1, 1, 1), volume(3, 3, 3)) << "Corner not kept by the trilinear resize.";
+  EXPECT_NEAR(Interpolation::TrilinearResize(volume, 7, 7, 7)(1, 3, 5), Interpolation::TrilinearInterpolation(volume, 0.5f, 1.5f, 2.5f), 1e-12) << "Resize differs from the interpolation.";
+}
@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\mapped_sequence.h"
+
+using namespace j::math;
+
+namespace {
+
+const char* kTestFile = "mapped_sequence_test.bin";
+
+// Write the values (optionally preceded by a header) to kTestFile as raw bytes.
+template<typename valuetype>
+void WriteTestFile(const std::vector<valuetype>& values, const std::string& header = "") {
+  std::ofstream file(kTestFile, std::ios::binary | std::ios::trunc);
+  file.write(header.data(), std::streamsize(header.size()));
+  if (!values.empty()) { file.write(reinterpret_cast<const char*>(values.data()), std::streamsize(values.size() * sizeof(valuetype))); }
+}
+
+std::vector<double> TestValues(size_t count) {
+  std::vector<double> values;
+  for (size_t i = 0; i < count; ++i) { values.push_back(double(i % 97) * 0.5 - 10.); }
+  return values;
+}
+
+} // namespace
+
+//
+// MappedFileTests
+//
+TEST(MappedFileTests, Open) {
+  WriteTestFile(std::vector<int>{ 1, 2, 3 });
+  MappedFile file(kTestFile);
+  EXPECT_TRUE(file.IsOpen()) << "Existing file could not be mapped.";
+  EXPECT_EQ(file.Size(), 3 * sizeof(int)) << "Wrong size of mapped file.";
+  EXPECT_FALSE(file.IsWritable()) << "Read-only mapping is writable.";
+  MappedFile moved(std::move(file));
+  EXPECT_TRUE(moved.IsOpen() && !file.IsOpen()) << "Move did not transfer the mapping.";
+  EXPECT_FALSE(MappedFile("does_not_exist.bin").IsOpen()) << "Missing file reported as open.";
+  std::remove(kTestFile);
+}
+
+//
+// MappedSequence1DTests
+//
+TEST(MappedSequence1DTests, Access) {
+  std::vector<double> values = TestValues(1001);
+  WriteTestFile(values);
+  {
+    mseq1d sequence(kTestFile);
+    ASSERT_TRUE(sequence.IsOpen()) << "Sequence file could not be mapped.";
+    EXPECT_EQ(sequence.Length(), values.size()) << "Wrong length of mapped sequence.";
+    EXPECT_EQ(sequence.Get(10), values[10]) << "Wrong mapped element.";
+    EXPECT_EQ(sequence(5000), values.back()) << "Mapped index not clamped.";
+    EXPECT_EQ(sequence.Get(1003, IndexType::WRAP), values[2]) << "Mapped index not wrapped.";
+    EXPECT_EQ(sequence.Ptr()[500], values[500]) << "Wrong element through pointer access.";
+    EXPECT_TRUE(seq1d(sequence) == seq1d(values)) << "Copy of mapped sequence differs from the file contents.";
+  }
+  std::remove(kTestFile);
+}
+
+TEST(MappedSequence1DTests, Reductions) {
+  std::vector<double> values = TestValues(100003);
+  WriteTestFile(values);
+  {
+    mseq1d mapped(kTestFile);
+    seq1d sequence(values);
+    EXPECT_EQ(mapped.Sum(), sequence.Sum()) << "Mapped sum differs from in-memory sum.";
+    EXPECT_EQ(mapped.SumOfSquares(SummationPolicy::KAHAN), sequence.SumOfSquares(SummationPolicy::KAHAN)) << "Mapped sum of squares differs from in-memory sum of squares.";
+    EXPECT_EQ(mapped.Average(), sequence.Average()) << "Mapped average differs from in-memory average.";
+    SequenceStatistics<double> statistics = mapped.Statistics(2);
+    EXPECT_EQ(statistics.Variance(), sequence.Statistics().Variance()) << "Mapped variance differs from in-memory variance.";
+    EXPECT_EQ(statistics.argmax_, 96u) << "Wrong mapped maximum.";
+  }
+  std::remove(kTestFile);
+}
+
+TEST(MappedSequence1DTests, CopyOnWrite) {
+  WriteTestFile(std::vector<float>{ 1.f, 2.f, 3.f });
+  {
+    mseq1f sequence(kTestFile, MapMode::COPY_ON_WRITE);
+    ASSERT_TRUE(sequence.IsOpen()) << "Sequence file could not be mapped copy-on-write.";
+    EXPECT_TRUE(sequence.Set(1, 20.f)) << "Copy-on-write element not set.";
+    EXPECT_EQ(sequence.Get(1), 20.f) << "Copy-on-write element not modified.";
+    EXPECT_EQ(sequence.Sum(), 24.f) << "Reduction does not see the modified element.";
+    mseq1f original(kTestFile);
+    EXPECT_EQ(original.Get(1), 2.f) << "Copy-on-write modification reached the file.";
+  }
+  std::remove(kTestFile);
+}
+
+TEST(MappedSequence1DTests, ReadOnlyAndMove) {
+  WriteTestFile(std::vector<float>{ 1.f, 2.f, 3.f, 4.f });
+  {
+    mseq1f sequence(kTestFile);
+    ASSERT_TRUE(sequence.IsOpen()) << "Sequence file could not be mapped.";
+    EXPECT_FALSE(sequence.Set(1, 20.f)) << "Element of a read-only mapping set.";
+    EXPECT_EQ(sequence.Get(1), 2.f) << "Read-only element modified.";
+    mseq1f moved(std::move(sequence));
+    EXPECT_EQ(moved.Length(), 4u) << "Move did not transfer the mapping.";
+    EXPECT_EQ(moved.Sum(), 10.f) << "Wrong sum after move.";
+    EXPECT_FALSE(sequence.IsOpen()) << "Moved-from sequence still open.";
+    EXPECT_EQ(sequence.Length(), 0u) << "Moved-from sequence not empty.";
+    EXPECT_EQ(sequence.Sum(), 0.f) << "Sum of a moved-from sequence is not zero.";
+    EXPECT_FALSE(sequence.Set(0, 1.f)) << "Element of a moved-from sequence set.";
+    mseq1f assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.Get(3), 4.f) << "Move assignment did not transfer the mapping.";
+    EXPECT_EQ(moved.Length(), 0u) << "Moved-from sequence not empty after assignment.";
+  }
+  std::remove(kTestFile);
+}
+
+TEST(MappedSequence1DTests, HeaderAndEdgeCases) {
+  WriteTestFile(std::vector<int>{ 7, 8, 9 }, std::string("HEAD"));
+  std::ofstream(kTestFile, std::ios::binary | std::ios::app).put('T');  // 17 bytes: no multiple of sizeof(int) or sizeof(double)
+  {
+    mseq1i sequence(kTestFile, MapMode::READ_ONLY, 4);
+    EXPECT_EQ(sequence.Length(), 3u) << "Trailing partial element not ignored after header.";
+    EXPECT_EQ(sequence.Get(0), 7) << "Header not skipped.";
+    EXPECT_EQ(sequence.Sum(), 24) << "Wrong sum after header.";
+    mseq1d partial(kTestFile);
+    EXPECT_EQ(partial.Length(), 2u) << "Trailing partial element not ignored.";
+  }
+  WriteTestFile(std::vector<int>{});
+  {
+    mseq1i empty(kTestFile);
+    EXPECT_TRUE(empty.IsOpen()) << "Empty file could not be opened.";
+    EXPECT_EQ(empty.Length(), 0u) << "Empty file has a non-zero length.";
+    EXPECT_EQ(empty.Sum(), 0) << "Sum of an empty file is not zero.";
+  }
+  std::remove(kTestFile);
+  mseq1f missing("does_not_exist.bin");
+  EXPECT_FALSE(missing.IsOpen()) << "Missing file reported as open.";
+  EXPECT_EQ(missing.Length(), 0u) << "Missing file has a non-zero length.";
+}
@@ -0,0 +1,111 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\prefix_sum.h"
+#include "..\..\lib\analysis\sequence.h"
+#include "..\..\lib\analysis\sequence_2d.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+template<typename valuetype>
+long double ReferenceSum(const std::vector<valuetype>& values, size_t begin, size_t end, bool square = false) {
+  long double s = 0;
+  for (size_t i = begin; i < end; ++i) { s += square ? (long double)(values[i]) * (long double)(values[i]) : (long double)(values[i]); }
+  return s;
+}
+
+} // namespace
+
+//
+// PrefixSumTests
+//
+TEST(PrefixSumTests, Scan) {
+  // More than one block, and enough elements to be split over threads.
+  std::vector<float> values = RandomValues<float>((size_t(1) << 20) + 17, 1);
+  std::vector<double> prefix(values.size() + 1), threaded(values.size() + 1);
+  ComputePrefixSums(values.data(), values.size(), prefix.data());
+  EXPECT_EQ(prefix[0], 0.) << "First prefix sum not zero.";
+  for (size_t i : { size_t(1), size_t(4096), size_t(4097), size_t(100000), values.size() }) {
+    EXPECT_NEAR(prefix[i], double(ReferenceSum(values, 0, i)), 1e-6) << "Wrong prefix sum of " << i << " elements.";
+  }
+  ComputePrefixSums(values.data(), values.size(), threaded.data(), false, 4);
+  EXPECT_EQ(std::memcmp(prefix.data(), threaded.data(), prefix.size() * sizeof(double)), 0) << "Prefix sums depend on the thread count.";
+  std::vector<int> integers{ 3, -1, 4 };
+  std::vector<long long> squares(4);
+  ComputePrefixSums(integers.data(), integers.size(), squares.data(), true);
+  EXPECT_TRUE(squares == std::vector<long long>({ 0, 9, 10, 26 })) << "Wrong prefix sums of squares.";
+}
+
+TEST(PrefixSumTests, SequenceRanges) {
+  std::vector<float> values = RandomValues<float>(10000, 2);
+  seq1f sequence(values);
+  for (size_t begin : { 0, 1, 4095, 5000 }) {
+    for (size_t end : { 5000, 5001, 9999, 10000 }) {
+      double sum = double(ReferenceSum(values, begin, end)), squares = double(ReferenceSum(values, begin, end, true));
+      EXPECT_NEAR(sequence.Sum(begin, end), sum, 1e-6 * std::abs(sum) + 1e-3) << "Wrong sum of [" << begin << ", " << end << ").";
+      EXPECT_NEAR(sequence.SumOfSquares(begin, end), squares, 1e-6 * squares) << "Wrong sum of squares of [" << begin << ", " << end << ").";
+    }
+  }
+  EXPECT_NEAR(sequence.Average(100, 200), float(ReferenceSum(values, 100, 200) / 100), 1e-4f) << "Wrong range average.";
+  EXPECT_EQ(sequence.Sum(0, 20000), sequence.Sum(0, 10000)) << "Range not clamped to the sequence.";
+  EXPECT_EQ(sequence.Sum(7, 3), 0.f) << "Empty range does not sum to zero.";
+  EXPECT_EQ(sequence.Average(5, 5), 0.f) << "Average of an empty range not zero.";
+  // Precision of a short range far into a long sequence
+  seq1f constant(std::vector<float>(1000000, 0.1f));
+  EXPECT_EQ(constant.Sum(999990, 1000000), float(10. * double(0.1f))) << "Short range lost precision.";
+}
+
+TEST(PrefixSumTests, Invalidation) {
+  seq1i sequence(std::vector<int>{ 1, 2, 3, 4 });
+  EXPECT_EQ(sequence.Sum(1, 3), 5) << "Wrong integral range sum.";
+  sequence.Set(2, 10);
+  EXPECT_EQ(sequence.Sum(1, 3), 12) << "Prefix sums not rebuilt after Set.";
+  sequence.Add(5);
+  EXPECT_EQ(sequence.Sum(0, 5), 22) << "Prefix sums not rebuilt after Add.";
+  sequence.Ptr()[0] = 0;
+  EXPECT_EQ(sequence.Sum(0, 2), 2) << "Prefix sums not rebuilt after writing through Ptr.";
+  seq1i copy = sequence;
+  copy.Set(0, 100);
+  EXPECT_EQ(sequence.Sum(0, 1), 0) << "Modifying a copy changed the prefix sums.";
+  EXPECT_EQ(copy.Sum(0, 1), 100) << "Copy uses stale prefix sums.";
+  sequence.BuildPrefixSums(true, 2);
+  EXPECT_EQ(sequence.SumOfSquares(0, 5), 0 + 4 + 100 + 16 + 25) << "Wrong sum of squares after building ahead of time.";
+}
+
+//
+// SummedAreaTableTests
+//
+TEST(SummedAreaTableTests, Rectangles) {
+  size_t width = 53, height = 41;
+  std::vector<double> values = RandomValues<double>(width * height, 3);
+  auto reference = [&](size_t x0, size_t y0, size_t x1, size_t y1) {
+    long double s = 0;
+    for (size_t y = y0; y < y1; ++y) { for (size_t x = x0; x < x1; ++x) { s += values[y * width + x]; } }
+    return double(s);
+  };
+  for (GridLayout layout : { GridLayout::ROW_MAJOR, GridLayout::TILED, GridLayout::MORTON }) {
+    seq2d grid(width, height, values, layout);
+    EXPECT_NEAR(grid.Sum(0, 0, width, height), reference(0, 0, width, height), 1e-9) << "Wrong sum of the whole grid.";
+    EXPECT_NEAR(grid.Sum(3, 7, 20, 40), reference(3, 7, 20, 40), 1e-9) << "Wrong rectangle sum.";
+    EXPECT_NEAR(grid.Sum(52, 40, 53, 41), values.back(), 1e-12) << "Wrong sum of the last element.";
+    EXPECT_NEAR(grid.Average(10, 10, 12, 13), reference(10, 10, 12, 13) / 6., 1e-9) << "Wrong rectangle average.";
+    EXPECT_EQ(grid.Sum(5, 5, 5, 30), 0.) << "Empty rectangle does not sum to zero.";
+    EXPECT_EQ(grid.Sum(40, 30, 100, 100), grid.Sum(40, 30, width, height)) << "Rectangle not clamped to the grid.";
+    grid.Set(4, 8, grid(4, 8) + 1.);
+    EXPECT_NEAR(grid.Sum(3, 7, 20, 40), reference(3, 7, 20, 40) + 1., 1e-9) << "Summed-area table not rebuilt after Set.";
+  }
+  // Large enough to be split over threads
+  std::vector<float> large = RandomValues<float>(1000 * 700, 4);
+  std::vector<double> table(1001 * 701), threaded(table.size());
+  ComputeSummedAreaTable(large.data(), 1000, 700, table.data());
+  ComputeSummedAreaTable(large.data(), 1000, 700, threaded.data(), false, 3);
+  EXPECT_TRUE(table == threaded) << "Summed-area table depends on the thread count.";
+  seq2i squares(2, 2, std::vector<int>{ 1, 2, 3, 4 });
+  EXPECT_EQ(squares.SumOfSquares(0, 0, 2, 2), 30) << "Wrong rectangle sum of squares.";
+  EXPECT_EQ(squares.SumOfSquares(1, 0, 2, 2), 20) << "Wrong column sum of squares.";
+}
@@ -0,0 +1,167 @@
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\sequence_2d.h"
+#include "..\..\lib\analysis\sequence_3d.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+template<typename valuetype>
+bool BitwiseEqual(valuetype a, valuetype b) { return std::memcmp(&a, &b, sizeof(valuetype)) == 0; }
+
+const GridLayout kLayouts[] = { GridLayout::ROW_MAJOR, GridLayout::TILED, GridLayout::MORTON };
+
+} // namespace
+
+//
+// Sequence2DTests
+//
+TEST(Sequence2DTests, Layouts) {
+  // Sizes that are no multiple of the tile size nor a power of two, with partial tiles along both edges.
+  size_t width = 37, height = 21;
+  std::vector<int> values(width * height);
+  for (size_t i = 0; i < values.size(); ++i) { values[i] = int(i); }
+  for (GridLayout layout : kLayouts) {
+    seq2i sequence(width, height, values, layout);
+    EXPECT_GE(sequence.StorageSize(), sequence.Length()) << "Storage smaller than the grid.";
+    std::vector<bool> used(sequence.StorageSize(), false);
+    for (size_t y = 0; y < height; ++y) {
+      for (size_t x = 0; x < width; ++x) {
+        size_t offset = sequence.Offset(x, y);
+        ASSERT_LT(offset, sequence.StorageSize()) << "Offset of (" << x << ", " << y << ") outside the storage.";
+        EXPECT_FALSE(used[offset]) << "Two elements share offset " << offset << ".";
+        used[offset] = true;
+        EXPECT_EQ(sequence(x, y), int(y * width + x)) << "Wrong element (" << x << ", " << y << ") for layout " << int(layout) << ".";
+      }
+    }
+    EXPECT_TRUE(sequence.RowMajorData() == values) << "Row-major copy differs for layout " << int(layout) << ".";
+  }
+  EXPECT_EQ(seq2i(width, height, GridLayout::TILED).StorageSize(), 48u * 32u) << "Tiled layout not padded to whole tiles.";
+  EXPECT_EQ(seq2i(width, height, GridLayout::MORTON).StorageSize(), 64u * 32u) << "Morton layout not padded to powers of two.";
+  // Neighbors inside a tile are close in memory.
+  seq2f tiled(256, 256, GridLayout::TILED);
+  EXPECT_EQ(tiled.Offset(5, 6) - tiled.Offset(5, 5), kGridTileSize2D) << "Vertical neighbors not one tile row apart.";
+}
+
+TEST(Sequence2DTests, Access) {
+  for (GridLayout layout : kLayouts) {
+    seq2f sequence(3, 2, layout, 1.f);
+    sequence.Set(2, 1, 5.f);
+    sequence.Set(4, 0, 7.f, IndexType::WRAP);
+    EXPECT_EQ(sequence(1, 0), 7.f) << "Wrapped index not set.";
+    EXPECT_EQ(sequence.Get(10, 10), 5.f) << "Index not clamped.";
+    EXPECT_EQ(sequence.Get(5, 3, IndexType::WRAP), 5.f) << "Index not wrapped.";
+    EXPECT_EQ(sequence(0, 1), 1.f) << "Wrong fill value.";
+    std::stringstream ss;
+    ss << sequence;
+    EXPECT_EQ(ss.str(), "Sequence2D((1, 7, 1), (1, 1, 5))") << "Wrong string conversion.";
+  }
+}
+
+TEST(Sequence2DTests, Conversion) {
+  seq2d row_major(19, 23, RandomValues<double>(19 * 23, 1));
+  seq2d morton(row_major, GridLayout::MORTON);
+  EXPECT_EQ(morton.Layout(), GridLayout::MORTON) << "Layout not changed.";
+  EXPECT_TRUE(morton == row_major) << "Values changed with the layout.";
+  morton.Set(3, 4, 0.);
+  EXPECT_TRUE(morton != row_major) << "Different values compare equal.";
+  EXPECT_TRUE(seq2d(2, 3) != seq2d(3, 2)) << "Different sizes compare equal.";
+  seq2i integers = seq2d(2, 1, std::vector<double>{ 1.5, -2.5 }, GridLayout::TILED);
+  EXPECT_TRUE(integers == seq2i(2, 1, std::vector<int>{ 1, -2 })) << "Wrong cast to a different valuetype.";
+  EXPECT_EQ(integers.Layout(), GridLayout::TILED) << "Layout not kept by the cast.";
+}
+
+TEST(Sequence2DTests, Reductions) {
+  // More than one reduction chunk, with chunks starting in the middle of rows.
+  size_t width = 301, height = 97;
+  std::vector<float> values = RandomValues<float>(width * height, 2);
+  values[5000] = -1000.f;
+  values[29000] = 1000.f;
+  SequenceStatistics<float> expected = ReduceStatistics(values.data(), values.size());
+  for (GridLayout layout : kLayouts) {
+    seq2f sequence(width, height, values, layout);
+    for (size_t thread_count : { 1, 3 }) {
+      EXPECT_TRUE(BitwiseEqual(sequence.Sum(SummationPolicy::PAIRWISE, thread_count), ReduceSum(values.data(), values.size()))) << "Sum depends on layout " << int(layout) << ".";
+      EXPECT_TRUE(BitwiseEqual(sequence.Sum(SummationPolicy::KAHAN, thread_count), ReduceSum(values.data(), values.size(), SummationPolicy::KAHAN))) << "Compensated sum depends on layout " << int(layout) << ".";
+      EXPECT_TRUE(BitwiseEqual(sequence.SumOfSquares(SummationPolicy::PAIRWISE, thread_count), ReduceSumOfSquares(values.data(), values.size()))) << "Sum of squares depends on layout " << int(layout) << ".";
+      SequenceStatistics<float> statistics = sequence.Statistics(thread_count);
+      EXPECT_TRUE(BitwiseEqual(statistics.mean_, expected.mean_) && BitwiseEqual(statistics.m2_, expected.m2_)) << "Moments depend on layout " << int(layout) << ".";
+      EXPECT_EQ(statistics.argmin_, 5000u) << "Minimum not reported as row-major index.";
+      EXPECT_EQ(statistics.argmax_, 29000u) << "Maximum not reported as row-major index.";
+    }
+  }
+  EXPECT_EQ(seq2f().Sum(), 0.f) << "Sum of an empty grid is not zero.";
+}
+
+TEST(Sequence2DTests, EmptyGrids) {
+  // Zero width or height used to divide by zero when tiled and Morton grids were copied to row-major order.
+  const size_t sizes[][2] = { { 0, 4 }, { 4, 0 }, { 0, 0 } };
+  for (GridLayout layout : { GridLayout::TILED, GridLayout::MORTON }) {
+    for (const auto& size : sizes) {
+      seq2f sequence(size[0], size[1], std::vector<float>{ 1.f, 2.f }, layout);
+      EXPECT_EQ(sequence.Length(), 0u) << "Empty grid has elements.";
+      EXPECT_TRUE(sequence.RowMajorData().empty()) << "Row-major copy of an empty grid is not empty for layout " << int(layout) << ".";
+      EXPECT_TRUE(seq2f(sequence, GridLayout::ROW_MAJOR) == sequence) << "Layout conversion changed an empty grid.";
+      EXPECT_EQ(sequence.Sum(), 0.f) << "Sum of an empty grid is not zero.";
+    }
+  }
+}
+
+//
+// Sequence3DTests
+//
+TEST(Sequence3DTests, Layouts) {
+  size_t width = 11, height = 9, depth = 13;
+  std::vector<int> values(width * height * depth);
+  for (size_t i = 0; i < values.size(); ++i) { values[i] = int(i); }
+  for (GridLayout layout : kLayouts) {
+    seq3i sequence(width, height, depth, values, layout);
+    std::vector<bool> used(sequence.StorageSize(), false);
+    for (size_t z = 0; z < depth; ++z) {
+      for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+          size_t offset = sequence.Offset(x, y, z);
+          ASSERT_LT(offset, sequence.StorageSize()) << "Offset of (" << x << ", " << y << ", " << z << ") outside the storage.";
+          EXPECT_FALSE(used[offset]) << "Two elements share offset " << offset << ".";
+          used[offset] = true;
+          EXPECT_EQ(sequence(x, y, z), int((z * height + y) * width + x)) << "Wrong element (" << x << ", " << y << ", " << z << ") for layout " << int(layout) << ".";
+        }
+      }
+    }
+    EXPECT_TRUE(sequence.RowMajorData() == values) << "Row-major copy differs for layout " << int(layout) << ".";
+  }
+  EXPECT_EQ(seq3i(width, height, depth, GridLayout::TILED).StorageSize(), 16u * 16u * 16u) << "Tiled layout not padded to whole tiles.";
+  EXPECT_EQ(seq3i(width, height, depth, GridLayout::MORTON).StorageSize(), 16u * 16u * 16u) << "Morton layout not padded to powers of two.";
+  seq3f morton(8, 8, 8, GridLayout::MORTON);
+  EXPECT_EQ(morton.Offset(1, 1, 1), 7u) << "Bits of the coordinates not interleaved.";
+}
+
+TEST(Sequence3DTests, AccessAndReductions) {
+  size_t width = 40, height = 30, depth = 20;
+  std::vector<double> values = RandomValues<double>(width * height * depth, 3);
+  for (GridLayout layout : kLayouts) {
+    seq3d sequence(width, height, depth, values, layout);
+    EXPECT_EQ(sequence.Get(41, 0, 21, IndexType::WRAP), sequence(1, 0, 1)) << "Index not wrapped.";
+    EXPECT_EQ(sequence.Get(100, 100, 100), sequence(39, 29, 19)) << "Index not clamped.";
+    EXPECT_TRUE(BitwiseEqual(sequence.Sum(SummationPolicy::PAIRWISE, 2), ReduceSum(values.data(), values.size()))) << "Sum depends on layout " << int(layout) << ".";
+    EXPECT_EQ(sequence.Statistics().argmax_, ReduceStatistics(values.data(), values.size()).argmax_) << "Maximum not reported as row-major index.";
+    EXPECT_TRUE(seq3d(sequence, GridLayout::ROW_MAJOR) == sequence) << "Values changed with the layout.";
+  }
+}
+
+TEST(Sequence3DTests, EmptyGrids) {
+  const size_t sizes[][3] = { { 0, 4, 4 }, { 4, 0, 4 }, { 4, 4, 0 } };
+  for (GridLayout layout : { GridLayout::TILED, GridLayout::MORTON }) {
+    for (const auto& size : sizes) {
+      seq3f sequence(size[0], size[1], size[2], std::vector<float>{ 1.f, 2.f }, layout);
+      EXPECT_TRUE(sequence.RowMajorData().empty()) << "Row-major copy of an empty grid is not empty for layout " << int(layout) << ".";
+      EXPECT_TRUE(seq3f(sequence, GridLayout::ROW_MAJOR) == sequence) << "Layout conversion changed an empty grid.";
+      EXPECT_EQ(sequence.Sum(), 0.f) << "Sum of an empty grid is not zero.";
+    }
+  }
+}
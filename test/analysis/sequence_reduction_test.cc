@@ -0,0 +1,162 @@
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\sequence.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+template<typename valuetype>
+long double ReferenceSum(const std::vector<valuetype>& values) { long double s = 0; for (valuetype v : values) { s += v; } return s; }
+
+template<typename valuetype>
+bool BitwiseEqual(valuetype a, valuetype b) { return std::memcmp(&a, &b, sizeof(valuetype)) == 0; }
+
+} // namespace
+
+//
+// SumTests
+//
+TEST(SumTests, Accuracy) {
+  std::vector<float> values = RandomValues<float>(100003, 1);
+  long double reference = ReferenceSum(values);
+  EXPECT_NEAR(double(ReduceSum(values.data(), values.size())), double(reference), 0.05) << "Pairwise float sum differs from the exact sum.";
+  EXPECT_NEAR(double(ReduceSum(values.data(), values.size(), SummationPolicy::KAHAN)), double(reference), 0.005) << "Compensated float sum differs from the exact sum.";
+  std::vector<double> values_d = RandomValues<double>(100003, 1);
+  EXPECT_NEAR(ReduceSum(values_d.data(), values_d.size()), double(ReferenceSum(values_d)), 1e-8) << "Pairwise double sum differs from the exact sum.";
+}
+
+TEST(SumTests, Compensated) {
+  std::vector<float> values(1000000, 0.1f);
+  double reference = 1000000. * double(0.1f);
+  float naive = 0.f;
+  for (float v : values) { naive += v; }
+  float kahan = ReduceSum(values.data(), values.size(), SummationPolicy::KAHAN);
+  EXPECT_NEAR(double(kahan), reference, 0.01) << "Compensated sum of 0.1f is inaccurate.";
+  EXPECT_LT(std::fabs(double(kahan) - reference), std::fabs(double(naive) - reference)) << "Compensated sum is not more accurate than a running sum.";
+  EXPECT_LT(std::fabs(double(ReduceSum(values.data(), values.size())) - reference), std::fabs(double(naive) - reference)) << "Pairwise sum is not more accurate than a running sum.";
+}
+
+TEST(SumTests, Deterministic) {
+  std::vector<float> values = RandomValues<float>(1000003, 2);
+  std::vector<double> values_d = RandomValues<double>(1000003, 2);
+  for (SummationPolicy policy : { SummationPolicy::PAIRWISE, SummationPolicy::KAHAN }) {
+    SetSimdLevel(SimdLevel::SCALAR);
+    float expected = ReduceSum(values.data(), values.size(), policy);
+    float expected_squares = ReduceSumOfSquares(values.data(), values.size(), policy);
+    double expected_d = ReduceSum(values_d.data(), values_d.size(), policy);
+    SetSimdLevel(GetSupportedSimdLevel());
+    ForEachSimdLevel([&](SimdLevel level) {
+      for (size_t thread_count : { 1, 2, 3, 0 }) {
+        EXPECT_TRUE(BitwiseEqual(ReduceSum(values.data(), values.size(), policy, thread_count), expected)) << "Float sum depends on SIMD level " << int(level) << " or thread count " << thread_count << ".";
+        EXPECT_TRUE(BitwiseEqual(ReduceSumOfSquares(values.data(), values.size(), policy, thread_count), expected_squares)) << "Float sum of squares depends on SIMD level " << int(level) << " or thread count " << thread_count << ".";
+        EXPECT_TRUE(BitwiseEqual(ReduceSum(values_d.data(), values_d.size(), policy, thread_count), expected_d)) << "Double sum depends on SIMD level " << int(level) << " or thread count " << thread_count << ".";
+      }
+    });
+  }
+}
+
+TEST(SumTests, SmallLengths) {
+  ForEachSimdLevel([](SimdLevel level) {
+    for (size_t length = 0; length < 40; ++length) {
+      std::vector<double> values = RandomValues<double>(length, 3);
+      double reference = double(ReferenceSum(values));
+      EXPECT_NEAR(ReduceSum(values.data(), values.size()), reference, 1e-10) << "Wrong sum of length " << length << " at SIMD level " << int(level) << ".";
+      EXPECT_NEAR(ReduceSum(values.data(), values.size(), SummationPolicy::KAHAN), reference, 1e-10) << "Wrong compensated sum of length " << length << " at SIMD level " << int(level) << ".";
+    }
+  });
+}
+
+TEST(SumTests, Integral) {
+  std::vector<int> values;
+  for (int i = 0; i < 10001; ++i) { values.push_back(i - 5000); }
+  values.push_back(7);
+  EXPECT_EQ(ReduceSum(values.data(), values.size()), 7) << "Wrong integer sum.";
+  EXPECT_EQ(ReduceSum(values.data(), values.size(), SummationPolicy::KAHAN, 0), 7) << "Wrong compensated integer sum.";
+  EXPECT_EQ(ReduceSumOfSquares(values.data(), 3), 5000 * 5000 + 4999 * 4999 + 4998 * 4998) << "Wrong integer sum of squares.";
+}
+
+//
+// StatisticsTests
+//
+TEST(StatisticsTests, Moments) {
+  std::vector<double> values = RandomValues<double>(50001, 4);
+  for (double& v : values) { v += 1e6; }  // A large offset defeats the naive sum-of-squares formula
+  long double mean = ReferenceSum(values) / values.size();
+  long double m2 = 0;
+  for (double v : values) { m2 += (v - mean) * (v - mean); }
+  SequenceStatistics<double> statistics = ReduceStatistics(values.data(), values.size());
+  EXPECT_EQ(statistics.count_, values.size()) << "Wrong count.";
+  EXPECT_NEAR(statistics.mean_, double(mean), 1e-8) << "Wrong mean.";
+  EXPECT_NEAR(statistics.Variance(), double(m2 / values.size()), 1e-6) << "Wrong variance.";
+  EXPECT_NEAR(statistics.SampleVariance(), double(m2 / (values.size() - 1)), 1e-6) << "Wrong sample variance.";
+  EXPECT_TRUE(BitwiseEqual(statistics.sum_, ReduceSum(values.data(), values.size()))) << "Statistics sum differs from the pairwise sum.";
+}
+
+TEST(StatisticsTests, MinMax) {
+  std::vector<float> values = RandomValues<float>(20011, 5);
+  values[3] = -1000.f; values[17000] = -1000.f; values[20010] = -1000.f;
+  values[9] = 1000.f; values[4097] = 1000.f; values[20009] = 1000.f;
+  ForEachSimdLevel([&](SimdLevel level) {
+    for (size_t thread_count : { 1, 3 }) {
+      SequenceStatistics<float> statistics = ReduceStatistics(values.data(), values.size(), thread_count);
+      EXPECT_EQ(statistics.min_, -1000.f) << "Wrong minimum at SIMD level " << int(level) << ".";
+      EXPECT_EQ(statistics.argmin_, 3u) << "Minimum is not the first occurrence at SIMD level " << int(level) << ".";
+      EXPECT_EQ(statistics.max_, 1000.f) << "Wrong maximum at SIMD level " << int(level) << ".";
+      EXPECT_EQ(statistics.argmax_, 9u) << "Maximum is not the first occurrence at SIMD level " << int(level) << ".";
+    }
+  });
+  std::vector<double> constant(37, 2.5);
+  SequenceStatistics<double> statistics = ReduceStatistics(constant.data(), constant.size());
+  EXPECT_EQ(statistics.argmin_, 0u) << "Minimum of a constant sequence is not at the first index.";
+  EXPECT_EQ(statistics.argmax_, 0u) << "Maximum of a constant sequence is not at the first index.";
+  EXPECT_EQ(statistics.Variance(), 0.) << "Variance of a constant sequence is not zero.";
+}
+
+TEST(StatisticsTests, Deterministic) {
+  std::vector<float> values = RandomValues<float>(1000003, 6);
+  SetSimdLevel(SimdLevel::SCALAR);
+  SequenceStatistics<float> expected = ReduceStatistics(values.data(), values.size());
+  SetSimdLevel(GetSupportedSimdLevel());
+  ForEachSimdLevel([&](SimdLevel level) {
+    for (size_t thread_count : { 1, 2, 0 }) {
+      SequenceStatistics<float> statistics = ReduceStatistics(values.data(), values.size(), thread_count);
+      EXPECT_TRUE(BitwiseEqual(statistics.mean_, expected.mean_) && BitwiseEqual(statistics.m2_, expected.m2_)) << "Moments depend on SIMD level " << int(level) << " or thread count " << thread_count << ".";
+      EXPECT_TRUE(statistics.argmin_ == expected.argmin_ && statistics.argmax_ == expected.argmax_) << "Extrema depend on SIMD level " << int(level) << " or thread count " << thread_count << ".";
+    }
+  });
+}
+
+TEST(StatisticsTests, Integral) {
+  std::vector<int> values = { 4, -2, 9, -2, 9, 6 };
+  SequenceStatistics<int> statistics = ReduceStatistics(values.data(), values.size());
+  EXPECT_EQ(statistics.sum_, 24) << "Wrong integer sum.";
+  EXPECT_DOUBLE_EQ(statistics.mean_, 4.) << "Wrong integer mean.";
+  EXPECT_DOUBLE_EQ(statistics.Variance(), 21.) << "Wrong integer variance.";
+  EXPECT_TRUE(statistics.min_ == -2 && statistics.argmin_ == 1) << "Wrong integer minimum.";
+  EXPECT_TRUE(statistics.max_ == 9 && statistics.argmax_ == 2) << "Wrong integer maximum.";
+}
+
+TEST(StatisticsTests, Empty) {
+  SequenceStatistics<float> statistics = ReduceStatistics(static_cast<const float*>(nullptr), 0);
+  EXPECT_EQ(statistics.count_, 0u) << "Empty sequence has a non-zero count.";
+  EXPECT_EQ(statistics.Variance(), 0.f) << "Empty sequence has a non-zero variance.";
+}
+
+//
+// Sequence1DReductionTests
+//
+TEST(Sequence1DReductionTests, Members) {
+  seq1d sequence(std::vector<double>{ 1., 2., 3., 4. });
+  EXPECT_EQ(sequence.Sum(), 10.) << "Wrong sequence sum.";
+  EXPECT_EQ(sequence.Sum(SummationPolicy::KAHAN, 0), 10.) << "Wrong compensated sequence sum.";
+  EXPECT_EQ(sequence.SumOfSquares(), 30.) << "Wrong sequence sum of squares.";
+  EXPECT_EQ(sequence.Average(), 2.5) << "Wrong sequence average.";
+  EXPECT_EQ(sequence.Statistics().Variance(), 1.25) << "Wrong sequence variance.";
+  EXPECT_EQ(seq1i(std::vector<int>{ 1, 2, 6 }).Average(), 3) << "Wrong integer sequence average.";
+  EXPECT_EQ(seq1f().Sum(), 0.f) << "Sum of an empty sequence is not zero.";
+}
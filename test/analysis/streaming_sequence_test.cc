@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\streaming_sequence.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<double> RandomValues(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(-100., 100.);
+  std::vector<double> values;
+  for (size_t i = 0; i < count; ++i) { values.push_back(distribution(generator)); }
+  return values;
+}
+
+// Statistics of values[begin, end) computed directly.
+void ExpectWindowStatistics(const sseq1d& sequence, const std::vector<double>& values, size_t begin, size_t end) {
+  double sum = 0., min = values[begin], max = values[begin];
+  for (size_t i = begin; i < end; ++i) { sum += values[i]; min = std::min(min, values[i]); max = std::max(max, values[i]); }
+  double mean = sum / double(end - begin), m2 = 0.;
+  for (size_t i = begin; i < end; ++i) { m2 += (values[i] - mean) * (values[i] - mean); }
+  EXPECT_EQ(sequence.Length(), end - begin) << "Wrong window length.";
+  double scale = std::max(1., max - min);
+  EXPECT_NEAR(sequence.Sum(), sum, 1e-12 * scale * double(end - begin)) << "Wrong window sum ending at " << end << ".";
+  EXPECT_NEAR(sequence.Mean(), mean, 1e-12 * scale) << "Wrong window mean ending at " << end << ".";
+  EXPECT_NEAR(sequence.Variance(), m2 / double(end - begin), 1e-10 * scale * scale) << "Wrong window variance ending at " << end << ".";
+  EXPECT_EQ(sequence.Min(), min) << "Wrong window minimum ending at " << end << ".";
+  EXPECT_EQ(sequence.Max(), max) << "Wrong window maximum ending at " << end << ".";
+}
+
+} // namespace
+
+//
+// StreamingSequence1DTests
+//
+TEST(StreamingSequence1DTests, Unbounded) {
+  sseq1i sequence;
+  EXPECT_EQ(sequence.Length(), 0u) << "New sequence is not empty.";
+  EXPECT_EQ(sequence.Sum(), 0) << "Sum of an empty sequence is not zero.";
+  sequence.Add(4);
+  sequence.Add(std::vector<int>{ -2, 9, 1 });
+  EXPECT_EQ(sequence.Length(), 4u) << "Wrong length after adding.";
+  EXPECT_EQ(sequence.Get(2), 9) << "Wrong element.";
+  EXPECT_EQ(sequence.Sum(), 12) << "Wrong running sum.";
+  EXPECT_EQ(sequence.SumOfSquares(), 102) << "Wrong running sum of squares.";
+  EXPECT_EQ(sequence.Average(), 3) << "Wrong running average.";
+  EXPECT_DOUBLE_EQ(sequence.Variance(), 16.5) << "Wrong running variance.";
+  EXPECT_EQ(sequence.Min(), -2) << "Wrong running minimum.";
+  EXPECT_EQ(sequence.Max(), 9) << "Wrong running maximum.";
+  EXPECT_TRUE(seq1i(sequence) == seq1i(std::vector<int>{ 4, -2, 9, 1 })) << "Copy to Sequence1D differs.";
+}
+
+TEST(StreamingSequence1DTests, StringConversion) {
+  sseq1i sequence(3);
+  std::stringstream ss;
+  ss << sequence;
+  EXPECT_EQ(ss.str(), "StreamingSequence1D()") << "Wrong string conversion of an empty sequence.";
+  sequence.Add(std::vector<int>{ 1, 2, 3, 4 });
+  ss.str("");
+  ss << sequence;
+  EXPECT_EQ(ss.str(), "StreamingSequence1D(2, 3, 4)") << "Wrong string conversion.";
+}
+
+TEST(StreamingSequence1DTests, RingBuffer) {
+  sseq1f sequence(3);
+  sequence.Add(std::vector<float>{ 1.f, 2.f, 3.f, 4.f });
+  EXPECT_TRUE(sequence.IsFull()) << "Ring buffer not full.";
+  EXPECT_EQ(sequence.Length(), 3u) << "Ring buffer exceeds its capacity.";
+  EXPECT_EQ(sequence.Get(0), 2.f) << "Index 0 is not the oldest sample.";
+  EXPECT_EQ(sequence.Get(2), 4.f) << "Wrong newest sample.";
+  EXPECT_EQ(sequence.Get(4, IndexType::WRAP), 3.f) << "Index not wrapped around the window.";
+  EXPECT_EQ(sequence.Get(7), 4.f) << "Index not clamped to the window.";
+  EXPECT_EQ(sequence.Sum(), 9.f) << "Wrong window sum.";
+  sequence.Add(-5.f);
+  EXPECT_EQ(sequence.Get(0), 3.f) << "Oldest sample not dropped.";
+  EXPECT_EQ(sequence.Min(), -5.f) << "Wrong window minimum.";
+  EXPECT_EQ(sequence.Max(), 4.f) << "Wrong window maximum.";
+  sequence.Clear();
+  EXPECT_EQ(sequence.Length(), 0u) << "Cleared sequence is not empty.";
+  EXPECT_EQ(sequence.Capacity(), 3u) << "Clear changed the capacity.";
+  sequence.Add(7.f);
+  EXPECT_TRUE(sequence.Sum() == 7.f && sequence.Min() == 7.f && sequence.Max() == 7.f) << "Wrong statistics after clearing.";
+}
+
+TEST(StreamingSequence1DTests, SlidingWindow) {
+  std::vector<double> values = RandomValues(5000, 1);
+  for (size_t i = 2000; i < 2100; ++i) { values[i] = 1e6 + values[i]; }  // Large samples that leave the window again
+  const size_t capacity = 97;
+  sseq1d sequence(capacity);
+  for (size_t i = 0; i < values.size(); ++i) {
+    sequence.Add(values[i]);
+    if (i % 37 == 0 || i + 1 == values.size()) { ExpectWindowStatistics(sequence, values, (i + 1 > capacity) ? i + 1 - capacity : 0, i + 1); }
+  }
+}
+
+TEST(StreamingSequence1DTests, BulkAppend) {
+  std::vector<double> values = RandomValues(1000, 2);
+  sseq1d bulk(64), single(64);
+  bulk.Add(values.data(), 10);
+  bulk.Add(values.data() + 10, values.size() - 10);
+  for (double v : values) { single.Add(v); }
+  ExpectWindowStatistics(bulk, values, values.size() - 64, values.size());
+  for (size_t i = 0; i < 64; ++i) { EXPECT_EQ(bulk.Get(i), single.Get(i)) << "Bulk append differs from single appends at " << i << "."; }
+  bulk.Add(values.data(), 5);
+  std::vector<double> window(values.end() - 59, values.end());
+  window.insert(window.end(), values.begin(), values.begin() + 5);
+  ExpectWindowStatistics(bulk, window, 0, 64);
+}
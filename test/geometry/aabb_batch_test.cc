@@ -0,0 +1,158 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\aabb_batch.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+// Random boxes with a count that is not a multiple of any SIMD width, so the scalar tail is exercised as well. Corners
+// are on a coarse grid so that boxes often touch exactly.
+template<typename valuetype>
+std::vector<AABB3D<valuetype>> RandomBoxes(size_t count, unsigned int seed) {
+  std::vector<double> values = RandomValues<double>(6 * count, seed, -20., 21.);
+  std::vector<valuetype> corners;
+  for (double value : values) { corners.push_back(valuetype(std::floor(value))); }
+  std::vector<AABB3D<valuetype>> boxes;
+  for (size_t i = 0; i < count; ++i) {
+    const valuetype* c = &corners[6 * i];
+    boxes.push_back(AABB3D<valuetype>(c[0], c[1], c[2], c[3], c[4], c[5]));
+  }
+  return boxes;
+}
+
+template<typename valuetype>
+void ExpectBatchMatchesScalar() {
+  std::vector<AABB3D<valuetype>> boxes = RandomBoxes<valuetype>(1003, 1), others = RandomBoxes<valuetype>(1003, 2);
+  AABB3DArray<valuetype> array(boxes), other_array(others);
+  AABB3D<valuetype> query(valuetype(-3), valuetype(-3), valuetype(-3), valuetype(4), valuetype(4), valuetype(4));
+  Point3D<valuetype> p(valuetype(1), valuetype(-2), valuetype(0));
+  ForEachSimdLevel([&](SimdLevel level) {
+    std::vector<uint64_t> overlaps, contains_point, contains_box;
+    BatchOverlaps(array, query, overlaps);
+    BatchContains(array, p, contains_point);
+    BatchContains(array, AABB3D<valuetype>(p, p), contains_box);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_EQ(IsMaskSet(overlaps.data(), i), boxes[i].Overlaps(query)) << "Wrong overlap of box " << i << " at SIMD level " << int(level) << ".";
+      EXPECT_EQ(IsMaskSet(contains_point.data(), i), boxes[i].Contains(p)) << "Wrong point containment of box " << i << " at SIMD level " << int(level) << ".";
+      EXPECT_EQ(IsMaskSet(contains_box.data(), i), boxes[i].Contains(AABB3D<valuetype>(p, p))) << "Wrong box containment of box " << i << " at SIMD level " << int(level) << ".";
+    }
+    AABB3DArray<valuetype> merged;
+    BatchMerge(array, other_array, merged);
+    ASSERT_EQ(merged.Length(), boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) { EXPECT_EQ(merged[i], boxes[i].Merge(others[i])) << "Wrong merge of box " << i << " at SIMD level " << int(level) << "."; }
+    AABB3D<valuetype> bounds;
+    for (const AABB3D<valuetype>& box : boxes) { bounds.Extend(box); }
+    EXPECT_EQ(BoundingBox(array), bounds) << "Wrong bounds of the boxes at SIMD level " << int(level) << ".";
+  });
+}
+
+// Merging boxes whose components tie as -0 and +0 or are NaN gives the same bits on every SIMD level, in the SIMD
+// lanes and in the scalar tail: a < b ? a : b for the minimum and a > b ? a : b for the maximum.
+template<typename valuetype>
+void ExpectMergeSignedZeroAndNaN() {
+  const valuetype nan = std::numeric_limits<valuetype>::quiet_NaN(), zero = valuetype(0);
+  const valuetype pairs[][2] = { { -zero, zero }, { zero, -zero }, { nan, valuetype(1) }, { valuetype(1), nan }, { -zero, nan }, { valuetype(2), valuetype(-3) } };
+  const size_t pair_count = sizeof(pairs) / sizeof(pairs[0]);
+  AABB3DArray<valuetype> a, b;
+  for (size_t i = 0; i < 11; ++i) {
+    AABB3D<valuetype> box_a, box_b;
+    for (int d = 0; d < 3; ++d) {
+      const valuetype* pair = pairs[(i + size_t(d)) % pair_count];
+      box_a.min_[d] = box_a.max_[d] = pair[0];
+      box_b.min_[d] = box_b.max_[d] = pair[1];
+    }
+    a.Add(box_a);
+    b.Add(box_b);
+  }
+  ForEachSimdLevel([&](SimdLevel level) {
+    AABB3DArray<valuetype> merged;
+    BatchMerge(a, b, merged);
+    for (size_t i = 0; i < a.Length(); ++i) {
+      for (int d = 0; d < 3; ++d) {
+        valuetype x = a[i].min_[d], y = b[i].min_[d], min = (x < y) ? x : y, max = (x > y) ? x : y;
+        EXPECT_EQ(std::memcmp(&merged[i].min_[d], &min, sizeof(valuetype)), 0) << "Wrong minimum of " << x << " and " << y << " in box " << i << " at SIMD level " << int(level) << ".";
+        EXPECT_EQ(std::memcmp(&merged[i].max_[d], &max, sizeof(valuetype)), 0) << "Wrong maximum of " << x << " and " << y << " in box " << i << " at SIMD level " << int(level) << ".";
+      }
+    }
+  });
+}
+
+// Bounds skip NaN components and order -0 below +0, whichever lane or the scalar tail the values fall in.
+template<typename valuetype>
+void ExpectBoundsSignedZeroAndNaN() {
+  const valuetype nan = std::numeric_limits<valuetype>::quiet_NaN(), zero = valuetype(0);
+  const valuetype x[] = { 0, 1, 2, 3, nan, 5, 6, 7, 8, nan, 10 };
+  const valuetype y[] = { 1, zero, 2, nan, -zero, 3, zero, 1, 2, nan, zero };
+  const valuetype z[] = { -1, -zero, -2, -3, nan, -zero, -1, -2, -3, -1, zero };
+  Point3DArray<valuetype> points;
+  AABB3DArray<valuetype> boxes;
+  for (size_t i = 0; i < 11; ++i) {
+    Point3D<valuetype> p(x[i], y[i], z[i]);
+    points.Add(p);
+    AABB3D<valuetype> box;
+    box.min_ = box.max_ = p;
+    boxes.Add(box);
+  }
+  const valuetype expected_min[] = { 0, -zero, -3 }, expected_max[] = { 10, 3, zero };
+  ForEachSimdLevel([&](SimdLevel level) {
+    AABB3D<valuetype> bounds[] = { BoundingBox(points), BoundingBox(boxes) };
+    for (const AABB3D<valuetype>& b : bounds) {
+      for (int d = 0; d < 3; ++d) {
+        EXPECT_EQ(std::memcmp(&b.min_[d], &expected_min[d], sizeof(valuetype)), 0) << "Wrong minimum " << b.min_[d] << " along axis " << d << " at SIMD level " << int(level) << ".";
+        EXPECT_EQ(std::memcmp(&b.max_[d], &expected_max[d], sizeof(valuetype)), 0) << "Wrong maximum " << b.max_[d] << " along axis " << d << " at SIMD level " << int(level) << ".";
+      }
+    }
+  });
+}
+
+} // namespace
+
+//
+// AABBBatchTests
+//
+TEST(AABBBatchTests, FloatMatchesScalar) {
+  ExpectBatchMatchesScalar<float>();
+}
+
+TEST(AABBBatchTests, DoubleMatchesScalar) {
+  ExpectBatchMatchesScalar<double>();
+}
+
+TEST(AABBBatchTests, MergeSignedZeroAndNaN) {
+  ExpectMergeSignedZeroAndNaN<float>();
+  ExpectMergeSignedZeroAndNaN<double>();
+}
+
+TEST(AABBBatchTests, BoundsSignedZeroAndNaN) {
+  ExpectBoundsSignedZeroAndNaN<float>();
+  ExpectBoundsSignedZeroAndNaN<double>();
+}
+
+TEST(AABBBatchTests, Array) {
+  AABB3DArray<double> array;
+  array.Add(AABB3Dd(0., 0., 0., 1., 1., 1.));
+  array.Add(AABB3Dd(2., 2., 2., 3., 3., 3.));
+  array.Set(0, AABB3Dd(-1., -1., -1., 0., 0., 0.));
+  EXPECT_EQ(array.Length(), 2u) << "Wrong length.";
+  EXPECT_EQ(array[0], AABB3Dd(-1., -1., -1., 0., 0., 0.)) << "Box not set.";
+  EXPECT_EQ(array.ToVector()[1], AABB3Dd(2., 2., 2., 3., 3., 3.)) << "Wrong conversion to an array of structs.";
+  EXPECT_EQ(BoundingBox(array), AABB3Dd(-1., -1., -1., 3., 3., 3.)) << "Wrong bounds.";
+  EXPECT_TRUE(BoundingBox(AABB3DArray<double>()).IsEmpty()) << "Bounds of no boxes not empty.";
+  std::vector<uint64_t> mask;
+  BatchOverlaps(array, AABB3Dd(0.5, 0.5, 0.5, 2., 2., 2.), mask);
+  EXPECT_EQ(MaskToIndices(mask, array.Length()), std::vector<size_t>({ 1 })) << "Wrong overlapping boxes.";
+}
+
+TEST(AABBBatchTests, PointBounds) {
+  p3arrayf points(std::vector<p3f>{ p3f(1.f, 0.f, 0.f), p3f(-1.f, 3.f, 0.f), p3f(0.f, 0.f, -2.f) });
+  for (int i = 0; i < 20; ++i) { points.Add(p3f(0.f, 0.f, 0.f)); }
+  ForEachSimdLevel([&](SimdLevel level) {
+    EXPECT_EQ(BoundingBox(points), AABB3Df(-1.f, 0.f, -2.f, 1.f, 3.f, 0.f)) << "Wrong point array bounds at SIMD level " << int(level) << ".";
+  });
+}
@@ -0,0 +1,86 @@
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\aabb.h"
+
+using namespace j::math;
+
+//
+// AABB2DTests
+//
+TEST(AABB2DTests, Construction) {
+  AABB2Dd box(3., -1., 1., 2.);
+  EXPECT_EQ(box.min_, p2d(1., -1.)) << "Corners not reordered into min.";
+  EXPECT_EQ(box.max_, p2d(3., 2.)) << "Corners not reordered into max.";
+  EXPECT_EQ(AABB2Dd(Rectangle2Dd(3., -1., 1., 2.)), box) << "Wrong conversion from Rectangle2D.";
+  EXPECT_TRUE(AABB2Dd().IsEmpty()) << "Default-constructed box not empty.";
+  EXPECT_FALSE(box.IsEmpty()) << "Box empty.";
+  EXPECT_EQ(box.Size(), vec2d(2., 3.)) << "Wrong size.";
+  EXPECT_EQ(box.Center(), p2d(2., 0.5)) << "Wrong center.";
+  EXPECT_EQ(box.Area(), 6.) << "Wrong area.";
+  EXPECT_EQ(AABB2Dd().Area(), 0.) << "Empty box has an area.";
+  EXPECT_EQ(box + vec2d(1., 1.), AABB2Dd(2., 0., 4., 3.)) << "Wrong translation.";
+}
+
+TEST(AABB2DTests, Tests) {
+  AABB2Dd box(0., 0., 2., 2.);
+  EXPECT_TRUE(box.Contains(p2d(1., 1.))) << "Inner point not contained.";
+  EXPECT_TRUE(box.Contains(p2d(2., 0.))) << "Corner not contained.";
+  EXPECT_FALSE(box.Contains(p2d(2.5, 1.))) << "Outer point contained.";
+  EXPECT_TRUE(box.Contains(AABB2Dd(0.5, 0.5, 1.5, 2.))) << "Inner box not contained.";
+  EXPECT_FALSE(box.Contains(AABB2Dd(0.5, 0.5, 1.5, 2.5))) << "Crossing box contained.";
+  EXPECT_TRUE(box.Overlaps(AABB2Dd(2., 2., 3., 3.))) << "Touching boxes do not overlap.";
+  EXPECT_FALSE(box.Overlaps(AABB2Dd(2.1, 0., 3., 3.))) << "Separate boxes overlap.";
+  EXPECT_FALSE(box.Overlaps(AABB2Dd())) << "Box overlaps the empty box.";
+  EXPECT_EQ(box.Merge(AABB2Dd(-1., 1., 1., 3.)), AABB2Dd(-1., 0., 2., 3.)) << "Wrong merge.";
+  EXPECT_EQ(box.Merge(AABB2Dd()), box) << "Merging the empty box changed the box.";
+  EXPECT_EQ(box.Intersection(AABB2Dd(1., -1., 3., 1.)), AABB2Dd(1., 0., 2., 1.)) << "Wrong intersection.";
+  EXPECT_TRUE(box.Intersection(AABB2Dd(3., 3., 4., 4.)).IsEmpty()) << "Intersection of separate boxes not empty.";
+  EXPECT_EQ(box.FindNearestPoint(p2d(3., 1.)), p2d(2., 1.)) << "Wrong nearest point.";
+  EXPECT_EQ(box.FindNearestPoint(p2d(1., 1.)), p2d(1., 1.)) << "Inner point not its own nearest point.";
+}
+
+//
+// AABB3DTests
+//
+TEST(AABB3DTests, Construction) {
+  AABB3Dd box(p3d(1., 5., -2.), p3d(-1., 2., 2.));
+  EXPECT_EQ(box.min_, p3d(-1., 2., -2.)) << "Corners not reordered into min.";
+  EXPECT_EQ(box.max_, p3d(1., 5., 2.)) << "Corners not reordered into max.";
+  EXPECT_TRUE(AABB3Dd().IsEmpty()) << "Default-constructed box not empty.";
+  EXPECT_EQ(box.Size(), vec3d(2., 3., 4.)) << "Wrong size.";
+  EXPECT_EQ(box.Center(), p3d(0., 3.5, 0.)) << "Wrong center.";
+  EXPECT_EQ(box.Volume(), 24.) << "Wrong volume.";
+  EXPECT_EQ(box.SurfaceArea(), 52.) << "Wrong surface area.";
+  AABB3Dd moved{ box };
+  moved -= vec3d(1., 0., 0.);
+  EXPECT_EQ(moved, AABB3Dd(-2., 2., -2., 0., 5., 2.)) << "Wrong translation.";
+}
+
+TEST(AABB3DTests, Tests) {
+  AABB3Dd box(0., 0., 0., 2., 2., 2.);
+  EXPECT_TRUE(box.Contains(p3d(1., 2., 0.))) << "Boundary point not contained.";
+  EXPECT_FALSE(box.Contains(p3d(1., 1., -0.1))) << "Outer point contained.";
+  EXPECT_TRUE(box.Contains(AABB3Dd(0., 0., 0., 1., 1., 1.))) << "Inner box not contained.";
+  EXPECT_TRUE(box.Overlaps(AABB3Dd(1., 1., 1., 3., 3., 3.))) << "Overlapping boxes do not overlap.";
+  EXPECT_FALSE(box.Overlaps(AABB3Dd(1., 1., 2.5, 3., 3., 3.))) << "Boxes separated along z overlap.";
+  EXPECT_EQ(box.Merge(AABB3Dd(1., -1., 1., 3., 1., 1.)), AABB3Dd(0., -1., 0., 3., 2., 2.)) << "Wrong merge.";
+  EXPECT_EQ(box.Intersection(AABB3Dd(1., -1., 1., 3., 1., 1.)), AABB3Dd(1., 0., 1., 2., 1., 1.)) << "Wrong intersection.";
+  EXPECT_EQ(box.FindNearestPoint(p3d(-1., 1., 5.)), p3d(0., 1., 2.)) << "Wrong nearest point.";
+  AABB3Dd grown;
+  grown.Extend(p3d(1., 2., 3.));
+  EXPECT_EQ(grown, AABB3Dd(1., 2., 3., 1., 2., 3.)) << "Empty box not extended to a point.";
+}
+
+//
+// BoundingBoxTests
+//
+TEST(BoundingBoxTests, Shapes) {
+  EXPECT_EQ(BoundingBox(Circled(1., 2., 0.5)), AABB2Dd(0.5, 1.5, 1.5, 2.5)) << "Wrong circle bounds.";
+  EXPECT_EQ(BoundingBox(Sphered(1., 2., 3., 1.)), AABB3Dd(0., 1., 2., 2., 3., 4.)) << "Wrong sphere bounds.";
+  EXPECT_EQ(BoundingBox(LineSegment2Dd(2., 0., 0., 1.)), AABB2Dd(0., 0., 2., 1.)) << "Wrong segment bounds.";
+  Line3d line(p3d(0., 0., 0.), vec3d(0., 0., -1.));
+  EXPECT_EQ(BoundingBox(line, -1., 2.), AABB3Dd(0., 0., -2., 0., 0., 1.)) << "Wrong line segment bounds.";
+  EXPECT_EQ(BoundingBox(std::vector<p3d>{ p3d(1., 0., 0.), p3d(-1., 3., 0.), p3d(0., 0., -2.) }), AABB3Dd(-1., 0., -2., 1., 3., 0.)) << "Wrong point set bounds.";
+  EXPECT_EQ(BoundingBox(std::vector<p2d>{ p2d(1., 0.), p2d(-1., 3.) }), AABB2Dd(-1., 0., 1., 3.)) << "Wrong 2D point set bounds.";
+  EXPECT_TRUE(BoundingBox(std::vector<p3d>()).IsEmpty()) << "Bounds of no points not empty.";
+}
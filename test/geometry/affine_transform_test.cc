@@ -0,0 +1,79 @@
+#include <sstream>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\affine_transform.h"
+#include "..\..\lib\utility\pi.h"
+
+using namespace j::math;
+
+namespace {
+
+// Component-wise comparison with a tolerance, for results that go through an inversion or a rotation.
+void ExpectNear(const p3d& a, const p3d& b, const char* message) {
+  EXPECT_NEAR(a.x_, b.x_, 1e-12) << message;
+  EXPECT_NEAR(a.y_, b.y_, 1e-12) << message;
+  EXPECT_NEAR(a.z_, b.z_, 1e-12) << message;
+}
+
+} // namespace
+
+//
+// AffineTransform3DTests
+//
+TEST(AffineTransform3DTests, Constructors) {
+  AffineTransform3d t_default;
+  EXPECT_EQ(t_default, AffineTransform3d::Identity()) << "Default constructor did not initialize to the identity.";
+  AffineTransform3d t(mat3d(1., 2., 3., 4., 5., 6., 7., 8., 10.), vec3d(1., 2., 3.));
+  EXPECT_EQ(AffineTransform3d(t.ToMatrix4x4()), t) << "Round trip through Matrix4x4 changed the transform.";
+  EXPECT_TRUE(t.ToMatrix4x4().IsAffine()) << "Matrix4x4 of an affine transform is not affine.";
+}
+
+TEST(AffineTransform3DTests, TransformPoint) {
+  AffineTransform3d t = AffineTransform3d::Translation(vec3d(1., 2., 3.)) * AffineTransform3d::Scale(vec3d(2., 2., 2.));
+  EXPECT_EQ(t(p3d(1., 1., 1.)), p3d(3., 4., 5.)) << "Composition did not scale before translating.";
+  EXPECT_EQ(t.TransformVector(vec3d(1., 1., 1.)), vec3d(2., 2., 2.)) << "Vector transformation should ignore the translation.";
+  EXPECT_EQ(t.ToMatrix4x4().TransformPoint(p3d(1., 1., 1.)), t(p3d(1., 1., 1.))) << "Matrix4x4 transformation differs from the affine transform.";
+}
+
+TEST(AffineTransform3DTests, Composition) {
+  AffineTransform3d a = AffineTransform3d::Rotation(vec3d(1., 1., 0.), 0.3) * AffineTransform3d::Translation(vec3d(1., -2., 0.5));
+  AffineTransform3d b = AffineTransform3d::Scale(vec3d(2., 3., 0.5)) * AffineTransform3d::Translation(vec3d(-4., 0., 1.));
+  p3d p(0.5, -1.5, 2.);
+  ExpectNear((a * b)(p), a(b(p)), "Composed transform differs from applying both transforms.");
+  AffineTransform3d c = a;
+  c *= b;
+  EXPECT_EQ(c, a * b) << "Compound composition is incorrect.";
+}
+
+TEST(AffineTransform3DTests, Inverse) {
+  AffineTransform3d t = AffineTransform3d::Scale(vec3d(2., 3., 0.5)) * AffineTransform3d::Rotation(vec3d(0., 1., 1.), 1.2) * AffineTransform3d::Translation(vec3d(1., 2., 3.));
+  p3d p(0.5, -1.5, 2.);
+  ASSERT_TRUE(t.IsInvertible()) << "Regular transform is considered singular.";
+  ExpectNear(t.Inverse()(t(p)), p, "Inverse did not undo the transform.");
+  EXPECT_FALSE(AffineTransform3d::Scale(vec3d(1., 0., 1.)).IsInvertible()) << "Singular transform is considered invertible.";
+  AffineTransform3d rigid = AffineTransform3d::Translation(vec3d(1., 2., 3.)) * AffineTransform3d::Rotation(vec3d(1., 0., 1.), double(PI) / 3.);
+  ExpectNear(rigid.InverseRigid()(rigid(p)), p, "Rigid inverse did not undo the transform.");
+  ExpectNear(rigid.InverseRigid()(p), rigid.Inverse()(p), "Rigid inverse differs from the general inverse.");
+}
+
+TEST(AffineTransform3DTests, CoordinateFrameConversion) {
+  CoordinateFrame3D<double> frame(p3d(1., 2., 3.), vec3d(0., 1., 0.), vec3d(-1., 0., 0.), vec3d(0., 0., 1.));
+  AffineTransform3d t(frame);
+  vec3d local(2., 3., 4.);
+  vec3d canonical = frame.CoordinateFrameToCanonicalCoordinates(local);
+  EXPECT_EQ(t.TransformVector(local), canonical) << "Transform differs from the frame's coordinate conversion.";
+  EXPECT_EQ(t(p3d(2., 3., 4.)), p3d(1., 2., 3.) + canonical) << "Transform did not move the origin to the frame origin.";
+  EXPECT_EQ(t.ToCoordinateFrame(), frame) << "Round trip through CoordinateFrame3D changed the frame.";
+}
+
+TEST(AffineTransform3DTests, CompileTimeEvaluation) {
+  constexpr AffineTransform3d t = AffineTransform3d::Translation(vec3d(1., 2., 3.)) * AffineTransform3d::Scale(vec3d(2., 2., 2.));
+  constexpr p3d p = t(p3d(1., 1., 1.));
+  static_assert(p.x_ == 3. && p.z_ == 5., "Affine transforms are not usable in constant expressions.");
+  EXPECT_EQ(t.Inverse()(p), p3d(1., 1., 1.)) << "Inverse of a compile-time transform is incorrect.";
+}
+
+TEST(AffineTransform3DTests, StringConversion) {
+  std::stringstream ss;
+  ss << AffineTransform3f::Translation(vec3f(1.f, 2.f, 3.f));
+  EXPECT_STREQ(ss.str().c_str(), "AffineTransform3D(m=Matrix3x3((1, 0, 0), (0, 1, 0), (0, 0, 1)), t=Vector3D(1, 2, 3))") << "String conversion returned incorrect result.";
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\bounding_volume_hierarchy.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<Sphered> RandomSpheres(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> position(-50., 50.);
+  std::uniform_real_distribution<double> radius(0.5, 4.);
+  std::vector<Sphered> spheres;
+  for (size_t i = 0; i < count; ++i) { spheres.push_back(Sphered(position(generator), position(generator), position(generator), radius(generator))); }
+  return spheres;
+}
+
+std::vector<Rectangle2Dd> RandomRectangles(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> position(-50., 50.);
+  std::uniform_real_distribution<double> size(-5., 5.);
+  std::vector<Rectangle2Dd> rectangles;
+  for (size_t i = 0; i < count; ++i) {
+    double x = position(generator), y = position(generator);
+    rectangles.push_back(Rectangle2Dd(x, y, x + size(generator), y + size(generator)));
+  }
+  return rectangles;
+}
+
+double SurfaceDistance(const Sphered& s, const p3d& p) { return std::fabs(s.SignedDistanceToSurface(p)); }
+double SurfaceDistance(const Rectangle2Dd& r, const p2d& p) { return r.FindNearestPoint(p).Distance(p); }
+
+// Compare every query of the hierarchy with a linear scan over the primitives.
+template<typename primitive, typename point, typename vector>
+void ExpectMatchesLinearScan(const std::vector<primitive>& primitives, const std::vector<point>& queries, const std::vector<vector>& directions) {
+  using traits = BvhPrimitiveTraits<primitive>;
+  BoundingVolumeHierarchy<primitive> bvh(primitives);
+  ASSERT_EQ(bvh.Size(), primitives.size());
+  for (size_t q = 0; q < queries.size(); ++q) {
+    const point& p = queries[q];
+    std::vector<size_t> expected_containing, containing;
+    for (size_t i = 0; i < primitives.size(); ++i) { if (traits::Contains(primitives[i], p)) { expected_containing.push_back(i); } }
+    bvh.FindContaining(p, containing);
+    std::sort(containing.begin(), containing.end());
+    EXPECT_EQ(containing, expected_containing) << "Containment query differs from linear scan for query " << q << ".";
+
+    double expected_distance = std::numeric_limits<double>::max();
+    for (const primitive& s : primitives) { expected_distance = std::min(expected_distance, SurfaceDistance(s, p)); }
+    point nearest;
+    size_t nearest_index = 0;
+    ASSERT_TRUE(bvh.FindNearestPoint(p, &nearest, &nearest_index));
+    EXPECT_NEAR(nearest.Distance(p), expected_distance, 1e-4) << "Nearest point query differs from linear scan for query " << q << ".";
+    EXPECT_NEAR(SurfaceDistance(primitives[nearest_index], p), expected_distance, 1e-4) << "Nearest point query reported the wrong primitive for query " << q << ".";
+
+    bool expected_hit = false;
+    double expected_t = std::numeric_limits<double>::max();
+    for (const primitive& s : primitives) {
+      double t;
+      if (traits::IntersectRay(s, p, directions[q], expected_t, &t)) { expected_hit = true; expected_t = t; }
+    }
+    double t = 0.;
+    size_t hit_index = 0;
+    bool hit = bvh.IntersectRay(p, directions[q], &t, &hit_index);
+    EXPECT_EQ(hit, expected_hit) << "Ray query differs from linear scan for query " << q << ".";
+    if (hit && expected_hit) {
+      EXPECT_DOUBLE_EQ(t, expected_t) << "Ray hit distance differs from linear scan for query " << q << ".";
+      double t_primitive;
+      EXPECT_TRUE(traits::IntersectRay(primitives[hit_index], p, directions[q], std::numeric_limits<double>::max(), &t_primitive)) << "Ray query reported a primitive that is not hit.";
+    }
+  }
+}
+
+} // namespace
+
+//
+// BoundingVolumeHierarchyTests
+//
+TEST(BoundingVolumeHierarchyTests, EmptyHierarchy) {
+  SphereBvh<double> bvh;
+  std::vector<size_t> containing;
+  p3d nearest;
+  double t;
+  bvh.FindContaining(p3d(0, 0, 0), containing);
+  EXPECT_TRUE(containing.empty()) << "Empty hierarchy reported containing primitives.";
+  EXPECT_FALSE(bvh.FindNearestPoint(p3d(0, 0, 0), &nearest)) << "Empty hierarchy reported a nearest point.";
+  EXPECT_FALSE(bvh.IntersectRay(p3d(0, 0, 0), vec3d(1, 0, 0), &t)) << "Empty hierarchy reported a ray hit.";
+}
+
+TEST(BoundingVolumeHierarchyTests, FlatLayout) {
+  SphereBvh<double> bvh(RandomSpheres(500, 1));
+  const std::vector<SphereBvh<double>::Node>& nodes = bvh.Nodes();
+  size_t leaf_primitives = 0;
+  for (size_t n = 0; n < nodes.size(); ++n) {
+    if (nodes[n].count_ > 0) { leaf_primitives += nodes[n].count_; continue; }
+    EXPECT_GT(nodes[n].offset_, n + 1) << "Second child of an interior node must follow the first child subtree.";
+    for (int a = 0; a < 3; ++a) {
+      EXPECT_LE(nodes[n].min_[a], nodes[n + 1].min_[a]) << "Parent bounds do not enclose the first child.";
+      EXPECT_GE(nodes[n].max_[a], nodes[nodes[n].offset_].max_[a]) << "Parent bounds do not enclose the second child.";
+    }
+  }
+  EXPECT_EQ(leaf_primitives, 500u) << "Leaves do not cover every primitive exactly once.";
+  EXPECT_LT(nodes.size(), 500u) << "Hierarchy has more nodes than expected for leaves of several primitives.";
+}
+
+TEST(BoundingVolumeHierarchyTests, SphereQueries) {
+  std::vector<Sphered> spheres = RandomSpheres(1000, 2);
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<double> position(-60., 60.);
+  std::vector<p3d> queries;
+  std::vector<vec3d> directions;
+  for (int i = 0; i < 200; ++i) {
+    queries.push_back(p3d(position(generator), position(generator), position(generator)));
+    directions.push_back(vec3d(position(generator), position(generator), position(generator)));
+  }
+  ExpectMatchesLinearScan(spheres, queries, directions);
+}
+
+TEST(BoundingVolumeHierarchyTests, RectangleQueries) {
+  std::vector<Rectangle2Dd> rectangles = RandomRectangles(1000, 4);
+  std::mt19937 generator(5);
+  std::uniform_real_distribution<double> position(-60., 60.);
+  std::vector<p2d> queries;
+  std::vector<vec2d> directions;
+  for (int i = 0; i < 200; ++i) {
+    queries.push_back(p2d(position(generator), position(generator)));
+    directions.push_back(vec2d(position(generator), position(generator)));
+  }
+  directions[0] = vec2d(1., 0.);
+  ExpectMatchesLinearScan(rectangles, queries, directions);
+}
+
+TEST(BoundingVolumeHierarchyTests, Refit) {
+  std::vector<Sphered> spheres = RandomSpheres(300, 6);
+  SphereBvh<double> bvh(spheres);
+  for (size_t i = 0; i < spheres.size(); i += 3) {
+    spheres[i] += vec3d(10., -5., 2.);
+    bvh.Set(i, spheres[i]);
+  }
+  bvh.Refit();
+  EXPECT_EQ(bvh.Get(3), spheres[3]) << "Updated primitive was not stored.";
+  std::vector<size_t> containing;
+  p3d center = spheres[99].c_;
+  bvh.FindContaining(center, containing);
+  EXPECT_NE(std::find(containing.begin(), containing.end(), size_t(99)), containing.end()) << "Moved primitive was not found after refitting.";
+  std::vector<p3d> queries;
+  std::vector<vec3d> directions;
+  for (size_t i = 0; i < spheres.size(); i += 7) { queries.push_back(spheres[i].c_ + vec3d(0.1, 0.2, 0.3)); directions.push_back(vec3d(1., 1., 0.)); }
+  ExpectMatchesLinearScan(spheres, queries, directions);
+}
@@ -13,4 +13,13 @@ using namespace j::math;
 //  EXPECT_EQ(vec_default, vec2i(0, 0)) << "Default constructor did not initialize to (0, 0). Values: " << vec_default;
 //  EXPECT_EQ(vec_xy, vec2i(3, 5)) << "Value-based constructor did not initialize to (3, 5). Values: " << vec_xy;
 //  EXPECT_EQ(vec_copy, vec2i(3, 5)) << "Copy constructor did not copy values (3, 5) correctly. Values: " << vec_copy;
-//}
\ No newline at end of file
+//}
+
+TEST(CoordinateFrame3DTests, CompileTimeEvaluation) {
+  constexpr cf3d canonical = cf3d::CarthesianCanonicalOrthonormal();
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  static_assert(canonical.IsRightHandedOrthonormal(), "Canonical coordinate frame is not usable in constant expressions.");
+#endif
+  static_assert(canonical.CanonicalCoordinatesToCoordinateFrame(vec3d(1., 2., 3.)) == vec3d(1., 2., 3.), "Coordinate conversion is not usable in constant expressions.");
+  EXPECT_TRUE(canonical.IsOrthonormal()) << "Compile-time coordinate frame is incorrect at run time.";
+}
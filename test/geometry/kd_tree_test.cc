@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\kd_tree.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+// Points in a few tight clusters, with some duplicates, to exercise uneven splits and ties.
+template<typename valuetype>
+std::vector<Point3D<valuetype>> ClusteredPoints(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> center(-100., 100.);
+  std::normal_distribution<double> spread(0., 2.);
+  std::vector<Point3D<valuetype>> centers;
+  for (int i = 0; i < 5; ++i) { centers.push_back(Point3D<valuetype>(valuetype(center(generator)), valuetype(center(generator)), valuetype(center(generator)))); }
+  std::vector<Point3D<valuetype>> points;
+  for (size_t i = 0; i < count; ++i) {
+    const Point3D<valuetype>& c = centers[i % centers.size()];
+    points.push_back(Point3D<valuetype>(c.x_ + valuetype(spread(generator)), c.y_ + valuetype(spread(generator)), c.z_ + valuetype(spread(generator))));
+  }
+  for (size_t i = 0; i < count / 10; ++i) { points[i + count / 2] = points[i]; }
+  return points;
+}
+
+template<typename valuetype>
+valuetype DistanceSquared(const Point3D<valuetype>& a, const Point3D<valuetype>& b) {
+  valuetype d2 = valuetype(0);
+  for (int i = 0; i < 3; ++i) { valuetype e = b[i] - a[i]; d2 += e * e; }
+  return d2;
+}
+
+// Indices of the k nearest points by a linear scan, ties ordered by index.
+template<typename valuetype>
+std::vector<size_t> LinearNearest(const std::vector<Point3D<valuetype>>& points, const Point3D<valuetype>& p, size_t k) {
+  std::vector<std::pair<valuetype, size_t>> candidates;
+  for (size_t i = 0; i < points.size(); ++i) { candidates.push_back(std::make_pair(DistanceSquared(points[i], p), i)); }
+  std::sort(candidates.begin(), candidates.end());
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < k && i < candidates.size(); ++i) { indices.push_back(candidates[i].second); }
+  return indices;
+}
+
+template<typename valuetype>
+void ExpectMatchesLinearScan() {
+  std::vector<Point3D<valuetype>> points = ClusteredPoints<valuetype>(3000, 1);
+  KdTree3D<valuetype> tree(points);
+  ASSERT_EQ(tree.Size(), points.size());
+  std::vector<Point3D<valuetype>> queries = ClusteredPoints<valuetype>(40, 2);
+  queries.push_back(points[1600]);  // A duplicated point
+  queries.push_back(Point3D<valuetype>(valuetype(1000), valuetype(1000), valuetype(1000)));  // Far outside the points
+  ForEachSimdLevel([&](SimdLevel level) {
+    for (size_t q = 0; q < queries.size(); ++q) {
+      std::vector<size_t> indices;
+      for (size_t k : { 1, 7, 100 }) {
+        tree.FindNearest(queries[q], k, indices);
+        EXPECT_EQ(indices, LinearNearest(points, queries[q], k)) << "Nearest neighbor query differs from linear scan for query " << q << " on SIMD level " << int(level) << ".";
+      }
+    }
+  });
+}
+
+} // namespace
+
+//
+// KdTreeTests
+//
+TEST(KdTreeTests, NearestDouble) {
+  ExpectMatchesLinearScan<double>();
+}
+
+TEST(KdTreeTests, NearestFloat) {
+  ExpectMatchesLinearScan<float>();
+}
+
+TEST(KdTreeTests, Batch) {
+  std::vector<p3d> points = ClusteredPoints<double>(5000, 3);
+  KdTree3D<double> serial(points), parallel(points, 4);
+  std::vector<p3d> queries = ClusteredPoints<double>(500, 4);
+  std::vector<size_t> batch, single;
+  parallel.FindNearest(queries, 6, batch, 4);
+  ASSERT_EQ(batch.size(), queries.size() * 6) << "Wrong number of batch results.";
+  for (size_t q = 0; q < queries.size(); ++q) {
+    serial.FindNearest(queries[q], 6, single);
+    EXPECT_TRUE(std::equal(single.begin(), single.end(), batch.begin() + ptrdiff_t(q * 6))) << "Batch result differs for query " << q << ".";
+  }
+  KdTree3D<double> small(std::vector<p3d>(points.begin(), points.begin() + 3));
+  small.FindNearest(queries, 6, batch);
+  EXPECT_EQ(batch.size(), queries.size() * 3) << "Batch results not limited to the number of points.";
+}
+
+TEST(KdTreeTests, Approximate) {
+  std::vector<p3d> points = ClusteredPoints<double>(5000, 5);
+  KdTree3D<double> tree(points);
+  std::vector<p3d> queries = ClusteredPoints<double>(200, 6);
+  const double epsilon = 0.5;
+  for (const p3d& q : queries) {
+    std::vector<size_t> exact = LinearNearest(points, q, 10), indices;
+    tree.FindNearest(q, 10, indices, epsilon);
+    ASSERT_EQ(indices.size(), exact.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      EXPECT_LE(std::sqrt(DistanceSquared(points[indices[i]], q)), (1. + epsilon) * std::sqrt(DistanceSquared(points[exact[i]], q)) + 1e-12) << "Approximate neighbor " << i << " too far.";
+    }
+  }
+}
+
+TEST(KdTreeTests, Points2D) {
+  KdTree2D<float> tree(std::vector<p2f>{ p2f(0.f, 0.f), p2f(1.5f, 0.f), p2f(-3.f, -3.f), p2f(0.f, 0.9f) });
+  std::vector<size_t> indices;
+  tree.FindNearest(p2f(2.f, 0.f), 2, indices);
+  EXPECT_EQ(indices, std::vector<size_t>({ 1, 0 })) << "Wrong 2D nearest neighbors.";
+  tree.FindNearest(p2f(100.f, 100.f), 10, indices);
+  EXPECT_EQ(indices.size(), 4u) << "Not all points reported when asking for more than there are.";
+  KdTree2D<float> empty;
+  empty.FindNearest(p2f(0.f, 0.f), 3, indices);
+  EXPECT_TRUE(indices.empty()) << "Empty tree reported points.";
+}
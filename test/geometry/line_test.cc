@@ -17,4 +17,14 @@ using namespace j::math;
 
 //
 // Line3DTests
-//
\ No newline at end of file
+//
+// Lines normalize their direction, which needs a constexpr Sqrt, see sqrt.h
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+TEST(Line3DTests, CompileTimeEvaluation) {
+  constexpr Line3d line(Point3D<double>(1., 2., 3.), Vector3D<double>(0., 0., 4.));
+  static_assert(line.GetDirection() == Vector3D<double>(0., 0., 1.), "Line direction is not normalized in constant expressions.");
+  static_assert(line(2.) == Point3D<double>(1., 2., 5.), "Line evaluation is not usable in constant expressions.");
+  static_assert(line.IsOnCurve(Point3D<double>(1., 2., -7.)), "Line containment is not usable in constant expressions.");
+  EXPECT_EQ(line.FindNearestPoint(Point3D<double>(1., 2., 8.)), Point3D<double>(1., 2., 8.)) << "Compile-time line is incorrect at run time.";
+}
+#endif
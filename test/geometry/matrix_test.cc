@@ -0,0 +1,74 @@
+#include <sstream>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\matrix.h"
+#include "..\..\lib\utility\pi.h"
+
+using namespace j::math;
+
+//
+// Matrix3x3Tests
+//
+TEST(Matrix3x3Tests, Constructors) {
+  mat3d m_default;
+  mat3d m_values(1., 2., 3., 4., 5., 6., 7., 8., 9.);
+  EXPECT_EQ(m_default, mat3d(0., 0., 0., 0., 0., 0., 0., 0., 0.)) << "Default constructor did not initialize to zero.";
+  EXPECT_EQ(m_values(1, 2), 6.) << "Value-based constructor is not row-major.";
+  EXPECT_EQ(mat3d::FromRows(vec3d(1., 2., 3.), vec3d(4., 5., 6.), vec3d(7., 8., 9.)), m_values) << "Construction from rows is incorrect.";
+  EXPECT_EQ(mat3d::FromColumns(vec3d(1., 4., 7.), vec3d(2., 5., 8.), vec3d(3., 6., 9.)), m_values) << "Construction from columns is incorrect.";
+  EXPECT_EQ(m_values.Transpose(), mat3d::FromColumns(vec3d(1., 2., 3.), vec3d(4., 5., 6.), vec3d(7., 8., 9.))) << "Transpose is incorrect.";
+}
+
+TEST(Matrix3x3Tests, Multiplication) {
+  mat3d a(1., 2., 3., 4., 5., 6., 7., 8., 10.);
+  EXPECT_EQ(a * vec3d(1., 0., -1.), vec3d(-2., -2., -3.)) << "Matrix-vector product is incorrect.";
+  EXPECT_EQ(a * mat3d::Identity(), a) << "Multiplication by the identity changed the matrix.";
+  EXPECT_EQ(a * mat3d::Scale(vec3d(2., 1., 1.)), mat3d(2., 2., 3., 8., 5., 6., 14., 8., 10.)) << "Matrix product is incorrect.";
+  mat3d b = a;
+  b *= a;
+  EXPECT_EQ(b, a * a) << "Compound multiplication is incorrect.";
+}
+
+TEST(Matrix3x3Tests, Inverse) {
+  mat3d a(1., 2., 3., 4., 5., 6., 7., 8., 10.);
+  EXPECT_EQ(a.Determinant(), -3.) << "Determinant is incorrect.";
+  EXPECT_TRUE(a.IsInvertible()) << "Regular matrix is considered singular.";
+  EXPECT_FALSE(mat3d(1., 2., 3., 4., 5., 6., 7., 8., 9.).IsInvertible()) << "Singular matrix is considered invertible.";
+  mat3d product = a * a.Inverse();
+  for (int r = 0; r < 3; ++r) { for (int c = 0; c < 3; ++c) { EXPECT_NEAR(product(r, c), (r == c) ? 1. : 0., 1e-12) << "Matrix times its inverse is not the identity."; } }
+}
+
+TEST(Matrix3x3Tests, Rotation) {
+  mat3d r = mat3d::Rotation(vec3d(0., 0., 2.), double(PI) / 2.);
+  vec3d v = r * vec3d(1., 0., 0.);
+  EXPECT_NEAR(v.x_, 0., 1e-15) << "Rotation around z is incorrect.";
+  EXPECT_NEAR(v.y_, 1., 1e-15) << "Rotation around z is incorrect.";
+  EXPECT_TRUE(r.IsOrthonormal()) << "Rotation matrix is not orthonormal.";
+  EXPECT_NEAR(r.Determinant(), 1., 1e-15) << "Rotation matrix does not preserve volume.";
+}
+
+//
+// Matrix4x4Tests
+//
+TEST(Matrix4x4Tests, TransformPoint) {
+  mat4d m(1., 0., 0., 1., 0., 2., 0., 2., 0., 0., 1., 3., 0., 0., 0., 1.);
+  EXPECT_TRUE(m.IsAffine()) << "Affine matrix is not recognized.";
+  EXPECT_EQ(m.TransformPoint(p3d(1., 1., 1.)), p3d(2., 4., 4.)) << "Point transformation is incorrect.";
+  EXPECT_EQ(m.TransformVector(vec3d(1., 1., 1.)), vec3d(1., 2., 1.)) << "Vector transformation should ignore the translation.";
+  mat4d perspective(1., 0., 0., 0., 0., 1., 0., 0., 0., 0., 1., 0., 0., 0., 1., 0.);
+  EXPECT_EQ(perspective.TransformPoint(p3d(2., 4., 2.)), p3d(1., 2., 1.)) << "Perspective division is incorrect.";
+}
+
+TEST(Matrix4x4Tests, Inverse) {
+  mat4d m(2., 0., 1., 3., 1., 1., 0., -2., 0., 3., 1., 1., 1., 0., 0., 4.);
+  EXPECT_TRUE(m.IsInvertible()) << "Regular matrix is considered singular.";
+  EXPECT_NEAR(m.Determinant(), 24., 1e-12) << "Determinant is incorrect.";
+  mat4d product = m * m.Inverse();
+  for (int r = 0; r < 4; ++r) { for (int c = 0; c < 4; ++c) { EXPECT_NEAR(product(r, c), (r == c) ? 1. : 0., 1e-12) << "Matrix times its inverse is not the identity."; } }
+  EXPECT_EQ(m.Transpose().Transpose(), m) << "Double transpose changed the matrix.";
+}
+
+TEST(Matrix4x4Tests, StringConversion) {
+  std::stringstream ss;
+  ss << mat4f::Identity();
+  EXPECT_STREQ(ss.str().c_str(), "Matrix4x4((1, 0, 0, 0), (0, 1, 0, 0), (0, 0, 1, 0), (0, 0, 0, 1))") << "String conversion returned incorrect result.";
+}
@@ -9,6 +9,15 @@ namespace math {
 //
 // Plane
 //
+TEST(Plane, SurfaceQueries) {
+  Planed plane(p3d(0, 0, 1), vec3d(0, 0, 2));
+  EXPECT_EQ(plane.Normal(), vec3d(0, 0, 1)) << "Normal is not normalized.";
+  EXPECT_DOUBLE_EQ(plane.DistanceToSurface(p3d(3, 4, -2)), 3.0) << "Distance below the plane is not positive.";
+  EXPECT_EQ(plane.FindNearestPoint(p3d(3, 4, 5)), p3d(3, 4, 1)) << "Nearest point is not projected onto the plane.";
+  plane.SetNormal(vec3d(0, 3, 0));
+  EXPECT_EQ(plane.Normal(), vec3d(0, 1, 0)) << "SetNormal ignores its argument.";
+}
+
 TEST(Plane, FunctionGroup1) {
   // ...
   // EXPECT_EQ(a, b) << "What went wrong.";
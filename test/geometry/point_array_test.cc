@@ -0,0 +1,47 @@
+#include <random>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\point_array.h"
+
+using namespace j::math;
+
+//
+// Point3DArrayTests
+//
+TEST(Point3DArrayTests, Constructors) {
+  p3arrayi array_default;
+  p3arrayi array_points(std::vector<p3i>{ p3i(1, 2, 3), p3i(4, 5, 6) });
+  EXPECT_EQ(array_default.Length(), 0u) << "Default constructor did not create an empty array.";
+  EXPECT_EQ(array_points.Length(), 2u) << "Conversion from std::vector did not copy all elements.";
+  EXPECT_EQ(array_points[1], p3i(4, 5, 6)) << "Conversion from std::vector did not copy values correctly.";
+  std::vector<p3i> round_trip = array_points.ToVector();
+  EXPECT_EQ(round_trip[0], p3i(1, 2, 3)) << "Conversion to std::vector did not copy values correctly.";
+}
+
+TEST(Point3DArrayTests, ProxyElementAccess) {
+  p3arrayi array(2);
+  array[0] = p3i(2, 3, 8);
+  array[1] = array[0] + vec3i(1, 1, 1);
+  array[1] -= vec3i(0, 0, 2);
+  EXPECT_EQ(array.Get(0), p3i(2, 3, 8)) << "Assignment through proxy did not write to the array.";
+  EXPECT_EQ(array.Get(1), p3i(3, 4, 7)) << "Translation through proxy returned incorrect result.";
+  EXPECT_EQ(array[0] - p3i(7, 6, 8), vec3i(5, 3, 0)) << "Point difference through proxy returned incorrect vector.";
+  EXPECT_EQ(array[0].Distance(p3i(2, 3, 5)), 3.f) << "Distance through proxy is incorrect.";
+}
+
+TEST(Point3DArrayTests, BatchDistance) {
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<double> distribution(-10., 10.);
+  std::vector<p3d> points;
+  for (int i = 0; i < 77; ++i) { points.push_back(p3d(distribution(generator), distribution(generator), distribution(generator))); }
+  p3d p(0.5, -1.5, 2.5);
+  std::vector<double> distances(points.size()), distances_squared(points.size()), array_distances;
+  BatchDistance(points.data(), p, distances.data(), points.size());
+  BatchDistanceSquared(points.data(), p, distances_squared.data(), points.size());
+  BatchDistance(p3arrayd(points), p, array_distances);
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(distances[i], (p - points[i]).Length()) << "Batch distance is incorrect at index " << i << ".";
+    EXPECT_EQ(distances_squared[i], (p - points[i]).LengthSquared()) << "Batch squared distance is incorrect at index " << i << ".";
+    EXPECT_EQ(array_distances[i], distances[i]) << "Batch distance on arrays differs from array-of-structs version at index " << i << ".";
+  }
+}
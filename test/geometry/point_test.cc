@@ -192,4 +192,15 @@ TEST(Point3DTests, Distance) {
   EXPECT_EQ(p1.Distance(p2), 5.74456264653802f) << "Distance between two points with all positive components is incorrect.";
   EXPECT_EQ(p1.Distance(p3), 11.35781669160054f) << "Distance between two points with some negative components is incorrect.";
   EXPECT_EQ(p1.Distance(p4), 13.74772708486752f) << "Distance between two points with all positive and all negative components is incorrect.";
-}
\ No newline at end of file
+}
+
+TEST(Point3DTests, CompileTimeEvaluation) {
+  constexpr p3d p1(1., 2., 3.);
+  constexpr p3d p2(3., 5., 9.);
+  static_assert(p1 + vec3d(2., 3., 6.) == p2, "Point translation is not usable in constant expressions.");
+  static_assert((p1 - p2) == vec3d(2., 3., 6.), "Point difference is not usable in constant expressions.");
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  static_assert(p1.Distance(p2) == 7.f, "Point distance is not usable in constant expressions.");
+#endif
+  EXPECT_EQ(p1.Distance(p2), 7.f) << "Compile-time point is incorrect at run time.";
+}
@@ -0,0 +1,78 @@
+#include <cstring>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\quaternion_batch.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+// Random vectors with a length that is not a multiple of any SIMD width or of the block size, so the scalar tail and
+// uneven thread ranges are exercised as well.
+template<typename valuetype>
+std::vector<Vector3D<valuetype>> RandomVectors(size_t count, unsigned int seed) {
+  std::vector<valuetype> values = RandomValues<valuetype>(3 * count, seed);
+  std::vector<Vector3D<valuetype>> vectors;
+  for (size_t i = 0; i < count; ++i) { vectors.push_back(Vector3D<valuetype>(values[3 * i], values[3 * i + 1], values[3 * i + 2])); }
+  return vectors;
+}
+
+template<typename valuetype>
+bool BitwiseEqual(valuetype a, valuetype b) { return std::memcmp(&a, &b, sizeof(valuetype)) == 0; }
+
+template<typename element>
+bool BitwiseEqualComponents(const element& a, const element& b) { return BitwiseEqual(a.x_, b.x_) && BitwiseEqual(a.y_, b.y_) && BitwiseEqual(a.z_, b.z_); }
+
+template<typename valuetype>
+void ExpectBatchMatchesScalar() {
+  const size_t count = 1003;
+  std::vector<Vector3D<valuetype>> vectors = RandomVectors<valuetype>(count, 1);
+  std::vector<Point3D<valuetype>> points;
+  for (const Vector3D<valuetype>& v : vectors) { points.push_back(Point3D<valuetype>(v.x_, v.y_, v.z_)); }
+  Quaternion<valuetype> q = Quaternion<valuetype>::FromAxisAngle(Vector3D<valuetype>(1, 2, 3), valuetype(0.7));
+  ForEachSimdLevel([&](SimdLevel level) {
+    for (size_t thread_count : { size_t(1), size_t(4), size_t(0) }) {
+      std::vector<Vector3D<valuetype>> rotated_vectors(count);
+      std::vector<Point3D<valuetype>> rotated_points(count);
+      BatchRotate(vectors.data(), q, rotated_vectors.data(), count, thread_count);
+      BatchRotate(points.data(), q, rotated_points.data(), count, thread_count);
+      Vector3DArray<valuetype> vector_array(vectors);
+      BatchRotate(vector_array, q, vector_array, thread_count);
+      for (size_t i = 0; i < count; ++i) {
+        ASSERT_TRUE(BitwiseEqualComponents(rotated_vectors[i], q.Rotate(vectors[i]))) << "Batch vector rotation differs from scalar version at index " << i << " (SIMD level " << int(level) << ", " << thread_count << " threads).";
+        ASSERT_TRUE(BitwiseEqualComponents(rotated_points[i], q.Rotate(points[i]))) << "Batch point rotation differs from scalar version at index " << i << " (SIMD level " << int(level) << ", " << thread_count << " threads).";
+        ASSERT_TRUE(BitwiseEqualComponents(vector_array.Get(i), q.Rotate(vectors[i]))) << "In-place structure-of-arrays rotation differs from scalar version at index " << i << " (SIMD level " << int(level) << ", " << thread_count << " threads).";
+      }
+    }
+  });
+}
+
+} // namespace
+
+//
+// QuaternionBatchTests
+//
+TEST(QuaternionBatchTests, MatchesScalarFloat) {
+  ExpectBatchMatchesScalar<float>();
+}
+
+TEST(QuaternionBatchTests, MatchesScalarDouble) {
+  ExpectBatchMatchesScalar<double>();
+}
+
+TEST(QuaternionBatchTests, Compose) {
+  const size_t count = 20000;
+  quatf delta = quatf::FromAxisAngle(vec3f(0.f, 1.f, 0.f), 0.01f);
+  std::vector<quatf> orientations(count), expected(count);
+  for (size_t i = 0; i < count; ++i) { orientations[i] = expected[i] = quatf::FromAxisAngle(vec3f(1.f, float(i), 2.f), float(i) * 0.001f); }
+  for (int tick = 0; tick < 100; ++tick) {
+    BatchCompose(delta, orientations.data(), orientations.data(), count, 4);
+    for (quatf& q : expected) { q = (delta * q).RenormalizeFast(); }
+  }
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_TRUE(BitwiseEqual(orientations[i].w_, expected[i].w_) && BitwiseEqualComponents(orientations[i], expected[i])) << "Batch composition differs from scalar version at index " << i << ".";
+    ASSERT_TRUE(orientations[i].IsNormalized()) << "Batch composition did not keep orientation " << i << " normalized.";
+  }
+}
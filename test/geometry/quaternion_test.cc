@@ -0,0 +1,115 @@
+#include <sstream>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\quaternion.h"
+#include "..\..\lib\utility\pi.h"
+
+using namespace j::math;
+
+namespace {
+
+// Component-wise comparison with a tolerance, for results that go through trigonometric functions.
+void ExpectNear(const vec3d& a, const vec3d& b, const char* message) {
+  EXPECT_NEAR(a.x_, b.x_, 1e-12) << message;
+  EXPECT_NEAR(a.y_, b.y_, 1e-12) << message;
+  EXPECT_NEAR(a.z_, b.z_, 1e-12) << message;
+}
+
+} // namespace
+
+//
+// QuaternionTests
+//
+TEST(QuaternionTests, Constructors) {
+  quatd q_default;
+  EXPECT_EQ(q_default, quatd(1., 0., 0., 0.)) << "Default constructor did not initialize to the identity rotation.";
+  EXPECT_EQ(quatd(2., vec3d(3., 4., 5.)), quatd(2., 3., 4., 5.)) << "Construction from a scalar and vector part is incorrect.";
+  quatd q = quatd::FromAxisAngle(vec3d(0., 0., 3.), double(PI) / 2.);
+  EXPECT_TRUE(q.IsNormalized()) << "Axis-angle quaternion is not normalized.";
+  EXPECT_NEAR(q.Angle(), double(PI) / 2., 1e-12) << "Rotation angle is incorrect.";
+  ExpectNear(q.Axis(), vec3d(0., 0., 1.), "Rotation axis is incorrect.");
+}
+
+TEST(QuaternionTests, Rotate) {
+  quatd q = quatd::FromAxisAngle(vec3d(0., 0., 1.), double(PI) / 2.);
+  ExpectNear(q.Rotate(vec3d(1., 0., 0.)), vec3d(0., 1., 0.), "Rotation around z is incorrect.");
+  vec3d axis(1., 2., 3.), v(-2., 0.5, 4.);
+  quatd r = quatd::FromAxisAngle(axis, 0.7);
+  ExpectNear(r.Rotate(v), mat3d::Rotation(axis, 0.7) * v, "Rotation differs from the rotation matrix.");
+  ExpectNear(r.Rotate(v), v.Rotate(axis, 0.7), "Rotation differs from Vector3D::Rotate.");
+  ExpectNear(r.ToRotationMatrix() * v, r.Rotate(v), "Rotation matrix of the quaternion is incorrect.");
+  EXPECT_EQ(r.Rotate(p3d(-2., 0.5, 4.)), p3d(r.Rotate(v).x_, r.Rotate(v).y_, r.Rotate(v).z_)) << "Point rotation differs from vector rotation.";
+}
+
+TEST(QuaternionTests, Composition) {
+  quatd a = quatd::FromAxisAngle(vec3d(1., 0., 1.), 0.4);
+  quatd b = quatd::FromAxisAngle(vec3d(0., 2., -1.), 1.3);
+  vec3d v(1., 2., 3.);
+  ExpectNear((a * b).Rotate(v), a.Rotate(b.Rotate(v)), "Composition did not rotate by the right operand first.");
+  ExpectNear((a * a.Inverse()).Rotate(v), v, "Quaternion times its inverse is not the identity.");
+  ExpectNear(a.Conjugate().Rotate(a.Rotate(v)), v, "Conjugate did not undo the rotation.");
+  quatd c = a;
+  c *= b;
+  EXPECT_EQ(c, a * b) << "Compound composition is incorrect.";
+}
+
+TEST(QuaternionTests, RotationMatrixRoundTrip) {
+  for (const vec3d& axis : { vec3d(1., 0., 0.), vec3d(0., 1., 0.), vec3d(0., 0., 1.), vec3d(1., -2., 0.5) }) {
+    for (double angle : { 0.1, 2., 3.1 }) {
+      quatd q = quatd::FromAxisAngle(axis, angle);
+      quatd round_trip = quatd::FromRotationMatrix(q.ToRotationMatrix());
+      EXPECT_NEAR(std::fabs(round_trip.ScalarProduct(q)), 1., 1e-12) << "Round trip through the rotation matrix changed the rotation.";
+    }
+  }
+  quatd q = quatd::FromAxisAngle(vec3d(1., 1., 0.), 0.9);
+  cf3d frame = q.ToCoordinateFrame(p3d(1., 2., 3.));
+  EXPECT_NEAR(frame.u_.ScalarProduct(frame.v_), 0., 1e-15) << "Coordinate frame of a unit quaternion is not orthogonal.";
+  ExpectNear(frame.u_.CrossProduct(frame.v_), frame.w_, "Coordinate frame of a unit quaternion is not right-handed.");
+  EXPECT_NEAR(quatd::FromCoordinateFrame(frame).ScalarProduct(q), 1., 1e-12) << "Round trip through the coordinate frame changed the rotation.";
+}
+
+TEST(QuaternionTests, Interpolation) {
+  quatd a = quatd::FromAxisAngle(vec3d(0., 0., 1.), 0.2);
+  quatd b = quatd::FromAxisAngle(vec3d(0., 0., 1.), 1.4);
+  EXPECT_EQ(quatd::Slerp(a, b, 0.), a) << "Slerp does not start at the first rotation.";
+  EXPECT_EQ(quatd::Slerp(a, b, 1.), b) << "Slerp does not end at the second rotation.";
+  EXPECT_EQ(quatd::Slerp(a, b, 0.25), quatd::FromAxisAngle(vec3d(0., 0., 1.), 0.5)) << "Slerp does not have a constant angular velocity.";
+  EXPECT_EQ(quatd::Slerp(a, -b, 0.25), quatd::FromAxisAngle(vec3d(0., 0., 1.), 0.5)) << "Slerp did not take the shortest path.";
+  EXPECT_EQ(quatd::Nlerp(a, b, 0.5), quatd::FromAxisAngle(vec3d(0., 0., 1.), 0.8)) << "Nlerp midpoint is incorrect.";
+  EXPECT_TRUE(quatd::Nlerp(a, b, 0.3).IsNormalized()) << "Nlerp result is not normalized.";
+  EXPECT_EQ(quatd::Slerp(a, a, 0.5), a) << "Slerp between identical rotations is incorrect.";
+}
+
+TEST(QuaternionTests, RenormalizeFast) {
+  quatf q = quatf::FromAxisAngle(vec3f(1.f, 2.f, 3.f), 0.01f);
+  quatf orientation, reference;
+  for (int i = 0; i < 100000; ++i) {
+    orientation = (q * orientation).RenormalizeFast();
+    reference = q * reference;
+  }
+  EXPECT_NEAR(orientation.Length(), 1.f, 1e-6f) << "Incremental renormalization did not prevent drift.";
+  EXPECT_GT(std::fabs(reference.Length() - 1.f), std::fabs(orientation.Length() - 1.f)) << "Renormalized orientation drifted more than the unnormalized one.";
+}
+
+TEST(QuaternionTests, CompileTimeEvaluation) {
+  constexpr quatd q(0., 0., 0., 1.);
+  constexpr vec3d v = q.Rotate(vec3d(1., 0., 0.));
+  static_assert(v.x_ == -1. && v.y_ == 0., "Quaternion rotation is not usable in constant expressions.");
+  constexpr quatd r = (q * q).Conjugate();
+  EXPECT_EQ(r, quatd(-1., 0., 0., 0.)) << "Compile-time composition is incorrect.";
+}
+
+TEST(QuaternionTests, StringConversion) {
+  std::stringstream ss;
+  ss << quatf(1.f, 2.f, 3.f, 4.f);
+  EXPECT_STREQ(ss.str().c_str(), "Quaternion(1, 2, 3, 4)") << "String conversion returned incorrect result.";
+}
+
+//
+// Vector rotation (Vector2D::Rotate and Vector3D::Rotate)
+//
+TEST(QuaternionTests, VectorRotate) {
+  vec2d v2 = vec2d(1., 0.).Rotate(double(PI) / 2.);
+  EXPECT_NEAR(v2.x_, 0., 1e-15) << "Vector2D rotation is incorrect.";
+  EXPECT_NEAR(v2.y_, 1., 1e-15) << "Vector2D rotation is incorrect.";
+  ExpectNear(vec3d(0., 1., 0.).Rotate(vec3d(2., 0., 0.), double(PI) / 2.), vec3d(0., 0., 1.), "Vector3D rotation is incorrect.");
+}
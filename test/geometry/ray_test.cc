@@ -0,0 +1,117 @@
+#include <cstring>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\ray.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+template<typename valuetype>
+bool BitwiseEqual(valuetype a, valuetype b) { return std::memcmp(&a, &b, sizeof(valuetype)) == 0; }
+
+// Random rays starting in [-10, 10]^3, aimed roughly at the origin so that a good share of them hits the primitives.
+template<typename valuetype>
+std::vector<Ray3D<valuetype>> RandomRays(size_t count, unsigned int seed) {
+  std::vector<valuetype> values = RandomValues<valuetype>(6 * count, seed, -10., 10.);
+  std::vector<Ray3D<valuetype>> rays;
+  for (size_t i = 0; i < count; ++i) {
+    const valuetype* v = &values[6 * i];
+    Point3D<valuetype> origin(v[0], v[1], v[2]);
+    Point3D<valuetype> target(v[3] / 5, v[4] / 5, v[5] / 5);
+    rays.push_back(Ray3D<valuetype>(origin, origin - target));
+  }
+  // Axis-aligned directions exercise the infinite inverse direction components
+  rays[0] = Ray3D<valuetype>(Point3D<valuetype>(-5, 0.5, 0.5), Vector3D<valuetype>(1, 0, 0));
+  rays[1] = Ray3D<valuetype>(Point3D<valuetype>(0.5, 5, 0.5), Vector3D<valuetype>(0, -1, 0));
+  return rays;
+}
+
+// Packets must report the same hits and hit parameters as the individual rays.
+template<typename valuetype, int size>
+void ExpectPacketMatchesScalar() {
+  std::vector<Ray3D<valuetype>> rays = RandomRays<valuetype>(size * 64, 11);
+  Sphere<valuetype> sphere(Point3D<valuetype>(1, -1, 0.5), 2);
+  Plane<valuetype> plane(Point3D<valuetype>(0, 0, 1), Vector3D<valuetype>(1, 2, 3));
+  Point3D<valuetype> min(-1, -2, -1), max(2, 1, 1);
+  ForEachSimdLevel([&](SimdLevel level) {
+    for (size_t first = 0; first < rays.size(); first += size) {
+      RayPacket3D<valuetype, size> packet(&rays[first]);
+      valuetype t_sphere[size], t_plane[size], t_box[size];
+      int mask_sphere = Intersect(packet, sphere, t_sphere, valuetype(12));
+      int mask_plane = Intersect(packet, plane, t_plane, valuetype(12));
+      int mask_box = IntersectBox(packet, min, max, t_box, valuetype(12));
+      for (int i = 0; i < size; ++i) {
+        const Ray3D<valuetype>& ray = rays[first + i];
+        valuetype t;
+        bool hit = ray.Intersect(sphere, &t, valuetype(12));
+        EXPECT_EQ(hit, (mask_sphere & (1 << i)) != 0) << "Packet sphere hit differs from the scalar hit (level " << int(level) << ", ray " << first + i << ").";
+        if (hit) { EXPECT_TRUE(BitwiseEqual(t, t_sphere[i])) << "Packet sphere hit parameter differs from the scalar one (level " << int(level) << ", ray " << first + i << ")."; }
+        hit = ray.Intersect(plane, &t, valuetype(12));
+        EXPECT_EQ(hit, (mask_plane & (1 << i)) != 0) << "Packet plane hit differs from the scalar hit (level " << int(level) << ", ray " << first + i << ").";
+        if (hit) { EXPECT_TRUE(BitwiseEqual(t, t_plane[i])) << "Packet plane hit parameter differs from the scalar one (level " << int(level) << ", ray " << first + i << ")."; }
+        hit = ray.IntersectBox(min, max, &t, valuetype(12));
+        EXPECT_EQ(hit, (mask_box & (1 << i)) != 0) << "Packet box hit differs from the scalar hit (level " << int(level) << ", ray " << first + i << ").";
+        if (hit) { EXPECT_TRUE(BitwiseEqual(t, t_box[i])) << "Packet box hit parameter differs from the scalar one (level " << int(level) << ", ray " << first + i << ")."; }
+      }
+    }
+  });
+}
+
+} // namespace
+
+TEST(RayTests, Construction) {
+  Ray3D<double> ray(Point3D<double>(1, 2, 3), Vector3D<double>(0, 0, 2));
+  EXPECT_EQ(Vector3D<double>(0, 0, 1), ray.GetDirection()) << "Ray direction is not normalized.";
+  EXPECT_EQ(Point3D<double>(1, 2, 5), ray(2)) << "Ray parametric specification is incorrect.";
+  EXPECT_EQ(2.0, ray.FindNearestParameterValue(Point3D<double>(4, 4, 5))) << "Nearest parameter value on the ray is incorrect.";
+  EXPECT_EQ(Point3D<double>(1, 2, 3), ray.FindNearestPoint(Point3D<double>(0, 0, -4))) << "Nearest point behind the ray origin is not the origin.";
+  Vector3D<double> inverse = Ray3D<double>(Point3D<double>(0, 0, 0), Vector3D<double>(0, 2, 0)).GetInverseDirection();
+  EXPECT_EQ(1.0, inverse.y_) << "Inverse direction is incorrect.";
+  EXPECT_TRUE(std::isinf(inverse.x_) && std::isinf(inverse.z_)) << "Inverse of a zero direction component is not infinite.";
+}
+
+TEST(RayTests, IntersectSphere) {
+  Sphere<double> sphere(Point3D<double>(0, 0, 0), 2);
+  double t = 0;
+  EXPECT_TRUE(Ray3D<double>(Point3D<double>(-5, 0, 0), Vector3D<double>(1, 0, 0)).Intersect(sphere, &t)) << "Ray towards the sphere misses it.";
+  EXPECT_EQ(3.0, t) << "Ray-sphere hit parameter is incorrect.";
+  EXPECT_TRUE(Ray3D<double>(Point3D<double>(0, 0, 0), Vector3D<double>(0, 1, 0)).Intersect(sphere, &t)) << "Ray from inside the sphere misses it.";
+  EXPECT_EQ(2.0, t) << "Ray from inside the sphere does not report the exit point.";
+  EXPECT_FALSE(Ray3D<double>(Point3D<double>(-5, 0, 0), Vector3D<double>(-1, 0, 0)).Intersect(sphere, &t)) << "Ray pointing away from the sphere hits it.";
+  EXPECT_FALSE(Ray3D<double>(Point3D<double>(-5, 3, 0), Vector3D<double>(1, 0, 0)).Intersect(sphere, &t)) << "Ray passing the sphere hits it.";
+  EXPECT_FALSE(Ray3D<double>(Point3D<double>(-5, 0, 0), Vector3D<double>(1, 0, 0)).Intersect(sphere, &t, 2.5)) << "Ray-sphere hit beyond t_max is reported.";
+}
+
+TEST(RayTests, IntersectPlane) {
+  Plane<double> plane(Point3D<double>(0, 0, 1), Vector3D<double>(0, 0, 1));
+  double t = 0;
+  EXPECT_TRUE(Ray3D<double>(Point3D<double>(3, 4, 5), Vector3D<double>(0, 0, -1)).Intersect(plane, &t)) << "Ray towards the plane misses it.";
+  EXPECT_EQ(4.0, t) << "Ray-plane hit parameter is incorrect.";
+  EXPECT_TRUE(Ray3D<double>(Point3D<double>(0, 0, -1), Vector3D<double>(0, 0, 1)).Intersect(plane, &t)) << "Ray towards the back of the plane misses it.";
+  EXPECT_EQ(2.0, t) << "Ray-plane hit parameter from the back is incorrect.";
+  EXPECT_FALSE(Ray3D<double>(Point3D<double>(3, 4, 5), Vector3D<double>(0, 0, 1)).Intersect(plane, &t)) << "Ray pointing away from the plane hits it.";
+  EXPECT_FALSE(Ray3D<double>(Point3D<double>(3, 4, 5), Vector3D<double>(1, 0, 0)).Intersect(plane, &t)) << "Ray parallel to the plane hits it.";
+}
+
+TEST(RayTests, IntersectBox) {
+  Point3D<double> min(-1, -1, -1), max(1, 2, 3);
+  double t = 0;
+  EXPECT_TRUE(Ray3D<double>(Point3D<double>(-4, 0, 0), Vector3D<double>(1, 0, 0)).IntersectBox(min, max, &t)) << "Axis-aligned ray towards the box misses it.";
+  EXPECT_EQ(3.0, t) << "Ray-box entry parameter is incorrect.";
+  EXPECT_TRUE(Ray3D<double>(Point3D<double>(0, 0, 0), Vector3D<double>(1, 1, 1)).IntersectBox(min, max, &t)) << "Ray from inside the box misses it.";
+  EXPECT_EQ(0.0, t) << "Ray from inside the box does not enter at its origin.";
+  EXPECT_TRUE(Ray3D<double>(Point3D<double>(-3, -3, -3), Vector3D<double>(1, 1, 1)).IntersectBox(min, max, &t)) << "Diagonal ray towards the box misses it.";
+  EXPECT_NEAR(2.0 * std::sqrt(3.0), t, 1e-12) << "Diagonal ray-box entry parameter is incorrect.";
+  EXPECT_FALSE(Ray3D<double>(Point3D<double>(-4, 0, 0), Vector3D<double>(-1, 0, 0)).IntersectBox(min, max, &t)) << "Ray pointing away from the box hits it.";
+  EXPECT_FALSE(Ray3D<double>(Point3D<double>(-4, 5, 0), Vector3D<double>(1, 0, 0)).IntersectBox(min, max, &t)) << "Ray passing the box hits it.";
+  EXPECT_FALSE(Ray3D<double>(Point3D<double>(-4, 0, 0), Vector3D<double>(1, 0, 0)).IntersectBox(min, max, &t, 2.0)) << "Ray-box hit beyond t_max is reported.";
+}
+
+TEST(RayTests, PacketsMatchScalar) {
+  ExpectPacketMatchesScalar<float, 4>();
+  ExpectPacketMatchesScalar<float, 8>();
+  ExpectPacketMatchesScalar<double, 4>();
+}
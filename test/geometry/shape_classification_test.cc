@@ -0,0 +1,84 @@
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\shape_classification.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+template<typename valuetype>
+std::vector<Point3D<valuetype>> RandomPoints3D(size_t count, unsigned int seed) {
+  std::vector<valuetype> values = RandomValues<valuetype>(3 * count, seed, -2., 2.);
+  std::vector<Point3D<valuetype>> points;
+  for (size_t i = 0; i < count; ++i) { points.push_back(Point3D<valuetype>(values[3 * i], values[3 * i + 1], values[3 * i + 2])); }
+  return points;
+}
+
+template<typename valuetype>
+void ExpectSphereAndPlaneMatchScalar() {
+  const size_t count = 1001;
+  std::vector<Point3D<valuetype>> points = RandomPoints3D<valuetype>(count, 5);
+  Point3DArray<valuetype> point_array(points);
+  Sphere<valuetype> sphere(valuetype(0.25), valuetype(-0.5), valuetype(0.1), valuetype(1.3));
+  Plane<valuetype> plane(Point3D<valuetype>(valuetype(0.1), valuetype(0.2), valuetype(-0.3)), Vector3D<valuetype>(valuetype(1), valuetype(2), valuetype(-1)));
+  ForEachSimdLevel([&](SimdLevel level) {
+    std::vector<uint64_t> inside(MaskWords(count)), outside(MaskWords(count)), above(MaskWords(count)), below(MaskWords(count));
+    std::vector<uint64_t> inside_array, above_array;
+    BatchIsInside(sphere, points.data(), count, inside.data());
+    BatchIsOutside(sphere, points.data(), count, outside.data());
+    BatchIsAbovePlane(plane, points.data(), count, above.data());
+    BatchIsBelowPlane(plane, points.data(), count, below.data());
+    BatchIsInside(sphere, point_array, inside_array);
+    BatchIsAbovePlane(plane, point_array, above_array);
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(IsMaskSet(inside.data(), i), sphere.IsInside(points[i])) << "Batch sphere inside test differs from Sphere::IsInside at index " << i << " (SIMD level " << int(level) << ").";
+      ASSERT_EQ(IsMaskSet(outside.data(), i), sphere.IsOutside(points[i])) << "Batch sphere outside test differs from Sphere::IsOutside at index " << i << " (SIMD level " << int(level) << ").";
+      ASSERT_EQ(IsMaskSet(above.data(), i), plane.IsAbovePlane(points[i])) << "Batch plane test differs from Plane::IsAbovePlane at index " << i << " (SIMD level " << int(level) << ").";
+      ASSERT_EQ(IsMaskSet(below.data(), i), plane.IsBelowPlane(points[i])) << "Batch plane test differs from Plane::IsBelowPlane at index " << i << " (SIMD level " << int(level) << ").";
+    }
+    EXPECT_EQ(inside_array, inside) << "Sphere classification of a Point3DArray differs from the array-of-structs version on SIMD level " << int(level) << ".";
+    EXPECT_EQ(above_array, above) << "Plane classification of a Point3DArray differs from the array-of-structs version on SIMD level " << int(level) << ".";
+  });
+}
+
+} // namespace
+
+//
+// ShapeClassificationTests
+//
+TEST(ShapeClassificationTests, SphereAndPlaneFloat) {
+  ExpectSphereAndPlaneMatchScalar<float>();
+}
+
+TEST(ShapeClassificationTests, SphereAndPlaneDouble) {
+  ExpectSphereAndPlaneMatchScalar<double>();
+}
+
+TEST(ShapeClassificationTests, Circle) {
+  std::vector<float> values = RandomValues<float>(2 * 333, 9, -2., 2.);
+  std::vector<p2f> points;
+  for (size_t i = 0; i < 333; ++i) { points.push_back(p2f(values[2 * i], values[2 * i + 1])); }
+  Circlef circle(0.3f, -0.2f, 1.1f);
+  ForEachSimdLevel([&](SimdLevel level) {
+    std::vector<uint64_t> inside(MaskWords(points.size())), outside(MaskWords(points.size()));
+    BatchIsInside(circle, points.data(), points.size(), inside.data());
+    BatchIsOutside(circle, points.data(), points.size(), outside.data());
+    for (size_t i = 0; i < points.size(); ++i) {
+      ASSERT_EQ(IsMaskSet(inside.data(), i), circle.IsInside(points[i])) << "Batch circle inside test differs from Circle::IsInside at index " << i << " (SIMD level " << int(level) << ").";
+      ASSERT_EQ(IsMaskSet(outside.data(), i), circle.IsOutside(points[i])) << "Batch circle outside test differs from Circle::IsOutside at index " << i << " (SIMD level " << int(level) << ").";
+    }
+  });
+}
+
+TEST(ShapeClassificationTests, IndexList) {
+  std::vector<p3i> points{ p3i(0, 0, 0), p3i(5, 0, 0), p3i(1, 1, 0), p3i(0, 0, 9), p3i(0, -1, 0) };
+  Spherei sphere(0, 0, 0, 2);
+  std::vector<uint64_t> mask(MaskWords(points.size()));
+  BatchIsInside(sphere, points.data(), points.size(), mask.data());
+  std::vector<size_t> indices = MaskToIndices(mask, points.size());
+  EXPECT_EQ(indices, (std::vector<size_t>{ 0, 2, 4 })) << "Index list of points inside the sphere is incorrect.";
+  EXPECT_EQ(MaskWords(64), 1u) << "Number of mask words is incorrect.";
+  EXPECT_EQ(MaskWords(65), 2u) << "Number of mask words is incorrect.";
+}
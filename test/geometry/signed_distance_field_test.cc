@@ -0,0 +1,136 @@
+#include <cmath>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\signed_distance_field.h"
+
+using namespace j::math;
+
+//
+// SignedDistanceFieldTests
+//
+TEST(SignedDistanceFieldTests, Shapes) {
+  Sphered sphere(1., 2., 3., 2.);
+  EXPECT_DOUBLE_EQ(Sdf(sphere)(p3d(1., 2., 8.)), sphere.SignedDistanceToSurface(p3d(1., 2., 8.))) << "Wrong sphere distance.";
+  EXPECT_DOUBLE_EQ(Sdf(Circled(0., 0., 1.))(p2d(0., 0.5)), -0.5) << "Wrong circle distance.";
+  Line2d line(p2d(0., 0.), p2d(1., 0.));
+  EXPECT_DOUBLE_EQ(Sdf(line)(p2d(3., 2.)), line.SignedDistanceToCurve(p2d(3., 2.))) << "Wrong line distance.";
+  Planed ground(p3d(0., 0., 1.), vec3d(0., 0., 2.));
+  EXPECT_DOUBLE_EQ(Sdf(ground)(p3d(5., 5., 3.)), 2.) << "Wrong distance above a plane.";
+  EXPECT_DOUBLE_EQ(Sdf(ground)(p3d(5., 5., 0.)), -1.) << "Wrong distance below a plane.";
+  AABB3Dd box(0., 0., 0., 2., 4., 6.);
+  EXPECT_DOUBLE_EQ(Sdf(box)(p3d(1., 1., 3.)), -1.) << "Wrong distance inside a box.";
+  EXPECT_DOUBLE_EQ(Sdf(box)(p3d(5., 8., 3.)), 5.) << "Wrong distance to a box edge.";
+  EXPECT_DOUBLE_EQ(Sdf(box)(p3d(1., 2., 7.)), 1.) << "Wrong distance to a box face.";
+  EXPECT_DOUBLE_EQ(Sdf(AABB2Dd(0., 0., 2., 2.))(p2d(-3., 6.)), 5.) << "Wrong distance to a rectangle corner.";
+}
+
+TEST(SignedDistanceFieldTests, Composition) {
+  auto a = Sdf(Sphered(0., 0., 0., 2.));
+  auto b = Sdf(Sphered(3., 0., 0., 2.));
+  p3d p(1., 0., 0.), q(-1.5, 0., 0.);
+  EXPECT_DOUBLE_EQ(Union(a, b)(p), -1.) << "Wrong union.";
+  EXPECT_DOUBLE_EQ((a | b)(q), -0.5) << "Wrong union operator.";
+  EXPECT_DOUBLE_EQ(Intersection(a, b)(p), 0.) << "Wrong intersection.";
+  EXPECT_DOUBLE_EQ((a & b)(q), 2.5) << "Wrong intersection operator.";
+  EXPECT_DOUBLE_EQ(Difference(a, b)(p), 0.) << "Wrong difference.";
+  EXPECT_DOUBLE_EQ((a - b)(q), -0.5) << "Wrong difference operator.";
+  // Nested expressions compose into one type
+  auto carved = (Sdf(AABB3Dd(-1., -1., -1., 1., 1., 1.)) & Sdf(Sphered(0., 0., 0., 1.3))) - Sdf(Sphered(0., 0., 0., 0.5));
+  EXPECT_DOUBLE_EQ(carved(p3d(0., 0., 0.)), 0.5) << "Wrong carved distance at the hollow center.";
+  EXPECT_DOUBLE_EQ(carved(p3d(0.8, 0., 0.)), -0.2) << "Wrong carved distance in the wall.";
+  EXPECT_DOUBLE_EQ(carved(p3d(1., 1., 1.)), std::sqrt(3.) - 1.3) << "Wrong carved distance at a cut corner.";
+}
+
+TEST(SignedDistanceFieldTests, SmoothUnion) {
+  auto a = Sdf(Circled(-1., 0., 1.));
+  auto b = Sdf(Circled(1.5, 0., 1.));
+  auto smooth = SmoothUnion(a, b, 1.);
+  for (double x = -3.; x <= 3.; x += 0.25) {
+    p2d p(x, 0.3);
+    double plain = Union(a, b)(p);
+    EXPECT_LE(smooth(p), plain + 1e-12) << "Smooth union above the union at x = " << x << ".";
+    EXPECT_GE(smooth(p), plain - 0.25) << "Smooth union more than k / 4 below the union at x = " << x << ".";
+  }
+  EXPECT_DOUBLE_EQ(smooth(p2d(-2.5, 0.)), Union(a, b)(p2d(-2.5, 0.))) << "Smooth union blended far from the seam.";
+  EXPECT_LT(smooth(p2d(0.25, 0.)), Union(a, b)(p2d(0.25, 0.))) << "Smooth union not blended at the seam.";
+  EXPECT_DOUBLE_EQ(SmoothUnion(a, b, -1.)(p2d(0.25, 0.)), Union(a, b)(p2d(0.25, 0.))) << "Non-positive k not a plain union.";
+}
+
+TEST(SignedDistanceFieldTests, Transforms) {
+  auto box = Sdf(AABB3Dd(-1., -2., -3., 1., 2., 3.));
+  EXPECT_DOUBLE_EQ(Translate(box, vec3d(10., 0., 0.))(p3d(10., 0., 0.)), -1.) << "Wrong translated distance.";
+  EXPECT_DOUBLE_EQ(Translate(Sdf(Circled(0., 0., 1.)), vec2d(0., 2.))(p2d(0., 0.)), 1.) << "Wrong translated 2D distance.";
+  auto rotated = Transform(box, AffineTransform3d::Rotation(vec3d(0., 0., 1.), 1.5707963267948966));
+  EXPECT_NEAR(rotated(p3d(0., 0., 0.)), -1., 1e-12) << "Wrong rotated distance at the center.";
+  EXPECT_NEAR(rotated(p3d(3., 0., 0.)), 1., 1e-12) << "Box not rotated.";
+  EXPECT_NEAR(rotated(p3d(0., 2., 0.)), 1., 1e-12) << "Box not rotated.";
+  EXPECT_DOUBLE_EQ(Transform(box, AffineTransform3d::Scale(vec3d(0., 1., 1.)))(p3d(2., 0., 0.)), 1.) << "Singular transform not replaced by the identity.";
+  EXPECT_DOUBLE_EQ(Scale(box, 2.)(p3d(4., 0., 0.)), 2.) << "Wrong scaled distance.";
+  EXPECT_DOUBLE_EQ(Scale(box, 0.)(p3d(4., 0., 0.)), 3.) << "Non-positive scale not replaced by 1.";
+}
+
+TEST(SignedDistanceFieldTests, EvaluateGrid) {
+  auto field = Sdf(Sphered(0.5, 0.5, 0.5, 1.)) | Sdf(Planed(p3d(0., 0., -1.), vec3d(0., 0., 1.)));
+  std::vector<double> serial, parallel;
+  EvaluateGrid(field, p3d(-2., -1., -3.), vec3d(0.25, 0.5, 0.75), 17, 5, 9, serial);
+  EvaluateGrid(field, p3d(-2., -1., -3.), vec3d(0.25, 0.5, 0.75), 17, 5, 9, parallel, 4);
+  ASSERT_EQ(serial.size(), 17u * 5u * 9u) << "Wrong number of values.";
+  EXPECT_EQ(parallel, serial) << "Values depend on the thread count.";
+  for (size_t z = 0; z < 9; ++z) {
+    for (size_t y = 0; y < 5; ++y) {
+      for (size_t x = 0; x < 17; ++x) {
+        EXPECT_DOUBLE_EQ(serial[(z * 5 + y) * 17 + x], field(p3d(-2. + 0.25 * double(x), -1. + 0.5 * double(y), -3. + 0.75 * double(z)))) << "Wrong value at (" << x << ", " << y << ", " << z << ").";
+      }
+    }
+  }
+  std::vector<double> image;
+  EvaluateGrid(Sdf(Circled(0., 0., 1.)), p2d(-1., -1.), vec2d(1., 1.), 3, 3, image);
+  EXPECT_EQ(image, std::vector<double>({ std::sqrt(2.) - 1., 0., std::sqrt(2.) - 1., 0., -1., 0., std::sqrt(2.) - 1., 0., std::sqrt(2.) - 1. })) << "Wrong 2D grid.";
+  std::vector<p2d> points{ p2d(2., 0.), p2d(0., 0.) };
+  Evaluate(Sdf(Circled(0., 0., 1.)), points, image);
+  EXPECT_EQ(image, std::vector<double>({ 1., -1. })) << "Wrong point values.";
+}
+
+TEST(SignedDistanceFieldTests, SphereTrace) {
+  Sphered sphere(0., 0., 10., 2.);
+  double t = 0., expected = 0.;
+  Ray3d ray(p3d(0.5, 0., 0.), vec3d(0., 0., 1.));
+  ASSERT_TRUE(ray.Intersect(sphere, &expected));
+  EXPECT_TRUE(SphereTrace(Sdf(sphere), ray, &t)) << "Ray misses the sphere.";
+  EXPECT_NEAR(t, expected, 1e-4) << "Wrong sphere hit.";
+  EXPECT_FALSE(SphereTrace(Sdf(sphere), Ray3d(p3d(3., 0., 0.), vec3d(0., 0., 1.)), &t, 100.)) << "Ray passing the sphere hits it.";
+  EXPECT_FALSE(SphereTrace(Sdf(sphere), ray, &t, 5.)) << "Hit beyond t_max reported.";
+  EXPECT_TRUE(SphereTrace(Sdf(sphere), Ray3d(p3d(0., 0., 10.), vec3d(1., 0., 0.)), &t)) << "Ray from inside misses.";
+  EXPECT_EQ(t, 0.) << "Ray from inside does not hit at its origin.";
+  // A hole drilled through the sphere lets the axial ray through to the ground plane behind it
+  auto scene = (Sdf(sphere) - Sdf(AABB3Dd(-1., -1., 0., 1., 1., 20.))) | Sdf(Planed(p3d(0., 0., 30.), vec3d(0., 0., -1.)));
+  EXPECT_TRUE(SphereTrace(scene, ray, &t)) << "Ray misses the scene.";
+  EXPECT_NEAR(t, 30., 1e-4) << "Ray does not pass through the hole.";
+  Vector3D<double> normal = EstimateNormal(scene, ray(t));
+  EXPECT_NEAR(normal.z_, -1., 1e-6) << "Wrong normal of the plane.";
+  EXPECT_TRUE(SphereTrace(scene, Ray3d(p3d(1.5, 0., 0.), vec3d(0., 0., 1.)), &t)) << "Ray outside the hole misses.";
+  EXPECT_LT(t, 10.) << "Ray outside the hole passes the sphere.";
+}
+
+TEST(SignedDistanceFieldTests, SphereTraceBatch) {
+  auto scene = Sdf(Spheref(0.f, 0.f, 10.f, 3.f)) | Sdf(AABB3Df(4.f, -1.f, 8.f, 6.f, 1.f, 12.f));
+  std::vector<Ray3f> rays;
+  for (int i = 0; i < 150; ++i) { rays.push_back(Ray3f(p3f(-8.f + 0.1f * float(i), 0.f, 0.f), vec3f(0.f, 0.f, 1.f))); }
+  std::vector<float> t, parallel_t;
+  std::vector<uint64_t> hits, parallel_hits;
+  SphereTrace(scene, rays, t, hits, 50.f);
+  SphereTrace(scene, rays, parallel_t, parallel_hits, 50.f, 1e-4f, 256, 4);
+  EXPECT_EQ(parallel_hits, hits) << "Hits depend on the thread count.";
+  for (size_t i = 0; i < rays.size(); ++i) {
+    float single = 0.f;
+    bool hit = SphereTrace(scene, rays[i], &single, 50.f);
+    ASSERT_EQ(IsMaskSet(hits.data(), i), hit) << "Wrong hit of ray " << i << ".";
+    if (hit) {
+      EXPECT_EQ(t[i], single) << "Wrong t of ray " << i << ".";
+      EXPECT_EQ(parallel_t[i], single) << "Wrong parallel t of ray " << i << ".";
+    }
+  }
+  EXPECT_TRUE(IsMaskSet(hits.data(), 80)) << "Ray through the sphere misses.";
+  EXPECT_TRUE(IsMaskSet(hits.data(), 130)) << "Ray through the box misses.";
+  EXPECT_FALSE(IsMaskSet(hits.data(), 0)) << "Ray beside the scene hits.";
+}
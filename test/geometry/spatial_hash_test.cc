@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\spatial_hash.h"
+
+using namespace j::math;
+
+namespace {
+
+std::vector<p3d> RandomPoints(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> position(-50., 50.);
+  std::vector<p3d> points;
+  for (size_t i = 0; i < count; ++i) { points.push_back(p3d(position(generator), position(generator), position(generator))); }
+  return points;
+}
+
+double DistanceSquared(const p3d& a, const p3d& b) { return (a.x_ - b.x_) * (a.x_ - b.x_) + (a.y_ - b.y_) * (a.y_ - b.y_) + (a.z_ - b.z_) * (a.z_ - b.z_); }
+
+// Indices of the points (skipping removed ones) within radius, and of the k nearest, by a linear scan.
+std::vector<size_t> LinearRadius(const std::vector<p3d>& points, const std::vector<bool>& removed, const p3d& p, double radius) {
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < points.size(); ++i) { if (!removed[i] && DistanceSquared(points[i], p) <= radius * radius) { indices.push_back(i); } }
+  return indices;
+}
+
+std::vector<size_t> LinearNearest(const std::vector<p3d>& points, const std::vector<bool>& removed, const p3d& p, size_t k) {
+  std::vector<std::pair<double, size_t>> candidates;
+  for (size_t i = 0; i < points.size(); ++i) { if (!removed[i]) { candidates.push_back(std::make_pair(DistanceSquared(points[i], p), i)); } }
+  std::sort(candidates.begin(), candidates.end());
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < k && i < candidates.size(); ++i) { indices.push_back(candidates[i].second); }
+  return indices;
+}
+
+void ExpectMatchesLinearScan(const SpatialHash3D<double>& hash, const std::vector<p3d>& points, const std::vector<bool>& removed) {
+  std::vector<p3d> queries = RandomPoints(50, 99);
+  queries.push_back(p3d(500., 500., 500.));  // Far outside the points
+  for (size_t q = 0; q < queries.size(); ++q) {
+    std::vector<size_t> indices;
+    for (double radius : { 0., 3., 10., 40. }) {
+      hash.FindInRadius(queries[q], radius, indices);
+      std::sort(indices.begin(), indices.end());
+      EXPECT_EQ(indices, LinearRadius(points, removed, queries[q], radius)) << "Radius query differs from linear scan for query " << q << ".";
+    }
+    for (size_t k : { 1, 5, 40 }) {
+      hash.FindNearest(queries[q], k, indices);
+      EXPECT_EQ(indices, LinearNearest(points, removed, queries[q], k)) << "Nearest neighbor query differs from linear scan for query " << q << ".";
+    }
+  }
+}
+
+} // namespace
+
+//
+// SpatialHashTests
+//
+TEST(SpatialHashTests, Queries) {
+  std::vector<p3d> points = RandomPoints(2000, 1);
+  SpatialHash3D<double> hash(4., points);
+  ASSERT_EQ(hash.Size(), points.size());
+  EXPECT_EQ(hash.Get(17), points[17]) << "Wrong point for an index.";
+  ExpectMatchesLinearScan(hash, points, std::vector<bool>(points.size(), false));
+  // A cell size far from the query radius only costs time
+  ExpectMatchesLinearScan(SpatialHash3D<double>(0.25, points), points, std::vector<bool>(points.size(), false));
+  ExpectMatchesLinearScan(SpatialHash3D<double>(100., points), points, std::vector<bool>(points.size(), false));
+}
+
+TEST(SpatialHashTests, Updates) {
+  std::vector<p3d> points = RandomPoints(500, 2);
+  SpatialHash3D<double> hash(5.);
+  for (const p3d& p : points) { hash.Insert(p); }
+  std::vector<bool> removed(points.size(), false);
+  for (size_t i = 0; i < points.size(); i += 3) { EXPECT_TRUE(hash.Remove(i)) << "Point " << i << " not removed."; removed[i] = true; }
+  EXPECT_FALSE(hash.Remove(0)) << "Point removed twice.";
+  EXPECT_FALSE(hash.Contains(3)) << "Removed point still contained.";
+  EXPECT_TRUE(hash.Contains(4)) << "Point missing.";
+  std::vector<p3d> targets = RandomPoints(points.size(), 3);
+  for (size_t i = 1; i < points.size(); i += 3) { EXPECT_TRUE(hash.Move(i, targets[i])) << "Point " << i << " not moved."; points[i] = targets[i]; }
+  EXPECT_FALSE(hash.Move(0, p3d())) << "Removed point moved.";
+  size_t index = hash.Insert(p3d(1., 2., 3.));
+  EXPECT_EQ(index, points.size()) << "Index of a removed point reused.";
+  points.push_back(p3d(1., 2., 3.));
+  removed.push_back(false);
+  EXPECT_EQ(hash.Size(), points.size() - (points.size() + 1) / 3) << "Wrong size after updates.";
+  ExpectMatchesLinearScan(hash, points, removed);
+  hash.Clear();
+  std::vector<size_t> indices;
+  hash.FindNearest(p3d(), 3, indices);
+  EXPECT_TRUE(indices.empty()) << "Cleared hash not empty.";
+}
+
+TEST(SpatialHashTests, ParallelBuild) {
+  // Large enough to be split over threads
+  std::vector<p3d> points = RandomPoints(100000, 4);
+  SpatialHash3D<double> serial(2., points), parallel(2., points, 4);
+  std::vector<p3d> queries = RandomPoints(20, 5);
+  for (const p3d& q : queries) {
+    std::vector<size_t> expected, indices;
+    serial.FindInRadius(q, 3., expected);
+    parallel.FindInRadius(q, 3., indices);
+    EXPECT_EQ(indices, expected) << "Result depends on the thread count.";
+    parallel.FindNearest(q, 10, indices);
+    EXPECT_EQ(indices, LinearNearest(points, std::vector<bool>(points.size(), false), q, 10)) << "Nearest neighbor query differs after a parallel build.";
+  }
+}
+
+TEST(SpatialHashTests, Points2D) {
+  SpatialHash2D<float> hash(1.f, std::vector<p2f>{ p2f(0.f, 0.f), p2f(1.5f, 0.f), p2f(-3.f, -3.f), p2f(0.f, 0.9f) });
+  std::vector<size_t> indices;
+  hash.FindInRadius(p2f(0.f, 0.f), 1.f, indices);
+  std::sort(indices.begin(), indices.end());
+  EXPECT_EQ(indices, std::vector<size_t>({ 0, 3 })) << "Wrong 2D radius query.";
+  hash.FindNearest(p2f(2.f, 0.f), 2, indices);
+  EXPECT_EQ(indices, std::vector<size_t>({ 1, 0 })) << "Wrong 2D nearest neighbors.";
+  hash.FindNearest(p2f(100.f, 100.f), 10, indices);
+  EXPECT_EQ(indices.size(), 4u) << "Not all points reported when asking for more than there are.";
+  EXPECT_EQ(SpatialHash2D<float>(-1.f).CellSize(), 1.f) << "Invalid cell size not replaced.";
+}
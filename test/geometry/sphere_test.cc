@@ -13,4 +13,28 @@ using namespace j::math;
 //  EXPECT_EQ(vec_default, vec2i(0, 0)) << "Default constructor did not initialize to (0, 0). Values: " << vec_default;
 //  EXPECT_EQ(vec_xy, vec2i(3, 5)) << "Value-based constructor did not initialize to (3, 5). Values: " << vec_xy;
 //  EXPECT_EQ(vec_copy, vec2i(3, 5)) << "Copy constructor did not copy values (3, 5) correctly. Values: " << vec_copy;
-//}
\ No newline at end of file
+//}
+
+TEST(SphereTests, NearestPoint) {
+  Sphered sphere(1., 2., 3., 2.);
+  EXPECT_EQ(sphere.FindNearestPoint(p3d(1., 2., 10.)), p3d(1., 2., 5.)) << "Nearest point on the sphere is incorrect for a point outside.";
+  EXPECT_EQ(sphere.FindNearestPoint(p3d(1.5, 2., 3.)), p3d(3., 2., 3.)) << "Nearest point on the sphere is incorrect for a point inside.";
+  EXPECT_EQ(sphere.FindNearestNormal(p3d(1., 2., 10.)), vec3d(0., 0., 1.)) << "Nearest normal should point outward.";
+}
+
+TEST(CircleTests, NearestPoint) {
+  Circled circle(1., 2., 2.);
+  EXPECT_EQ(circle.FindNearestPoint(p2d(-5., 2.)), p2d(-1., 2.)) << "Nearest point on the circle is incorrect for a point outside.";
+  EXPECT_EQ(circle.SignedDistanceToSurface(p2d(-5., 2.)), 4.) << "Signed distance to the circle is incorrect.";
+}
+
+TEST(SphereTests, CompileTimeEvaluation) {
+  constexpr Sphered sphere(1., 2., 3., 2.);
+  static_assert(sphere.IsInside(p3d(1., 2., 4.)) && sphere.IsOutside(p3d(1., 2., 6.)), "Sphere containment is not usable in constant expressions.");
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  static_assert(sphere.SignedDistanceToSurface(p3d(1., 2., 10.)) == 5., "Sphere distance is not usable in constant expressions.");
+  static_assert(sphere.FindNearestPoint(p3d(1., 2., 10.)) == p3d(1., 2., 5.), "Sphere nearest point is not usable in constant expressions.");
+#endif
+  constexpr Sphered colliders[] = { sphere, sphere + vec3d(4., 0., 0.) };
+  EXPECT_EQ(colliders[1].c_, p3d(5., 2., 3.)) << "Compile-time sphere table is incorrect at run time.";
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\sweep_and_prune.h"
+
+using namespace j::math;
+
+namespace {
+
+typedef std::vector<std::pair<size_t, size_t>> Pairs;
+
+std::vector<Sphered> RandomSpheres(size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> position(-50., 50.), radius(0.5, 4.);
+  std::vector<Sphered> spheres;
+  for (size_t i = 0; i < count; ++i) { spheres.push_back(Sphered(position(generator), position(generator), position(generator), radius(generator))); }
+  return spheres;
+}
+
+// Broad phase pairs are checked against the box overlaps themselves.
+template<typename valuetype>
+bool Overlap(const AABB3D<valuetype>& a, const AABB3D<valuetype>& b) { return a.Overlaps(b); }
+
+template<typename shape>
+Pairs BruteForce(const std::vector<shape>& shapes, const std::vector<bool>& removed) {
+  Pairs pairs;
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    for (size_t j = i + 1; j < shapes.size(); ++j) { if (!removed[i] && !removed[j] && Overlap(shapes[i], shapes[j])) { pairs.push_back(std::make_pair(i, j)); } }
+  }
+  return pairs;
+}
+
+Pairs Sorted(Pairs pairs) { std::sort(pairs.begin(), pairs.end()); return pairs; }
+
+} // namespace
+
+//
+// SweepAndPruneTests
+//
+TEST(SweepAndPruneTests, BroadPhase) {
+  std::vector<Sphered> spheres = RandomSpheres(800, 1);
+  std::vector<AABB3Dd> boxes;
+  SweepAndPrune3D<double> broad_phase(1);
+  for (const Sphered& s : spheres) { boxes.push_back(BoundingBox(s)); broad_phase.Add(boxes.back()); }
+  std::vector<bool> removed(boxes.size(), false);
+  Pairs pairs;
+  broad_phase.FindPairs(pairs);
+  EXPECT_EQ(Sorted(pairs), BruteForce(boxes, removed)) << "Pairs differ from brute force.";
+  // A few frames of small movements, with boxes removed and added in between
+  std::mt19937 generator(2);
+  std::uniform_real_distribution<double> step(-1., 1.);
+  for (int frame = 0; frame < 5; ++frame) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      if (removed[i]) { continue; }
+      boxes[i] += vec3d(step(generator), step(generator), step(generator));
+      EXPECT_TRUE(broad_phase.Update(i, boxes[i])) << "Box " << i << " not updated.";
+    }
+    EXPECT_TRUE(broad_phase.Remove(size_t(frame) * 7)) << "Box not removed.";
+    removed[size_t(frame) * 7] = true;
+    boxes.push_back(AABB3Dd(0., 0., 0., 5., 5., 5.));
+    removed.push_back(false);
+    EXPECT_EQ(broad_phase.Add(boxes.back()), boxes.size() - 1) << "Wrong id for an added box.";
+    broad_phase.FindPairs(pairs);
+    EXPECT_EQ(Sorted(pairs), BruteForce(boxes, removed)) << "Pairs differ from brute force in frame " << frame << ".";
+  }
+  EXPECT_FALSE(broad_phase.Remove(0)) << "Box removed twice.";
+  EXPECT_FALSE(broad_phase.Update(0, AABB3Dd())) << "Removed box updated.";
+  EXPECT_EQ(broad_phase.Size(), 800u) << "Wrong number of boxes.";
+}
+
+TEST(SweepAndPruneTests, BulkRemove) {
+  std::vector<Sphered> spheres = RandomSpheres(2000, 4);
+  std::vector<AABB3Dd> boxes;
+  SweepAndPrune3D<double> broad_phase;
+  for (const Sphered& s : spheres) { boxes.push_back(BoundingBox(s)); broad_phase.Add(boxes.back()); }
+  Pairs pairs;
+  broad_phase.FindPairs(pairs);
+  // Removed boxes are dropped from the order by the next query, also when several removals happen in between
+  std::vector<bool> removed(boxes.size(), false);
+  for (size_t i = 0; i < boxes.size(); i += 3) { EXPECT_TRUE(broad_phase.Remove(i)) << "Box " << i << " not removed."; removed[i] = true; }
+  for (size_t i = 1; i < boxes.size(); i += 3) { broad_phase.Remove(i); removed[i] = true; }
+  EXPECT_EQ(broad_phase.Size(), boxes.size() / 3) << "Wrong number of boxes after removal.";
+  broad_phase.FindPairs(pairs);
+  EXPECT_EQ(Sorted(pairs), BruteForce(boxes, removed)) << "Pairs differ from brute force after removal.";
+  boxes.push_back(AABB3Dd(-50., -50., -50., 50., 50., 50.));
+  removed.push_back(false);
+  broad_phase.Add(boxes.back());
+  broad_phase.Remove(2);
+  removed[2] = true;
+  broad_phase.FindPairs(pairs);
+  EXPECT_EQ(Sorted(pairs), BruteForce(boxes, removed)) << "Pairs differ from brute force after adding and removing.";
+}
+
+TEST(SweepAndPruneTests, Collisions) {
+  std::vector<Sphered> spheres = RandomSpheres(1000, 3);
+  SweepAndPrune3D<double> serial, parallel;
+  Pairs collisions, parallel_collisions;
+  for (int frame = 0; frame < 3; ++frame) {
+    FindCollisions(spheres, serial, collisions);
+    FindCollisions(spheres, parallel, parallel_collisions, 4);
+    EXPECT_EQ(Sorted(collisions), BruteForce(spheres, std::vector<bool>(spheres.size(), false))) << "Collisions differ from brute force in frame " << frame << ".";
+    EXPECT_EQ(parallel_collisions, collisions) << "Collisions depend on the thread count.";
+    for (Sphered& s : spheres) { s += vec3d(0.5, -0.25, 0.1); s.r_ *= 1.1; }
+  }
+}
+
+TEST(SweepAndPruneTests, Shapes2D) {
+  std::vector<Rectangle2Dd> rectangles{ Rectangle2Dd(0., 0., 2., 2.), Rectangle2Dd(3., 3., 1.5, 1.5), Rectangle2Dd(2.5, 0., 4., 1.) };
+  SweepAndPrune2D<double> broad_phase;
+  Pairs collisions;
+  FindCollisions(rectangles, broad_phase, collisions);
+  EXPECT_EQ(collisions, Pairs({ std::make_pair(size_t(0), size_t(1)) })) << "Wrong rectangle collisions.";
+  std::vector<Circled> circles{ Circled(2.5, 2.5, 1.), Circled(-1., -1., 1.) };
+  Pairs candidates{ { 0, 0 }, { 0, 1 }, { 1, 0 }, { 1, 1 }, { 2, 0 } };
+  NarrowPhase(rectangles, circles, candidates, collisions);
+  EXPECT_EQ(collisions, Pairs({ std::make_pair(size_t(0), size_t(0)), std::make_pair(size_t(1), size_t(0)) })) << "Wrong rectangle-circle collisions.";
+}
+
+//
+// OverlapTests
+//
+TEST(OverlapTests, Shapes) {
+  EXPECT_TRUE(Overlap(Sphered(0., 0., 0., 1.), Sphered(2., 0., 0., 1.))) << "Touching spheres do not overlap.";
+  EXPECT_FALSE(Overlap(Sphered(0., 0., 0., 1.), Sphered(2., 1., 0., 1.))) << "Separate spheres overlap.";
+  EXPECT_TRUE(Overlap(Circled(0., 0., 1.), Circled(1., 1., 0.5))) << "Overlapping circles do not overlap.";
+  EXPECT_FALSE(Overlap(Circled(0., 0., 1.), Rectangle2Dd(0.8, 0.8, 2., 2.))) << "Circle overlaps a rectangle near its corner.";
+  EXPECT_TRUE(Overlap(Rectangle2Dd(0.6, 0.6, 2., 2.), Circled(0., 0., 1.))) << "Circle does not overlap a rectangle at its corner.";
+  EXPECT_TRUE(Overlap(Circled(1., 1., 0.1), Rectangle2Dd(0., 0., 2., 2.))) << "Circle inside a rectangle does not overlap it.";
+  Planed ground(p3d(0., 0., 0.), vec3d(0., 0., 1.));
+  EXPECT_TRUE(Overlap(Sphered(0., 0., 0.5, 1.), ground)) << "Sphere crossing the plane does not overlap it.";
+  EXPECT_TRUE(Overlap(ground, Sphered(0., 0., -5., 1.))) << "Sphere below the plane does not overlap it.";
+  EXPECT_FALSE(Overlap(Sphered(0., 0., 1.5, 1.), ground)) << "Sphere above the plane overlaps it.";
+}
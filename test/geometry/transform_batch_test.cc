@@ -0,0 +1,81 @@
+#include <cstring>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\transform_batch.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+// Random points with a length that is not a multiple of any SIMD width or of the block size, so the scalar tail and
+// uneven thread ranges are exercised as well.
+template<typename valuetype>
+std::vector<Point3D<valuetype>> RandomPoints(size_t count, unsigned int seed) {
+  std::vector<valuetype> values = RandomValues<valuetype>(3 * count, seed);
+  std::vector<Point3D<valuetype>> points;
+  for (size_t i = 0; i < count; ++i) { points.push_back(Point3D<valuetype>(values[3 * i], values[3 * i + 1], values[3 * i + 2])); }
+  return points;
+}
+
+template<typename valuetype>
+bool BitwiseEqual(valuetype a, valuetype b) { return std::memcmp(&a, &b, sizeof(valuetype)) == 0; }
+
+template<typename element>
+bool BitwiseEqualComponents(const element& a, const element& b) { return BitwiseEqual(a.x_, b.x_) && BitwiseEqual(a.y_, b.y_) && BitwiseEqual(a.z_, b.z_); }
+
+template<typename valuetype>
+void ExpectBatchMatchesScalar() {
+  const size_t count = 1003;
+  std::vector<Point3D<valuetype>> points = RandomPoints<valuetype>(count, 1);
+  std::vector<Vector3D<valuetype>> vectors;
+  for (const Point3D<valuetype>& p : points) { vectors.push_back(Vector3D<valuetype>(p.x_, p.y_, p.z_)); }
+  AffineTransform3D<valuetype> t = AffineTransform3D<valuetype>::Translation(Vector3D<valuetype>(1, -2, 3)) * AffineTransform3D<valuetype>::Rotation(Vector3D<valuetype>(1, 2, 3), valuetype(0.7)) * AffineTransform3D<valuetype>::Scale(Vector3D<valuetype>(2, 1, valuetype(0.5)));
+  ForEachSimdLevel([&](SimdLevel level) {
+    for (size_t thread_count : { size_t(1), size_t(4), size_t(0) }) {
+      std::vector<Point3D<valuetype>> transformed_points(count);
+      std::vector<Vector3D<valuetype>> transformed_vectors(count);
+      BatchTransformPoints(points.data(), t, transformed_points.data(), count, thread_count);
+      BatchTransformVectors(vectors.data(), t, transformed_vectors.data(), count, thread_count);
+      Point3DArray<valuetype> point_array(points);
+      BatchTransformPoints(point_array, t, point_array, thread_count);
+      for (size_t i = 0; i < count; ++i) {
+        ASSERT_TRUE(BitwiseEqualComponents(transformed_points[i], t.TransformPoint(points[i]))) << "Batch point transformation differs from scalar version at index " << i << " (SIMD level " << int(level) << ", " << thread_count << " threads).";
+        ASSERT_TRUE(BitwiseEqualComponents(transformed_vectors[i], t.TransformVector(vectors[i]))) << "Batch vector transformation differs from scalar version at index " << i << " (SIMD level " << int(level) << ", " << thread_count << " threads).";
+        ASSERT_TRUE(BitwiseEqualComponents(point_array.Get(i), t.TransformPoint(points[i]))) << "In-place structure-of-arrays transformation differs from scalar version at index " << i << " (SIMD level " << int(level) << ", " << thread_count << " threads).";
+      }
+    }
+  });
+}
+
+} // namespace
+
+//
+// TransformBatchTests
+//
+TEST(TransformBatchTests, MatchesScalarFloat) {
+  ExpectBatchMatchesScalar<float>();
+}
+
+TEST(TransformBatchTests, MatchesScalarDouble) {
+  ExpectBatchMatchesScalar<double>();
+}
+
+TEST(TransformBatchTests, EmptyInput) {
+  Point3DArray<float> points, result(3);
+  BatchTransformPoints(points, AffineTransform3f::Identity(), result, 4);
+  EXPECT_EQ(result.Length(), size_t(0)) << "Result was not resized to the input length.";
+}
+
+//
+// ParallelForTests
+//
+TEST(ParallelForTests, CoversRangeOnce) {
+  std::vector<int> visits(1000, 0);
+  ParallelFor(visits.size(), 3, 64, [&](size_t begin, size_t end) {
+    EXPECT_EQ(begin % 64, size_t(0)) << "Range does not start on a grain boundary.";
+    for (size_t i = begin; i < end; ++i) { ++visits[i]; }
+  });
+  for (size_t i = 0; i < visits.size(); ++i) { ASSERT_EQ(visits[i], 1) << "Element " << i << " was not visited exactly once."; }
+}
@@ -0,0 +1,77 @@
+#include <random>
+#include <sstream>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\vector_array.h"
+
+using namespace j::math;
+
+//
+// Vector3DArrayTests
+//
+TEST(Vector3DArrayTests, Constructors) {
+  vec3arrayi array_default;
+  vec3arrayi array_sized(4);
+  vec3arrayi array_vectors(std::vector<vec3i>{ vec3i(1, 2, 3), vec3i(4, 5, 6) });
+  EXPECT_EQ(array_default.Length(), 0u) << "Default constructor did not create an empty array.";
+  EXPECT_EQ(array_sized.Length(), 4u) << "Sized constructor did not create the requested number of elements.";
+  EXPECT_EQ(array_sized[3], vec3i(0, 0, 0)) << "Sized constructor did not zero-initialize the elements.";
+  EXPECT_EQ(array_vectors.Length(), 2u) << "Conversion from std::vector did not copy all elements.";
+  EXPECT_EQ(array_vectors[1], vec3i(4, 5, 6)) << "Conversion from std::vector did not copy values correctly.";
+}
+
+TEST(Vector3DArrayTests, SeparateComponentBuffers) {
+  vec3arrayf array(std::vector<vec3f>{ vec3f(1.f, 2.f, 3.f), vec3f(4.f, 5.f, 6.f), vec3f(7.f, 8.f, 9.f) });
+  EXPECT_EQ(array.X()[0], 1.f) << "X buffer does not hold consecutive x components.";
+  EXPECT_EQ(array.X()[2], 7.f) << "X buffer does not hold consecutive x components.";
+  EXPECT_EQ(array.Y()[1], 5.f) << "Y buffer does not hold consecutive y components.";
+  EXPECT_EQ(array.Z()[2], 9.f) << "Z buffer does not hold consecutive z components.";
+}
+
+TEST(Vector3DArrayTests, ProxyElementAccess) {
+  vec3arrayi array(2);
+  array[0] = vec3i(2, 3, 8);
+  array[1].x_ = 9;
+  array[1] += vec3i(0, 6, 5);
+  EXPECT_EQ(array.Get(0), vec3i(2, 3, 8)) << "Assignment through proxy did not write to the array.";
+  EXPECT_EQ(array.Get(1), vec3i(9, 6, 5)) << "Component or compound assignment through proxy did not write to the array.";
+  EXPECT_EQ(array[0] + array[1], vec3i(11, 9, 13)) << "Sum of proxies returned incorrect result.";
+  EXPECT_EQ(vec3i(1, 1, 1) - array[0], vec3i(-1, -2, -7)) << "Difference with proxy returned incorrect result.";
+  EXPECT_EQ(array[0] * 2, vec3i(4, 6, 16)) << "Scalar multiplication of proxy returned incorrect result.";
+  EXPECT_EQ(array[0] * array[1], 2 * 9 + 3 * 6 + 8 * 5) << "Scalar product of proxies returned incorrect result.";
+  vec3i v = array[0];
+  EXPECT_EQ(v.CrossProduct(array[1]), vec3i(2, 3, 8).CrossProduct(vec3i(9, 6, 5))) << "Proxy did not convert to Vector3D correctly.";
+  array[0] = array[1];
+  EXPECT_EQ(array.Get(0), vec3i(9, 6, 5)) << "Proxy-to-proxy assignment did not copy values.";
+  std::stringstream ss;
+  ss << array[0];
+  EXPECT_STREQ(ss.str().c_str(), "Vector3D(9, 6, 5)") << "String conversion of proxy returned incorrect string.";
+}
+
+TEST(Vector3DArrayTests, ConversionToVector) {
+  std::vector<vec3d> vectors{ vec3d(1.5, 2.5, 3.5), vec3d(-4.5, 5.5, -6.5) };
+  vec3arrayd array(vectors);
+  std::vector<vec3d> round_trip = array;
+  EXPECT_EQ(round_trip, vectors) << "Round trip through structure-of-arrays changed the values.";
+}
+
+TEST(Vector3DArrayTests, BatchKernels) {
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> distribution(-10.f, 10.f);
+  vec3arrayf a, b;
+  for (int i = 0; i < 101; ++i) {
+    a.Add(vec3f(distribution(generator), distribution(generator), distribution(generator)));
+    b.Add(vec3f(distribution(generator), distribution(generator), distribution(generator)));
+  }
+  std::vector<float> scalar_products;
+  vec3arrayf cross_products, normalized;
+  BatchScalarProduct(a, b, scalar_products);
+  BatchCrossProduct(a, b, cross_products);
+  BatchNormalize(a, normalized);
+  ASSERT_EQ(scalar_products.size(), a.Length()) << "Result of batch scalar product was not resized.";
+  for (size_t i = 0; i < a.Length(); ++i) {
+    EXPECT_EQ(scalar_products[i], a.Get(i).ScalarProduct(b.Get(i))) << "Batch scalar product on arrays is incorrect at index " << i << ".";
+    EXPECT_EQ(cross_products.Get(i), a.Get(i).CrossProduct(b.Get(i))) << "Batch cross product on arrays is incorrect at index " << i << ".";
+    EXPECT_EQ(normalized.Get(i), a.Get(i).Normalize()) << "Batch normalization on arrays is incorrect at index " << i << ".";
+  }
+}
@@ -0,0 +1,87 @@
+#include <cstring>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\vector_batch.h"
+#include "..\utility\test_utility.h"
+
+using namespace j::math;
+using namespace j::math::test;
+
+namespace {
+
+// Random vectors with a length that is not a multiple of any SIMD width, so the scalar tail is exercised as well.
+template<typename valuetype>
+std::vector<Vector3D<valuetype>> RandomVectors(size_t count, unsigned int seed) {
+  std::vector<valuetype> values = RandomValues<valuetype>(3 * count, seed);
+  std::vector<Vector3D<valuetype>> vectors;
+  for (size_t i = 0; i < count; ++i) { vectors.push_back(Vector3D<valuetype>(values[3 * i], values[3 * i + 1], values[3 * i + 2])); }
+  return vectors;
+}
+
+template<typename valuetype>
+bool BitwiseEqual(valuetype a, valuetype b) { return std::memcmp(&a, &b, sizeof(valuetype)) == 0; }
+
+template<typename valuetype>
+bool BitwiseEqual(const Vector3D<valuetype>& a, const Vector3D<valuetype>& b) { return BitwiseEqual(a.x_, b.x_) && BitwiseEqual(a.y_, b.y_) && BitwiseEqual(a.z_, b.z_); }
+
+template<typename valuetype>
+void ExpectBatchMatchesScalar() {
+  const size_t count = 1003;
+  std::vector<Vector3D<valuetype>> a = RandomVectors<valuetype>(count, 1);
+  std::vector<Vector3D<valuetype>> b = RandomVectors<valuetype>(count, 2);
+  ForEachSimdLevel([&](SimdLevel level) {
+    std::vector<valuetype> scalar_products(count);
+    std::vector<Vector3D<valuetype>> cross_products(count), normalized(count);
+    BatchScalarProduct(a.data(), b.data(), scalar_products.data(), count);
+    BatchCrossProduct(a.data(), b.data(), cross_products.data(), count);
+    BatchNormalize(a.data(), normalized.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+      ASSERT_TRUE(BitwiseEqual(scalar_products[i], a[i].ScalarProduct(b[i]))) << "Batch scalar product differs from scalar version at index " << i << " (SIMD level " << int(level) << ").";
+      ASSERT_TRUE(BitwiseEqual(cross_products[i], a[i].CrossProduct(b[i]))) << "Batch cross product differs from scalar version at index " << i << " (SIMD level " << int(level) << ").";
+      ASSERT_TRUE(BitwiseEqual(normalized[i], a[i].Normalize())) << "Batch normalization differs from scalar version at index " << i << " (SIMD level " << int(level) << ").";
+    }
+  });
+}
+
+} // namespace
+
+//
+// VectorBatchTests
+//
+TEST(VectorBatchTests, SimdLevelSelection) {
+  SimdLevel original = GetSimdLevel();
+  SetSimdLevel(SimdLevel::SCALAR);
+  EXPECT_EQ(GetSimdLevel(), SimdLevel::SCALAR) << "Scalar fallback could not be selected.";
+  SetSimdLevel(SimdLevel::AVX2);
+  EXPECT_EQ(GetSimdLevel(), GetSupportedSimdLevel()) << "Selected SIMD level was not capped at the level supported by the CPU.";
+  SetSimdLevel(original);
+}
+
+TEST(VectorBatchTests, FloatMatchesScalar) {
+  ExpectBatchMatchesScalar<float>();
+}
+
+TEST(VectorBatchTests, DoubleMatchesScalar) {
+  ExpectBatchMatchesScalar<double>();
+}
+
+TEST(VectorBatchTests, IntegerMatchesScalar) {
+  std::vector<vec3i> a = { vec3i(2, 3, 8), vec3i(-4, 6, 7), vec3i(9, 0, -5) };
+  std::vector<vec3i> b = { vec3i(4, 6, 7), vec3i(1, -1, 2), vec3i(3, 3, 3) };
+  std::vector<int> scalar_products(a.size());
+  std::vector<vec3i> cross_products(a.size());
+  BatchScalarProduct(a.data(), b.data(), scalar_products.data(), a.size());
+  BatchCrossProduct(a.data(), b.data(), cross_products.data(), a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(scalar_products[i], a[i].ScalarProduct(b[i])) << "Batch scalar product is incorrect.";
+    EXPECT_EQ(cross_products[i], a[i].CrossProduct(b[i])) << "Batch cross product is incorrect.";
+  }
+}
+
+TEST(VectorBatchTests, InPlaceOperation) {
+  std::vector<vec3f> v = RandomVectors<float>(37, 3);
+  std::vector<vec3f> expected;
+  for (const vec3f& vector : v) { expected.push_back(vector.Normalize()); }
+  BatchNormalize(v.data(), v.data(), v.size());
+  for (size_t i = 0; i < v.size(); ++i) { EXPECT_TRUE(BitwiseEqual(v[i], expected[i])) << "In-place batch normalization is incorrect at index " << i << "."; }
+}
@@ -0,0 +1,90 @@
+#include <sstream>
+#include <type_traits>
+#include <gtest\gtest.h>
+#include "..\..\lib\geometry\vector_n.h"
+
+using namespace j::math;
+
+//
+// VectorNTests
+//
+TEST(VectorNTests, Constructors) {
+  vec4d vec_default;
+  vec4d vec_values(1., 2., 3., 4.);
+  vec4d vec_copy(vec_values);
+  EXPECT_EQ(vec_default, vec4d(0., 0., 0., 0.)) << "Default constructor did not initialize correctly.";
+  EXPECT_EQ(vec_values[3], 4.) << "Value-based constructor did not initialize correctly.";
+  EXPECT_EQ(vec_copy, vec_values) << "Copy constructor did not copy values correctly.";
+  EXPECT_EQ(vec4d::Unit(2), vec4d(0., 0., 1., 0.)) << "Unit vector is incorrect.";
+  EXPECT_EQ(vec4i(2.5, 3.5, 1, 0), vec4i(2, 3, 1, 0)) << "Vector of type int did not truncate values correctly.";
+}
+
+TEST(VectorNTests, ArithmeticOperators) {
+  vec4f a(1.f, 2.f, 3.f, 4.f);
+  vec4f b(4.f, 3.f, 2.f, 1.f);
+  vec4f c(0.5f, 0.5f, 0.5f, 0.5f);
+  vec4f result = a + b * 2.f - c;
+  EXPECT_EQ(result, vec4f(8.5f, 7.5f, 6.5f, 5.5f)) << "Chained expression evaluated incorrectly.";
+  EXPECT_EQ(vec4f(-a), vec4f(-1.f, -2.f, -3.f, -4.f)) << "Negation is incorrect.";
+  EXPECT_EQ(vec4f(a / 2.f), vec4f(0.5f, 1.f, 1.5f, 2.f)) << "Division by a scalar is incorrect.";
+  EXPECT_EQ(a * b, 20.f) << "Scalar product is incorrect.";
+  result = b;
+  result += a * 2.f;
+  EXPECT_EQ(result, vec4f(6.f, 7.f, 8.f, 9.f)) << "Compound addition of an expression is incorrect.";
+  result -= a;
+  EXPECT_EQ(result, vec4f(5.f, 5.f, 5.f, 5.f)) << "Compound subtraction is incorrect.";
+  result *= 2.f;
+  result /= 5.f;
+  EXPECT_EQ(result, vec4f(2.f, 2.f, 2.f, 2.f)) << "Compound scalar operators are incorrect.";
+  result = result - a + result;
+  EXPECT_EQ(result, vec4f(3.f, 2.f, 1.f, 0.f)) << "Assigning an expression that references the target is incorrect.";
+}
+
+TEST(VectorNTests, ExpressionsAvoidTemporaries) {
+  vec4d a(1., 2., 3., 4.), b(4., 3., 2., 1.), c(1., 1., 1., 1.);
+  using expression = decltype(a + b * 2. - c);
+  static_assert(!std::is_same<expression, vec4d>::value, "Chained arithmetic should build an expression, not a vector.");
+  static_assert(sizeof(expression) < 3 * sizeof(vec4d), "Expression nodes should reference their operands, not copy them.");
+  EXPECT_EQ((a + b * 2. - c).Evaluate(), vec4d(8., 7., 6., 5.)) << "Explicit evaluation of an expression is incorrect.";
+}
+
+TEST(VectorNTests, VectorFunctions) {
+  vec4d vec(1., 2., 2., 4.);
+  EXPECT_EQ(vec.LengthSquared(), 25.) << "Squared length is incorrect.";
+  EXPECT_EQ(vec.Length(), 5.) << "Length is incorrect.";
+  EXPECT_EQ(vec.Normalize(), vec4d(0.2, 0.4, 0.4, 0.8)) << "Normalized vector is incorrect.";
+  EXPECT_TRUE(vec.Normalize().IsNormalized()) << "Normalized vector is not normalized.";
+  EXPECT_EQ((vec * 2.).Length(), 10.) << "Length of an expression is incorrect.";
+  EXPECT_TRUE(vec.IsCollinear(vec * -3.)) << "Scaled vector is not collinear.";
+  EXPECT_TRUE(vec4d::Unit(0).IsOrthogonal(vec4d::Unit(3))) << "Unit vectors are not orthogonal.";
+  EXPECT_EQ(vec.Project(vec4d::Unit(3) * 2.), vec4d(0., 0., 0., 4.)) << "Projection is incorrect.";
+}
+
+TEST(VectorNTests, Vector3DCompatibility) {
+  vec3f vec(2.f, 3.f, 8.f);
+  VectorN<float, 3> vec_n(vec);
+  EXPECT_EQ(vec_n.ToVector3D(), vec) << "Round trip through VectorN changed the vector.";
+  EXPECT_EQ(vec_n.Normalize().ToVector3D(), vec.Normalize()) << "Normalization differs from Vector3D.";
+  EXPECT_EQ(vec_n.Length(), vec.Length()) << "Length differs from Vector3D.";
+  EXPECT_EQ(vec_n.CrossProduct(VectorN<float, 3>(vec3f::Xn())).ToVector3D(), vec.CrossProduct(vec3f::Xn())) << "Cross product differs from Vector3D.";
+  VectorN<int, 2> vec_2d(vec2i(3, 5));
+  EXPECT_EQ(vec_2d.ToVector2D(), vec2i(3, 5)) << "Round trip of a Vector2D through VectorN changed the vector.";
+  VectorN<double, 3> vec_d = vec_n;
+  EXPECT_EQ(vec_d[2], 8.) << "Cast to a different valuetype is incorrect.";
+}
+
+TEST(VectorNTests, CompileTimeEvaluation) {
+  constexpr vec4d a(1., 2., 2., 4.);
+  constexpr vec4d b = a * 2. - vec4d::Unit(0);
+  static_assert(b[0] == 1. && b[3] == 8., "Vector expressions are not usable in constant expressions.");
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  static_assert(a.Length() == 5., "Vector length is not usable in constant expressions.");
+#endif
+  EXPECT_EQ(b, vec4d(1., 4., 4., 8.)) << "Compile-time vector expression is incorrect at run time.";
+}
+
+TEST(VectorNTests, StringConversion) {
+  std::stringstream ss;
+  ss << vec4i(1, 2, 3, 4);
+  EXPECT_STREQ(ss.str().c_str(), "VectorN(1, 2, 3, 4)") << "String conversion returned incorrect result.";
+}
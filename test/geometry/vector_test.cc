@@ -168,6 +168,15 @@ TEST(Vector2DTests, Projection) {
   EXPECT_EQ(vec.ProjectOnto(vec), vec2f(2.f, 3.f)) << "Vector projection onto self should result in identity operation.";
 }
 
+TEST(Vector2DTests, Rotation) {
+  const double quarter = 1.5707963267948966;
+  EXPECT_EQ(vec2i(2, 1).Rotate(quarter), vec2i(-1, 2)) << "Integral vector rotation is not rounded to the nearest integers.";
+  EXPECT_EQ(vec2i(3, 0).Rotate(3), vec2i(-3, 0)) << "Integral vector rotation by about a half turn is incorrect.";
+  vec2f rotated = vec2f(2.f, 1.f).Rotate(quarter);
+  EXPECT_FLOAT_EQ(rotated.x_, -1.f) << "Vector rotation is incorrect.";
+  EXPECT_FLOAT_EQ(rotated.y_, 2.f) << "Vector rotation is incorrect.";
+}
+
 
 
 //
@@ -340,4 +349,28 @@ TEST(Vector3DTests, Projection) {
   EXPECT_EQ(vec.Project(vec_neg_y), vec3f(0.f, 3.f, 0.f)) << "Vector projection onto negative y-axis is incorrect. Possible error with negative components in projection vectors.";
   EXPECT_EQ(vec.Project(vec_x * 2), vec3f(2.f, 0.f, 0.f)) << "Vector projection onto non-normalized x-axis is incorrect. Possible error with non-unit projection vectors.";
   EXPECT_EQ(vec.Project(vec), vec3f(2.f, 3.f, 8.f)) << "Vector projection onto self should result in identity operation.";
-}
\ No newline at end of file
+}
+
+TEST(Vector3DTests, Rotation) {
+  const double quarter = 1.5707963267948966;
+  EXPECT_EQ(vec3i(2, 1, 5).Rotate(vec3i(0, 0, 3), quarter), vec3i(-1, 2, 5)) << "Integral vector rotation is not rounded to the nearest integers.";
+  vec3f rotated = vec3f(1.f, 0.f, 0.f).Rotate(vec3f(1.f, 1.f, 1.f), 4. * quarter / 3.);
+  EXPECT_NEAR(rotated.x_, 0.f, 1e-6f) << "Vector rotation around a diagonal axis is incorrect.";
+  EXPECT_NEAR(rotated.y_, 1.f, 1e-6f) << "Vector rotation around a diagonal axis is incorrect.";
+  EXPECT_NEAR(rotated.z_, 0.f, 1e-6f) << "Vector rotation around a diagonal axis is incorrect.";
+}
+
+TEST(Vector3DTests, CompileTimeEvaluation) {
+  constexpr vec3d vec(2., 3., 6.);
+  static_assert(vec3d::Xn() + vec3d::Yn() == vec3d(1., 1., 0.), "Unit vectors are not usable in constant expressions.");
+  static_assert(vec3d::Xn().CrossProduct(vec3d::Yn()) == vec3d::Zn(), "Cross product is not usable in constant expressions.");
+  static_assert(vec.IsCollinear(vec * 3.) && !vec.IsOrthogonal(vec), "Vector predicates are not usable in constant expressions.");
+  // Lengths need a constexpr Sqrt, see sqrt.h
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  static_assert(vec.Length() == 7., "Vector length is not usable in constant expressions.");
+  static_assert(vec.Normalize() == vec3d(2. / 7., 3. / 7., 6. / 7.), "Vector normalization is not usable in constant expressions.");
+  constexpr vec3f table[] = { vec3f(1.f, 1.f, 0.f).Normalize(), vec3f(0.f, 3.f, 4.f).Normalize() };
+  static_assert(table[1] == vec3f(0.f, 0.6f, 0.8f), "Lookup table of normalized vectors could not be built at compile time.");
+  EXPECT_EQ(table[0], vec3f(1.f, 1.f, 0.f).Normalize()) << "Compile-time normalization differs from run-time normalization.";
+#endif
+}
@@ -0,0 +1,119 @@
+#include <cstdint>
+#include <set>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\analysis\sequence.h"
+#include "..\..\lib\geometry\point_array.h"
+#include "..\..\lib\geometry\vector_array.h"
+#include "..\..\lib\utility\allocator.h"
+
+using namespace j::math;
+
+//
+// MemoryArenaTests
+//
+TEST(MemoryArenaTests, Allocate) {
+  MemoryArena arena(256);
+  void* a = arena.Allocate(10, 1);
+  void* b = arena.Allocate(8, 64);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u) << "Allocation not aligned.";
+  EXPECT_NE(a, b) << "Allocations overlap.";
+  EXPECT_EQ(arena.Used(), 18u) << "Wrong number of bytes used.";
+  EXPECT_EQ(arena.Capacity(), 256u) << "Small allocations did not share a block.";
+  arena.Allocate(1000);
+  EXPECT_GE(arena.Capacity(), 1256u) << "Allocation larger than a block not served.";
+}
+
+TEST(MemoryArenaTests, Reset) {
+  MemoryArena arena(64);
+  void* first = arena.Allocate(32);
+  for (int i = 0; i < 10; ++i) { arena.Allocate(48); }
+  size_t capacity = arena.Capacity();
+  arena.Reset();
+  EXPECT_EQ(arena.Used(), 0u) << "Memory still in use after a reset.";
+  EXPECT_EQ(arena.Capacity(), capacity) << "Capacity not kept by a reset.";
+  // The blocks were merged, so the same allocations now fit without growing.
+  arena.Allocate(32);
+  for (int i = 0; i < 10; ++i) { arena.Allocate(48); }
+  EXPECT_EQ(arena.Capacity(), capacity) << "Arena grew after a reset.";
+  MemoryArena single(1024);
+  first = single.Allocate(100);
+  single.Reset();
+  EXPECT_EQ(single.Allocate(100), first) << "Memory not reused after a reset.";
+  single.Release();
+  EXPECT_EQ(single.Capacity(), 0u) << "Memory not released.";
+}
+
+//
+// MemoryPoolTests
+//
+TEST(MemoryPoolTests, AllocateDeallocate) {
+  MemoryPool pool(20, 4);
+  EXPECT_EQ(pool.BlockSize() % alignof(std::max_align_t), 0u) << "Block size not a multiple of the alignment.";
+  EXPECT_GE(pool.BlockSize(), 20u) << "Block smaller than requested.";
+  std::set<void*> blocks;
+  for (int i = 0; i < 10; ++i) { blocks.insert(pool.Allocate()); }
+  EXPECT_EQ(blocks.size(), 10u) << "Block handed out twice.";
+  EXPECT_EQ(pool.Capacity(), 12u) << "Pool not grown one chunk at a time.";
+  void* block = *blocks.begin();
+  pool.Deallocate(block);
+  EXPECT_EQ(pool.Allocate(), block) << "Freed block not reused.";
+  EXPECT_EQ(pool.Capacity(), 12u) << "Pool grew while a block was free.";
+}
+
+//
+// AllocatorTests
+//
+TEST(AllocatorTests, Sequence) {
+  MemoryArena arena;
+  Sequence1D<float, ArenaAllocator<float>> sequence{ ArenaAllocator<float>(arena) };
+  sequence.Reserve(100);
+  for (int i = 0; i < 100; ++i) { sequence.Add(float(i)); }
+  EXPECT_EQ(arena.Used(), 100 * sizeof(float)) << "Storage not taken from the arena.";
+  EXPECT_EQ(sequence.Sum(), 4950.f) << "Wrong sum of an arena sequence.";
+  EXPECT_EQ(sequence.Sum(10, 20), 145.f) << "Wrong range sum of an arena sequence.";
+  Sequence1D<float, ArenaAllocator<float>> copy = sequence;
+  EXPECT_TRUE(copy.GetAllocator() == sequence.GetAllocator()) << "Copy does not use the same arena.";
+  EXPECT_TRUE(copy == sequence) << "Copy differs.";
+  seq1f heap = sequence;
+  EXPECT_EQ(heap.Sum(), 4950.f) << "Wrong conversion to the default allocator.";
+  Sequence1D<float, ArenaAllocator<float>> back(heap, ArenaAllocator<float>(arena));
+  EXPECT_TRUE(back == sequence) << "Wrong conversion from the default allocator.";
+  sequence.Clear();
+  EXPECT_EQ(sequence.Length(), 0u) << "Sequence not cleared.";
+  EXPECT_EQ(sequence.Sum(0, 10), 0.f) << "Range sum of a cleared sequence not zero.";
+  // A default-constructed allocator uses the heap.
+  Sequence1D<double, ArenaAllocator<double>> unbound(std::vector<double>{ 1., 2. });
+  EXPECT_EQ(unbound.Sum(), 3.) << "Wrong sum of a sequence without arena.";
+
+  MemoryPool pool(64 * sizeof(int));
+  {
+    Sequence1D<int, PoolAllocator<int>> small{ PoolAllocator<int>(pool) };
+    small.Reserve(64);
+    for (int i = 0; i < 64; ++i) { small.Add(i); }
+    EXPECT_EQ(pool.Capacity(), kDefaultPoolChunkSize) << "Storage not taken from the pool.";
+    small.Add(64);  // Grows beyond a block, from the heap
+    EXPECT_EQ(small.Sum(), 2080) << "Wrong sum of a pool sequence.";
+  }
+  void* block = pool.Allocate();
+  pool.Deallocate(block);
+  EXPECT_EQ(pool.Capacity(), kDefaultPoolChunkSize) << "Pool grew after the sequence returned its block.";
+}
+
+TEST(AllocatorTests, GeometryArrays) {
+  MemoryArena arena;
+  Point3DArray<float, ArenaAllocator<float>> points{ ArenaAllocator<float>(arena) };
+  points.Reserve(3);
+  points.Add(Point3D<float>(3.f, 4.f, 0.f));
+  points.Add(Point3D<float>(0.f, 0.f, 2.f));
+  points.Add(Point3D<float>(1.f, 0.f, 0.f));
+  EXPECT_EQ(arena.Used(), 9 * sizeof(float)) << "Components not taken from the arena.";
+  std::vector<float> distances;
+  BatchDistance(points, Point3D<float>(0.f, 0.f, 0.f), distances);
+  EXPECT_TRUE(distances == std::vector<float>({ 5.f, 2.f, 1.f })) << "Wrong batch distances of an arena array.";
+  Vector3DArray<float, ArenaAllocator<float>> a(std::vector<vec3f>{ vec3f(1.f, 0.f, 0.f), vec3f(0.f, 3.f, 0.f) }, ArenaAllocator<float>(arena));
+  vec3arrayf b(std::vector<vec3f>{ vec3f(0.f, 1.f, 0.f), vec3f(0.f, 0.f, 1.f) });
+  Vector3DArray<float, ArenaAllocator<float>> cross{ ArenaAllocator<float>(arena) };
+  BatchCrossProduct(a, b, cross);
+  EXPECT_TRUE(cross[0] == vec3f(0.f, 0.f, 1.f) && cross[1] == vec3f(3.f, 0.f, 0.f)) << "Wrong cross products of mixed allocators.";
+}
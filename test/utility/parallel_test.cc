@@ -0,0 +1,35 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <gtest\gtest.h>
+#include "..\..\lib\utility\parallel.h"
+
+using namespace j::math;
+
+//
+// ParallelForTests
+//
+TEST(ParallelForTests, Ranges) {
+  for (size_t thread_count : { 0, 1, 3, 64 }) {
+    std::vector<int> visits(1000, 0);
+    std::atomic<bool> aligned(true);
+    ParallelFor(visits.size(), thread_count, 16, [&](size_t begin, size_t end) {
+      if (begin % 16 != 0) { aligned = false; }
+      for (size_t i = begin; i < end; ++i) { ++visits[i]; }
+    });
+    EXPECT_EQ(visits, std::vector<int>(1000, 1)) << "Not every index visited once with " << thread_count << " threads.";
+    EXPECT_TRUE(aligned) << "Range not aligned to the grain with " << thread_count << " threads.";
+  }
+  ParallelFor(0, 4, 1, [](size_t, size_t) { FAIL() << "Body called for an empty range."; });
+}
+
+TEST(ParallelForTests, Exceptions) {
+  for (size_t thrower : { 0, 3 }) {
+    std::atomic<size_t> visited(0);
+    EXPECT_THROW(ParallelFor(400, 4, 1, [&](size_t begin, size_t end) {
+      visited += end - begin;
+      if (begin / 100 == thrower) { throw std::runtime_error("range failed"); }
+    }), std::runtime_error) << "Exception in range " << thrower << " not rethrown.";
+    EXPECT_EQ(visited, 400u) << "Other ranges did not run to completion when range " << thrower << " threw.";
+  }
+}
@@ -0,0 +1,28 @@
+#include <cmath>
+#include <gtest\gtest.h>
+#include "..\..\lib\utility\sqrt.h"
+
+using namespace j::math;
+
+//
+// SqrtTests
+//
+TEST(SqrtTests, CompileTimeEvaluation) {
+  static_assert(ConstexprSqrt(0.) == 0., "Square root of zero is incorrect.");
+  static_assert(ConstexprSqrt(49.) == 7., "Square root of a perfect square is incorrect.");
+  static_assert(ConstexprSqrt(0.0625f) == 0.25f, "Square root of a value below one is incorrect.");
+  static_assert(ConstexprSqrt(144) == 12., "Square root of an integer is incorrect.");
+  static_assert(ConstexprSqrt(-1.) != ConstexprSqrt(-1.), "Square root of a negative value is not NaN.");
+  constexpr double root_two = ConstexprSqrt(2.);
+  EXPECT_DOUBLE_EQ(root_two, std::sqrt(2.)) << "Compile-time square root deviates from std::sqrt.";
+#if defined(J_MATH_HAS_CONSTANT_EVALUATED)
+  static_assert(Sqrt(49.) == 7. && Sqrt(0.0625f) == 0.25f, "Square root is not usable in constant expressions.");
+#endif
+}
+
+TEST(SqrtTests, RunTimeEvaluation) {
+  for (double x : { 0., 0.5, 2., 3., 1e-300, 12345.678, 1e300 }) {
+    EXPECT_EQ(Sqrt(x), std::sqrt(x)) << "Run-time square root differs from std::sqrt for " << x << ".";
+    EXPECT_EQ(Sqrt(float(x)), std::sqrt(float(x))) << "Run-time float square root differs from std::sqrt for " << x << ".";
+  }
+}
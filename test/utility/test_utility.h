@@ -0,0 +1,42 @@
+#pragma once
+#ifndef J_MATH_TEST_UTILITY_H_
+#define J_MATH_TEST_UTILITY_H_
+
+#include <cstddef>
+#include <random>
+#include <vector>
+#include "..\..\lib\utility\simd.h"
+
+namespace j {
+namespace math {
+namespace test {
+
+// Runs body(level) once for every instruction set supported by the CPU, restoring the selected one afterwards.
+template<typename function>
+void ForEachSimdLevel(function body) {
+  SimdLevel original = GetSimdLevel();
+  for (SimdLevel level : { SimdLevel::SCALAR, SimdLevel::SSE, SimdLevel::AVX2 }) {
+    if (GetSupportedSimdLevel() < level) { continue; }
+    SetSimdLevel(level);
+    body(level);
+  }
+  SetSimdLevel(original);
+}
+
+// count values drawn uniformly from [min, max), the same for every run with the same seed. Tests pass counts that are
+// no multiple of any SIMD width so the scalar tails are exercised as well.
+template<typename valuetype>
+std::vector<valuetype> RandomValues(size_t count, unsigned int seed, double min = -100., double max = 100.) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(min, max);
+  std::vector<valuetype> values;
+  values.reserve(count);
+  for (size_t i = 0; i < count; ++i) { values.push_back(valuetype(distribution(generator))); }
+  return values;
+}
+
+} // namespace
+} // namespace
+} // namespace
+
+#endif // J_MATH_TEST_UTILITY_H_